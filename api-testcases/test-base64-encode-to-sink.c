@@ -0,0 +1,144 @@
+/*
+ *  duk_base64_encode_to_sink()
+ */
+
+/*===
+*** test_basic (duk_safe_call)
+ret: 4, output: Zm9v
+ret: 8, output: Zm9vYg==
+ret: 8, output: Zm9vYmE=
+ret: 0, chunks: 0
+number: MTIzLjU=
+top after: 5
+==> rc=0, result='undefined'
+*** test_chunks (duk_safe_call)
+chunks > 1: 1
+max chunk <= 1024: 1
+all chunks multiple of 4: 1
+output matches duk_base64_encode(): 1
+top after: 1
+==> rc=0, result='undefined'
+*** test_sink_error (duk_safe_call)
+==> rc=1, result='Error: sink failed'
+*** test_invalid_args (duk_safe_call)
+==> rc=1, result='Error: invalid call args'
+===*/
+
+typedef struct {
+	char buf[65536];
+	duk_size_t len;
+	duk_size_t chunks;
+	duk_size_t max_chunk;
+	int unaligned_chunk;
+	duk_context *ctx;
+	int fail;
+} sink_state;
+
+static sink_state state;
+
+static void sink_reset(duk_context *ctx) {
+	memset((void *) &state, 0, sizeof(state));
+	state.ctx = ctx;
+}
+
+static void sink_write(void *udata, const char *buf, duk_size_t len) {
+	sink_state *st = (sink_state *) udata;
+
+	if (st->fail) {
+		duk_error(st->ctx, DUK_ERR_ERROR, "sink failed");
+	}
+	if (len > st->max_chunk) {
+		st->max_chunk = len;
+	}
+	if (len % 4 != 0) {
+		st->unaligned_chunk = 1;
+	}
+	st->chunks++;
+	if (st->len + len < sizeof(st->buf)) {
+		memcpy((void *) (st->buf + st->len), (const void *) buf, len);
+	}
+	st->len += len;
+	st->buf[st->len < sizeof(st->buf) ? st->len : sizeof(st->buf) - 1] = (char) 0;
+}
+
+static duk_ret_t test_basic(duk_context *ctx) {
+	duk_size_t ret;
+	void *p;
+
+	duk_push_string(ctx, "foo");
+	sink_reset(ctx);
+	ret = duk_base64_encode_to_sink(ctx, -1, sink_write, (void *) &state);
+	printf("ret: %ld, output: %s\n", (long) ret, state.buf);
+
+	p = duk_push_fixed_buffer(ctx, 4);
+	memcpy(p, (const void *) "foob", 4);
+	sink_reset(ctx);
+	ret = duk_base64_encode_to_sink(ctx, -1, sink_write, (void *) &state);
+	printf("ret: %ld, output: %s\n", (long) ret, state.buf);
+
+	duk_push_string(ctx, "fooba");
+	sink_reset(ctx);
+	ret = duk_base64_encode_to_sink(ctx, -1, sink_write, (void *) &state);
+	printf("ret: %ld, output: %s\n", (long) ret, state.buf);
+
+	duk_push_string(ctx, "");
+	sink_reset(ctx);
+	ret = duk_base64_encode_to_sink(ctx, -1, sink_write, (void *) &state);
+	printf("ret: %ld, chunks: %ld\n", (long) ret, (long) state.chunks);
+
+	/* Value is coerced with ToString() but not modified in place. */
+	duk_push_number(ctx, 123.5);
+	sink_reset(ctx);
+	(void) duk_base64_encode_to_sink(ctx, -1, sink_write, (void *) &state);
+	printf("%s: %s\n", duk_is_number(ctx, -1) ? "number" : "not number", state.buf);
+
+	printf("top after: %ld\n", (long) duk_get_top(ctx));
+	duk_set_top(ctx, 0);
+	return 0;
+}
+
+static duk_ret_t test_chunks(duk_context *ctx) {
+	duk_eval_string(ctx, "(function () { var b = Duktape.Buffer(10000); "
+	                     "for (var i = 0; i < b.length; i++) { b[i] = (i * 13) & 0xff; } return b; })()");
+
+	sink_reset(ctx);
+	(void) duk_base64_encode_to_sink(ctx, -1, sink_write, (void *) &state);
+	printf("chunks > 1: %d\n", (int) (state.chunks > 1));
+	printf("max chunk <= 1024: %d\n", (int) (state.max_chunk <= 1024));
+	printf("all chunks multiple of 4: %d\n", (int) (!state.unaligned_chunk));
+
+	duk_dup_top(ctx);
+	duk_base64_encode(ctx, -1);
+	printf("output matches duk_base64_encode(): %d\n",
+	       (int) (state.len == duk_get_length(ctx, -1) &&
+	              strcmp(state.buf, duk_get_string(ctx, -1)) == 0));
+	duk_pop(ctx);
+
+	printf("top after: %ld\n", (long) duk_get_top(ctx));
+	duk_set_top(ctx, 0);
+	return 0;
+}
+
+static duk_ret_t test_sink_error(duk_context *ctx) {
+	duk_push_string(ctx, "foo");
+
+	sink_reset(ctx);
+	state.fail = 1;
+	(void) duk_base64_encode_to_sink(ctx, -1, sink_write, (void *) &state);
+	printf("never here\n");
+	return 0;
+}
+
+static duk_ret_t test_invalid_args(duk_context *ctx) {
+	duk_push_string(ctx, "foo");
+	(void) duk_base64_encode_to_sink(ctx, -1, NULL, NULL);
+	printf("never here\n");
+	return 0;
+}
+
+void test(duk_context *ctx) {
+	TEST_SAFE_CALL(test_basic);
+	TEST_SAFE_CALL(test_chunks);
+	TEST_SAFE_CALL(test_sink_error);
+	TEST_SAFE_CALL(test_invalid_args);
+}
@@ -0,0 +1,157 @@
+/*
+ *  Heap in arena mode (DUK_HEAP_OPTION_ARENA).  Behavior must be the same
+ *  as for an ordinary heap, and all memory must be released on destroy;
+ *  the option is ignored if arena support is not compiled in.
+ */
+
+/*===
+*** test_1 (duk_safe_call)
+script result: 19999 1000 cyclic
+finalizer count before destroy: 0
+finalizer: last
+finalizer count after destroy: 1
+outstanding allocations after destroy: 0
+==> rc=0, result='undefined'
+*** test_2 (duk_safe_call)
+script result: 500000
+outstanding allocations after destroy: 0
+==> rc=0, result='undefined'
+===*/
+
+static long outstanding = 0;
+static int finalizer_count = 0;
+
+static void *my_alloc(void *udata, duk_size_t size) {
+	void *res;
+	(void) udata;
+	res = malloc(size);
+	if (res) {
+		outstanding++;
+	}
+	return res;
+}
+
+static void *my_realloc(void *udata, void *ptr, duk_size_t size) {
+	void *res;
+	(void) udata;
+	if (size == 0) {
+		if (ptr) {
+			outstanding--;
+		}
+		free(ptr);
+		return NULL;
+	}
+	res = realloc(ptr, size);
+	if (res && !ptr) {
+		outstanding++;
+	}
+	return res;
+}
+
+static void my_free(void *udata, void *ptr) {
+	(void) udata;
+	if (ptr) {
+		outstanding--;
+	}
+	free(ptr);
+}
+
+static duk_ret_t my_finalizer(duk_context *ctx) {
+	duk_get_prop_string(ctx, 0, "name");
+	printf("finalizer: %s\n", duk_safe_to_string(ctx, -1));
+	finalizer_count++;
+	return 0;
+}
+
+static duk_ret_t test_1(duk_context *ctx) {
+	duk_context *new_ctx;
+	duk_heap_options opts;
+
+	memset((void *) &opts, 0, sizeof(opts));
+	opts.flags = DUK_HEAP_OPTION_ARENA;
+	opts.arena_chunk_size = 8192;
+
+	outstanding = 0;
+	finalizer_count = 0;
+	new_ctx = duk_create_heap_ex(my_alloc, my_realloc, my_free, NULL, NULL, &opts);
+	if (!new_ctx) {
+		printf("heap creation failed\n");
+		return 0;
+	}
+
+	/* Garbage (including cycles and large objects), long strings, and
+	 * buffers; then an object with a finalizer which is still reachable
+	 * when the heap is destroyed.
+	 */
+	duk_eval_string(new_ctx,
+		"(function () {\n"
+		"    var keep = [];\n"
+		"    var last, big, cyc;\n"
+		"    for (var i = 0; i < 20000; i++) {\n"
+		"        last = { index: i, name: 'obj' + i };\n"
+		"        cyc = { other: last }; last.other = cyc; cyc.tag = 'cyclic';\n"
+		"        if (i % 20 === 0) { keep.push(last); }\n"
+		"        if (i % 1000 === 0) {\n"
+		"            big = {};\n"
+		"            for (var j = 0; j < 1000; j++) { big['k' + j] = j; }\n"
+		"            big.str = new Array(1000).join('x');\n"
+		"            big.buf = Duktape.Buffer(4096);\n"
+		"        }\n"
+		"    }\n"
+		"    return [ last.index, keep.length, last.other.tag ].join(' ');\n"
+		"})()");
+	printf("script result: %s\n", duk_safe_to_string(new_ctx, -1));
+	duk_pop(new_ctx);
+
+	duk_push_object(new_ctx);
+	duk_push_string(new_ctx, "last");
+	duk_put_prop_string(new_ctx, -2, "name");
+	duk_push_c_function(new_ctx, my_finalizer, 1);
+	duk_set_finalizer(new_ctx, -2);
+	duk_put_global_string(new_ctx, "finalizable");
+	duk_gc(new_ctx, 0);
+
+	printf("finalizer count before destroy: %d\n", finalizer_count);
+	duk_destroy_heap(new_ctx);
+	printf("finalizer count after destroy: %d\n", finalizer_count);
+	printf("outstanding allocations after destroy: %ld\n", outstanding);
+
+	(void) ctx;
+	return 0;
+}
+
+static duk_ret_t test_2(duk_context *ctx) {
+	duk_context *new_ctx;
+	duk_heap_options opts;
+
+	/* Default chunk size, many heaps created and destroyed. */
+	memset((void *) &opts, 0, sizeof(opts));
+	opts.flags = DUK_HEAP_OPTION_ARENA;
+
+	outstanding = 0;
+	{
+		int i;
+		double sum = 0.0;
+		for (i = 0; i < 20; i++) {
+			new_ctx = duk_create_heap_ex(my_alloc, my_realloc, my_free, NULL, NULL, &opts);
+			if (!new_ctx) {
+				printf("heap creation failed\n");
+				return 0;
+			}
+			duk_eval_string(new_ctx,
+				"var t = 0; for (var i = 0; i < 1000; i++) { t += [ i, i ].length + String(i).length * 0; } t / 2;");
+			sum += duk_get_number(new_ctx, -1);
+			duk_destroy_heap(new_ctx);
+		}
+		printf("script result: %.0f\n", sum * 25.0);
+	}
+	printf("outstanding allocations after destroy: %ld\n", outstanding);
+
+	(void) ctx;
+	return 0;
+}
+
+void test(duk_context *ctx) {
+	TEST_SAFE_CALL(test_1);
+	TEST_SAFE_CALL(test_2);
+}
@@ -0,0 +1,204 @@
+/*
+ *  duk_create_heap_ex() with heap options, and duk_get_slab_stats().
+ *  The slab allocator is optional so the slab statistics are only checked
+ *  for consistency when they're available.
+ */
+
+/*===
+*** test_1 (duk_safe_call)
+NULL options: concat test: 'foobarquux'
+outstanding allocations after destroy: 0
+==> rc=0, result='undefined'
+*** test_2 (duk_safe_call)
+script result: 99999
+slab stats consistent: 1
+slab stats after gc consistent: 1
+outstanding allocations after destroy: 0
+==> rc=0, result='undefined'
+*** test_3 (duk_safe_call)
+invalid options sanitized: 1
+script result: abcabcabc
+outstanding allocations after destroy: 0
+==> rc=0, result='undefined'
+===*/
+
+static long outstanding = 0;
+
+static void *my_alloc(void *udata, duk_size_t size) {
+	void *res;
+	(void) udata;
+	res = malloc(size);
+	if (res) {
+		outstanding++;
+	}
+	return res;
+}
+
+static void *my_realloc(void *udata, void *ptr, duk_size_t size) {
+	void *res;
+	(void) udata;
+	if (size == 0) {
+		if (ptr) {
+			outstanding--;
+		}
+		free(ptr);
+		return NULL;
+	}
+	res = realloc(ptr, size);
+	if (res && !ptr) {
+		outstanding++;
+	}
+	return res;
+}
+
+static void my_free(void *udata, void *ptr) {
+	(void) udata;
+	if (ptr) {
+		outstanding--;
+	}
+	free(ptr);
+}
+
+/* Check that the slab statistics add up; trivially true without the slab
+ * allocator.  With 'expect_opts' the sizes given in test_2 are expected.
+ */
+static int check_slab_stats(duk_context *ctx, int expect_opts) {
+	duk_slab_stats st;
+	duk_size_t i;
+	duk_size_t pages = 0;
+
+	if (!duk_get_slab_stats(ctx, &st)) {
+		return st.chunk_count == 0 && st.class_count == 0;
+	}
+	if (expect_opts) {
+		if (st.page_size != 2048 || st.chunk_pages != 4 || st.max_size != 128) {
+			printf("unexpected sizes: %ld %ld %ld\n",
+			       (long) st.page_size, (long) st.chunk_pages, (long) st.max_size);
+			return 0;
+		}
+	}
+	if (st.class_count == 0 || st.class_count > DUK_SLAB_MAX_CLASSES ||
+	    st.class_count * 8 != st.max_size) {
+		return 0;
+	}
+	for (i = 0; i < st.class_count; i++) {
+		duk_slab_class_stats *cs = st.classes + i;
+		if (cs->slot_size != (i + 1) * 8) {
+			return 0;
+		}
+		if (cs->alloc_count - cs->free_count != cs->used_count) {
+			return 0;
+		}
+		if (cs->used_count > 0 && cs->page_count == 0) {
+			return 0;
+		}
+		pages += cs->page_count;
+	}
+	if (pages + st.free_page_count != st.chunk_count * st.chunk_pages) {
+		return 0;
+	}
+	if (st.chunk_alloc_count - st.chunk_free_count != st.chunk_count) {
+		return 0;
+	}
+	return 1;
+}
+
+static duk_ret_t test_1(duk_context *ctx) {
+	duk_context *new_ctx;
+
+	outstanding = 0;
+	new_ctx = duk_create_heap_ex(my_alloc, my_realloc, my_free, NULL, NULL, NULL);
+	if (!new_ctx) {
+		printf("heap creation failed\n");
+		return 0;
+	}
+	duk_push_string(new_ctx, "foo");
+	duk_push_string(new_ctx, "bar");
+	duk_push_string(new_ctx, "quux");
+	duk_concat(new_ctx, 3);
+	printf("NULL options: concat test: '%s'\n", duk_get_string(new_ctx, -1));
+	duk_destroy_heap(new_ctx);
+	printf("outstanding allocations after destroy: %ld\n", outstanding);
+
+	(void) ctx;
+	return 0;
+}
+
+static duk_ret_t test_2(duk_context *ctx) {
+	duk_context *new_ctx;
+	duk_heap_options opts;
+
+	memset((void *) &opts, 0, sizeof(opts));
+	opts.slab_page_size = 2048;
+	opts.slab_chunk_pages = 4;
+	opts.slab_max_size = 128;
+
+	outstanding = 0;
+	new_ctx = duk_create_heap_ex(my_alloc, my_realloc, my_free, NULL, NULL, &opts);
+	if (!new_ctx) {
+		printf("heap creation failed\n");
+		return 0;
+	}
+
+	/* Lots of small objects and strings which die in various orders. */
+	duk_eval_string(new_ctx,
+		"(function () {\n"
+		"    var keep = [];\n"
+		"    var last;\n"
+		"    for (var i = 0; i < 100000; i++) {\n"
+		"        var o = { index: i, name: 'obj' + i };\n"
+		"        if (i % 3 === 0) { o.extra = [ i, i + 1 ]; }\n"
+		"        if (i % 7 === 0) { keep.push(o); }\n"
+		"        if (keep.length > 1000) { keep.splice(0, 500); }\n"
+		"        last = o;\n"
+		"    }\n"
+		"    globalThis_keep = keep;\n"
+		"    return last.index;\n"
+		"})()");
+	printf("script result: %s\n", duk_safe_to_string(new_ctx, -1));
+	duk_pop(new_ctx);
+	printf("slab stats consistent: %d\n", check_slab_stats(new_ctx, 1));
+
+	duk_eval_string_noresult(new_ctx, "globalThis_keep = null;");
+	duk_gc(new_ctx, 0);
+	duk_gc(new_ctx, 0);
+	printf("slab stats after gc consistent: %d\n", check_slab_stats(new_ctx, 1));
+
+	duk_destroy_heap(new_ctx);
+	printf("outstanding allocations after destroy: %ld\n", outstanding);
+
+	(void) ctx;
+	return 0;
+}
+
+static duk_ret_t test_3(duk_context *ctx) {
+	duk_context *new_ctx;
+	duk_heap_options opts;
+
+	/* Out of range sizes are clamped rather than rejected. */
+	memset((void *) &opts, 0, sizeof(opts));
+	opts.slab_page_size = 100;
+	opts.slab_chunk_pages = 1;
+	opts.slab_max_size = 100000;
+
+	outstanding = 0;
+	new_ctx = duk_create_heap_ex(my_alloc, my_realloc, my_free, NULL, NULL, &opts);
+	if (!new_ctx) {
+		printf("heap creation failed\n");
+		return 0;
+	}
+	printf("invalid options sanitized: %d\n", check_slab_stats(new_ctx, 0));
+	duk_eval_string(new_ctx, "var s = ''; for (var i = 0; i < 3; i++) { s += 'abc'; } s;");
+	printf("script result: %s\n", duk_safe_to_string(new_ctx, -1));
+	duk_destroy_heap(new_ctx);
+	printf("outstanding allocations after destroy: %ld\n", outstanding);
+
+	(void) ctx;
+	return 0;
+}
+
+void test(duk_context *ctx) {
+	TEST_SAFE_CALL(test_1);
+	TEST_SAFE_CALL(test_2);
+	TEST_SAFE_CALL(test_3);
+}
@@ -0,0 +1,263 @@
+/*
+ *  Heap memory limits (mem_limit_soft, mem_limit_hard).
+ */
+
+/*===
+*** test_1 (duk_safe_call)
+caught: RangeError memory limit exceeded
+after: 4950
+peak within hard limit: 1
+limits: 0 1048576
+duk_alloc over limit: 1
+duk_alloc_raw over limit: 1
+duk_alloc under limit: 1
+outstanding allocations after destroy: 0
+==> rc=0, result='undefined'
+*** test_2 (duk_safe_call)
+emergency gc triggered: 1
+used below hard limit: 1
+outstanding allocations after destroy: 0
+==> rc=0, result='undefined'
+*** test_3 (duk_safe_call)
+heap creation failed: 1
+outstanding allocations after failed creation: 0
+==> rc=0, result='undefined'
+*** test_4 (duk_safe_call)
+hard limit at 16kB fails: 1
+hard limit sweep: 1
+soft limit sweep: 1
+outstanding allocations after sweep: 0
+==> rc=0, result='undefined'
+===*/
+
+static long outstanding = 0;
+
+static void *my_alloc(void *udata, duk_size_t size) {
+	void *res;
+	(void) udata;
+	res = malloc(size);
+	if (res) {
+		outstanding++;
+	}
+	return res;
+}
+
+static void *my_realloc(void *udata, void *ptr, duk_size_t size) {
+	void *res;
+	(void) udata;
+	if (size == 0) {
+		if (ptr) {
+			outstanding--;
+		}
+		free(ptr);
+		return NULL;
+	}
+	res = realloc(ptr, size);
+	if (res && !ptr) {
+		outstanding++;
+	}
+	return res;
+}
+
+static void my_free(void *udata, void *ptr) {
+	(void) udata;
+	if (ptr) {
+		outstanding--;
+	}
+	free(ptr);
+}
+
+static duk_ret_t test_1(duk_context *ctx) {
+	duk_context *new_ctx;
+	duk_heap_options opts;
+	duk_heap_stats st;
+	void *ptr;
+
+	memset((void *) &opts, 0, sizeof(opts));
+	opts.mem_limit_hard = 1024 * 1024;
+
+	outstanding = 0;
+	new_ctx = duk_create_heap_ex(my_alloc, my_realloc, my_free, NULL, NULL, &opts);
+	if (!new_ctx) {
+		printf("heap creation failed\n");
+		return 0;
+	}
+
+	/* A runaway script gets a catchable RangeError and the heap remains
+	 * usable once the garbage is gone.
+	 */
+	duk_eval_string_noresult(new_ctx,
+		"function runaway() {\n"
+		"    var keep = [];\n"
+		"    for (;;) { keep.push(new Array(100).join('x') + keep.length); }\n"
+		"}\n"
+		"try {\n"
+		"    runaway();\n"
+		"} catch (e) {\n"
+		"    print('caught:', e.name, e.message);\n"
+		"}\n"
+		"var t = 0; for (var i = 0; i < 100; i++) { t += [ i ].map(function (v) { return v; })[0]; }\n"
+		"print('after:', t);\n");
+
+	duk_get_heap_stats(new_ctx, &st);
+	printf("peak within hard limit: %d\n", (int) (st.mem_peak > 0 && st.mem_peak <= 1024 * 1024 &&
+	                                              st.mem_used <= st.mem_peak));
+	printf("limits: %ld %ld\n", (long) st.mem_limit_soft, (long) st.mem_limit_hard);
+
+	/* Raw and ordinary allocations from C are limited too. */
+	ptr = duk_alloc(new_ctx, 2 * 1024 * 1024);
+	printf("duk_alloc over limit: %d\n", (int) (ptr == NULL));
+	ptr = duk_alloc_raw(new_ctx, 2 * 1024 * 1024);
+	printf("duk_alloc_raw over limit: %d\n", (int) (ptr == NULL));
+	ptr = duk_alloc(new_ctx, 1024);
+	printf("duk_alloc under limit: %d\n", (int) (ptr != NULL));
+	duk_free(new_ctx, ptr);
+
+	duk_destroy_heap(new_ctx);
+	printf("outstanding allocations after destroy: %ld\n", outstanding);
+
+	(void) ctx;
+	return 0;
+}
+
+static duk_ret_t test_2(duk_context *ctx) {
+	duk_context *new_ctx;
+	duk_heap_options opts;
+	duk_heap_stats st1, st2;
+
+	/* Measure the baseline with a limit which is never reached. */
+	memset((void *) &opts, 0, sizeof(opts));
+	opts.mem_limit_hard = 256 * 1024 * 1024;
+	new_ctx = duk_create_heap_ex(my_alloc, my_realloc, my_free, NULL, NULL, &opts);
+	if (!new_ctx) {
+		printf("heap creation failed\n");
+		return 0;
+	}
+	duk_gc(new_ctx, 0);
+	duk_get_heap_stats(new_ctx, &st1);
+	duk_destroy_heap(new_ctx);
+
+	/* Cyclic garbage is only collected by mark-and-sweep; reaching the
+	 * soft limit causes an emergency mark-and-sweep.
+	 */
+	opts.mem_limit_soft = st1.mem_used + 256 * 1024;
+	opts.mem_limit_hard = st1.mem_used + 4 * 1024 * 1024;
+	outstanding = 0;
+	new_ctx = duk_create_heap_ex(my_alloc, my_realloc, my_free, NULL, NULL, &opts);
+	if (!new_ctx) {
+		printf("heap creation failed\n");
+		return 0;
+	}
+	duk_get_heap_stats(new_ctx, &st1);
+	duk_eval_string_noresult(new_ctx,
+		"for (var i = 0; i < 50000; i++) {\n"
+		"    var o = { name: 'obj' + i }; o.self = o;\n"
+		"}\n");
+	duk_get_heap_stats(new_ctx, &st2);
+	printf("emergency gc triggered: %d\n", (int) (st2.ms_emergency_count > st1.ms_emergency_count));
+	printf("used below hard limit: %d\n", (int) (st2.mem_used < opts.mem_limit_hard));
+
+	duk_destroy_heap(new_ctx);
+	printf("outstanding allocations after destroy: %ld\n", outstanding);
+
+	(void) ctx;
+	return 0;
+}
+
+static duk_ret_t test_3(duk_context *ctx) {
+	duk_context *new_ctx;
+	duk_heap_options opts;
+
+	/* Too small for the built-ins. */
+	memset((void *) &opts, 0, sizeof(opts));
+	opts.mem_limit_hard = 4096;
+
+	outstanding = 0;
+	new_ctx = duk_create_heap_ex(my_alloc, my_realloc, my_free, NULL, NULL, &opts);
+	printf("heap creation failed: %d\n", (int) (new_ctx == NULL));
+	if (new_ctx) {
+		duk_destroy_heap(new_ctx);
+	}
+	printf("outstanding allocations after failed creation: %ld\n", outstanding);
+
+	(void) ctx;
+	return 0;
+}
+
+static duk_ret_t test_4(duk_context *ctx) {
+	duk_context *new_ctx;
+	duk_heap_options opts;
+	duk_heap_stats st;
+	duk_size_t footprint;
+	duk_size_t limit;
+	int hard_ok = 1;
+	int soft_ok = 1;
+	long leaks = 0;
+
+	/* Peak usage of heap creation with a limit which is never reached. */
+	memset((void *) &opts, 0, sizeof(opts));
+	opts.mem_limit_hard = 256 * 1024 * 1024;
+	new_ctx = duk_create_heap_ex(my_alloc, my_realloc, my_free, NULL, NULL, &opts);
+	if (!new_ctx) {
+		printf("heap creation failed\n");
+		return 0;
+	}
+	duk_get_heap_stats(new_ctx, &st);
+	footprint = st.mem_peak;
+	duk_destroy_heap(new_ctx);
+
+	memset((void *) &opts, 0, sizeof(opts));
+	opts.mem_limit_hard = 16 * 1024;
+	outstanding = 0;
+	new_ctx = duk_create_heap_ex(my_alloc, my_realloc, my_free, NULL, NULL, &opts);
+	printf("hard limit at 16kB fails: %d\n", (int) (new_ctx == NULL));
+	duk_destroy_heap(new_ctx);
+	leaks += outstanding;
+
+	/* Limits up to the default footprint are reached during heap init,
+	 * which must then run its GCs safely.  With a hard limit, heap
+	 * creation either fails cleanly or gives a usable heap; a soft limit
+	 * never causes heap creation to fail.
+	 */
+	for (limit = 16 * 1024; limit <= footprint + 4096; limit += 1024) {
+		memset((void *) &opts, 0, sizeof(opts));
+		opts.mem_limit_hard = limit;
+		outstanding = 0;
+		new_ctx = duk_create_heap_ex(my_alloc, my_realloc, my_free, NULL, NULL, &opts);
+		if (new_ctx) {
+			/* may fail with a RangeError, but must not be fatal */
+			(void) duk_peval_string(new_ctx, "[ 1, 2, 3 ].map(function (v) { return v * 2; }).join();");
+			duk_destroy_heap(new_ctx);
+		} else if (limit > footprint) {
+			hard_ok = 0;
+		}
+		leaks += outstanding;
+
+		memset((void *) &opts, 0, sizeof(opts));
+		opts.mem_limit_soft = limit;
+		outstanding = 0;
+		new_ctx = duk_create_heap_ex(my_alloc, my_realloc, my_free, NULL, NULL, &opts);
+		if (new_ctx) {
+			if (duk_peval_string(new_ctx, "[ 1, 2, 3 ].map(function (v) { return v * 2; }).join();") != 0) {
+				soft_ok = 0;
+			}
+			duk_destroy_heap(new_ctx);
+		} else {
+			soft_ok = 0;
+		}
+		leaks += outstanding;
+	}
+	printf("hard limit sweep: %d\n", hard_ok);
+	printf("soft limit sweep: %d\n", soft_ok);
+	printf("outstanding allocations after sweep: %ld\n", leaks);
+
+	(void) ctx;
+	return 0;
+}
+
+void test(duk_context *ctx) {
+	TEST_SAFE_CALL(test_1);
+	TEST_SAFE_CALL(test_2);
+	TEST_SAFE_CALL(test_3);
+	TEST_SAFE_CALL(test_4);
+}
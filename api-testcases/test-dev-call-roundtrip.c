@@ -0,0 +1,194 @@
+/*
+ *  C -> Ecmascript -> C call round trips.  Each iteration calls an
+ *  Ecmascript function from C which in turn calls a native function.
+ *
+ *  An unprotected call made with no outer catchpoint (directly from
+ *  test() below) doesn't set up a setjmp() catchpoint of its own; nested
+ *  protected calls inside it must still work and leave the value stack
+ *  and the callstack clean.
+ */
+
+/*===
+*** test_pcall (duk_safe_call)
+sum: 500500
+final top: 1
+==> rc=0, result='undefined'
+*** test_call (duk_safe_call)
+sum: 500500
+final top: 1
+==> rc=0, result='undefined'
+*** test_safe_call (duk_safe_call)
+count: 1000
+final top: 0
+==> rc=0, result='undefined'
+*** test_error (duk_safe_call)
+errors: 100
+final top: 1
+==> rc=0, result='undefined'
+*** test_direct (no catchpoint)
+top: 0, depth: 2
+sum: 500500
+nested rc: 1, Error: nested
+result: 123
+nested rc: 1, Error: nested
+result: 124
+top: 0, depth: 2
+===*/
+
+#define ROUNDS 1000
+
+static duk_ret_t native_add(duk_context *ctx) {
+	duk_push_number(ctx, duk_get_number(ctx, 0) + 1.0);
+	return 1;
+}
+
+static duk_ret_t native_noop(duk_context *ctx) {
+	(void) ctx;
+	return 0;
+}
+
+static void setup(duk_context *ctx) {
+	duk_push_global_object(ctx);
+	duk_push_c_function(ctx, native_add, 1);
+	duk_put_prop_string(ctx, -2, "nativeAdd");
+	duk_pop(ctx);
+
+	duk_eval_string(ctx, "(function (x) { if (x < 0) { throw new Error('neg'); } return nativeAdd(x); })");
+}
+
+static duk_ret_t test_pcall(duk_context *ctx) {
+	double sum = 0.0;
+	int i;
+
+	setup(ctx);
+	for (i = 0; i < ROUNDS; i++) {
+		duk_dup(ctx, -1);
+		duk_push_int(ctx, i);
+		if (duk_pcall(ctx, 1) == DUK_EXEC_SUCCESS) {
+			sum += duk_get_number(ctx, -1);
+		}
+		duk_pop(ctx);
+	}
+	printf("sum: %.0f\n", sum);
+
+	printf("final top: %ld\n", (long) duk_get_top(ctx));
+	return 0;
+}
+
+static duk_ret_t test_call(duk_context *ctx) {
+	double sum = 0.0;
+	int i;
+
+	setup(ctx);
+	for (i = 0; i < ROUNDS; i++) {
+		duk_dup(ctx, -1);
+		duk_push_int(ctx, i);
+		duk_call(ctx, 1);
+		sum += duk_get_number(ctx, -1);
+		duk_pop(ctx);
+	}
+	printf("sum: %.0f\n", sum);
+
+	printf("final top: %ld\n", (long) duk_get_top(ctx));
+	return 0;
+}
+
+static duk_ret_t test_safe_call(duk_context *ctx) {
+	int count = 0;
+	int i;
+
+	for (i = 0; i < ROUNDS; i++) {
+		if (duk_safe_call(ctx, native_noop, 0, 1) == DUK_EXEC_SUCCESS) {
+			count++;
+		}
+		duk_pop(ctx);
+	}
+	printf("count: %d\n", count);
+
+	printf("final top: %ld\n", (long) duk_get_top(ctx));
+	return 0;
+}
+
+static duk_ret_t test_error(duk_context *ctx) {
+	int errors = 0;
+	int i;
+
+	setup(ctx);
+	for (i = 0; i < ROUNDS / 10; i++) {
+		duk_dup(ctx, -1);
+		duk_push_int(ctx, -1);
+		if (duk_pcall(ctx, 1) != DUK_EXEC_SUCCESS) {
+			errors++;
+		}
+		duk_pop(ctx);
+	}
+	printf("errors: %d\n", errors);
+
+	printf("final top: %ld\n", (long) duk_get_top(ctx));
+	return 0;
+}
+
+/* Callstack depth as seen from an Ecmascript function. */
+static long get_depth(duk_context *ctx) {
+	long depth;
+
+	duk_eval_string(ctx, "(function () { var n = 0; while (Duktape.act(-n - 1)) { n++; } return n - 1; })()");
+	depth = (long) duk_get_int(ctx, -1);
+	duk_pop(ctx);
+	return depth;
+}
+
+static duk_ret_t native_nested_pcall(duk_context *ctx) {
+	duk_int_t rc;
+
+	duk_eval_string(ctx, "(function () { throw new Error('nested'); })");
+	rc = duk_pcall(ctx, 0);
+	printf("nested rc: %d, %s\n", (int) rc, duk_safe_to_string(ctx, -1));
+	duk_pop(ctx);
+
+	duk_push_int(ctx, 123);
+	return 1;
+}
+
+/* Not called through TEST_SAFE_CALL(), so there is no outer catchpoint. */
+static void test_direct(duk_context *ctx) {
+	double sum = 0.0;
+	int i;
+
+	printf("*** test_direct (no catchpoint)\n");
+	printf("top: %ld, depth: %ld\n", (long) duk_get_top(ctx), get_depth(ctx));
+
+	setup(ctx);
+	for (i = 0; i < ROUNDS; i++) {
+		duk_dup(ctx, -1);
+		duk_push_int(ctx, i);
+		duk_call(ctx, 1);
+		sum += duk_get_number(ctx, -1);
+		duk_pop(ctx);
+	}
+	printf("sum: %.0f\n", sum);
+	duk_pop(ctx);
+
+	/* C function with a nested protected call which throws */
+	duk_push_c_function(ctx, native_nested_pcall, 0);
+	duk_call(ctx, 0);
+	printf("result: %s\n", duk_safe_to_string(ctx, -1));
+	duk_pop(ctx);
+
+	/* same through an Ecmascript function */
+	duk_eval_string(ctx, "(function (f) { return f() + 1; })");
+	duk_push_c_function(ctx, native_nested_pcall, 0);
+	duk_call(ctx, 1);
+	printf("result: %s\n", duk_safe_to_string(ctx, -1));
+	duk_pop(ctx);
+
+	printf("top: %ld, depth: %ld\n", (long) duk_get_top(ctx), get_depth(ctx));
+}
+
+void test(duk_context *ctx) {
+	TEST_SAFE_CALL(test_pcall);
+	TEST_SAFE_CALL(test_call);
+	TEST_SAFE_CALL(test_safe_call);
+	TEST_SAFE_CALL(test_error);
+	test_direct(ctx);
+}
@@ -0,0 +1,68 @@
+/*
+ *  duk_get_heap_stats()
+ */
+
+/*===
+*** test_1 (duk_safe_call)
+class names: Array Function Object
+object count grows: 1
+object bytes grow: 1
+Object class count grows: 1
+buffer bytes grow: 1
+string bytes grow: 1
+thread stacks: 1
+string table: 1
+total: 1
+final top: 3
+==> rc=0, result='undefined'
+===*/
+
+static duk_ret_t test_1(duk_context *ctx) {
+	duk_heap_stats st1, st2;
+	int i;
+	int obj_class = 0;
+
+	duk_gc(ctx, 0);
+	duk_get_heap_stats(ctx, &st1);
+	printf("class names:");
+	for (i = 0; i < DUK_HEAP_STATS_MAX_CLASSES; i++) {
+		const char *name = st1.classes[i].name;
+		if (name && (strcmp(name, "Object") == 0 || strcmp(name, "Array") == 0 ||
+		             strcmp(name, "Function") == 0)) {
+			printf(" %s", name);
+		}
+		if (name && strcmp(name, "Object") == 0) {
+			obj_class = i;
+		}
+	}
+	printf("\n");
+
+	duk_push_array(ctx);
+	for (i = 0; i < 100; i++) {
+		duk_push_object(ctx);
+		duk_push_int(ctx, i);
+		duk_put_prop_string(ctx, -2, "value");
+		duk_put_prop_index(ctx, -2, (duk_uarridx_t) i);
+	}
+	(void) duk_push_fixed_buffer(ctx, 10000);
+	duk_push_string(ctx, "a string which is not interned yet, with some length to it");
+
+	duk_get_heap_stats(ctx, &st2);
+	printf("object count grows: %d\n", (int) (st2.object_count >= st1.object_count + 101));
+	printf("object bytes grow: %d\n", (int) (st2.object_bytes > st1.object_bytes));
+	printf("Object class count grows: %d\n", (int) (st2.classes[obj_class].count >= st1.classes[obj_class].count + 100));
+	printf("buffer bytes grow: %d\n", (int) (st2.buffer_bytes >= st1.buffer_bytes + 10000));
+	printf("string bytes grow: %d\n", (int) (st2.string_bytes > st1.string_bytes + 50));
+	printf("thread stacks: %d\n", (int) (st2.thread_count >= 1 && st2.thread_stack_bytes > 0));
+	printf("string table: %d\n", (int) (st2.strtab_size > 0 &&
+	                                   st2.strtab_used + st2.strtab_deleted <= st2.strtab_size &&
+	                                   st2.strtab_used == st2.string_count));
+	printf("total: %d\n", (int) (st2.total_bytes > st2.object_bytes + st2.string_bytes + st2.buffer_bytes));
+
+	printf("final top: %ld\n", (long) duk_get_top(ctx));
+	return 0;
+}
+
+void test(duk_context *ctx) {
+	TEST_SAFE_CALL(test_1);
+}
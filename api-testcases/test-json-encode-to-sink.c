@@ -0,0 +1,173 @@
+/*
+ *  duk_json_encode_to_sink()
+ */
+
+/*===
+*** test_basic (duk_safe_call)
+rc: 1
+output: {"foo":123,"bar":"quux","arr":[1,2,3]}
+top after: 2
+==> rc=0, result='undefined'
+*** test_formats (duk_safe_call)
+json: {"u":"ሴ","nan":null}
+jx: {u:"\u1234",nan:NaN,buf:|616263|}
+jc: {"u":"\u1234","nan":{"_nan":true},"buf":{"_buf":"616263"}}
+top after: 1
+==> rc=0, result='undefined'
+*** test_undefined (duk_safe_call)
+rc: 0, chunks: 0
+top after: 1
+==> rc=0, result='undefined'
+*** test_chunks (duk_safe_call)
+rc: 1
+chunks > 1: 1
+max chunk <= 4096: 1
+output matches duk_json_encode(): 1
+top after: 1
+==> rc=0, result='undefined'
+*** test_sink_error (duk_safe_call)
+==> rc=1, result='Error: sink failed'
+*** test_invalid_args (duk_safe_call)
+==> rc=1, result='Error: invalid call args'
+===*/
+
+typedef struct {
+	char buf[65536];
+	duk_size_t len;
+	duk_size_t chunks;
+	duk_size_t max_chunk;
+	duk_context *ctx;
+	int fail;
+} sink_state;
+
+static sink_state state;
+
+static void sink_reset(duk_context *ctx) {
+	memset((void *) &state, 0, sizeof(state));
+	state.ctx = ctx;
+}
+
+static void sink_write(void *udata, const char *buf, duk_size_t len) {
+	sink_state *st = (sink_state *) udata;
+
+	if (st->fail) {
+		duk_error(st->ctx, DUK_ERR_ERROR, "sink failed");
+	}
+	if (len > st->max_chunk) {
+		st->max_chunk = len;
+	}
+	st->chunks++;
+	if (st->len + len < sizeof(st->buf)) {
+		memcpy((void *) (st->buf + st->len), (const void *) buf, len);
+	}
+	st->len += len;
+	st->buf[st->len < sizeof(st->buf) ? st->len : sizeof(st->buf) - 1] = (char) 0;
+}
+
+static duk_ret_t test_basic(duk_context *ctx) {
+	duk_bool_t rc;
+
+	duk_eval_string(ctx, "({ foo: 123, bar: 'quux', arr: [ 1, 2, 3 ], f: function () {} })");
+	duk_push_int(ctx, 123);  /* dummy */
+
+	sink_reset(ctx);
+	rc = duk_json_encode_to_sink(ctx, -2, 0 /*flags*/, sink_write, (void *) &state);
+	printf("rc: %d\n", (int) rc);
+	printf("output: %s\n", state.buf);
+	printf("top after: %ld\n", (long) duk_get_top(ctx));  /* value + dummy */
+	duk_set_top(ctx, 0);
+	return 0;
+}
+
+static duk_ret_t test_formats(duk_context *ctx) {
+	duk_eval_string(ctx, "({ u: '\\u1234', nan: NaN, buf: Duktape.Buffer('abc').valueOf() })");
+
+	sink_reset(ctx);
+	(void) duk_json_encode_to_sink(ctx, -1, 0 /*flags*/, sink_write, (void *) &state);
+	printf("json: %s\n", state.buf);
+
+	sink_reset(ctx);
+	(void) duk_json_encode_to_sink(ctx, -1, DUK_JSON_ENCODE_JX, sink_write, (void *) &state);
+	printf("jx: %s\n", state.buf);
+
+	sink_reset(ctx);
+	(void) duk_json_encode_to_sink(ctx, -1, DUK_JSON_ENCODE_JC, sink_write, (void *) &state);
+	printf("jc: %s\n", state.buf);
+
+	printf("top after: %ld\n", (long) duk_get_top(ctx));
+	duk_set_top(ctx, 0);
+	return 0;
+}
+
+static duk_ret_t test_undefined(duk_context *ctx) {
+	duk_bool_t rc;
+
+	duk_eval_string(ctx, "(function () {})");
+
+	sink_reset(ctx);
+	rc = duk_json_encode_to_sink(ctx, -1, 0 /*flags*/, sink_write, (void *) &state);
+	printf("rc: %d, chunks: %ld\n", (int) rc, (long) state.chunks);
+	printf("top after: %ld\n", (long) duk_get_top(ctx));
+	duk_set_top(ctx, 0);
+	return 0;
+}
+
+static duk_ret_t test_chunks(duk_context *ctx) {
+	duk_bool_t rc;
+
+	duk_eval_string(ctx,
+		"(function () {\n"
+		"    var res = [];\n"
+		"    for (var i = 0; i < 1000; i++) {\n"
+		"        res.push({ id: i, name: 'item' + i, data: new Array(i % 20).join('x') });\n"
+		"    }\n"
+		"    res.push(new Array(3000).join('long'));\n"
+		"    return res;\n"
+		"})()");
+
+	sink_reset(ctx);
+	rc = duk_json_encode_to_sink(ctx, -1, 0 /*flags*/, sink_write, (void *) &state);
+	printf("rc: %d\n", (int) rc);
+	printf("chunks > 1: %d\n", (int) (state.chunks > 1));
+	printf("max chunk <= 4096: %d\n", (int) (state.max_chunk <= 4096));
+
+	duk_dup_top(ctx);
+	duk_json_encode(ctx, -1);
+	printf("output matches duk_json_encode(): %d\n",
+	       (int) (state.len == duk_get_length(ctx, -1) &&
+	              strcmp(state.buf, duk_get_string(ctx, -1)) == 0));
+	duk_pop(ctx);
+
+	printf("top after: %ld\n", (long) duk_get_top(ctx));
+	duk_set_top(ctx, 0);
+	return 0;
+}
+
+static duk_ret_t test_sink_error(duk_context *ctx) {
+	/* An error thrown by the sink propagates out; output written before
+	 * the error is not taken back.
+	 */
+	duk_eval_string(ctx, "[ 1, 2, 3 ]");
+
+	sink_reset(ctx);
+	state.fail = 1;
+	(void) duk_json_encode_to_sink(ctx, -1, 0 /*flags*/, sink_write, (void *) &state);
+	printf("never here\n");
+	return 0;
+}
+
+static duk_ret_t test_invalid_args(duk_context *ctx) {
+	duk_push_int(ctx, 123);
+	(void) duk_json_encode_to_sink(ctx, -1, 0 /*flags*/, NULL, NULL);
+	printf("never here\n");
+	return 0;
+}
+
+void test(duk_context *ctx) {
+	TEST_SAFE_CALL(test_basic);
+	TEST_SAFE_CALL(test_formats);
+	TEST_SAFE_CALL(test_undefined);
+	TEST_SAFE_CALL(test_chunks);
+	TEST_SAFE_CALL(test_sink_error);
+	TEST_SAFE_CALL(test_invalid_args);
+}
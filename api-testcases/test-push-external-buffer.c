@@ -0,0 +1,162 @@
+/*===
+*** test_1 (duk_safe_call)
+is_buffer: 1, is_external: 1, is_dynamic: 0, is_fixed: 0
+same pointer: 1, size: 8
+script sees: 0,1,2,3,4,5,6,7
+data after script write: 100 1 2 3 4 5 6 200
+release count before pop: 0
+release_cb: udata=0xdeadbeef, same pointer=1
+release count after pop: 1
+final top: 0
+==> rc=0, result='undefined'
+*** test_2 (duk_safe_call)
+resize external buffer
+==> rc=1, result='TypeError: buffer is not dynamic'
+*** test_3 (duk_safe_call)
+to_buffer keeps external: 1
+to_fixed_buffer: is_external=0, is_fixed=1, copied=1
+release_cb: udata=0xdeadbeef, same pointer=1
+to_dynamic_buffer: is_external=0, is_dynamic=1, copied=1
+final top: 1
+==> rc=0, result='undefined'
+*** test_4 (duk_safe_call)
+zero size: is_external=1, size=0, ptr=NULL
+null pointer with nonzero size
+==> rc=1, result='Error: invalid call args'
+*** test_5 (duk_safe_call)
+release on heap destroy: 0
+release_cb: udata=0xdeadbeef, same pointer=1
+release on heap destroy: 1
+==> rc=0, result='undefined'
+===*/
+
+static unsigned char ext_data[8] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+static int release_count = 0;
+
+static void release_cb(void *udata, void *ptr) {
+	release_count++;
+	printf("release_cb: udata=%p, same pointer=%d\n", udata, (ptr == (void *) ext_data ? 1 : 0));
+}
+
+static void dump_ext_data(const char *prefix) {
+	int i;
+	printf("%s:", prefix);
+	for (i = 0; i < 8; i++) {
+		printf(" %d", (int) ext_data[i]);
+	}
+	printf("\n");
+}
+
+/* basic case: zero copy access from C and script, release on free */
+static duk_ret_t test_1(duk_context *ctx) {
+	void *p;
+	duk_size_t sz;
+
+	duk_set_top(ctx, 0);
+	release_count = 0;
+
+	duk_push_external_buffer(ctx, (void *) ext_data, sizeof(ext_data), release_cb, (void *) 0xdeadbeef);
+	printf("is_buffer: %d, is_external: %d, is_dynamic: %d, is_fixed: %d\n",
+	       (int) duk_is_buffer(ctx, -1), (int) duk_is_external_buffer(ctx, -1),
+	       (int) duk_is_dynamic_buffer(ctx, -1), (int) duk_is_fixed_buffer(ctx, -1));
+	p = duk_get_buffer(ctx, -1, &sz);
+	printf("same pointer: %d, size: %ld\n", (p == (void *) ext_data ? 1 : 0), (long) sz);
+
+	duk_eval_string(ctx, "(function (b) { var r = []; for (var i = 0; i < b.length; i++) { r.push(b[i]); } "
+	                     "b[0] = 100; b[7] = 200; return r.join(','); })");
+	duk_dup(ctx, 0);
+	duk_call(ctx, 1);
+	printf("script sees: %s\n", duk_get_string(ctx, -1));
+	duk_pop(ctx);
+	dump_ext_data("data after script write");
+
+	printf("release count before pop: %d\n", release_count);
+	duk_pop(ctx);
+	duk_gc(ctx, 0);  /* without refcounting */
+	printf("release count after pop: %d\n", release_count);
+
+	printf("final top: %ld\n", (long) duk_get_top(ctx));
+	return 0;
+}
+
+/* external buffers can't be resized */
+static duk_ret_t test_2(duk_context *ctx) {
+	duk_set_top(ctx, 0);
+
+	duk_push_external_buffer(ctx, (void *) ext_data, sizeof(ext_data), NULL, NULL);
+	printf("resize external buffer\n");
+	(void) duk_resize_buffer(ctx, -1, 16);
+
+	printf("final top: %ld\n", (long) duk_get_top(ctx));
+	return 0;
+}
+
+/* coercion to a fixed or dynamic buffer makes a copy */
+static duk_ret_t test_3(duk_context *ctx) {
+	void *p;
+
+	duk_set_top(ctx, 0);
+
+	duk_push_external_buffer(ctx, (void *) ext_data, sizeof(ext_data), release_cb, (void *) 0xdeadbeef);
+	p = duk_to_buffer(ctx, -1, NULL);
+	printf("to_buffer keeps external: %d\n", (p == (void *) ext_data && duk_is_external_buffer(ctx, -1)) ? 1 : 0);
+
+	duk_dup(ctx, -1);
+	p = duk_to_fixed_buffer(ctx, -1, NULL);
+	printf("to_fixed_buffer: is_external=%d, is_fixed=%d, copied=%d\n",
+	       (int) duk_is_external_buffer(ctx, -1), (int) duk_is_fixed_buffer(ctx, -1),
+	       (p != (void *) ext_data && memcmp(p, (void *) ext_data, sizeof(ext_data)) == 0) ? 1 : 0);
+	duk_pop(ctx);
+
+	p = duk_to_dynamic_buffer(ctx, -1, NULL);  /* replaces the only reference */
+	duk_gc(ctx, 0);
+	printf("to_dynamic_buffer: is_external=%d, is_dynamic=%d, copied=%d\n",
+	       (int) duk_is_external_buffer(ctx, -1), (int) duk_is_dynamic_buffer(ctx, -1),
+	       (p != (void *) ext_data && memcmp(p, (void *) ext_data, sizeof(ext_data)) == 0) ? 1 : 0);
+
+	printf("final top: %ld\n", (long) duk_get_top(ctx));
+	return 0;
+}
+
+/* NULL pointer is only allowed with zero size */
+static duk_ret_t test_4(duk_context *ctx) {
+	void *p;
+	duk_size_t sz;
+
+	duk_set_top(ctx, 0);
+
+	duk_push_external_buffer(ctx, NULL, 0, NULL, NULL);
+	p = duk_get_buffer(ctx, -1, &sz);
+	printf("zero size: is_external=%d, size=%ld, ptr=%s\n",
+	       (int) duk_is_external_buffer(ctx, -1), (long) sz, (p == NULL ? "NULL" : "non-NULL"));
+
+	printf("null pointer with nonzero size\n");
+	duk_push_external_buffer(ctx, NULL, 1, NULL, NULL);
+
+	printf("final top: %ld\n", (long) duk_get_top(ctx));
+	return 0;
+}
+
+/* release callback is called when the heap is destroyed */
+static duk_ret_t test_5(duk_context *ctx) {
+	duk_context *new_ctx;
+
+	release_count = 0;
+	new_ctx = duk_create_heap_default();
+	duk_push_external_buffer(new_ctx, (void *) ext_data, sizeof(ext_data), release_cb, (void *) 0xdeadbeef);
+	duk_put_global_string(new_ctx, "extbuf");
+	printf("release on heap destroy: %d\n", release_count);
+	duk_destroy_heap(new_ctx);
+	printf("release on heap destroy: %d\n", release_count);
+
+	DUK_UNREF(ctx);
+	return 0;
+}
+
+void test(duk_context *ctx) {
+	TEST_SAFE_CALL(test_1);
+	TEST_SAFE_CALL(test_2);
+	TEST_SAFE_CALL(test_3);
+	TEST_SAFE_CALL(test_4);
+	TEST_SAFE_CALL(test_5);
+}
@@ -0,0 +1,120 @@
+/*===
+*** test_1 (duk_safe_call)
+string: 'external string data', length: 20
+script sees: EXTERNAL STRING DATA
+equal to literal: true
+release count after gc: 1
+final top: 0
+==> rc=0, result='undefined'
+*** test_2 (duk_safe_call)
+already interned: 'foo', release count: 1
+final top: 1
+==> rc=0, result='undefined'
+*** test_3 (duk_safe_call)
+missing NUL terminator
+==> rc=1, result='Error: invalid call args'
+*** test_4 (duk_safe_call)
+property lookup: 123
+release count after heap destroy: 1
+==> rc=0, result='undefined'
+===*/
+
+static int release_count = 0;
+
+static void release_cb(void *udata, void *ptr) {
+	DUK_UNREF(udata);
+	release_count++;
+	free(ptr);
+}
+
+static char *make_ext_string(const char *str) {
+	size_t len = strlen(str);
+	char *res = (char *) malloc(len + 1);
+	memcpy((void *) res, (const void *) str, len + 1);
+	return res;
+}
+
+/* A new string.  Whether the data is referenced or copied depends on
+ * DUK_OPT_EXTERNAL_STRINGS, so only check the end result.
+ */
+static duk_ret_t test_1(duk_context *ctx) {
+	char *p;
+
+	duk_set_top(ctx, 0);
+	release_count = 0;
+
+	p = make_ext_string("external string data");
+	duk_push_external_lstring(ctx, p, strlen(p), release_cb, NULL);
+	printf("string: '%s', length: %ld\n", duk_get_string(ctx, -1), (long) duk_get_length(ctx, -1));
+
+	duk_eval_string(ctx, "(function (s) { print('script sees:', s.toUpperCase()); "
+	                     "print('equal to literal:', s === 'external string data'); })");
+	duk_dup(ctx, 0);
+	duk_call(ctx, 1);
+	duk_pop(ctx);
+
+	duk_pop(ctx);
+	duk_gc(ctx, 0);
+	printf("release count after gc: %d\n", release_count);
+
+	printf("final top: %ld\n", (long) duk_get_top(ctx));
+	return 0;
+}
+
+/* An equal string exists already, the data is released right away. */
+static duk_ret_t test_2(duk_context *ctx) {
+	char *p;
+
+	duk_set_top(ctx, 0);
+	release_count = 0;
+
+	duk_push_string(ctx, "foo");
+	p = make_ext_string("foo");
+	duk_push_external_lstring(ctx, p, 3, release_cb, NULL);
+	printf("already interned: '%s', release count: %d\n", duk_get_string(ctx, -1), release_count);
+	duk_pop(ctx);
+
+	printf("final top: %ld\n", (long) duk_get_top(ctx));
+	return 0;
+}
+
+/* str[len] must be a NUL */
+static duk_ret_t test_3(duk_context *ctx) {
+	duk_set_top(ctx, 0);
+
+	printf("missing NUL terminator\n");
+	duk_push_external_lstring(ctx, "foobar", 3, NULL, NULL);
+
+	printf("final top: %ld\n", (long) duk_get_top(ctx));
+	return 0;
+}
+
+/* Use as a property key, release on heap destruction at the latest. */
+static duk_ret_t test_4(duk_context *ctx) {
+	duk_context *new_ctx;
+	char *p;
+
+	release_count = 0;
+	new_ctx = duk_create_heap_default();
+	duk_eval_string_noresult(new_ctx, "var obj = {};");
+
+	duk_eval_string(new_ctx, "(function (k) { obj[k] = 123; return obj[Object.keys(obj)[0]]; })");
+	p = make_ext_string("dynamicKey");
+	duk_push_external_lstring(new_ctx, p, strlen(p), release_cb, NULL);
+	duk_call(new_ctx, 1);
+	printf("property lookup: %d\n", (int) duk_get_int(new_ctx, -1));
+	duk_pop(new_ctx);
+
+	duk_destroy_heap(new_ctx);
+	printf("release count after heap destroy: %d\n", release_count);
+
+	DUK_UNREF(ctx);
+	return 0;
+}
+
+void test(duk_context *ctx) {
+	TEST_SAFE_CALL(test_1);
+	TEST_SAFE_CALL(test_2);
+	TEST_SAFE_CALL(test_3);
+	TEST_SAFE_CALL(test_4);
+}
@@ -0,0 +1,135 @@
+/*
+ *  duk_set_gc_hook()
+ */
+
+/*===
+*** test_1 (duk_safe_call)
+events: start end
+reason: explicit
+count matches: 1
+flags: 0
+objects freed: 1
+strings freed: 1
+bytes freed: 1
+kept: 1
+times: 1
+string table size: 1
+events: start end
+reason: explicit
+flags: 1
+events after removing hook: 0
+final top: 0
+==> rc=0, result='undefined'
+*** test_2 (duk_safe_call)
+destroy reasons seen: 1
+==> rc=0, result='undefined'
+===*/
+
+static int event_count;
+static int start_count;
+static int end_count;
+static int destroy_count;
+static duk_gc_event last_start;
+static duk_gc_event last_end;
+
+static void my_hook(void *udata, const duk_gc_event *ev) {
+	if (udata != (void *) &event_count) {
+		printf("wrong udata\n");
+	}
+	event_count++;
+	if (ev->event == DUK_GC_EVENT_START) {
+		start_count++;
+		last_start = *ev;
+	} else if (ev->event == DUK_GC_EVENT_END) {
+		end_count++;
+		last_end = *ev;
+	}
+	if (ev->reason == DUK_GC_REASON_HEAP_DESTROY) {
+		destroy_count++;
+	}
+}
+
+static void reset(void) {
+	event_count = 0;
+	start_count = 0;
+	end_count = 0;
+	destroy_count = 0;
+	memset((void *) &last_start, 0, sizeof(last_start));
+	memset((void *) &last_end, 0, sizeof(last_end));
+}
+
+static void print_events(void) {
+	printf("events:%s%s\n",
+	       (start_count >= 1 && last_start.event == DUK_GC_EVENT_START) ? " start" : "",
+	       (end_count == start_count && last_end.event == DUK_GC_EVENT_END) ? " end" : "");
+	printf("reason: %s\n", last_end.reason == DUK_GC_REASON_EXPLICIT ? "explicit" : "other");
+}
+
+static duk_ret_t test_1(duk_context *ctx) {
+	duk_heap_stats st;
+	duk_double_t sum;
+
+	/* Unreachable cycles are only freed by mark-and-sweep. */
+	duk_gc(ctx, 0);
+	duk_eval_string_noresult(ctx,
+		"(function () {\n"
+		"    for (var i = 0; i < 1000; i++) {\n"
+		"        var o = { name: 'gc-hook-test-' + i }; o.self = o;\n"
+		"    }\n"
+		"})();\n");
+
+	reset();
+	duk_set_gc_hook(ctx, my_hook, (void *) &event_count);
+	duk_gc(ctx, 0);
+	duk_get_heap_stats(ctx, &st);
+
+	print_events();
+	printf("count matches: %d\n", (int) (last_start.count == last_end.count && last_end.count == st.ms_count));
+	printf("flags: %ld\n", (long) last_end.flags);
+	printf("objects freed: %d\n", (int) (last_end.objects_freed >= 1000));
+	printf("strings freed: %d\n", (int) (last_end.strings_freed >= 1000));
+	printf("bytes freed: %d\n", (int) (last_end.bytes_freed > 1000 * 32));
+	printf("kept: %d\n", (int) (last_end.objects_kept > 0 && last_end.strings_kept > 0));
+	sum = last_end.time_mark + last_end.time_mark_finalizable + last_end.time_sweep +
+	      last_end.time_sweep_strings + last_end.time_compaction +
+	      last_end.time_stringtable_resize + last_end.time_finalizers;
+	printf("times: %d\n", (int) (last_end.time_total >= 0.0 && sum <= last_end.time_total + 0.001 &&
+	                             sum >= last_end.time_total - 0.001));
+	printf("string table size: %d\n", (int) (last_end.stringtable_size == st.strtab_size));
+
+	/* Emergency flag is reported. */
+	reset();
+	duk_eval_string_noresult(ctx, "Duktape.gc(1);");
+	print_events();
+	printf("flags: %ld\n", (long) (last_end.flags & DUK_GC_FLAG_EMERGENCY));
+
+	reset();
+	duk_set_gc_hook(ctx, NULL, NULL);
+	duk_gc(ctx, 0);
+	printf("events after removing hook: %d\n", event_count);
+
+	printf("final top: %ld\n", (long) duk_get_top(ctx));
+	return 0;
+}
+
+static duk_ret_t test_2(duk_context *ctx) {
+	duk_context *new_ctx;
+
+	new_ctx = duk_create_heap_default();
+	if (!new_ctx) {
+		printf("heap creation failed\n");
+		return 0;
+	}
+	reset();
+	duk_set_gc_hook(new_ctx, my_hook, (void *) &event_count);
+	duk_destroy_heap(new_ctx);
+	printf("destroy reasons seen: %d\n", (int) (destroy_count > 0 && start_count == end_count));
+
+	(void) ctx;
+	return 0;
+}
+
+void test(duk_context *ctx) {
+	TEST_SAFE_CALL(test_1);
+	TEST_SAFE_CALL(test_2);
+}
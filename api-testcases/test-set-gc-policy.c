@@ -0,0 +1,335 @@
+/*
+ *  duk_get_gc_policy(), duk_set_gc_policy(), duk_gc_idle()
+ */
+
+/*===
+*** test_1 (duk_safe_call)
+defaults: 1 1 0 0 0.5 0
+clamped: 0 1
+reset: 1 0
+==> rc=0, result='undefined'
+*** test_2 (duk_safe_call)
+voluntary rounds without byte trigger: 0
+voluntary rounds with byte trigger: 1
+==> rc=0, result='undefined'
+*** test_3 (duk_safe_call)
+voluntary rounds with minimum interval: 0
+voluntary rounds without minimum interval: 1
+==> rc=0, result='undefined'
+*** test_4 (duk_safe_call)
+idle right after gc: 0
+idle with zero threshold: 1
+reason: idle
+==> rc=0, result='undefined'
+*** test_5 (duk_safe_call)
+no compaction: 1
+no stringtable resize: 1
+explicit flags kept: 0
+final top: 0
+==> rc=0, result='undefined'
+*** test_6 (duk_safe_call)
+objects freed by round: 1
+freed during round: 0
+freed by later allocations: 1
+freed when idle: 1
+budgeted compaction: 1
+==> rc=0, result='undefined'
+*** test_7 (duk_safe_call)
+freed by assignment: 1
+freed by later calls: 1
+freed when idle: 1
+all freed: 1
+==> rc=0, result='undefined'
+===*/
+
+static int voluntary_count;
+static int idle_count;
+static duk_gc_event last_end;
+
+static void my_hook(void *udata, const duk_gc_event *ev) {
+	(void) udata;
+	if (ev->event != DUK_GC_EVENT_END) {
+		return;
+	}
+	if (ev->reason == DUK_GC_REASON_VOLUNTARY) {
+		voluntary_count++;
+	} else if (ev->reason == DUK_GC_REASON_IDLE) {
+		idle_count++;
+	}
+	last_end = *ev;
+}
+
+static void make_garbage(duk_context *ctx) {
+	int i;
+
+	for (i = 0; i < 100; i++) {
+		(void) duk_push_fixed_buffer(ctx, 100000);
+		duk_pop(ctx);
+	}
+}
+
+static duk_ret_t test_1(duk_context *ctx) {
+	duk_gc_policy pol;
+
+	duk_get_gc_policy(ctx, &pol);
+	printf("defaults: %d %d %ld %g %g %ld\n",
+	       (int) (pol.trigger_mult > 0), (int) (pol.trigger_add > 0),
+	       (long) pol.trigger_bytes, (double) pol.min_interval,
+	       (double) pol.idle_threshold, (long) pol.flags);
+
+	pol.min_interval = -1.0;
+	pol.idle_threshold = 2.0;
+	duk_set_gc_policy(ctx, &pol);
+	duk_get_gc_policy(ctx, &pol);
+	printf("clamped: %g %g\n", (double) pol.min_interval, (double) pol.idle_threshold);
+
+	pol.flags = DUK_GC_POLICY_ALWAYS_COMPACT;
+	duk_set_gc_policy(ctx, &pol);
+	duk_set_gc_policy(ctx, NULL);
+	duk_get_gc_policy(ctx, &pol);
+	printf("reset: %d %ld\n", (int) (pol.trigger_mult > 0), (long) pol.flags);
+	return 0;
+}
+
+static duk_ret_t test_2(duk_context *ctx) {
+	duk_gc_policy pol;
+
+	duk_set_gc_hook(ctx, my_hook, NULL);
+
+	/* A hundred allocations don't use up the default trigger. */
+	duk_gc(ctx, 0);
+	voluntary_count = 0;
+	make_garbage(ctx);
+	printf("voluntary rounds without byte trigger: %d\n", voluntary_count);
+
+	/* 10MB allocated with a 1MB byte trigger. */
+	duk_get_gc_policy(ctx, &pol);
+	pol.trigger_bytes = 1024 * 1024;
+	duk_set_gc_policy(ctx, &pol);
+	voluntary_count = 0;
+	make_garbage(ctx);
+	printf("voluntary rounds with byte trigger: %d\n", (int) (voluntary_count >= 5));
+
+	duk_set_gc_policy(ctx, NULL);
+	duk_set_gc_hook(ctx, NULL, NULL);
+	return 0;
+}
+
+static duk_ret_t test_3(duk_context *ctx) {
+	duk_gc_policy pol;
+
+	duk_set_gc_hook(ctx, my_hook, NULL);
+
+	/* A very small trigger, but rounds are at least a day apart.  The
+	 * trigger counter is recomputed by the explicit round.
+	 */
+	duk_get_gc_policy(ctx, &pol);
+	pol.trigger_mult = 0;
+	pol.trigger_add = 10;
+	pol.min_interval = 24.0 * 3600.0 * 1000.0;
+	duk_set_gc_policy(ctx, &pol);
+	duk_gc(ctx, 0);
+	voluntary_count = 0;
+	make_garbage(ctx);
+	printf("voluntary rounds with minimum interval: %d\n", voluntary_count);
+
+	pol.min_interval = 0.0;
+	duk_set_gc_policy(ctx, &pol);
+	voluntary_count = 0;
+	make_garbage(ctx);
+	printf("voluntary rounds without minimum interval: %d\n", (int) (voluntary_count >= 5));
+
+	duk_set_gc_policy(ctx, NULL);
+	duk_set_gc_hook(ctx, NULL, NULL);
+	return 0;
+}
+
+static duk_ret_t test_4(duk_context *ctx) {
+	duk_gc_policy pol;
+	duk_bool_t rc;
+
+	duk_set_gc_hook(ctx, my_hook, NULL);
+
+	duk_gc(ctx, 0);
+	idle_count = 0;
+	rc = duk_gc_idle(ctx);
+	printf("idle right after gc: %d\n", (int) rc + idle_count);
+
+	duk_get_gc_policy(ctx, &pol);
+	pol.idle_threshold = 0.0;
+	duk_set_gc_policy(ctx, &pol);
+	rc = duk_gc_idle(ctx);
+	printf("idle with zero threshold: %d\n", (int) (rc && idle_count == 1));
+	printf("reason: %s\n", last_end.reason == DUK_GC_REASON_IDLE ? "idle" : "other");
+
+	duk_set_gc_policy(ctx, NULL);
+	duk_set_gc_hook(ctx, NULL, NULL);
+	return 0;
+}
+
+static duk_ret_t test_5(duk_context *ctx) {
+	duk_gc_policy pol;
+
+	duk_set_gc_hook(ctx, my_hook, NULL);
+
+	/* Policy flags show up in the flags of every round. */
+	duk_get_gc_policy(ctx, &pol);
+	pol.flags = DUK_GC_POLICY_NO_OBJECT_COMPACTION | DUK_GC_POLICY_NO_STRINGTABLE_RESIZE;
+	duk_set_gc_policy(ctx, &pol);
+	duk_gc(ctx, 0);
+	printf("no compaction: %d\n", (int) ((last_end.flags & DUK_GC_FLAG_NO_OBJECT_COMPACTION) != 0));
+	printf("no stringtable resize: %d\n", (int) ((last_end.flags & DUK_GC_FLAG_NO_STRINGTABLE_RESIZE) != 0 &&
+	                                             last_end.stringtable_resized == 0));
+
+	duk_set_gc_policy(ctx, NULL);
+	duk_gc(ctx, 0);
+	printf("explicit flags kept: %ld\n", (long) last_end.flags);
+
+	duk_set_gc_hook(ctx, NULL, NULL);
+	printf("final top: %ld\n", (long) duk_get_top(ctx));
+	return 0;
+}
+
+/* Live objects and unreachable objects waiting to be freed incrementally.
+ * Counted by Duktape, so independent of the allocator (with the slab
+ * allocator most frees never reach the user free function).
+ */
+static long object_count(duk_context *ctx) {
+	duk_heap_stats st;
+	duk_get_heap_stats(ctx, &st);
+	return (long) st.object_count;
+}
+
+static long sweep_free_count(duk_context *ctx) {
+	duk_heap_stats st;
+	duk_get_heap_stats(ctx, &st);
+	return (long) st.sweep_free_list_count;
+}
+
+static duk_ret_t test_6(duk_context *ctx) {
+	duk_context *new_ctx;
+	duk_gc_policy pol;
+	long before;
+	int i;
+
+	new_ctx = duk_create_heap_default();
+	if (!new_ctx) {
+		printf("heap creation failed\n");
+		return 0;
+	}
+	duk_set_gc_hook(new_ctx, my_hook, NULL);
+
+	duk_get_gc_policy(new_ctx, &pol);
+	pol.sweep_step = 4;
+	duk_set_gc_policy(new_ctx, &pol);
+
+	/* Unreachable cycles are only freed by mark-and-sweep. */
+	duk_gc(new_ctx, 0);
+	duk_eval_string_noresult(new_ctx,
+		"(function () {\n"
+		"    for (var i = 0; i < 1000; i++) {\n"
+		"        var o = { name: 'sweep-step-' + i }; o.self = o;\n"
+		"    }\n"
+		"})();\n");
+
+	/* The round only unlinks the objects; strings are freed as usual. */
+	duk_gc(new_ctx, 0);
+	printf("objects freed by round: %d\n", (int) (last_end.objects_freed >= 1000));
+	printf("freed during round: %d\n", (int) (sweep_free_count(new_ctx) < 1000));
+
+	/* Each allocation frees a few of them. */
+	before = sweep_free_count(new_ctx);
+	for (i = 0; i < 100; i++) {
+		duk_push_object(new_ctx);
+		duk_pop(new_ctx);
+	}
+	printf("freed by later allocations: %d\n", (int) (before - sweep_free_count(new_ctx) >= 100 * 4));
+
+	(void) duk_gc_idle(new_ctx);
+	printf("freed when idle: %d\n", (int) (sweep_free_count(new_ctx) == 0));
+
+	/* Compaction in small steps across rounds. */
+	pol.flags = DUK_GC_POLICY_ALWAYS_COMPACT;
+	pol.compact_step = 10;
+	duk_set_gc_policy(new_ctx, &pol);
+	for (i = 0; i < 200; i++) {
+		duk_gc(new_ctx, 0);
+	}
+	duk_eval_string(new_ctx, "var o = { a: 1, b: 2 }; delete o.a; o.b");
+	printf("budgeted compaction: %ld\n", (long) (duk_get_int(new_ctx, -1) == 2));
+
+	duk_destroy_heap(new_ctx);
+
+	(void) ctx;
+	return 0;
+}
+
+static duk_ret_t dummy_func(duk_context *ctx) {
+	(void) ctx;
+	return 0;
+}
+
+static duk_ret_t test_7(duk_context *ctx) {
+	duk_context *new_ctx;
+	duk_gc_policy pol;
+	long before, freed_assign, freed_calls, freed_idle;
+	int i;
+
+	new_ctx = duk_create_heap_default();
+	if (!new_ctx) {
+		printf("heap creation failed\n");
+		return 0;
+	}
+
+	duk_get_gc_policy(new_ctx, &pol);
+	pol.refzero_step = 10;
+	duk_set_gc_policy(new_ctx, &pol);
+
+	/* 2047 objects freed by reference counting when the tree is dropped. */
+	duk_eval_string_noresult(new_ctx,
+		"function mk(d) { return d == 0 ? {} : { l: mk(d - 1), r: mk(d - 1) }; }\n"
+		"var holder = { tree: mk(10) };\n");
+	duk_push_global_object(new_ctx);
+	duk_get_prop_string(new_ctx, -1, "holder");
+
+	/* Only the first batch is freed by the assignment itself. */
+	before = object_count(new_ctx);
+	duk_push_null(new_ctx);
+	duk_put_prop_string(new_ctx, -2, "tree");
+	freed_assign = before - object_count(new_ctx);
+	printf("freed by assignment: %d\n", (int) (freed_assign > 0 && freed_assign < 100));
+
+	/* Calls are safe points which free a batch each. */
+	duk_push_c_function(new_ctx, dummy_func, 0);
+	before = object_count(new_ctx);
+	for (i = 0; i < 10; i++) {
+		duk_dup_top(new_ctx);
+		duk_call(new_ctx, 0);
+		duk_pop(new_ctx);
+	}
+	freed_calls = before - object_count(new_ctx);
+	printf("freed by later calls: %d\n", (int) (freed_calls >= 10 * 10 && freed_calls < 1000));
+
+	before = object_count(new_ctx);
+	(void) duk_gc_idle(new_ctx);
+	freed_idle = before - object_count(new_ctx);
+	printf("freed when idle: %d\n", (int) (freed_idle >= 1000));
+
+	printf("all freed: %d\n", (int) (freed_assign + freed_calls + freed_idle >= 2047));
+
+	duk_pop_3(new_ctx);
+	duk_destroy_heap(new_ctx);
+
+	(void) ctx;
+	return 0;
+}
+
+void test(duk_context *ctx) {
+	TEST_SAFE_CALL(test_1);
+	TEST_SAFE_CALL(test_2);
+	TEST_SAFE_CALL(test_3);
+	TEST_SAFE_CALL(test_4);
+	TEST_SAFE_CALL(test_5);
+	TEST_SAFE_CALL(test_6);
+	TEST_SAFE_CALL(test_7);
+}
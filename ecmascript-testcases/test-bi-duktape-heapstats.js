@@ -0,0 +1,117 @@
+/*
+ *  Duktape.heapStats()
+ *
+ *  Absolute numbers depend on the build and platform, so only check the
+ *  structure and relationships between the values.
+ */
+
+/*===
+structure
+strings number number
+objects number number object
+functions number number number number number
+buffers number number
+threads number number
+stringTable number number number number number
+lists number number number number
+gc number number number number number
+totalBytes number
+growth
+objects grow: true
+Array count grows: true
+strings grow: true
+buffers grow: true
+function data shared: true
+bytecode counted: true
+gc
+gc count grows: true
+gc times: true
+invariants
+total is sum: true
+load in range: true
+===*/
+
+function keys(o) {
+    return Object.keys(o).map(function (k) { return typeof o[k]; }).join(' ');
+}
+
+var st;
+
+print('structure');
+try {
+    st = Duktape.heapStats();
+    print('strings', keys(st.strings));
+    print('objects', keys(st.objects));
+    print('functions', keys(st.functions));
+    print('buffers', keys(st.buffers));
+    print('threads', keys(st.threads));
+    print('stringTable', keys(st.stringTable));
+    print('lists', keys(st.lists));
+    print('gc', keys(st.gc));
+    print('totalBytes', typeof st.totalBytes);
+} catch (e) {
+    print(e);
+}
+
+var keep = [];
+
+print('growth');
+try {
+    // Collect garbage first so that it doesn't disappear in between.
+    Duktape.gc();
+    var before = Duktape.heapStats();
+    var i;
+    var makeAdder = function (n) { return function (x) { return x + n; }; };
+
+    for (i = 0; i < 1000; i++) {
+        keep.push([ i, 'heapstats-string-' + i ]);
+    }
+    for (i = 0; i < 100; i++) {
+        keep.push(Duktape.Buffer(1000));
+        keep.push(makeAdder(i));
+    }
+
+    var after = Duktape.heapStats();
+    print('objects grow:', after.objects.count >= before.objects.count + 1000 &&
+                          after.objects.bytes > before.objects.bytes);
+    print('Array count grows:', after.objects.classes.Array.count >= before.objects.classes.Array.count + 1000);
+    print('strings grow:', after.strings.count >= before.strings.count + 1000);
+    print('buffers grow:', after.buffers.bytes >= before.buffers.bytes + 100 * 1000);
+
+    // 100 closures share the function data of a single template.
+    print('function data shared:', after.functions.count >= before.functions.count + 100 &&
+                                   after.functions.dataCount < before.functions.dataCount + 10);
+    print('bytecode counted:', after.functions.bytecodeBytes > 0 &&
+                               after.functions.dataBytes >= after.functions.bytecodeBytes);
+} catch (e) {
+    print(e);
+}
+
+print('gc');
+try {
+    var before = Duktape.heapStats();
+    Duktape.gc();
+    var after = Duktape.heapStats();
+    // Count is zero if mark-and-sweep is disabled.
+    print('gc count grows:', after.gc.count > before.gc.count || after.gc.count === 0);
+    print('gc times:', after.gc.timeTotal >= after.gc.timeMax && after.gc.timeMax >= after.gc.timeLast &&
+                       after.gc.timeLast >= 0);
+} catch (e) {
+    print(e);
+}
+
+print('invariants');
+try {
+    st = Duktape.heapStats();
+    var sum = 0;
+    Object.keys(st.objects.classes).forEach(function (k) {
+        sum += st.objects.classes[k].bytes;
+    });
+    print('total is sum:', sum === st.objects.bytes &&
+                           st.totalBytes > st.strings.bytes + st.objects.bytes + st.buffers.bytes +
+                                           st.threads.stackBytes + st.stringTable.bytes);
+    print('load in range:', st.stringTable.load > 0 && st.stringTable.load <= 1 &&
+                            st.stringTable.used === st.strings.count);
+} catch (e) {
+    print(e);
+}
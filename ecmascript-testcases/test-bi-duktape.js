@@ -19,6 +19,7 @@ Duktape.Buffer function wc
 Duktape.Pointer function wc
 Duktape.Thread function wc
 Duktape.Logger function wc
+Duktape.WeakRef function wc
 Duktape.info function wc
 Duktape.act function wc
 Duktape.gc function wc
@@ -26,6 +27,7 @@ Duktape.fin function wc
 Duktape.enc function wc
 Duktape.dec function wc
 Duktape.compact function wc
+Duktape.heapStats function wc
 Duktape.env string wc
 Duktape.modLoaded object wc
 Duktape.Buffer.name string none
@@ -93,6 +95,13 @@ Duktape.Logger.prototype.error.name string none
 Duktape.Logger.prototype.fatal.length number none
 Duktape.Logger.prototype.fatal.name string none
 Duktape.Logger.clog.n string wec
+Duktape.WeakRef.name string none
+Duktape.WeakRef.length number none
+Duktape.WeakRef.prototype object none
+Duktape.WeakRef.prototype.constructor function wc
+Duktape.WeakRef.prototype.deref function wc
+Duktape.WeakRef.prototype.deref.length number none
+Duktape.WeakRef.prototype.deref.name string none
 Duktape.info.length number none
 Duktape.info.name string none
 Duktape.act.length number none
@@ -107,6 +116,8 @@ Duktape.dec.length number none
 Duktape.dec.name string none
 Duktape.compact.length number none
 Duktape.compact.name string none
+Duktape.heapStats.length number none
+Duktape.heapStats.name string none
 ===*/
 
 function propsTest() {
@@ -2813,3 +2813,37 @@ try {
 } catch (e) {
     print(e);
 }
+
+/*===
+leading digit
+string 9.99999999999999916114e+22
+string 1.0e+23
+string 9.8813129168249308835e-324
+string 9.88e-324
+string 4.9406564584124654418e-324
+string 9.9999999999999694493e-311
+string -9.8813129168249308835e-323
+string 9.88131e-324
+===*/
+
+/* The first digit is never zero, also for values less than half an ULP
+ * below a power of ten and for denormals.
+ */
+
+function leadingDigitTest() {
+    test(1e23, [ 21 ]);
+    test(1e23, [ 2 ]);
+    test(1e-323, [ 20 ]);
+    test(1e-323, [ 3 ]);
+    test(5e-324, [ 20 ]);
+    test(1e-310, [ 20 ]);
+    test(-1e-322, [ 20 ]);
+    print(typeof (1e-323).toExponential(5), (1e-323).toExponential(5));
+}
+
+try {
+    print('leading digit');
+    leadingDigitTest();
+} catch (e) {
+    print(e);
+}
@@ -0,0 +1,86 @@
+/*
+ *  Duktape specific typed array behavior.
+ */
+
+/*---
+{
+    "custom": true
+}
+---*/
+
+/*===
+shared buffer
+8 4 66 65
+11adbeef
+4 11adbeef
+virtual props
+0,1,length,byteLength,byteOffset,buffer
+byteLength
+byteLength,byteOffset,buffer
+{"value":2,"writable":false,"enumerable":false,"configurable":false}
+{"value":0,"writable":true,"enumerable":true,"configurable":false}
+true true
+2 false false
+TypeError
+TypeError
+===*/
+
+function sharedBufferTest() {
+    var db = Duktape.Buffer(8, true);
+    var plain = Duktape.dec('hex', 'deadbeef');
+    var ab, v;
+
+    /* an ArrayBuffer wraps a plain buffer or Duktape.Buffer without a copy */
+    ab = new ArrayBuffer(db);
+    v = new Uint16Array(ab);
+    v[0] = 0x4142;
+    print(ab.byteLength, v.length, db[0], db[1]);
+
+    ab = new ArrayBuffer(plain);
+    new Uint8Array(ab)[0] = 0x11;
+    print(Duktape.enc('hex', plain));
+
+    /* a plain buffer given to a typed array constructor is copied */
+    v = new Uint8Array(plain);
+    v[1] = 0;
+    print(v.length, Duktape.enc('hex', plain));
+}
+
+function virtualPropsTest() {
+    var u8 = new Uint8Array(2);
+    var ab = u8.buffer;
+
+    /* 'buffer', 'byteLength', 'byteOffset', and 'length' are virtual own
+     * properties rather than inherited accessors.
+     */
+    print(Object.getOwnPropertyNames(u8).join(','));
+    print(Object.getOwnPropertyNames(ab).join(','));
+    print(Object.getOwnPropertyNames(new DataView(ab)).join(','));
+    print(JSON.stringify(Object.getOwnPropertyDescriptor(u8, 'length')));
+    print(JSON.stringify(Object.getOwnPropertyDescriptor(u8, 0)));
+
+    /* 'buffer' is created on demand and then stays the same */
+    print(u8.buffer === ab, u8.subarray(1).buffer === ab);
+
+    u8.length = 10;
+    print(u8.length, delete u8.length, delete u8[0]);
+    try {
+        (function () { 'use strict'; u8.byteLength = 1; })();
+    } catch (e) {
+        print(e.name);
+    }
+    try {
+        Object.defineProperty(u8, '0', { value: 1 });
+    } catch (e) {
+        print(e.name);
+    }
+}
+
+try {
+    print('shared buffer');
+    sharedBufferTest();
+    print('virtual props');
+    virtualPropsTest();
+} catch (e) {
+    print(e);
+}
@@ -0,0 +1,261 @@
+/*
+ *  ArrayBuffer, typed array views, and DataView (ES6).
+ */
+
+/*===
+ArrayBuffer
+16 [object ArrayBuffer] false
+0
+8 true
+2 0
+RangeError
+TypeError
+views
+16 2 4 8 true
+true false
+239 190 173 222 255 255
+99 4 2 true
+1 8 4294967295
+undefined 16 false
+RangeError
+RangeError
+TypeError
+conversion
+4 1.5 -2 NaN 1e+300 undefined
+1.5 -2 NaN Infinity
+0,0,2,2,254,255,0
+127,-128,-1,127
+65535,0,1,12,1
+77,12,1
+set
+1 2 3
+RangeError
+250,251,252,0
+1,2,3,3,4,5,6,8
+1,1,3,3,4,5,6,8
+DataView
+8 8 true true
+18 52 13330
+3.141592653589793 3.141592653589793
+bfb99999 9999999a
+63 192 1.5
+-2 4294967294 -2 -2
+RangeError
+RangeError
+misc
+2 8 3 Uint8Array
+true function function
+0,1,2
+3
+{"0":1,"1":2}
+2,4,6
+[object Uint8ClampedArray] [object DataView]
+===*/
+
+function arrayBufferTest() {
+    var ab = new ArrayBuffer(16);
+    var sl;
+
+    print(ab.byteLength, Object.prototype.toString.call(ab), ArrayBuffer.isView(ab));
+    print(new Uint8Array(ab)[15]);
+    sl = ab.slice(4, -4);
+    print(sl.byteLength, sl !== ab);
+    print(ab.slice(-2).byteLength, ab.slice(10, 2).byteLength);
+
+    try {
+        new ArrayBuffer(-1);
+    } catch (e) {
+        print(e.name);
+    }
+    try {
+        ArrayBuffer(1);
+    } catch (e) {
+        print(e.name);
+    }
+}
+
+function viewTest() {
+    var ab = new ArrayBuffer(16);
+    var u8 = new Uint8Array(ab);
+    var u32 = new Uint32Array(ab, 4, 2);
+    var s;
+
+    print(u8.length, u32.length, u32.byteOffset, u32.byteLength, u32.buffer === ab);
+    print(ArrayBuffer.isView(u8), ArrayBuffer.isView({}));
+    u32[0] = 0xdeadbeef;
+    u32[1] = -1;
+    print(u8[4], u8[5], u8[6], u8[7], u8[8], u8[11]);
+
+    /* views share data, no copies */
+    s = u8.subarray(2, 6);
+    s[0] = 99;
+    print(u8[2], s.length, s.byteOffset, s.buffer === ab);
+    s = u32.subarray(-1);
+    print(s.length, s.byteOffset, s[0]);
+
+    /* out of range writes are ignored */
+    u8[100] = 5;
+    print(u8[100], u8.length, '100' in u8);
+
+    try {
+        new Uint32Array(ab, 1);
+    } catch (e) {
+        print(e.name);
+    }
+    try {
+        new Uint32Array(ab, 4, 4);
+    } catch (e) {
+        print(e.name);
+    }
+    try {
+        Uint8Array(2);
+    } catch (e) {
+        print(e.name);
+    }
+}
+
+function conversionTest() {
+    var f = new Float64Array([1.5, -2, NaN, 1e300]);
+    var f32 = new Float32Array(f);
+    var c = new Uint8ClampedArray([-5, 0.5, 1.5, 2.5, 254.5, 300, NaN]);
+    var i8 = new Int8Array([127, 128, 255, -129]);
+    var u16 = new Uint16Array([-1, 65536, 65537.9, '12', true]);
+    var x = new Uint8Array(3);
+
+    print(f.length, f[0], f[1], f[2], f[3], f[4]);
+    print(f32[0], f32[1], f32[2], f32[3]);
+    print(Array.prototype.join.call(c, ','));
+    print(Array.prototype.join.call(i8, ','));
+    print(Array.prototype.join.call(u16, ','));
+
+    x[0] = { valueOf: function () { return 77; } };
+    x[1] = '12';
+    x[2] = true;
+    print(Array.prototype.join.call(x, ','));
+}
+
+function setTest() {
+    var u8 = new Uint8Array(16);
+    var u16 = new Uint16Array(4);
+    var t = new Uint8Array([1, 2, 3, 4, 5, 6, 7, 8]);
+
+    u8.set([1, 2, 3], 13);
+    print(u8[13], u8[14], u8[15]);
+    try {
+        u8.set([1, 2, 3, 4], 13);
+    } catch (e) {
+        print(e.name);
+    }
+
+    u16.set(new Uint8Array([250, 251, 252]));
+    print(Array.prototype.join.call(u16, ','));
+
+    /* overlapping views of the same buffer */
+    t.set(new Uint8Array(t.buffer, 2, 4), 3);
+    print(Array.prototype.join.call(t, ','));
+    t.set(new Uint16Array(t.buffer, 0, 2), 1);
+    print(Array.prototype.join.call(t, ','));
+}
+
+function dataViewTest() {
+    var ab = new ArrayBuffer(16);
+    var dv = new DataView(ab, 8);
+
+    print(dv.byteOffset, dv.byteLength, dv.buffer === ab, ArrayBuffer.isView(dv));
+    dv.setUint16(0, 0x1234);
+    print(dv.getUint8(0), dv.getUint8(1), dv.getUint16(0, true));
+    dv.setFloat64(0, Math.PI, true);
+    print(dv.getFloat64(0, true), new Float64Array(ab, 8, 1)[0]);
+    dv.setFloat64(0, -0.1);
+    print(dv.getUint32(0).toString(16), dv.getUint32(4).toString(16));
+    dv.setFloat32(0, 1.5);
+    print(dv.getUint8(0), dv.getUint8(1), dv.getFloat32(0));
+    dv.setInt32(4, -2);
+    print(dv.getInt32(4), dv.getUint32(4), dv.getInt16(6), dv.getInt8(7));
+
+    try {
+        dv.getFloat64(4);
+    } catch (e) {
+        print(e.name);
+    }
+    try {
+        dv.setInt8(-1, 0);
+    } catch (e) {
+        print(e.name);
+    }
+}
+
+function miscTest() {
+    var proto = Object.getPrototypeOf(Uint8Array.prototype);
+    var n = 0;
+    var k;
+
+    print(Uint16Array.BYTES_PER_ELEMENT, new Float64Array(1).BYTES_PER_ELEMENT, Uint8Array.length, Uint8Array.name);
+    print(proto === Object.getPrototypeOf(Float32Array.prototype), typeof proto.set, typeof proto.subarray);
+    print(Object.keys(new Int16Array(3)).join(','));
+    for (k in new Float32Array(3)) {
+        n++;
+    }
+    print(n);
+    print(JSON.stringify(new Uint8Array([1, 2])));
+    print(Array.prototype.map.call(new Uint8Array([1, 2, 3]), function (v) { return v * 2; }).join(','));
+    print(Object.prototype.toString.call(new Uint8ClampedArray(1)), Object.prototype.toString.call(new DataView(new ArrayBuffer(1))));
+}
+
+try {
+    print('ArrayBuffer');
+    arrayBufferTest();
+    print('views');
+    viewTest();
+    print('conversion');
+    conversionTest();
+    print('set');
+    setTest();
+    print('DataView');
+    dataViewTest();
+    print('misc');
+    miscTest();
+} catch (e) {
+    print(e);
+}
+
+/*===
+freeze
+TypeError
+false 5
+true true
+true true
+true false 6
+===*/
+
+/* Typed array elements can't be made non-writable. */
+
+function freezeTest() {
+    var a = new Uint8Array(2);
+    var e = new Float32Array(0);
+    var dv = new DataView(new ArrayBuffer(4));
+    var s = new Int16Array(2);
+
+    try {
+        Object.freeze(a);
+        print('never here');
+    } catch (err) {
+        print(err.name);
+    }
+    a[0] = 5;
+    print(Object.isFrozen(a), a[0]);
+
+    print(Object.freeze(e) === e, Object.isFrozen(e));
+    print(Object.freeze(dv) === dv, Object.isFrozen(dv));
+
+    Object.seal(s);
+    s[1] = 6;
+    print(Object.isSealed(s), Object.isFrozen(s), s[1]);
+}
+
+try {
+    print('freeze');
+    freezeTest();
+} catch (e) {
+    print(e);
+}
@@ -0,0 +1,253 @@
+/*
+ *  WeakMap (ES6 draft) and Duktape.WeakRef
+ *
+ *  Collection tests call Duktape.gc() so that the results don't depend
+ *  on whether reference counting is enabled.
+ */
+
+/*---
+{
+    "custom": true
+}
+---*/
+
+/*===
+basic
+function 0 object
+[object WeakMap] [object Object]
+1 1 1 2
+true one true false undefined
+uno 2 3
+true false false undefined
+TypeError
+TypeError
+undefined false false
+TypeError
+TypeError
+TypeError
+initializer
+1 2 undefined
+TypeError
+TypeError
+many
+true
+===*/
+
+function basicTest() {
+    var m = new WeakMap();
+    var k1 = {}, k2 = [], k3 = function () {};
+
+    print(typeof WeakMap, WeakMap.length, typeof WeakMap.prototype);
+    print(Object.prototype.toString.call(m), Object.prototype.toString.call(WeakMap.prototype));
+    print(m.get.length, m.has.length, m.delete.length, m.set.length);
+
+    print(m.set(k1, 'one') === m, m.get(k1), m.has(k1), m.has(k2), m.get(k2));
+    m.set(k2, 2);
+    m.set(k3, 3);
+    m.set(k1, 'uno');
+    print(m.get(k1), m.get(k2), m.get(k3));
+    print(m.delete(k2), m.delete(k2), m.has(k2), m.get(k2));
+
+    // Keys must be objects.
+    try {
+        m.set(1, 2);
+    } catch (e) {
+        print(e.name);
+    }
+    try {
+        m.set('foo', 2);
+    } catch (e) {
+        print(e.name);
+    }
+    print(m.get('x'), m.has(null), m.delete(1));
+
+    // Must be called as a constructor, 'this' must be a WeakMap.
+    try {
+        WeakMap();
+    } catch (e) {
+        print(e.name);
+    }
+    try {
+        WeakMap.prototype.get.call({}, k1);
+    } catch (e) {
+        print(e.name);
+    }
+    try {
+        WeakMap.prototype.set.call(new Duktape.WeakRef(k1), k1, 1);
+    } catch (e) {
+        print(e.name);
+    }
+}
+
+function initializerTest() {
+    var k1 = {}, k2 = {};
+    var m = new WeakMap([ [ k1, 1 ], [ k2, 2 ] ]);
+
+    print(m.get(k1), m.get(k2), m.get({}));
+
+    try {
+        new WeakMap([ 1 ]);
+    } catch (e) {
+        print(e.name);
+    }
+    try {
+        new WeakMap([ [ 'key', 1 ] ]);
+    } catch (e) {
+        print(e.name);
+    }
+}
+
+function manyTest() {
+    var m = new WeakMap();
+    var keys = [];
+    var ok = true;
+    var i;
+
+    for (i = 0; i < 1000; i++) {
+        keys.push({});
+        m.set(keys[i], i);
+    }
+    for (i = 0; i < 1000; i += 2) {
+        m.delete(keys[i]);
+    }
+    for (i = 0; i < 1000; i++) {
+        if (m.get(keys[i]) !== (i & 1 ? i : undefined)) {
+            ok = false;
+        }
+    }
+    print(ok);
+}
+
+try {
+    print('basic');
+    basicTest();
+    print('initializer');
+    initializerTest();
+    print('many');
+    manyTest();
+} catch (e) {
+    print(e);
+}
+
+/*===
+weakref
+function 1 [object WeakRef]
+true
+TypeError
+TypeError
+undefined
+undefined
+===*/
+
+function weakRefTest() {
+    var target = { name: 'target' };
+    var r = new Duktape.WeakRef(target);
+
+    print(typeof Duktape.WeakRef, Duktape.WeakRef.length, Object.prototype.toString.call(r));
+    print(r.deref() === target);
+
+    try {
+        new Duktape.WeakRef(123);
+    } catch (e) {
+        print(e.name);
+    }
+    try {
+        Duktape.WeakRef(target);
+    } catch (e) {
+        print(e.name);
+    }
+
+    // Dropping the only strong reference clears the WeakRef.
+    target = null;
+    Duktape.gc();
+    print(r.deref());
+
+    // Same for an unreachable cycle.
+    target = {};
+    target.self = target;
+    r = new Duktape.WeakRef(target);
+    target = null;
+    Duktape.gc();
+    print(r.deref());
+}
+
+try {
+    print('weakref');
+    weakRefTest();
+} catch (e) {
+    print(e);
+}
+
+/*===
+collection
+key dropped: undefined undefined
+value kept: 1 1
+ephemeron cycle: undefined undefined
+map dropped: undefined
+finalizable key: true
+after finalizer: undefined
+===*/
+
+function collectionTest() {
+    var m = new WeakMap();
+    var key, val, rk, rv, rm, ra, rb;
+
+    // Entry goes away with its key, and the value with it.
+    key = {};
+    val = { value: 1 };
+    m.set(key, val);
+    rk = new Duktape.WeakRef(key);
+    rv = new Duktape.WeakRef(val);
+    key = null;
+    val = null;
+    Duktape.gc();
+    print('key dropped:', rk.deref(), rv.deref());
+
+    // A reachable key keeps its value alive.
+    key = {};
+    m.set(key, { x: 1 });
+    rv = new Duktape.WeakRef(m.get(key));
+    Duktape.gc();
+    print('value kept:', rv.deref().x, m.get(key).x);
+
+    // Values referring to each other's keys don't keep the keys alive.
+    (function () {
+        var a = {}, b = {};
+        m.set(a, b);
+        m.set(b, a);
+        ra = new Duktape.WeakRef(a);
+        rb = new Duktape.WeakRef(b);
+    })();
+    Duktape.gc();
+    print('ephemeron cycle:', ra.deref(), rb.deref());
+
+    // A dropped map releases its values.
+    val = {};
+    m.set(key, val);
+    rm = new Duktape.WeakRef(val);
+    val = null;
+    m = null;
+    Duktape.gc();
+    print('map dropped:', rm.deref());
+
+    // A key with a finalizer stays in the map until it has been finalized
+    // and collected.
+    m = new WeakMap();
+    key = {};
+    Duktape.fin(key, function (o) {
+        print('finalizable key:', m.get(o) === 'fin');
+    });
+    m.set(key, 'fin');
+    rk = new Duktape.WeakRef(key);
+    key = null;
+    Duktape.gc();
+    Duktape.gc();
+    print('after finalizer:', rk.deref());
+}
+
+try {
+    print('collection');
+    collectionTest();
+} catch (e) {
+    print(e);
+}
@@ -0,0 +1,154 @@
+/*
+ *  Enumeration shortcuts: enumerator key lists cached per object shape
+ *  (DUK_OPT_HOBJECT_SHAPES) and the dense array fast path.  The results
+ *  must be identical to the plain enumeration algorithm.
+ */
+
+function keys(o) {
+    var res = [];
+    var k;
+    for (k in o) {
+        res.push(k);
+    }
+    return res.join(',');
+}
+
+/*===
+same shape
+x,y
+x,y
+x,y,z
+x,y
+proto key
+x,y
+x,y,p
+x,y
+===*/
+
+print('same shape');
+
+try {
+    var o1 = { x: 1, y: 2 };
+    var o2 = { x: 3, y: 4 };
+    var o3 = { x: 5, y: 6, z: 7 };
+    print(keys(o1));
+    print(keys(o2));
+    print(keys(o3));
+    print(keys({ x: 8, y: 9 }));
+
+    /* a prototype gaining an enumerable key must be noticed even for an
+     * object whose own layout is unchanged
+     */
+    print('proto key');
+    function F() { this.x = 1; this.y = 2; }
+    var f1 = new F();
+    var f2 = new F();
+    print(keys(f1) === keys(f2) ? keys(f1) : 'mismatch');
+    F.prototype.p = 1;
+    print(keys(new F()));
+    delete F.prototype.p;
+    print(keys(f2));
+} catch (e) {
+    print(e);
+}
+
+/*===
+object keys
+x,y
+x,y,hidden
+x,y
+===*/
+
+print('object keys');
+
+try {
+    var k1 = { x: 1, y: 2 };
+    var k2 = { x: 1, y: 2 };
+    Object.defineProperty(k2, 'hidden', { value: 3, enumerable: false });
+    print(Object.keys(k1));
+    print(Object.getOwnPropertyNames(k2));
+    print(Object.keys(k2));
+} catch (e) {
+    print(e);
+}
+
+/*===
+dense arrays
+0,1,2
+0,1,2,foo
+0,1,2,3,4
+0,1,2,length
+0,1,5,9
+0,1,2,3
+===*/
+
+print('dense arrays');
+
+try {
+    var a = [ 'a', 'b', 'c' ];
+    print(keys(a));
+    a.foo = 'bar';
+    print(keys(a));
+
+    /* prototype index keys are not duplicated */
+    var P = [ 1, 2, 3, 4, 5 ];
+    var child = Object.create(P);
+    child[0] = 'x'; child[1] = 'y';
+    print(keys(child));
+
+    print(Object.getOwnPropertyNames([ 1, 2, 3 ]));
+
+    var sparse = [ 1, 2 ];
+    sparse[9] = 3;
+    sparse[5] = 4;
+    print(keys(sparse));
+
+    print(keys(new String('abcd')));
+} catch (e) {
+    print(e);
+}
+
+/*===
+mutation during enumeration
+0,1,2
+0,1,foo
+0,1,2,3
+===*/
+
+print('mutation during enumeration');
+
+try {
+    var m = [ 1, 2, 3, 4, 5 ];
+    var res = [];
+    var k;
+    for (k in m) {
+        res.push(k);
+        if (k === '2') {
+            m.length = 3;
+        }
+    }
+    print(res.join(','));
+
+    m = [ 1, 2, 3, 4 ];
+    m.foo = 1;
+    res = [];
+    for (k in m) {
+        res.push(k);
+        if (k === '1') {
+            delete m[2];
+            delete m[3];
+        }
+    }
+    print(res.join(','));
+
+    /* keys added during enumeration are not visited */
+    m = [ 1, 2, 3, 4 ];
+    res = [];
+    for (k in m) {
+        res.push(k);
+        m.push(0);
+    }
+    print(res.join(','));
+} catch (e) {
+    print(e);
+}
@@ -0,0 +1,146 @@
+/*
+ *  Fused opcodes emitted by the compiler: comparison + conditional skip
+ *  (IFCMP), post-increment/decrement of a register bound variable, and
+ *  method calls using the base register directly (CSPROP).  Results and
+ *  coercion side effects must match the unfused instruction sequences.
+ */
+
+/*===
+compare in condition
+lt
+le
+ge false
+nan ne
+zero eq
+loose eq
+strict ne
+a,b,a,b,a,b,a,b
+1,3
+===*/
+
+print('compare in condition');
+
+function testCompare() {
+    var log = [];
+    var a = { valueOf: function () { log.push('a'); return 1; } };
+    var b = { valueOf: function () { log.push('b'); return 2; } };
+    var n = NaN;
+    var i;
+
+    /* ToPrimitive() coercion order is left-to-right for all relational ops */
+    if (a < b) { print('lt'); }
+    if (a <= b) { print('le'); }
+    if (a > b) { print('gt'); }
+    if (a >= b) { print('ge'); } else { print('ge false'); }
+
+    if (n == n) { print('nan eq'); }
+    if (n != n) { print('nan ne'); }
+    if (n < 1 || n >= 1) { print('nan cmp'); }
+    if (0 === -0) { print('zero eq'); }
+    if (null == undefined) { print('loose eq'); }
+    if (null !== undefined) { print('strict ne'); }
+    print(log.join(','));
+
+    /* loop conditions */
+    log = [];
+    for (i = 0; i != 3; i++) {
+        do {
+            i++;
+        } while (i < 1);
+        log.push(i);
+        if (i >= 2) { break; }
+    }
+    print(log.join(','));
+}
+
+try {
+    testCompare();
+} catch (e) {
+    print(e);
+}
+
+/*===
+postincdec
+number 5 6
+number 5 4
+7 6
+number NaN NaN
+3 -3
+===*/
+
+print('postincdec');
+
+function testPostIncDec() {
+    var x = '5';
+    var y;
+    var z;
+    var i, j;
+
+    y = x++;
+    print(typeof y, y, x);
+    x = '5';
+    y = x--;
+    print(typeof y, y, x);
+
+    /* the variable is assigned after coercion, overwriting any change
+     * made by valueOf()
+     */
+    z = { valueOf: function () { z = 100; return 7; } };
+    y = z--;
+    print(y, z);
+
+    x = 'foo';
+    y = x++;
+    print(typeof y, y, x);
+
+    i = 0; j = 0;
+    while (i < 3) { i++; j--; }
+    print(i, j);
+}
+
+try {
+    testPostIncDec();
+} catch (e) {
+    print(e);
+}
+
+/*===
+method call
+true
+true
+true
+ABC
+===*/
+
+print('method call');
+
+function testMethodCall() {
+    var k = 'foo';
+    var obj = { foo: function () { return this === obj; } };
+    var saved;
+    var base;
+
+    print(obj.foo());
+    print(obj[k]());
+
+    /* 'this' binding is the base value before the property lookup even
+     * if a getter reassigns the variable holding the base
+     */
+    base = {
+        get f() {
+            base = null;
+            return function () { return this === saved; };
+        }
+    };
+    saved = base;
+    print(base.f());
+
+    /* primitive base */
+    print('abc'.toUpperCase());
+}
+
+try {
+    testMethodCall();
+} catch (e) {
+    print(e);
+}
@@ -0,0 +1,87 @@
+/*
+ *  Interned strings of small integers are cached at the heap level.  The
+ *  cache holds weak references, so strings must be collected normally and
+ *  the cache must not return stale entries after garbage collection.
+ */
+
+/*===
+coercion
+0 0 0 7 255 256 4294967295 -1 1.5
+string string
+true
+gc
+0,1,2,3,4,5,6,7,8,9
+0,1,2,3,4,5,6,7,8,9
+keys 1000 999 true
+index keys
+1 2 3 undefined
+100 200 300
+===*/
+
+print('coercion');
+
+try {
+    print(String(0), String(-0), 0 + '', 7 + '', String(255), String(256),
+          String(4294967295), String(-1), String(1.5));
+    print(typeof String(3), typeof (3 + ''));
+    print('x' + 3 + '' === 'x3');
+} catch (e) {
+    print(e);
+}
+
+print('gc');
+
+try {
+    (function () {
+        var arr = [];
+        var i;
+        var keys;
+
+        for (i = 0; i < 10; i++) {
+            arr.push(String(i));
+        }
+        print(arr.join(','));
+        arr = null;
+        Duktape.gc();
+        Duktape.gc();
+
+        arr = [];
+        for (i = 0; i < 10; i++) {
+            arr.push(i + '');
+        }
+        print(arr.join(','));
+
+        arr = [];
+        for (i = 0; i < 1000; i++) {
+            arr[i] = i;
+        }
+        keys = Object.keys(arr);
+        arr = null;
+        Duktape.gc();
+        print('keys', keys.length, keys[999], keys.every(function (k, idx) { return k === String(idx); }));
+    })();
+} catch (e) {
+    print(e);
+}
+
+print('index keys');
+
+try {
+    (function () {
+        /* object without an array part */
+        var obj = { 0: 1, 1: 2, 2: 3 };
+        var arr = [];
+
+        print(obj[0], obj[1], obj[2], obj[3]);
+
+        /* array part abandoned by a sparse write */
+        arr[0] = 100;
+        arr[1] = 200;
+        arr[1e6] = 1;
+        arr[2] = 300;
+        Duktape.gc();
+        print(arr[0], arr[1], arr[2]);
+    })();
+} catch (e) {
+    print(e);
+}
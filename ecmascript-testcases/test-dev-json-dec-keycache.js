@@ -0,0 +1,97 @@
+/*
+ *  JSON.parse() caches recently decoded object keys and preallocates
+ *  objects based on the key count of the previous object at the same
+ *  depth.  Neither may affect the result.
+ */
+
+/*===
+records
+{"id":1,"name":"a","tags":["x"],"nested":{"k":1}}
+{"id":2,"name":"b","tags":[],"nested":{"k":2,"extra":true}}
+{"id":3,"name":"c","nested":{}}
+{"id":4}
+===*/
+
+print('records');
+
+try {
+    (function () {
+        var res = JSON.parse('[' +
+            '{"id":1,"name":"a","tags":["x"],"nested":{"k":1}},' +
+            '{"id":2,"name":"b","tags":[],"nested":{"k":2,"extra":true}},' +
+            '{"id":3,"name":"c","nested":{}},' +
+            '{"id":4}' +
+            ']');
+        res.forEach(function (v) { print(JSON.stringify(v)); });
+    })();
+} catch (e) {
+    print(e);
+}
+
+/*===
+keys
+{"":1,"a":2,"\"":3,"\\":4,"a\nb":5,"\u00e4":6,"\ud800":7}
+3
+0,1,10,length
+3 2
+2000 2000 2000
+===*/
+
+print('keys');
+
+try {
+    (function () {
+        var txt, obj, i, keys, same;
+
+        /* empty, escaped and non-ASCII keys, mixed with plain ones */
+        obj = JSON.parse('{"":1,"a":2,"\\"":3,"\\\\":4,"a\\nb":5,"\u00e4":6,"\\ud800":7}');
+        print(Duktape.enc('jc', obj));
+
+        /* duplicate key, last one wins */
+        print(JSON.parse('{"dup":1,"dup":2,"dup":3}').dup);
+
+        /* array index keys */
+        print(Object.keys(JSON.parse('{"0":1,"1":2,"10":3,"length":4}')).join(','));
+
+        /* keys differing only in bytes not used for cache indexing */
+        obj = JSON.parse('[{"aXXXb":1,"aYYYb":2,"aXYYb":3},{"aXXXb":1,"aYYYb":2}]');
+        print(Object.keys(obj[0]).length, Object.keys(obj[1]).length);
+
+        /* many distinct keys, much more than the cache holds */
+        txt = [];
+        for (i = 0; i < 2000; i++) {
+            txt.push('"key' + i + '":' + i);
+        }
+        obj = JSON.parse('[{' + txt.join(',') + '},{' + txt.join(',') + '}]');
+        keys = Object.keys(obj[1]);
+        same = 0;
+        for (i = 0; i < keys.length; i++) {
+            if (keys[i] === 'key' + i && obj[0][keys[i]] === i) {
+                same++;
+            }
+        }
+        print(keys.length, Object.keys(obj[0]).length, same);
+    })();
+} catch (e) {
+    print(e);
+}
+
+/*===
+reviver
+{"a":{"b":"B!","c":"C!"},"d":["b!"]}
+===*/
+
+/* Reviver runs after parsing with the key cache already released; it may
+ * trigger garbage collection.
+ */
+
+print('reviver');
+
+try {
+    print(JSON.stringify(JSON.parse('{"a":{"b":"B","c":"C"},"d":["b"]}', function (k, v) {
+        Duktape.gc();
+        return typeof v === 'string' ? v + '!' : v;
+    })));
+} catch (e) {
+    print(e);
+}
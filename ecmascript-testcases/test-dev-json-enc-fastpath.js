@@ -0,0 +1,183 @@
+/*
+ *  JSON.stringify() fast path: plain objects and dense arrays are serialized
+ *  directly from property storage, and anything else must fall back to the
+ *  standard algorithm with identical results.
+ */
+
+/*===
+fast path
+[1,-1,0,0,1.5,1e+21,2147483647,-2147483648,2147483648,-2147483649,null,null,null,true,false,null]
+"foo\"bar\\\n\u0001\u001f"
+{"a":1,"b":"x","c":[1,2,{"d":null}],"g":{}}
+[null,null,1]
+{"a":1,"c":3,"d":4}
+{"q":1}
+{"own":2}
+[{},[],"",[[]]]
+[{"s":1},{"s":1},{"a":{"s":1}}]
+[1,2,3]
+undefined
+undefined
+"abc"
+123
+===*/
+
+print('fast path');
+
+function test(v, replacer, space) {
+    var res;
+    try {
+        res = JSON.stringify(v, replacer, space);
+        print(typeof res === 'string' ? res : String(res));
+    } catch (e) {
+        print(e.name);
+    }
+}
+
+try {
+    test([ 1, -1, 0, -0, 1.5, 1e21, 2147483647, -2147483648, 2147483648, -2147483649,
+           NaN, Infinity, -Infinity, true, false, null ]);
+    test('foo"bar\\\n\u0001\u001f');
+    test({ a: 1, b: 'x', c: [ 1, 2, { d: null } ], e: undefined, f: function () {}, g: {} });
+    test([ undefined, function () {}, 1 ]);
+    test((function () { var x = { a: 1, b: 2, c: 3 }; delete x.b; x.d = 4; return x; })());
+    test((function () { var x = Object.create(null); x.q = 1; return x; })());
+    test((function () { var x = Object.create({ inherited: 1 }); x.own = 2; return x; })());
+    test([ {}, [], '', [ [] ] ]);
+    test((function () { var s = { s: 1 }; return [ s, s, { a: s } ]; })());
+    test((function () { var a = [ 1, 2, 3 ]; a.extra = 'x'; return a; })());
+    test(undefined);
+    test(function () {});
+    test('abc');
+    test(123);
+} catch (e) {
+    print(e);
+}
+
+/*===
+fallback
+{"vis":2}
+{"a":1,"acc":"got","z":3}
+{"x":"proto-tojson"}
+{"x":"k=x"}
+{"d":"1970-01-01T00:00:00.000Z"}
+[1,"s",false]
+[1,null,3]
+[null,null,null,null,null,1]
+[1,2,null,null,null]
+[0,"inherited",2]
+"OP"
+TypeError
+{"r":{}}
+{"a":1}
+{"a":10,"b":20}
+{"b":2}
+{"a":[1,{"b":2}]}
+{
+  "a": [
+    1
+  ]
+}
+===*/
+
+print('fallback');
+
+try {
+    // non-enumerable property
+    test((function () {
+        var o = {};
+        Object.defineProperty(o, 'hidden', { value: 1, enumerable: false });
+        o.vis = 2;
+        return o;
+    })());
+
+    // accessor property, getter must be called
+    test((function () {
+        var o = { a: 1 };
+        Object.defineProperty(o, 'acc', { get: function () { return 'got'; }, enumerable: true });
+        o.z = 3;
+        return o;
+    })());
+
+    // toJSON() in the prototype chain and in the object itself
+    test((function () {
+        function P() {}
+        P.prototype.toJSON = function () { return 'proto-tojson'; };
+        return { x: new P() };
+    })());
+    test({ x: { toJSON: function (k) { return 'k=' + k; } } });
+    test({ d: new Date(0) });
+
+    // wrapper objects are unwrapped
+    test([ new Number(1), new String('s'), new Boolean(false) ]);
+
+    // array gaps and gaps beyond the array part
+    test([ 1, , 3 ]);
+    test((function () { var a = []; a[5] = 1; return a; })());
+    test((function () { var a = [ 1, 2 ]; a.length = 5; return a; })());
+
+    // gaps are looked up from Array.prototype
+    Array.prototype[1] = 'inherited';
+    test([ 0, , 2 ]);
+    delete Array.prototype[1];
+
+    // toJSON() inherited from Object.prototype
+    Object.prototype.toJSON = function () { return 'OP'; };
+    test({ a: 1 });
+    delete Object.prototype.toJSON;
+
+    // cycles are detected by the slow path
+    test((function () { var o = { a: {} }; o.a.b = o; return o; })());
+
+    // other object classes
+    test({ r: /foo/g });
+    test(new Proxy({ a: 1 }, {}));
+
+    // replacer, property list, indent
+    test({ a: 1, b: 2 }, function (k, v) { return typeof v === 'number' ? v * 10 : v; });
+    test({ a: 1, b: 2 }, [ 'b' ]);
+    test({ a: [ 1, { b: 2 } ] }, null, '');
+    test({ a: [ 1 ] }, null, 2);
+} catch (e) {
+    print(e);
+}
+
+/*===
+nesting
+681
+TypeError
+RangeError
+===*/
+
+/* Nesting deeper than the fast path supports is handled by the slow path,
+ * which also enforces the recursion limit.
+ */
+
+print('nesting');
+
+try {
+    (function () {
+        var i;
+        var o = {};
+        var curr = o;
+        var arr;
+
+        for (i = 0; i < 40; i++) {
+            curr.x = [ { y: null } ];
+            curr = curr.x[0];
+        }
+        print(JSON.stringify(o).length);
+
+        // loop deep inside a structure
+        curr.y = o;
+        test(o);
+
+        arr = [];
+        for (i = 0; i < 10000; i++) {
+            arr = [ arr ];
+        }
+        test(arr);
+    })();
+} catch (e) {
+    print(e);
+}
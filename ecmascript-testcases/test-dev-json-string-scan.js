@@ -0,0 +1,131 @@
+/*
+ *  JSON string encoding and decoding locate runs of plain string content
+ *  a machine word (8 or 4 bytes) at a time, and the encoder works in input
+ *  chunks of 256 bytes.  Put characters needing special handling at every
+ *  offset within a word and around the chunk boundary, with varying amounts
+ *  of trailing content so that the bytewise tail scan is also exercised.
+ */
+
+/*---
+{
+    "custom": true
+}
+---*/
+
+/*===
+cases 3348
+stringify 0
+parse 0
+raw control 0
+jx 0
+jc 0
+===*/
+
+/* Reference implementation of E5 Section 15.12.3 Quote(). */
+function quote(s) {
+    var res = '"';
+    var i, c, h;
+
+    for (i = 0; i < s.length; i++) {
+        c = s.charAt(i);
+        if (c === '"' || c === '\\') {
+            res += '\\' + c;
+        } else if (c === '\b') {
+            res += '\\b';
+        } else if (c === '\f') {
+            res += '\\f';
+        } else if (c === '\n') {
+            res += '\\n';
+        } else if (c === '\r') {
+            res += '\\r';
+        } else if (c === '\t') {
+            res += '\\t';
+        } else if (c < ' ') {
+            h = c.charCodeAt(0).toString(16);
+            res += '\\u' + '0000'.substring(h.length) + h;
+        } else {
+            res += c;
+        }
+    }
+    return res + '"';
+}
+
+function repeat(c, n) {
+    var res = '';
+    while (n-- > 0) {
+        res += c;
+    }
+    return res;
+}
+
+function scanTest() {
+    var specials = [ '"', '\\', '\n', '\u0000', '\u0001', '\u001f', '\u007f',
+                     'ä', '€', '𝄞', '"\\', 'ä\n' ];
+    var offsets = [];
+    var tails = [ 0, 1, 2, 7, 8, 9, 15, 16, 17 ];
+    var cases = 0, failStringify = 0, failParse = 0, failRaw = 0, failJx = 0, failJc = 0;
+    var i, j, k, c, s, t;
+
+    for (i = 0; i <= 17; i++) {
+        offsets.push(i);
+    }
+    for (i = 250; i <= 262; i++) {
+        offsets.push(i);
+    }
+
+    for (i = 0; i < specials.length; i++) {
+        c = specials[i];
+        for (j = 0; j < offsets.length; j++) {
+            for (k = 0; k < tails.length; k++) {
+                s = repeat('a', offsets[j]) + c + repeat('b', tails[k]);
+                cases++;
+
+                if (JSON.stringify(s) !== quote(s)) {
+                    print('stringify mismatch', i, offsets[j], tails[k]);
+                    failStringify++;
+                }
+                if (JSON.parse(quote(s)) !== s) {
+                    print('parse mismatch', i, offsets[j], tails[k]);
+                    failParse++;
+                }
+                if (c.charCodeAt(0) < 0x20 || c.charCodeAt(c.length - 1) < 0x20) {
+                    /* unescaped control characters are rejected */
+                    try {
+                        JSON.parse('"' + s + '"');
+                        print('raw control accepted', i, offsets[j], tails[k]);
+                        failRaw++;
+                    } catch (e) {
+                        if (e.name !== 'SyntaxError') {
+                            failRaw++;
+                        }
+                    }
+                }
+
+                /* JX/JC output is ASCII only and must round trip */
+                t = Duktape.enc('jx', s);
+                if (!/^[\x20-\x7e]*$/.test(t) || Duktape.dec('jx', t) !== s) {
+                    print('jx mismatch', i, offsets[j], tails[k]);
+                    failJx++;
+                }
+                t = Duktape.enc('jc', s);
+                if (!/^[\x20-\x7e]*$/.test(t) || Duktape.dec('jc', t) !== s) {
+                    print('jc mismatch', i, offsets[j], tails[k]);
+                    failJc++;
+                }
+            }
+        }
+    }
+
+    print('cases', cases);
+    print('stringify', failStringify);
+    print('parse', failParse);
+    print('raw control', failRaw);
+    print('jx', failJx);
+    print('jc', failJc);
+}
+
+try {
+    scanTest();
+} catch (e) {
+    print(e);
+}
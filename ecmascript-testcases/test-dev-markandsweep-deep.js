@@ -0,0 +1,109 @@
+/*---
+{
+    "custom": true
+}
+---*/
+
+/*
+ *  Mark-and-sweep marking of deep structures.  Marking uses an explicit
+ *  mark stack so that long linked lists and deep trees are marked in
+ *  linear time.  Nothing reachable may be freed, and unreachable cycles
+ *  hanging off the structures must be freed.
+ */
+
+/*===
+list
+finalized: 0
+sum: 4999950000
+freed: 1
+tree
+depth: 20000
+finalized: 1
+wide
+sum: 499500
+===*/
+
+var finalized;
+
+function makeList(n) {
+    // Append at the tail: the oldest object is the head, which is the
+    // worst case for a recursion limited marker.
+    var head = { v: 0 };
+    var tail = head;
+    var i;
+    for (i = 1; i < n; i++) {
+        tail.next = { v: i };
+        tail = tail.next;
+    }
+    // Finalizable cycle at the end of the list.
+    tail.next = { cyc: null };
+    tail.next.cyc = tail.next;
+    Duktape.fin(tail.next, function () { finalized++; });
+    return head;
+}
+
+print('list');
+try {
+    finalized = 0;
+    var list = makeList(100000);
+    Duktape.gc();
+    print('finalized:', finalized);
+
+    var sum = 0;
+    var p = list;
+    while (p && p.v !== undefined) { sum += p.v; p = p.next; }
+    print('sum:', sum);
+
+    list = null;
+    p = null;
+    Duktape.gc();
+    Duktape.gc();
+    print('freed:', finalized);
+} catch (e) {
+    print(e);
+}
+
+print('tree');
+try {
+    finalized = 0;
+    var root = { kids: [] };
+    var node = root;
+    var i;
+    for (i = 0; i < 20000; i++) {
+        var child = { kids: [], parent: node };
+        node.kids.push(child, { leaf: i });
+        node = child;
+    }
+    Duktape.fin(node, function () { finalized++; });
+    node = null;
+    child = null;
+    Duktape.gc();
+
+    var depth = 0;
+    node = root;
+    while (node.kids.length > 0) { node = node.kids[0]; depth++; }
+    print('depth:', depth);
+
+    node = null;
+    root = null;
+    Duktape.gc();
+    Duktape.gc();
+    print('finalized:', finalized);
+} catch (e) {
+    print(e);
+}
+
+print('wide');
+try {
+    var wide = [];
+    for (i = 0; i < 1000; i++) {
+        wide.push({ v: i, self: null });
+        wide[i].self = wide[i];
+    }
+    Duktape.gc();
+    sum = 0;
+    wide.forEach(function (o) { sum += o.self.v; });
+    print('sum:', sum);
+} catch (e) {
+    print(e);
+}
@@ -0,0 +1,217 @@
+/*
+ *  String-to-number conversion edge cases: 64-bit integer fast path,
+ *  radix 10 fast path, and inputs close to a rounding boundary which
+ *  fall back to Dragon4.
+ */
+
+/*===
+integers
+9007199254740991
+9007199254740992
+9007199254740992
+9007199254740996
+9007199254740996
+18446744073709552000
+123456789012345680000
+-0
+255
+4294967297
+18446744073709552000
+511
+===*/
+
+print('integers');
+
+try {
+    [
+        '9007199254740991', '9007199254740992', '9007199254740993',
+        '9007199254740995', '9007199254740997', '18446744073709551615',
+        '123456789012345678901'
+    ].forEach(function (v) {
+        print(String(Number(v)));
+    });
+    print(1 / Number('-0') === -Infinity ? '-0' : '+0');
+    print(Number('0xff'));
+    print(parseInt('100000001', 16));
+    print(parseInt('ffffffffffffffff', 16));
+    print(parseInt('777', 8));
+} catch (e) {
+    print(e);
+}
+
+/*===
+decimals
+0.1
+0.3
+1e+23
+8.41e+21
+3.517e+21
+4865226925978608
+455009202912255170
+1.7976931348623157e+308
+Infinity
+2.2250738585072014e-308
+2.225073858507201e-308
+5e-324
+5e-324
+0
+0
+-0
+1e-7
+123.456
+123.456
+0.001
+1000
+===*/
+
+print('decimals');
+
+try {
+    [
+        '0.1', '.3', '1e23', '8.41e21', '3517e18', '4865226925978608.5',
+        '455009202912255168', '1.7976931348623157e308', '1.7976931348623159e308',
+        '2.2250738585072014e-308', '2.2250738585072011e-308',
+        '4.9406564584124654e-324', '2.4703282292062328e-324',
+        '2.4703282292062327e-324', '1e-400', '-0.0e5', '1e-7',
+        '123.456', '123456e-3', '0.000001e3', '0.000001e9'
+    ].forEach(function (v) {
+        var n = Number(v);
+        print(n === 0 && 1 / n < 0 ? '-0' : String(n));
+    });
+} catch (e) {
+    print(e);
+}
+
+/*===
+call sites
+12.375
+-0.5
+1.5
+0.1 1e-20 1e+300
+true
+===*/
+
+print('call sites');
+
+try {
+    print(12.375);
+    print(parseFloat('-0.5garbage'));
+    print(+'  1.5  ');
+    print(JSON.parse('[0.1,1e-20,1e300]').join(' '));
+
+    /* shortest output round trips for a range of magnitudes */
+    (function () {
+        var i, v, ok = true;
+        for (i = -320; i <= 300; i += 7) {
+            v = 1.2345678901234567 * Math.pow(10, i);
+            if (Number(String(v)) !== v) {
+                print('round trip failed', v);
+                ok = false;
+            }
+            v = v / 3;
+            if (Number(String(v)) !== v) {
+                print('round trip failed', v);
+                ok = false;
+            }
+        }
+        print(ok);
+    })();
+} catch (e) {
+    print(e);
+}
+
+/*===
+long significands
+9007199254740994
+9007199254740992
+9007199254740994
+1
+1.0000000000000002
+1
+1.2345678901234567
+Infinity
+1.7976931348623157e+308
+0
+5e-324
+9007199254740994
+9007199254740994
+===*/
+
+/* Digits beyond the 20th still affect rounding. */
+
+print('long significands');
+
+try {
+    (function () {
+        var halfOne = '1.00000000000000011102230246251565404236316680908203125';
+        var halfMax = '17976931348623158079372897140530341507993413271003782693617377898044496829276475094664901797758720709633028641669288791094655554785194040263065748867150582068190890200070838367627385484581771153176447573027006985557136695962284291481986083493647529271907416844436551070434271155969950809304288017790417449779' + '2';
+        var halfMin = '2.4703282292062327208828439643411068618252990130716238221279284125033775363510437593264991818081799618989828234772285886546332835517796989819938739800539093906315035659515570226392290858392449105184435931802849936536152500319370457678249219365623669863658480757001585769269903706311928279558551332927834338409351978015531246597263579574622766465272827220056374006485499977096599470454020828166226237857393450736339007967761930577506740176324673600968951340535537458516661134223766678604162159680461914467291840300530057530849048765391711386591646239524912623653881879636239373280423891018672348497668235089863388587925628302755995657524455507255189313690836254779186948667994968324049705821028513185451396213837722826145437693412532098591327667236328125e-324';
+
+        [
+            '9007199254740993.0000000000000000001',
+            '9007199254740992.9999999999999999999',
+            '90071992547409930000000000000000001e-19',
+            halfOne,
+            halfOne.replace(/5$/, '6'),
+            halfOne.replace(/5$/, '4'),
+            '0.000000000000000000000000000000123456789012345678901234567890123456789e31',
+            halfMax,
+            halfMax.replace(/2$/, '1'),
+            halfMin,
+            halfMin.replace(/e/, '1e')
+        ].forEach(function (v) {
+            print(Number(v));
+        });
+
+        print(parseFloat('9007199254740993.00000000000000000001xyz'));
+        print(JSON.parse('9007199254740993.00000000000000000001'));
+    })();
+} catch (e) {
+    print(e);
+}
+
+/*===
+round trips
+true
+true
+true
+===*/
+
+/* Parsed values must be exact for JSON and CSV style inputs. */
+
+print('round trips');
+
+try {
+    (function () {
+        var ints = [];
+        var floats = [];
+        var seed = 1;
+        var i, csv, ok;
+
+        function rnd() {
+            /* deterministic LCG, result in [0,1) */
+            seed = (seed * 1103515245 + 12345) % 2147483648;
+            return seed / 2147483648;
+        }
+
+        for (i = 0; i < 1000; i++) {
+            ints.push(Math.floor(rnd() * 1e9) - 5e8);
+            floats.push((rnd() - 0.5) * Math.pow(10, Math.floor(rnd() * 40) - 20));
+        }
+
+        print(JSON.stringify(JSON.parse(JSON.stringify(ints))) === JSON.stringify(ints));
+        print(JSON.stringify(JSON.parse(JSON.stringify(floats))) === JSON.stringify(floats));
+
+        csv = floats.map(function (v) { return v.toFixed(4); });
+        ok = true;
+        csv.forEach(function (v) {
+            if (Number(v).toFixed(4) !== v && Number(v).toFixed(4) !== v.replace(/^-/, '')) {
+                print('csv mismatch', v);
+                ok = false;
+            }
+        });
+        print(ok);
+    })();
+} catch (e) {
+    print(e);
+}
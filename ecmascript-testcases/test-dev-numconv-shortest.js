@@ -0,0 +1,101 @@
+/*
+ *  Shortest number-to-string conversion edge cases: integer fast path
+ *  limits, Grisu3 fast path, and values where Grisu3 falls back to Dragon4.
+ */
+
+/*===
+integers
+0
+0
+4294967295
+4294967296
+-4294967297
+9007199254740991
+9007199254740992
+9007199254740994
+18446744073709552000
+123456789012345680000
+1e+21
+11111111111111111111111111111111111111111111111111111
+-1000000000000
+2dfdc1c35
+-cre66i9s
+===*/
+
+print('integers');
+
+try {
+    [
+        0, -0, 4294967295, 4294967296, -4294967297,
+        9007199254740991, 9007199254740992, 9007199254740994,
+        18446744073709551616, 123456789012345678901, 1e21
+    ].forEach(function (v) {
+        print(String(v));
+    });
+    print((9007199254740991).toString(2));
+    print((-1e12).toString(10));
+    print((12345678901).toString(16));
+    print((-1e12).toString(36));
+} catch (e) {
+    print(e);
+}
+
+/*===
+fractions
+0.1
+0.30000000000000004
+0.3333333333333333
+-2.5
+1e-7
+0.000001
+1.23e-18
+123.456
+1.7976931348623157e+308
+2.2250738585072014e-308
+2.225073858507201e-308
+5e-324
+5e-324
+1.1392378155556871e-305
+8.98846567431158e+307
+7.291122019556398e-304
+===*/
+
+print('fractions');
+
+try {
+    [
+        0.1, 0.1 + 0.2, 1 / 3, -2.5, 1e-7, 0.000001, 123e-20, 123.456,
+        1.7976931348623157e308, 2.2250738585072014e-308, 2.225073858507201e-308,
+        5e-324,
+
+        /* powers of two have a smaller lower gap */
+        Math.pow(2, -1074), Math.pow(2, -1013), Math.pow(2, 1023), Math.pow(2, -1007)
+    ].forEach(function (v) {
+        print(String(v));
+    });
+} catch (e) {
+    print(e);
+}
+
+/*===
+other formats
+1.23456e+2
+1e+21
+1.2e-7
+123.46
+123.5
+0.0001234
+===*/
+
+print('other formats');
+
+try {
+    print((123.456).toExponential());
+    print((1e21).toExponential());
+    print((1.2e-7).toExponential());
+    print((123.456).toFixed(2));
+    print((123.456).toPrecision(4));
+    print((0.00012345).toPrecision(4));
+} catch (e) {
+    print(e);
+}
@@ -0,0 +1,193 @@
+/*
+ *  Objects sharing the same property layout.  When DUK_OPT_HOBJECT_SHAPES
+ *  is enabled these objects share a shape; a delete, an attribute change,
+ *  or a large number of properties converts an object back to its own
+ *  property table.  The results must be identical with and without shapes.
+ */
+
+function Point(x, y) {
+    this.x = x;
+    this.y = y;
+}
+
+function dump(o) {
+    var k = [];
+    var i;
+    for (i in o) {
+        k.push(i + '=' + o[i]);
+    }
+    print(k.join(' '));
+}
+
+function printDesc(o, k) {
+    var d = Object.getOwnPropertyDescriptor(o, k);
+    if (!d) {
+        print(k, 'missing');
+    } else if ('value' in d) {
+        print(k, d.value, d.writable, d.enumerable, d.configurable);
+    } else {
+        print(k, typeof d.get, typeof d.set, d.enumerable, d.configurable);
+    }
+}
+
+/*===
+same layout
+x=1 y=2
+x=3 y=4
+x=5 y=6 z=7
+x=3 y=4
+x=100 y=2
+===*/
+
+print('same layout');
+
+try {
+    var p1 = new Point(1, 2);
+    var p2 = new Point(3, 4);
+    var p3 = new Point(5, 6);
+    p3.z = 7;  /* diverge from p1 and p2 */
+    dump(p1);
+    dump(p2);
+    dump(p3);
+
+    /* a value write must not affect other objects of the same layout */
+    p1.x = 100;
+    dump(p2);
+    dump(p1);
+} catch (e) {
+    print(e);
+}
+
+/*===
+delete
+y=2 z=3
+x=4 y=5 z=6
+y=2 z=3 w=4
+===*/
+
+print('delete');
+
+try {
+    var o1 = { x: 1, y: 2, z: 3 };
+    var o2 = { x: 4, y: 5, z: 6 };
+    delete o1.x;
+    dump(o1);
+    dump(o2);
+    o1.w = 4;
+    dump(o1);
+} catch (e) {
+    print(e);
+}
+
+/*===
+attributes
+x 1 false true true
+x 2 true true true
+y 2 true false true
+y 3 true true true
+x=1
+x=2 y=3
+frozen
+x 1 false true false
+x 3 true true true
+true
+===*/
+
+print('attributes');
+
+try {
+    var a1 = { x: 1, y: 2 };
+    var a2 = { x: 2, y: 3 };
+    Object.defineProperty(a1, 'x', { writable: false });
+    printDesc(a1, 'x');
+    printDesc(a2, 'x');
+    Object.defineProperty(a1, 'y', { enumerable: false });
+    printDesc(a1, 'y');
+    printDesc(a2, 'y');
+    dump(a1);
+    dump(a2);
+
+    var f1 = { x: 1 };
+    var f2 = { x: 3 };
+    Object.freeze(f1);
+    print('frozen');
+    printDesc(f1, 'x');
+    printDesc(f2, 'x');
+    f2.x = 4;  /* f2 must remain writable */
+    print(f2.x === 4);
+} catch (e) {
+    print(e);
+}
+
+/*===
+accessors
+x function undefined true true
+x 1 true true true
+getter
+10
+x 20 true true true
+===*/
+
+print('accessors');
+
+try {
+    var g1 = { x: 1 };
+    var g2 = { x: 1 };
+    Object.defineProperty(g1, 'x', { get: function () { print('getter'); return 10; } });
+    printDesc(g1, 'x');
+    printDesc(g2, 'x');
+    print(g1.x);
+    Object.defineProperty(g1, 'x', { value: 20, writable: true });
+    printDesc(g1, 'x');
+} catch (e) {
+    print(e);
+}
+
+/*===
+many properties
+100 p0 p99
+0 99 undefined
+===*/
+
+print('many properties');
+
+try {
+    var m1 = {};
+    var m2 = {};
+    var i;
+    for (i = 0; i < 100; i++) {
+        m1['p' + i] = i;
+        m2['p' + i] = i;
+    }
+    var keys = Object.keys(m1);
+    print(keys.length, keys[0], keys[99]);
+    delete m2.p50;
+    print(m1.p0, m2.p99, m2.p50);
+} catch (e) {
+    print(e);
+}
+
+/*===
+arrays
+1,2,3,4
+foo bar
+0,1,2,3,foo
+0,1,2,foo 4
+===*/
+
+print('arrays');
+
+try {
+    var arr1 = [1, 2, 3];
+    var arr2 = [1, 2, 3];
+    arr1.push(4);
+    arr1.foo = 'bar';
+    arr2.foo = 'quux';
+    arr2.length = 4;
+    print(arr1);
+    print('foo', arr1.foo);
+    print(Object.keys(arr1));
+    print(Object.keys(arr2), arr2.length);
+} catch (e) {
+    print(e);
+}
@@ -0,0 +1,138 @@
+/*
+ *  Error tracebacks are captured as a raw callstack snapshot and decoded
+ *  lazily when 'stack', 'fileName' or 'lineNumber' is read.  Check that
+ *  the decoded result is right after many throws, for shallow and deep
+ *  call stacks, and when the snapshot is the only reference left to the
+ *  functions involved.
+ */
+
+/*---
+{
+    "custom": true
+}
+---*/
+
+function recurse(n, fn) {
+    if (n <= 0) {
+        return fn();
+    }
+    return recurse(n - 1, fn) + 1;
+}
+
+function thrower() {
+    throw new Error('control flow');
+}
+
+/* Function names of the traceback lines, without file names. */
+function summary(e) {
+    return e.stack.split('\n').slice(1).map(function (line) {
+        return line.replace(/^\s+/, '').split(' ')[0];
+    }).join(' ');
+}
+
+/*===
+many throws
+1000 0 0
+thrower recurse recurse recurse recurse recurse recurse recurse recurse recurse [...]
+23 true
+===*/
+
+print('many throws');
+
+try {
+    (function () {
+        var errs = [];
+        var i, diffSummary = 0, diffLine = 0;
+
+        for (i = 0; i < 1000; i++) {
+            try {
+                recurse(30, thrower);
+            } catch (e) {
+                errs.push(e);
+            }
+        }
+        for (i = 0; i < errs.length; i++) {
+            if (summary(errs[i]) !== summary(errs[0])) {
+                diffSummary++;
+            }
+            if (errs[i].lineNumber !== errs[0].lineNumber) {
+                diffLine++;
+            }
+        }
+        print(errs.length, diffSummary, diffLine);
+        print(summary(errs[0]));
+        print(errs[0].lineNumber, typeof errs[0].fileName === 'string');
+    })();
+} catch (e) {
+    print(e);
+}
+
+/*===
+shallow stack
+thrower recurse recurse recurse anon
+===*/
+
+print('shallow stack');
+
+try {
+    (function () {
+        try {
+            recurse(3, thrower);
+        } catch (e) {
+            print(summary(e).replace(/ global$/, ''));
+        }
+    })();
+} catch (e) {
+    print(e);
+}
+
+/*===
+error from native code
+true
+anon recurse recurse
+===*/
+
+print('error from native code');
+
+try {
+    (function () {
+        try {
+            recurse(2, function () { return null.foo; });
+        } catch (e) {
+            /* first line is the C file and line the error was created at */
+            print(/\.c:\d+$/.test(e.stack.split('\n')[1]));
+            print(summary(e).split(' ').slice(1, 4).join(' '));
+        }
+    })();
+} catch (e) {
+    print(e);
+}
+
+/*===
+unreachable functions
+innerThrower outerCaller
+===*/
+
+print('unreachable functions');
+
+try {
+    (function () {
+        var err;
+
+        /* The snapshot keeps the functions alive once nothing else does. */
+        (function () {
+            var f = function innerThrower() { throw new Error('x'); };
+            var g = function outerCaller() { f(); };
+            try {
+                g();
+            } catch (e) {
+                err = e;
+            }
+        })();
+        Duktape.gc();
+        Duktape.gc();
+        print(summary(err).split(' ').slice(0, 2).join(' '));
+    })();
+} catch (e) {
+    print(e);
+}
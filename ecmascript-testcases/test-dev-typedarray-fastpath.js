@@ -0,0 +1,152 @@
+/*
+ *  Typed array element reads and writes with a number key have executor
+ *  and property code fast paths.  A string key, or a non-number value for
+ *  a write, takes the generic property path instead.  Both must agree on
+ *  the edge cases.
+ */
+
+/*===
+out of range
+4 undefined undefined 0,1,2,3 true
+5 undefined undefined 0,1,2,3 true
+4294967294 undefined undefined 0,1,2,3 true
+fractional and negative
+1.5 3 3 true
+-1 3 3 true
+NaN 3 3 true
+-0 0:3 true
+NaN store
+Uint8Array 0 true
+Uint8ClampedArray 0 true
+Int8Array 0 true
+Uint16Array 0 true
+Int16Array 0 true
+Uint32Array 0 true
+Int32Array 0 true
+Float32Array NaN true
+Float64Array NaN true
+clamped rounding
+2,2,0,255,254,0,1,255,0,0,0,254,3,1 true
+integer conversion
+Int8Array -56,127,-128,-1,1 true
+Uint8Array 200,127,128,255,1 true
+Uint16Array 200,127,65408,65535,1 true
+Int32Array 200,127,-128,-1,-2147483648 true
+Uint32Array 200,127,4294967168,4294967295,2147483648 true
+Float32Array 200,127.5,-128,-1,0.10000000149011612 true
+===*/
+
+/* Write through the fast path (number key and value) and the slow path
+ * (string key, and a number key with an object value), returning the
+ * resulting elements of each as strings.
+ */
+function writeBoth(ctor, len, key, val) {
+    var fast = new ctor(len);
+    var slowKey = new ctor(len);
+    var slowVal = new ctor(len);
+
+    fast[key] = val;
+    slowKey[String(key)] = val;
+    slowVal[key] = { valueOf: function () { return val; } };
+    return [ fast, slowKey, slowVal ];
+}
+
+function elems(a) {
+    return Array.prototype.join.call(a, ',');
+}
+
+function sameElems(arrs) {
+    return elems(arrs[0]) === elems(arrs[1]) && elems(arrs[0]) === elems(arrs[2]);
+}
+
+function outOfRangeTest() {
+    [ 4, 5, 4294967294 ].forEach(function (idx) {
+        var r = writeBoth(Uint8Array, 4, idx, 1);
+        print(idx, r[0][idx], r[1][String(idx)], Object.keys(r[1]).join(','),
+              sameElems(r) && Object.keys(r[0]).join() === Object.keys(r[1]).join() &&
+              Object.keys(r[0]).join() === Object.keys(r[2]).join());
+    });
+}
+
+function fractionalTest() {
+    var r;
+
+    /* Not array indices: ordinary properties, elements untouched. */
+    [ 1.5, -1, NaN ].forEach(function (key) {
+        r = writeBoth(Uint8Array, 4, key, 3);
+        print(key, r[0][key], r[1][String(key)], sameElems(r) && elems(r[0]) === '0,0,0,0' &&
+              r[2][key] == 3);
+    });
+
+    /* -0 is element 0 (ToString(-0) is '0'). */
+    r = writeBoth(Uint8Array, 4, -0, 3);
+    print('-0', '0:' + r[0][0], sameElems(r) && r[0][-0] === 3 && r[1]['0'] === 3);
+}
+
+var ctors = [ Uint8Array, Uint8ClampedArray, Int8Array, Uint16Array, Int16Array,
+              Uint32Array, Int32Array, Float32Array, Float64Array ];
+var ctorNames = [ 'Uint8Array', 'Uint8ClampedArray', 'Int8Array', 'Uint16Array', 'Int16Array',
+                  'Uint32Array', 'Int32Array', 'Float32Array', 'Float64Array' ];
+
+function nanStoreTest() {
+    ctors.forEach(function (ctor, i) {
+        var r = writeBoth(ctor, 1, 0, NaN);
+        print(ctorNames[i], r[0][0], sameElems(r));
+    });
+}
+
+/* Write each value at its own index through both paths. */
+function writeValues(ctor, vals) {
+    var fast = new ctor(vals.length);
+    var slowKey = new ctor(vals.length);
+    var slowVal = new ctor(vals.length);
+    var i;
+
+    for (i = 0; i < vals.length; i++) {
+        fast[i] = vals[i];
+        slowKey[String(i)] = vals[i];
+        slowVal[i] = new Number(vals[i]);
+    }
+    return [ fast, slowKey, slowVal ];
+}
+
+function clampedTest() {
+    /* ToUint8Clamp rounds half to even */
+    var r = writeValues(Uint8ClampedArray, [ 1.5, 2.5, -1, 300, 254.5, 0.5, 0.50001, Infinity,
+                                             -0, NaN, -Infinity, 253.5, 2.5000001, 0.9 ]);
+    print(elems(r[0]), sameElems(r));
+}
+
+function conversionTest() {
+    var vals = [ 200, 127.5, -128, -1, 0.1 ];
+
+    [ Int8Array, Uint8Array, Uint16Array, Int32Array, Uint32Array, Float32Array ].forEach(function (ctor) {
+        var v = vals;
+        var r;
+
+        if (ctor === Int8Array || ctor === Uint8Array) {
+            v = [ 200, 127.5, -128, 255, 1.5 ];
+        } else if (ctor === Uint16Array) {
+            v = [ 200, 127.5, -128, -1, 65537 ];
+        } else if (ctor === Int32Array || ctor === Uint32Array) {
+            v = [ 200, 127.5, -128, -1, 2147483648 ];
+        }
+        r = writeValues(ctor, v);
+        print(Object.prototype.toString.call(r[0]).slice(8, -1), elems(r[0]), sameElems(r));
+    });
+}
+
+try {
+    print('out of range');
+    outOfRangeTest();
+    print('fractional and negative');
+    fractionalTest();
+    print('NaN store');
+    nanStoreTest();
+    print('clamped rounding');
+    clampedTest();
+    print('integer conversion');
+    conversionTest();
+} catch (e) {
+    print(e);
+}
@@ -13,7 +13,8 @@ DUK_EXTERNAL void *duk_resize_buffer(duk_context *ctx, duk_idx_t index, duk_size
 	h = (duk_hbuffer_dynamic *) duk_require_hbuffer(ctx, index);
 	DUK_ASSERT(h != NULL);
 
-	if (!DUK_HBUFFER_HAS_DYNAMIC(h)) {
+	if (!DUK_HBUFFER_IS_RESIZABLE(h)) {
+		/* fixed and external buffers can't be resized */
 		DUK_ERROR(thr, DUK_ERR_TYPE_ERROR, DUK_STR_BUFFER_NOT_DYNAMIC);
 	}
 
@@ -2,10 +2,159 @@
  *  Encoding and decoding basic formats: hex, base64.
  *
  *  These are in-place operations which may allow an optimized implementation.
+ *
+ *  With DUK_USE_BASE64_FASTPATH and DUK_USE_HEX_FASTPATH the codecs are
+ *  table driven and handle a full group of input bytes per loop round,
+ *  checking validity for the whole group at once.  Base64 decoding drops
+ *  to a character-at-a-time slow path for whitespace and padding.
  */
 
 #include "duk_internal.h"
 
+/* Output chunk size for duk_base64_encode_to_sink(), must be a multiple
+ * of 4 so that each chunk encodes a whole number of 3-byte groups.
+ */
+#define DUK__BASE64_SINK_CHUNK  1024
+
+#if defined(DUK_USE_BASE64_FASTPATH)
+DUK_LOCAL const duk_uint8_t duk__base64_enctab[64] = {
+	'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P',
+	'Q', 'R', 'S', 'T', 'U', 'V', 'W', 'X', 'Y', 'Z', 'a', 'b', 'c', 'd', 'e', 'f',
+	'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't', 'u', 'v',
+	'w', 'x', 'y', 'z', '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', '+', '/'
+};
+
+/* Decode table: 0-63 for base64 digits, -1 = invalid, -2 = allowed
+ * whitespace, -3 = padding ('=').
+ */
+DUK_LOCAL const duk_int8_t duk__base64_dectab[256] = {
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -2, -2, -1, -1, -2, -1, -1,  /* 0x00-0x0f */
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  /* 0x10-0x1f */
+	-2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,  /* 0x20-0x2f */
+	52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -3, -1, -1,  /* 0x30-0x3f */
+	-1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,  /* 0x40-0x4f */
+	15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,  /* 0x50-0x5f */
+	-1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,  /* 0x60-0x6f */
+	41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,  /* 0x70-0x7f */
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  /* 0x80-0x8f */
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  /* 0x90-0x9f */
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  /* 0xa0-0xaf */
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  /* 0xb0-0xbf */
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  /* 0xc0-0xcf */
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  /* 0xd0-0xdf */
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,  /* 0xe0-0xef */
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1   /* 0xf0-0xff */
+};
+#endif  /* DUK_USE_BASE64_FASTPATH */
+
+#if defined(DUK_USE_HEX_FASTPATH)
+/* Like duk_hex_dectab[] but values shifted left by 4, -1 if invalid. */
+DUK_LOCAL const duk_int16_t duk__hex_dectab_shift4[256] = {
+	  -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,  /* 0x00-0x0f */
+	  -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,  /* 0x10-0x1f */
+	  -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,  /* 0x20-0x2f */
+	   0,   16,   32,   48,   64,   80,   96,  112,  128,  144,   -1,   -1,   -1,   -1,   -1,   -1,  /* 0x30-0x3f */
+	  -1,  160,  176,  192,  208,  224,  240,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,  /* 0x40-0x4f */
+	  -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,  /* 0x50-0x5f */
+	  -1,  160,  176,  192,  208,  224,  240,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,  /* 0x60-0x6f */
+	  -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,  /* 0x70-0x7f */
+	  -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,  /* 0x80-0x8f */
+	  -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,  /* 0x90-0x9f */
+	  -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,  /* 0xa0-0xaf */
+	  -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,  /* 0xb0-0xbf */
+	  -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,  /* 0xc0-0xcf */
+	  -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,  /* 0xd0-0xdf */
+	  -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,  /* 0xe0-0xef */
+	  -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1,   -1   /* 0xf0-0xff */
+};
+#endif  /* DUK_USE_HEX_FASTPATH */
+
+/* Get the data of a codec input value without a copy: buffers are used
+ * as is, strings as their (CESU-8) bytes, and other values are replaced
+ * with their ToString() coercion.  The data pointer may be NULL if the
+ * length is zero.
+ */
+DUK_LOCAL const duk_uint8_t *duk__prep_codec_arg(duk_context *ctx, duk_idx_t index, duk_size_t *out_len) {
+	DUK_ASSERT(out_len != NULL);
+
+	if (duk_is_buffer(ctx, index)) {
+		return (const duk_uint8_t *) duk_get_buffer(ctx, index, out_len);
+	} else {
+		return (const duk_uint8_t *) duk_to_lstring(ctx, index, out_len);
+	}
+}
+
+#if defined(DUK_USE_BASE64_FASTPATH)
+/* dst length must be exactly ceil(len/3)*4 */
+DUK_LOCAL void duk__base64_encode_helper(const duk_uint8_t *src, const duk_uint8_t *src_end,
+                                         duk_uint8_t *dst, duk_uint8_t *dst_end) {
+	duk_uint_fast32_t t;
+	duk_size_t n_full;
+	const duk_uint8_t *src_end_full;
+
+	DUK_UNREF(dst_end);
+
+	/* Full 3-byte groups, two groups per round while possible. */
+	n_full = (duk_size_t) (src_end - src) / 3;
+	src_end_full = src + n_full * 3;
+
+	while (src_end_full - src >= 6) {
+		t = ((duk_uint_fast32_t) src[0] << 16) | ((duk_uint_fast32_t) src[1] << 8) | (duk_uint_fast32_t) src[2];
+		dst[0] = duk__base64_enctab[t >> 18];
+		dst[1] = duk__base64_enctab[(t >> 12) & 0x3f];
+		dst[2] = duk__base64_enctab[(t >> 6) & 0x3f];
+		dst[3] = duk__base64_enctab[t & 0x3f];
+		t = ((duk_uint_fast32_t) src[3] << 16) | ((duk_uint_fast32_t) src[4] << 8) | (duk_uint_fast32_t) src[5];
+		dst[4] = duk__base64_enctab[t >> 18];
+		dst[5] = duk__base64_enctab[(t >> 12) & 0x3f];
+		dst[6] = duk__base64_enctab[(t >> 6) & 0x3f];
+		dst[7] = duk__base64_enctab[t & 0x3f];
+		src += 6;
+		dst += 8;
+	}
+	if (src < src_end_full) {
+		t = ((duk_uint_fast32_t) src[0] << 16) | ((duk_uint_fast32_t) src[1] << 8) | (duk_uint_fast32_t) src[2];
+		dst[0] = duk__base64_enctab[t >> 18];
+		dst[1] = duk__base64_enctab[(t >> 12) & 0x3f];
+		dst[2] = duk__base64_enctab[(t >> 6) & 0x3f];
+		dst[3] = duk__base64_enctab[t & 0x3f];
+		src += 3;
+		dst += 4;
+	}
+	DUK_ASSERT(src == src_end_full);
+
+	/*
+	 *  Missing bytes    base64 example
+	 *    0               XXXX
+	 *    1               XXX=
+	 *    2               XX==
+	 */
+
+	switch (src_end - src) {
+	case 1:
+		t = (duk_uint_fast32_t) src[0];
+		dst[0] = duk__base64_enctab[t >> 2];
+		dst[1] = duk__base64_enctab[(t << 4) & 0x3f];
+		dst[2] = (duk_uint8_t) '=';
+		dst[3] = (duk_uint8_t) '=';
+		dst += 4;
+		break;
+	case 2:
+		t = ((duk_uint_fast32_t) src[0] << 8) | (duk_uint_fast32_t) src[1];
+		dst[0] = duk__base64_enctab[t >> 10];
+		dst[1] = duk__base64_enctab[(t >> 4) & 0x3f];
+		dst[2] = duk__base64_enctab[(t << 2) & 0x3f];
+		dst[3] = (duk_uint8_t) '=';
+		dst += 4;
+		break;
+	default:
+		DUK_ASSERT(src == src_end);
+		break;
+	}
+
+	DUK_ASSERT(dst == dst_end);
+}
+#else  /* DUK_USE_BASE64_FASTPATH */
 /* dst length must be exactly ceil(len/3)*4 */
 DUK_LOCAL void duk__base64_encode_helper(const duk_uint8_t *src, const duk_uint8_t *src_end,
                                          duk_uint8_t *dst, duk_uint8_t *dst_end) {
@@ -63,7 +212,109 @@ DUK_LOCAL void duk__base64_encode_helper(const duk_uint8_t *src, const duk_uint8
 		}
 	}
 }
+#endif  /* DUK_USE_BASE64_FASTPATH */
 
+#if defined(DUK_USE_BASE64_FASTPATH)
+DUK_LOCAL duk_bool_t duk__base64_decode_helper(const duk_uint8_t *src, const duk_uint8_t *src_end,
+                                               duk_uint8_t *dst, duk_uint8_t *dst_end, duk_uint8_t **out_dst_final) {
+	duk_uint_fast32_t t;
+	duk_int_t x, x1, x2, x3;
+	duk_small_uint_t group_idx;
+
+	DUK_UNREF(dst_end);
+
+	for (;;) {
+		/* Fast path: whole groups without whitespace or padding.  A
+		 * negative table value in any of the four characters makes
+		 * the OR negative and drops to the slow path.
+		 */
+		while (src_end - src >= 4) {
+			x = duk__base64_dectab[src[0]];
+			x1 = duk__base64_dectab[src[1]];
+			x2 = duk__base64_dectab[src[2]];
+			x3 = duk__base64_dectab[src[3]];
+			if (DUK_UNLIKELY((x | x1 | x2 | x3) < 0)) {
+				break;
+			}
+			t = ((duk_uint_fast32_t) x << 18) | ((duk_uint_fast32_t) x1 << 12) |
+			    ((duk_uint_fast32_t) x2 << 6) | (duk_uint_fast32_t) x3;
+			DUK_ASSERT(dst + 3 <= dst_end);
+			dst[0] = (duk_uint8_t) (t >> 16);
+			dst[1] = (duk_uint8_t) ((t >> 8) & 0xff);
+			dst[2] = (duk_uint8_t) (t & 0xff);
+			src += 4;
+			dst += 3;
+		}
+
+		/* Slow path: one character at a time until the end of the
+		 * next group, then back to the fast path.
+		 */
+		t = 0;
+		group_idx = 0;
+		for (;;) {
+			if (src >= src_end) {
+				if (group_idx != 0) {
+					/* Unpadded base64 (e.g. "xxxxyy" instead
+					 * of "xxxxyy==") is not accepted.
+					 */
+					goto error;
+				}
+				goto done;
+			}
+
+			x = duk__base64_dectab[*src++];
+			if (x >= 0) {
+				t = (t << 6) + (duk_uint_fast32_t) x;
+				if (group_idx == 3) {
+					DUK_ASSERT(dst + 3 <= dst_end);
+					dst[0] = (duk_uint8_t) ((t >> 16) & 0xff);
+					dst[1] = (duk_uint8_t) ((t >> 8) & 0xff);
+					dst[2] = (duk_uint8_t) (t & 0xff);
+					dst += 3;
+					break;
+				}
+				group_idx++;
+			} else if (x == -2) {
+				/* allow basic ASCII whitespace */
+				continue;
+			} else if (x == -3) {
+				/* Padding; zero padding bits are not checked.
+				 * Parsing continues after the group in case
+				 * several padded base64 strings have been
+				 * concatenated.
+				 */
+				if (group_idx == 2) {
+					/* xx== -> 1 byte, t contains 12 bits, 4 on right are zero */
+					DUK_ASSERT(dst < dst_end);
+					*dst++ = (duk_uint8_t) ((t >> 4) & 0xff);
+					if (src >= src_end || *src++ != (duk_uint8_t) '=') {
+						goto error;
+					}
+				} else if (group_idx == 3) {
+					/* xxx= -> 2 bytes, t contains 18 bits, 2 on right are zero */
+					t = t >> 2;
+					DUK_ASSERT(dst + 2 <= dst_end);
+					dst[0] = (duk_uint8_t) ((t >> 8) & 0xff);
+					dst[1] = (duk_uint8_t) (t & 0xff);
+					dst += 2;
+				} else {
+					goto error;
+				}
+				break;
+			} else {
+				goto error;
+			}
+		}
+	}
+
+ done:
+	*out_dst_final = dst;
+	return 1;
+
+ error:
+	return 0;
+}
+#else  /* DUK_USE_BASE64_FASTPATH */
 DUK_LOCAL duk_bool_t duk__base64_decode_helper(const duk_uint8_t *src, const duk_uint8_t *src_end,
                                                duk_uint8_t *dst, duk_uint8_t *dst_end, duk_uint8_t **out_dst_final) {
 	duk_uint_fast32_t t;
@@ -163,21 +414,22 @@ DUK_LOCAL duk_bool_t duk__base64_decode_helper(const duk_uint8_t *src, const duk
  error:
 	return 0;
 }
+#endif  /* DUK_USE_BASE64_FASTPATH */
 
 DUK_EXTERNAL const char *duk_base64_encode(duk_context *ctx, duk_idx_t index) {
 	duk_hthread *thr = (duk_hthread *) ctx;
-	duk_uint8_t *src;
+	const duk_uint8_t *src;
 	duk_size_t srclen;
 	duk_size_t dstlen;
 	duk_uint8_t *dst;
 	const char *ret;
 
-	/* XXX: optimize for string inputs: no need to coerce to a buffer
-	 * which makes a copy of the input.
+	/* String inputs are encoded directly without coercing them to a
+	 * buffer first, which would copy the input.
 	 */
 
 	index = duk_require_normalize_index(ctx, index);
-	src = (duk_uint8_t *) duk_to_buffer(ctx, index, &srclen);
+	src = duk__prep_codec_arg(ctx, index, &srclen);
 	/* Note: for srclen=0, src may be NULL */
 
 	/* Computation must not wrap; this limit works for 32-bit size_t:
@@ -191,8 +443,7 @@ DUK_EXTERNAL const char *duk_base64_encode(duk_context *ctx, duk_idx_t index) {
 	dstlen = (srclen + 2) / 3 * 4;
 	dst = (duk_uint8_t *) duk_push_fixed_buffer(ctx, dstlen);
 
-	duk__base64_encode_helper((const duk_uint8_t *) src, (const duk_uint8_t *) (src + srclen),
-	                          dst, (dst + dstlen));
+	duk__base64_encode_helper(src, src + srclen, dst, dst + dstlen);
 
 	ret = duk_to_string(ctx, -1);
 	duk_replace(ctx, index);
@@ -203,6 +454,46 @@ DUK_EXTERNAL const char *duk_base64_encode(duk_context *ctx, duk_idx_t index) {
 	return NULL;  /* never here */
 }
 
+/* Encode to a callback in fixed size chunks, so that neither the result
+ * string nor an intermediate buffer needs to be allocated.  The value at
+ * 'index' is not modified.
+ */
+DUK_EXTERNAL duk_size_t duk_base64_encode_to_sink(duk_context *ctx, duk_idx_t index, duk_json_write_function write_cb, void *udata) {
+	duk_hthread *thr = (duk_hthread *) ctx;
+	duk_uint8_t chunk[DUK__BASE64_SINK_CHUNK];
+	const duk_uint8_t *src;
+	duk_size_t srclen;
+	duk_size_t off;
+	duk_size_t n;
+	duk_size_t total = 0;
+
+	index = duk_require_normalize_index(ctx, index);
+	if (write_cb == NULL) {
+		DUK_ERROR(thr, DUK_ERR_API_ERROR, DUK_STR_INVALID_CALL_ARGS);
+	}
+
+	duk_dup(ctx, index);  /* coerced in place if not a buffer or a string */
+	for (off = 0; ; off += n) {
+		/* Look up data pointer and size for each chunk: the callback
+		 * may have resized a dynamic input buffer.
+		 */
+		src = duk__prep_codec_arg(ctx, -1, &srclen);
+		if (off >= srclen) {
+			break;
+		}
+		n = srclen - off;
+		if (n > DUK__BASE64_SINK_CHUNK / 4 * 3) {
+			n = DUK__BASE64_SINK_CHUNK / 4 * 3;
+		}
+		duk__base64_encode_helper(src + off, src + off + n, chunk, chunk + (n + 2) / 3 * 4);
+		write_cb(udata, (const char *) chunk, (n + 2) / 3 * 4);
+		total += (n + 2) / 3 * 4;
+	}
+	duk_pop(ctx);
+
+	return total;
+}
+
 DUK_EXTERNAL void duk_base64_decode(duk_context *ctx, duk_idx_t index) {
 	duk_hthread *thr = (duk_hthread *) ctx;
 	const duk_uint8_t *src;
@@ -212,12 +503,12 @@ DUK_EXTERNAL void duk_base64_decode(duk_context *ctx, duk_idx_t index) {
 	duk_uint8_t *dst_final;
 	duk_bool_t retval;
 
-	/* XXX: optimize for buffer inputs: no need to coerce to a string
-	 * which causes an unnecessary interning.
+	/* Buffer inputs are decoded directly without coercing them to a
+	 * string first, which would copy and intern the input.
 	 */
 
 	index = duk_require_normalize_index(ctx, index);
-	src = (const duk_uint8_t *) duk_to_lstring(ctx, index, &srclen);
+	src = duk__prep_codec_arg(ctx, index, &srclen);
 
 	/* Computation must not wrap, only srclen + 3 is at risk of
 	 * wrapping because after that the number gets smaller.
@@ -231,8 +522,7 @@ DUK_EXTERNAL void duk_base64_decode(duk_context *ctx, duk_idx_t index) {
 	dst = (duk_uint8_t *) duk_push_dynamic_buffer(ctx, dstlen);
 	/* Note: for dstlen=0, dst may be NULL */
 
-	retval = duk__base64_decode_helper((const duk_uint8_t *) src, (const duk_uint8_t *) (src + srclen),
-	                                   dst, dst + dstlen, &dst_final);
+	retval = duk__base64_decode_helper(src, src + srclen, dst, dst + dstlen, &dst_final);
 	if (!retval) {
 		goto type_error;
 	}
@@ -247,28 +537,50 @@ DUK_EXTERNAL void duk_base64_decode(duk_context *ctx, duk_idx_t index) {
 }
 
 DUK_EXTERNAL const char *duk_hex_encode(duk_context *ctx, duk_idx_t index) {
-	duk_uint8_t *data;
+	const duk_uint8_t *inp;
 	duk_size_t len;
 	duk_size_t i;
-	duk_uint_fast8_t t;
 	duk_uint8_t *buf;
 	const char *ret;
-
-	/* XXX: special case for input string, no need to coerce to buffer */
+#if defined(DUK_USE_HEX_FASTPATH)
+	duk_size_t len_safe;
+	duk_uint16_t *p16;
+#else
+	duk_uint_fast8_t t;
+#endif
 
 	index = duk_require_normalize_index(ctx, index);
-	data = (duk_uint8_t *) duk_to_buffer(ctx, index, &len);
-	DUK_ASSERT(data != NULL);
+	inp = duk__prep_codec_arg(ctx, index, &len);
+	DUK_ASSERT(inp != NULL || len == 0);
 
 	buf = (duk_uint8_t *) duk_push_fixed_buffer(ctx, len * 2);
 	DUK_ASSERT(buf != NULL);
 	/* buf is always zeroed */
 
+#if defined(DUK_USE_HEX_FASTPATH)
+	/* Fixed buffer data is aligned by at least 4, so two-byte table
+	 * entries can be stored directly.
+	 */
+	DUK_ASSERT((((duk_uintptr_t) (void *) buf) & 0x01U) == 0);
+	p16 = (duk_uint16_t *) (void *) buf;
+	len_safe = len & ~((duk_size_t) 0x03U);
+	for (i = 0; i < len_safe; i += 4) {
+		p16[0] = duk_hex_enctab[inp[i]];
+		p16[1] = duk_hex_enctab[inp[i + 1]];
+		p16[2] = duk_hex_enctab[inp[i + 2]];
+		p16[3] = duk_hex_enctab[inp[i + 3]];
+		p16 += 4;
+	}
+	for (; i < len; i++) {
+		*p16++ = duk_hex_enctab[inp[i]];
+	}
+#else  /* DUK_USE_HEX_FASTPATH */
 	for (i = 0; i < len; i++) {
-		t = (duk_uint_fast8_t) data[i];
+		t = (duk_uint_fast8_t) inp[i];
 		buf[i*2 + 0] = duk_lc_digits[t >> 4];
 		buf[i*2 + 1] = duk_lc_digits[t & 0x0f];
 	}
+#endif  /* DUK_USE_HEX_FASTPATH */
 
 	ret = duk_to_string(ctx, -1);
 	duk_replace(ctx, index);
@@ -277,19 +589,20 @@ DUK_EXTERNAL const char *duk_hex_encode(duk_context *ctx, duk_idx_t index) {
 
 DUK_EXTERNAL void duk_hex_decode(duk_context *ctx, duk_idx_t index) {
 	duk_hthread *thr = (duk_hthread *) ctx;
-	const duk_uint8_t *str;
+	const duk_uint8_t *inp;
 	duk_size_t len;
 	duk_size_t i;
-	duk_small_int_t t;
+	duk_int_t t;
 	duk_uint8_t *buf;
-
-	/* XXX: optimize for buffer inputs: no need to coerce to a string
-	 * which causes an unnecessary interning.
-	 */
+#if defined(DUK_USE_HEX_FASTPATH)
+	duk_int_t chk;
+	duk_uint8_t *p;
+	duk_size_t len_safe;
+#endif
 
 	index = duk_require_normalize_index(ctx, index);
-	str = (const duk_uint8_t *) duk_to_lstring(ctx, index, &len);
-	DUK_ASSERT(str != NULL);
+	inp = duk__prep_codec_arg(ctx, index, &len);
+	DUK_ASSERT(inp != NULL || len == 0);
 
 	if (len & 0x01) {
 		goto type_error;
@@ -299,8 +612,40 @@ DUK_EXTERNAL void duk_hex_decode(duk_context *ctx, duk_idx_t index) {
 	DUK_ASSERT(buf != NULL);
 	/* buf is always zeroed */
 
+#if defined(DUK_USE_HEX_FASTPATH)
+	/* Four output bytes per round, an invalid digit makes the combined
+	 * value (and thus 'chk') negative.
+	 */
+	p = buf;
+	len_safe = len & ~((duk_size_t) 0x07U);
+	for (i = 0; i < len_safe; i += 8) {
+		t = ((duk_int_t) duk__hex_dectab_shift4[inp[i]]) | ((duk_int_t) duk_hex_dectab[inp[i + 1]]);
+		chk = t;
+		p[0] = (duk_uint8_t) t;
+		t = ((duk_int_t) duk__hex_dectab_shift4[inp[i + 2]]) | ((duk_int_t) duk_hex_dectab[inp[i + 3]]);
+		chk |= t;
+		p[1] = (duk_uint8_t) t;
+		t = ((duk_int_t) duk__hex_dectab_shift4[inp[i + 4]]) | ((duk_int_t) duk_hex_dectab[inp[i + 5]]);
+		chk |= t;
+		p[2] = (duk_uint8_t) t;
+		t = ((duk_int_t) duk__hex_dectab_shift4[inp[i + 6]]) | ((duk_int_t) duk_hex_dectab[inp[i + 7]]);
+		chk |= t;
+		p[3] = (duk_uint8_t) t;
+		if (DUK_UNLIKELY(chk < 0)) {
+			goto type_error;
+		}
+		p += 4;
+	}
+	for (; i < len; i += 2) {
+		t = ((duk_int_t) duk__hex_dectab_shift4[inp[i]]) | ((duk_int_t) duk_hex_dectab[inp[i + 1]]);
+		if (DUK_UNLIKELY(t < 0)) {
+			goto type_error;
+		}
+		*p++ = (duk_uint8_t) t;
+	}
+#else  /* DUK_USE_HEX_FASTPATH */
 	for (i = 0; i < len; i++) {
-		t = str[i];
+		t = inp[i];
 		DUK_ASSERT(t >= 0 && t <= 0xff);
 		t = duk_hex_dectab[t];
 		if (DUK_UNLIKELY(t < 0)) {
@@ -313,6 +658,7 @@ DUK_EXTERNAL void duk_hex_decode(duk_context *ctx, duk_idx_t index) {
 			buf[i >> 1] = (duk_uint8_t) (t << 4);
 		}
 	}
+#endif  /* DUK_USE_HEX_FASTPATH */
 
 	duk_replace(ctx, index);
 	return;
@@ -332,7 +678,9 @@ DUK_EXTERNAL const char *duk_json_encode(duk_context *ctx, duk_idx_t index) {
 	                             index /*idx_value*/,
 	                             DUK_INVALID_INDEX /*idx_replacer*/,
 	                             DUK_INVALID_INDEX /*idx_space*/,
-	                             0 /*flags*/);
+	                             0 /*flags*/,
+	                             NULL /*write_cb*/,
+	                             NULL /*write_udata*/);
 	DUK_ASSERT(duk_is_string(ctx, -1));
 	duk_replace(ctx, index);
 	ret = duk_get_string(ctx, index);
@@ -342,6 +690,55 @@ DUK_EXTERNAL const char *duk_json_encode(duk_context *ctx, duk_idx_t index) {
 	return ret;
 }
 
+DUK_EXTERNAL duk_bool_t duk_json_encode_to_sink(duk_context *ctx, duk_idx_t index, duk_uint_t flags, duk_json_write_function write_cb, void *udata) {
+	duk_hthread *thr = (duk_hthread *) ctx;
+#ifdef DUK_USE_ASSERTIONS
+	duk_idx_t top_at_entry = duk_get_top(ctx);
+#endif
+	duk_small_uint_t enc_flags;
+	duk_bool_t ret;
+
+	index = duk_require_normalize_index(ctx, index);
+	if (write_cb == NULL) {
+		goto invalid_args;
+	}
+
+	if (flags == 0) {
+		enc_flags = 0;
+#ifdef DUK_USE_JX
+	} else if (flags == DUK_JSON_ENCODE_JX) {
+		enc_flags = DUK_JSON_FLAG_EXT_CUSTOM |
+		            DUK_JSON_FLAG_ASCII_ONLY |
+		            DUK_JSON_FLAG_AVOID_KEY_QUOTES;
+#endif
+#ifdef DUK_USE_JC
+	} else if (flags == DUK_JSON_ENCODE_JC) {
+		enc_flags = DUK_JSON_FLAG_EXT_COMPATIBLE |
+		            DUK_JSON_FLAG_ASCII_ONLY;
+#endif
+	} else {
+		goto invalid_args;
+	}
+
+	duk_bi_json_stringify_helper(ctx,
+	                             index /*idx_value*/,
+	                             DUK_INVALID_INDEX /*idx_replacer*/,
+	                             DUK_INVALID_INDEX /*idx_space*/,
+	                             enc_flags /*flags*/,
+	                             write_cb,
+	                             udata /*write_udata*/);
+	ret = !duk_is_undefined(ctx, -1);
+	duk_pop(ctx);
+
+	DUK_ASSERT(duk_get_top(ctx) == top_at_entry);
+
+	return ret;
+
+ invalid_args:
+	DUK_ERROR(thr, DUK_ERR_API_ERROR, DUK_STR_INVALID_CALL_ARGS);
+	return 0;  /* not reachable */
+}
+
 DUK_EXTERNAL void duk_json_decode(duk_context *ctx, duk_idx_t index) {
 #ifdef DUK_USE_ASSERTIONS
 	duk_idx_t top_at_entry = duk_get_top(ctx);
@@ -28,7 +28,9 @@ DUK_EXTERNAL void duk_push_context_dump(duk_context *ctx) {
 	                             DUK_INVALID_INDEX,  /*idx_space*/
 	                             DUK_JSON_FLAG_EXT_CUSTOM |
 	                             DUK_JSON_FLAG_ASCII_ONLY |
-	                             DUK_JSON_FLAG_AVOID_KEY_QUOTES /*flags*/);
+	                             DUK_JSON_FLAG_AVOID_KEY_QUOTES,  /*flags*/
+	                             NULL,  /*write_cb*/
+	                             NULL  /*write_udata*/);
 
 	duk_push_sprintf(ctx, "ctx: top=%ld, stack=%s", (long) top, (const char *) duk_safe_to_string(ctx, -1));
 	duk_replace(ctx, -3);  /* [ ... arr jsonx(arr) res ] -> [ ... res jsonx(arr) ] */
@@ -10,6 +10,16 @@ duk_context *duk_create_heap(duk_alloc_function alloc_func,
                              duk_free_function free_func,
                              void *alloc_udata,
                              duk_fatal_function fatal_handler) {
+	return duk_create_heap_ex(alloc_func, realloc_func, free_func, alloc_udata, fatal_handler, NULL);
+}
+
+DUK_EXTERNAL
+duk_context *duk_create_heap_ex(duk_alloc_function alloc_func,
+                                duk_realloc_function realloc_func,
+                                duk_free_function free_func,
+                                void *alloc_udata,
+                                duk_fatal_function fatal_handler,
+                                const duk_heap_options *options) {
 	duk_heap *heap = NULL;
 	duk_context *ctx;
 
@@ -41,7 +51,7 @@ duk_context *duk_create_heap(duk_alloc_function alloc_func,
 	DUK_ASSERT(free_func != NULL);
 	DUK_ASSERT(fatal_handler != NULL);
 
-	heap = duk_heap_alloc(alloc_func, realloc_func, free_func, alloc_udata, fatal_handler);
+	heap = duk_heap_alloc(alloc_func, realloc_func, free_func, alloc_udata, fatal_handler, options);
 	if (!heap) {
 		return NULL;
 	}
@@ -78,6 +78,224 @@ DUK_EXTERNAL void duk_get_memory_functions(duk_context *ctx, duk_memory_function
 	out_funcs->udata = heap->alloc_udata;
 }
 
+DUK_EXTERNAL duk_bool_t duk_get_slab_stats(duk_context *ctx, duk_slab_stats *out_stats) {
+#if defined(DUK_USE_SLAB_ALLOC)
+	duk_hthread *thr = (duk_hthread *) ctx;
+	duk_slab *slab;
+	duk_small_uint_t i;
+
+	DUK_ASSERT(ctx != NULL);
+	DUK_ASSERT(out_stats != NULL);
+	DUK_ASSERT(thr->heap != NULL);
+
+	slab = &thr->heap->slab;
+	DUK_MEMZERO((void *) out_stats, sizeof(*out_stats));
+	out_stats->page_size = slab->page_size;
+	out_stats->chunk_pages = slab->chunk_pages;
+	out_stats->max_size = slab->max_size;
+	out_stats->chunk_count = slab->chunk_count;
+	out_stats->chunk_bytes = slab->chunk_count * (slab->chunk_pages * slab->page_size + (slab->page_size - 1) + sizeof(duk_slab_chunk));
+	out_stats->free_page_count = slab->free_page_count;
+	out_stats->chunk_alloc_count = slab->chunk_alloc_count;
+	out_stats->chunk_free_count = slab->chunk_free_count;
+	out_stats->class_count = slab->class_count;
+	for (i = 0; i < slab->class_count; i++) {
+		duk_slab_class *cls = slab->classes + i;
+		duk_slab_class_stats *st = out_stats->classes + i;
+
+		st->slot_size = cls->slot_size;
+		st->page_count = cls->page_count;
+		st->used_count = cls->used_count;
+		st->alloc_count = cls->alloc_count;
+		st->free_count = cls->free_count;
+	}
+	return 1;
+#else
+	DUK_ASSERT(ctx != NULL);
+	DUK_ASSERT(out_stats != NULL);
+	DUK_UNREF(ctx);
+
+	DUK_MEMZERO((void *) out_stats, sizeof(*out_stats));
+	return 0;
+#endif
+}
+
+/* Accumulate statistics for a heap object list.  TEMPROOT is used to count
+ * shared function data buffers only once, see duk__heap_stats_clear_list().
+ * This is safe because the flag is only used by the mark phase which never
+ * calls out to user code.
+ */
+DUK_LOCAL duk_size_t duk__heap_stats_add_list(duk_heap *heap, duk_heaphdr *curr, duk_heap_stats *st) {
+	duk_size_t count = 0;
+
+	DUK_UNREF(heap);
+
+	for (; curr != NULL; curr = DUK_HEAPHDR_GET_NEXT(curr)) {
+		duk_size_t size;
+
+		count++;
+		size = duk_heap_get_heaphdr_alloc_size(curr);
+
+		switch ((int) DUK_HEAPHDR_GET_TYPE(curr)) {
+		case DUK_HTYPE_OBJECT: {
+			duk_hobject *h = (duk_hobject *) curr;
+			duk_heap_stats_class *cls;
+
+			size += DUK_HOBJECT_E_ALLOC_SIZE(h);
+			st->object_count++;
+			st->object_bytes += size;
+			cls = st->classes + DUK_HOBJECT_GET_CLASS_NUMBER(h);
+			cls->count++;
+			cls->bytes += size;
+
+			if (DUK_HOBJECT_IS_COMPILEDFUNCTION(h)) {
+				duk_hcompiledfunction *f = (duk_hcompiledfunction *) h;
+				duk_hbuffer *data = (duk_hbuffer *) DUK_HCOMPILEDFUNCTION_GET_DATA(f);
+
+				st->function_count++;
+				if (data != NULL && !DUK_HEAPHDR_HAS_TEMPROOT((duk_heaphdr *) data)) {
+					DUK_HEAPHDR_SET_TEMPROOT((duk_heaphdr *) data);
+					st->function_data_count++;
+					st->function_data_bytes += duk_heap_get_heaphdr_alloc_size((duk_heaphdr *) data);
+					st->bytecode_bytes += DUK_HCOMPILEDFUNCTION_GET_CODE_SIZE(f);
+					st->constant_count += DUK_HCOMPILEDFUNCTION_GET_CONSTS_COUNT(f);
+				}
+			} else if (DUK_HOBJECT_IS_THREAD(h)) {
+				duk_hthread *t = (duk_hthread *) h;
+
+				st->thread_count++;
+				st->thread_stack_bytes += (duk_size_t) (t->valstack_end - t->valstack) * sizeof(duk_tval) +
+				                          t->callstack_size * sizeof(duk_activation) +
+				                          t->catchstack_size * sizeof(duk_catcher);
+			}
+			break;
+		}
+		case DUK_HTYPE_BUFFER: {
+			duk_hbuffer *h = (duk_hbuffer *) curr;
+
+			if (DUK_HBUFFER_HAS_DYNAMIC(h) && !DUK_HBUFFER_HAS_EXTERNAL(h)) {
+				size += DUK_HBUFFER_DYNAMIC_GET_ALLOC_SIZE((duk_hbuffer_dynamic *) h);
+			}
+			st->buffer_count++;
+			st->buffer_bytes += size;
+			break;
+		}
+		default: {
+			/* strings are only in the string table */
+			DUK_UNREACHABLE();
+			break;
+		}
+		}
+	}
+
+	return count;
+}
+
+DUK_LOCAL void duk__heap_stats_clear_list(duk_heap *heap, duk_heaphdr *curr) {
+	DUK_UNREF(heap);
+
+	for (; curr != NULL; curr = DUK_HEAPHDR_GET_NEXT(curr)) {
+		if (DUK_HEAPHDR_GET_TYPE(curr) == DUK_HTYPE_OBJECT &&
+		    DUK_HOBJECT_IS_COMPILEDFUNCTION((duk_hobject *) curr)) {
+			duk_heaphdr *data = (duk_heaphdr *) DUK_HCOMPILEDFUNCTION_GET_DATA((duk_hcompiledfunction *) curr);
+			if (data != NULL) {
+				DUK_HEAPHDR_CLEAR_TEMPROOT(data);
+			}
+		}
+	}
+}
+
+DUK_EXTERNAL void duk_get_heap_stats(duk_context *ctx, duk_heap_stats *out_stats) {
+	duk_hthread *thr = (duk_hthread *) ctx;
+	duk_heap *heap;
+	duk_heap_stats *st = out_stats;
+#if defined(DUK_USE_MARK_AND_SWEEP)
+	duk_heaphdr *curr;
+#endif
+	duk_uint_fast32_t i;
+
+	DUK_ASSERT(ctx != NULL);
+	DUK_ASSERT(out_stats != NULL);
+	DUK_ASSERT(thr->heap != NULL);
+
+	heap = thr->heap;
+	DUK_MEMZERO((void *) st, sizeof(*st));
+
+	for (i = 0; i < DUK_HEAP_STATS_MAX_CLASSES; i++) {
+		duk_hstring *h_name = DUK_HTHREAD_GET_STRING(thr, DUK_HOBJECT_CLASS_NUMBER_TO_STRIDX(i));
+		if (DUK_HSTRING_GET_BYTELEN(h_name) > 0) {
+			st->classes[i].name = (const char *) DUK_HSTRING_GET_DATA(h_name);
+		}
+	}
+
+	/* objects and buffers */
+	st->heap_allocated_count = duk__heap_stats_add_list(heap, heap->heap_allocated, st);
+#if defined(DUK_USE_REFERENCE_COUNTING)
+	st->refzero_list_count = duk__heap_stats_add_list(heap, heap->refzero_list, st);
+#endif
+#if defined(DUK_USE_MARK_AND_SWEEP)
+	st->finalize_list_count = duk__heap_stats_add_list(heap, heap->finalize_list, st);
+#endif
+	duk__heap_stats_clear_list(heap, heap->heap_allocated);
+#if defined(DUK_USE_REFERENCE_COUNTING)
+	duk__heap_stats_clear_list(heap, heap->refzero_list);
+#endif
+#if defined(DUK_USE_MARK_AND_SWEEP)
+	duk__heap_stats_clear_list(heap, heap->finalize_list);
+#endif
+#if defined(DUK_USE_MARK_AND_SWEEP)
+	/* Objects on the sweep free list are only counted: they're already
+	 * garbage and their contents may refer to freed objects.
+	 */
+	for (curr = heap->sweep_free_list; curr != NULL; curr = DUK_HEAPHDR_GET_NEXT(curr)) {
+		st->sweep_free_list_count++;
+	}
+#endif
+
+	/* strings */
+	st->strtab_size = heap->st_size;
+#if defined(DUK_USE_HEAPPTR16)
+	st->strtab_bytes = heap->st_size * sizeof(duk_uint16_t);
+#else
+	st->strtab_bytes = heap->st_size * sizeof(duk_hstring *);
+#endif
+	for (i = 0; i < (duk_uint_fast32_t) heap->st_size; i++) {
+		duk_hstring *h;
+#if defined(DUK_USE_HEAPPTR16)
+		h = (duk_hstring *) DUK_USE_HEAPPTR_DEC16(heap->strtable16[i]);
+#else
+		h = heap->strtable[i];
+#endif
+		if (h == NULL) {
+			continue;
+		} else if (h == DUK_STRTAB_DELETED_MARKER(heap)) {
+			st->strtab_deleted++;
+			continue;
+		}
+		st->strtab_used++;
+		st->string_count++;
+		st->string_bytes += duk_heap_get_heaphdr_alloc_size((duk_heaphdr *) h);
+	}
+
+#if defined(DUK_USE_MARK_AND_SWEEP)
+	st->ms_count = heap->mark_and_sweep_count;
+	st->ms_emergency_count = heap->mark_and_sweep_emergency_count;
+	st->ms_time_total = heap->mark_and_sweep_time_total;
+	st->ms_time_last = heap->mark_and_sweep_time_last;
+	st->ms_time_max = heap->mark_and_sweep_time_max;
+#endif
+
+	st->total_bytes = st->string_bytes + st->object_bytes + st->buffer_bytes +
+	                  st->thread_stack_bytes + st->strtab_bytes + sizeof(duk_heap);
+
+	if (heap->mem_alloc_func) {
+		st->mem_used = heap->mem_used;
+		st->mem_peak = heap->mem_peak;
+		st->mem_limit_soft = (heap->mem_limit_soft == DUK_SIZE_MAX ? 0 : heap->mem_limit_soft);
+		st->mem_limit_hard = (heap->mem_limit_hard == DUK_SIZE_MAX ? 0 : heap->mem_limit_hard);
+	}
+}
+
 DUK_EXTERNAL void duk_gc(duk_context *ctx, duk_uint_t flags) {
 #ifdef DUK_USE_MARK_AND_SWEEP
 	duk_hthread *thr = (duk_hthread *) ctx;
@@ -92,10 +310,160 @@ DUK_EXTERNAL void duk_gc(duk_context *ctx, duk_uint_t flags) {
 	DUK_ASSERT(heap != NULL);
 
 	DUK_D(DUK_DPRINT("mark-and-sweep requested by application"));
-	duk_heap_mark_and_sweep(heap, 0);
+	duk_heap_mark_and_sweep(heap, DUK_MS_REASON(DUK_GC_REASON_EXPLICIT));
 #else
 	DUK_D(DUK_DPRINT("mark-and-sweep requested by application but mark-and-sweep not enabled, ignoring"));
 	DUK_UNREF(ctx);
 	DUK_UNREF(flags);
 #endif
 }
+
+DUK_EXTERNAL void duk_set_gc_hook(duk_context *ctx, duk_gc_hook_function hook, void *udata) {
+#ifdef DUK_USE_MARK_AND_SWEEP
+	duk_hthread *thr = (duk_hthread *) ctx;
+	duk_heap *heap;
+
+	DUK_ASSERT(ctx != NULL);
+	heap = thr->heap;
+	DUK_ASSERT(heap != NULL);
+
+	heap->gc_hook = hook;
+	heap->gc_hook_udata = (hook != NULL ? udata : NULL);
+#else
+	/* no mark-and-sweep, the hook would never be called */
+	DUK_UNREF(ctx);
+	DUK_UNREF(hook);
+	DUK_UNREF(udata);
+#endif
+}
+
+DUK_EXTERNAL void duk_get_gc_policy(duk_context *ctx, duk_gc_policy *out_policy) {
+#ifdef DUK_USE_MARK_AND_SWEEP
+	duk_hthread *thr = (duk_hthread *) ctx;
+	duk_heap *heap;
+
+	DUK_ASSERT(ctx != NULL);
+	DUK_ASSERT(out_policy != NULL);
+	heap = thr->heap;
+	DUK_ASSERT(heap != NULL);
+
+	*out_policy = heap->gc_policy;
+#else
+	DUK_UNREF(ctx);
+	DUK_ASSERT(out_policy != NULL);
+	DUK_MEMZERO((void *) out_policy, sizeof(*out_policy));
+#endif
+}
+
+DUK_EXTERNAL void duk_set_gc_policy(duk_context *ctx, const duk_gc_policy *policy) {
+#ifdef DUK_USE_MARK_AND_SWEEP
+	duk_hthread *thr = (duk_hthread *) ctx;
+	duk_heap *heap;
+	duk_gc_policy *p;
+
+	DUK_ASSERT(ctx != NULL);
+	heap = thr->heap;
+	DUK_ASSERT(heap != NULL);
+
+	if (policy == NULL) {
+		duk_heap_gc_policy_init(heap);
+		return;
+	}
+
+	p = &heap->gc_policy;
+	*p = *policy;
+	if (!(p->min_interval > 0.0)) {  /* also NaN */
+		p->min_interval = 0.0;
+	}
+	if (!(p->idle_threshold > 0.0)) {
+		p->idle_threshold = 0.0;
+	} else if (p->idle_threshold > 1.0) {
+		p->idle_threshold = 1.0;
+	}
+
+	if (p->sweep_step == 0) {
+		/* deferred freeing disabled, don't leave anything behind */
+		(void) duk_heap_free_deferred(heap, 0);
+	}
+#ifdef DUK_USE_REFERENCE_COUNTING
+	if (p->refzero_step == 0 && heap->refzero_list != NULL) {
+		/* batching disabled, finish pending refzero work */
+		duk_heap_refzero_process_pending(thr, 1 /*all*/);
+	}
+#endif
+
+	/* The trigger counter is recomputed at the end of the next round;
+	 * the byte trigger takes effect immediately.
+	 */
+#ifdef DUK_USE_VOLUNTARY_GC
+	heap->mark_and_sweep_bytes_trigger = (p->trigger_bytes > 0 ? p->trigger_bytes : DUK_SIZE_MAX);
+#endif
+#else
+	/* no mark-and-sweep, nothing to configure */
+	DUK_UNREF(ctx);
+	DUK_UNREF(policy);
+#endif
+}
+
+DUK_EXTERNAL duk_bool_t duk_gc_idle(duk_context *ctx) {
+#ifdef DUK_USE_MARK_AND_SWEEP
+	duk_hthread *thr = (duk_hthread *) ctx;
+	duk_heap *heap;
+	duk_small_uint_t flags;
+	duk_bool_t rc;
+#ifdef DUK_USE_VOLUNTARY_GC
+	duk_double_t used;
+	duk_double_t tmp;
+#endif
+
+	DUK_ASSERT(ctx != NULL);
+	heap = thr->heap;
+	DUK_ASSERT(heap != NULL);
+
+	if (DUK_HEAP_HAS_MARKANDSWEEP_RUNNING(heap)) {
+		return 0;
+	}
+
+	/* Objects left over by a round with deferred freeing or by batched
+	 * refzero processing are freed in any case.
+	 */
+	(void) duk_heap_free_deferred(heap, 0);
+#ifdef DUK_USE_REFERENCE_COUNTING
+	if (heap->refzero_list != NULL) {
+		duk_heap_refzero_process_pending(thr, 1 /*all*/);
+	}
+#endif
+
+#ifdef DUK_USE_VOLUNTARY_GC
+	/* Fraction of the voluntary trigger used up since the previous round,
+	 * based on the operation count or allocated bytes, whichever is
+	 * further along.
+	 */
+	if (heap->mark_and_sweep_trigger_limit > 0) {
+		used = 1.0 - (duk_double_t) heap->mark_and_sweep_trigger_counter /
+		             (duk_double_t) heap->mark_and_sweep_trigger_limit;
+	} else {
+		used = 1.0;
+	}
+	if (heap->mark_and_sweep_bytes_trigger != DUK_SIZE_MAX && heap->gc_policy.trigger_bytes > 0) {
+		tmp = (duk_double_t) heap->mark_and_sweep_bytes / (duk_double_t) heap->gc_policy.trigger_bytes;
+		if (tmp > used) {
+			used = tmp;
+		}
+	}
+	if (used < heap->gc_policy.idle_threshold) {
+		DUK_DD(DUK_DDPRINT("idle gc skipped, %lf of trigger used", (double) used));
+		return 0;
+	}
+#endif
+
+	DUK_D(DUK_DPRINT("mark-and-sweep requested by application when idle"));
+	flags = DUK_MS_REASON(DUK_GC_REASON_IDLE);
+	rc = duk_heap_mark_and_sweep(heap, flags);
+	DUK_UNREF(rc);
+	return 1;
+#else
+	DUK_UNREF(ctx);
+	return 0;
+#endif
+}
@@ -2017,7 +2017,9 @@ DUK_LOCAL void *duk__to_buffer_raw(duk_context *ctx, duk_idx_t index, duk_size_t
 	h_buf = duk_get_hbuffer(ctx, index);
 	if (h_buf != NULL) {
 		/* Buffer is kept as is: note that fixed/dynamic nature of
-		 * the buffer is not changed.
+		 * the buffer is not changed.  An external buffer is neither
+		 * fixed nor dynamic, so it's only kept if the caller doesn't
+		 * care.
 		 */
 		duk_small_int_t tmp;
 
@@ -2025,7 +2027,7 @@ DUK_LOCAL void *duk__to_buffer_raw(duk_context *ctx, duk_idx_t index, duk_size_t
 		src_size = DUK_HBUFFER_GET_SIZE(h_buf);
 
 		tmp = (DUK_HBUFFER_HAS_DYNAMIC(h_buf) ? 1 : 0);
-		if (((tmp ^ buf_dynamic) == 0) || buf_dontcare) {
+		if ((((tmp ^ buf_dynamic) == 0) && !DUK_HBUFFER_HAS_EXTERNAL(h_buf)) || buf_dontcare) {
 			/* Note: src_data may be NULL if input is a zero-size
 			 * dynamic buffer.
 			 */
@@ -2496,7 +2498,7 @@ DUK_EXTERNAL duk_bool_t duk_is_dynamic_buffer(duk_context *ctx, duk_idx_t index)
 	if (DUK_TVAL_IS_BUFFER(tv)) {
 		duk_hbuffer *h = DUK_TVAL_GET_BUFFER(tv);
 		DUK_ASSERT(h != NULL);
-		return (DUK_HBUFFER_HAS_DYNAMIC(h) ? 1 : 0);
+		return (DUK_HBUFFER_IS_RESIZABLE(h) ? 1 : 0);
 	}
 	return 0;
 }
@@ -2515,6 +2517,20 @@ DUK_EXTERNAL duk_bool_t duk_is_fixed_buffer(duk_context *ctx, duk_idx_t index) {
 	return 0;
 }
 
+DUK_EXTERNAL duk_bool_t duk_is_external_buffer(duk_context *ctx, duk_idx_t index) {
+	duk_tval *tv;
+
+	DUK_ASSERT(ctx != NULL);
+
+	tv = duk_get_tval(ctx, index);
+	if (DUK_TVAL_IS_BUFFER(tv)) {
+		duk_hbuffer *h = DUK_TVAL_GET_BUFFER(tv);
+		DUK_ASSERT(h != NULL);
+		return (DUK_HBUFFER_HAS_EXTERNAL(h) ? 1 : 0);
+	}
+	return 0;
+}
+
 /* XXX: make macro in API */
 DUK_EXTERNAL duk_bool_t duk_is_primitive(duk_context *ctx, duk_idx_t index) {
 	DUK_ASSERT(ctx != NULL);
@@ -2684,6 +2700,55 @@ DUK_EXTERNAL const char *duk_push_lstring(duk_context *ctx, const char *str, duk
 	return (const char *) DUK_HSTRING_GET_DATA(h);
 }
 
+/* Like duk_push_lstring() but without copying the string data when the
+ * string is not yet interned and external strings are enabled.  'str' must
+ * be NUL terminated (str[len] == 0).  Once the push succeeds, ownership
+ * of 'str' has moved to Duktape: if 'str' was not taken into use (equal
+ * string already interned, external strings disabled), 'release_func' is
+ * called before returning.  If an error is thrown, the caller still owns
+ * 'str'.
+ */
+DUK_EXTERNAL const char *duk_push_external_lstring(duk_context *ctx, const char *str, duk_size_t len, duk_free_function release_func, void *udata) {
+	duk_hthread *thr = (duk_hthread *) ctx;
+	duk_hstring *h;
+	duk_tval *tv_slot;
+	duk_bool_t used;
+
+	DUK_ASSERT(ctx != NULL);
+
+	if (thr->valstack_top >= thr->valstack_end) {
+		DUK_ERROR(thr, DUK_ERR_API_ERROR, DUK_STR_PUSH_BEYOND_ALLOC_STACK);
+	}
+	if (str == NULL || str[len] != (char) 0) {
+		DUK_ERROR(thr, DUK_ERR_API_ERROR, DUK_STR_INVALID_CALL_ARGS);
+	}
+	if (len > DUK_HSTRING_MAX_BYTELEN) {
+		DUK_ERROR(thr, DUK_ERR_RANGE_ERROR, DUK_STR_STRING_TOO_LONG);
+	}
+
+#if defined(DUK_USE_HSTRING_EXTDATA)
+	h = duk_heap_string_intern_external(thr->heap, (duk_uint8_t *) str, (duk_uint32_t) len, release_func, udata, &used);
+	if (!h) {
+		DUK_ERROR(thr, DUK_ERR_ALLOC_ERROR, "failed to intern string");
+	}
+#else
+	h = duk_heap_string_intern_checked(thr, (duk_uint8_t *) str, (duk_uint32_t) len);
+	used = 0;
+#endif
+	DUK_ASSERT(h != NULL);
+
+	tv_slot = thr->valstack_top;
+	DUK_TVAL_SET_STRING(tv_slot, h);
+	DUK_HSTRING_INCREF(thr, h);
+	thr->valstack_top++;
+
+	if (!used && release_func != NULL) {
+		release_func(udata, (void *) str);
+	}
+
+	return (const char *) DUK_HSTRING_GET_DATA(h);
+}
+
 DUK_EXTERNAL const char *duk_push_string(duk_context *ctx, const char *str) {
 	DUK_ASSERT(ctx != NULL);
 
@@ -3068,6 +3133,68 @@ DUK_INTERNAL duk_idx_t duk_push_object_helper_proto(duk_context *ctx, duk_uint_t
 	return ret;
 }
 
+/* Push a buffer object (ArrayBuffer, DataView, typed array).  The caller
+ * must initialize the 'buf' field before the object is exposed to any
+ * code which may read it.
+ */
+DUK_INTERNAL duk_hbufferobject *duk_push_bufferobject_raw(duk_context *ctx, duk_uint_t hobject_flags_and_class, duk_small_int_t prototype_bidx) {
+	duk_hthread *thr = (duk_hthread *) ctx;
+	duk_hbufferobject *h;
+	duk_tval *tv_slot;
+
+	DUK_ASSERT(ctx != NULL);
+	DUK_ASSERT(prototype_bidx >= 0 && prototype_bidx < DUK_NUM_BUILTINS);
+
+	/* check stack first */
+	if (thr->valstack_top >= thr->valstack_end) {
+		DUK_ERROR(thr, DUK_ERR_API_ERROR, DUK_STR_PUSH_BEYOND_ALLOC_STACK);
+	}
+
+	h = duk_hbufferobject_alloc(thr->heap, hobject_flags_and_class | DUK_HOBJECT_FLAG_BUFFEROBJECT);
+	if (!h) {
+		DUK_ERROR(thr, DUK_ERR_ALLOC_ERROR, DUK_STR_OBJECT_ALLOC_FAILED);
+	}
+
+	tv_slot = thr->valstack_top;
+	DUK_TVAL_SET_OBJECT(tv_slot, (duk_hobject *) h);
+	DUK_HOBJECT_INCREF(thr, (duk_hobject *) h);
+	thr->valstack_top++;
+
+	DUK_HOBJECT_SET_PROTOTYPE_UPDREF(thr, (duk_hobject *) h, thr->builtins[prototype_bidx]);
+
+	return h;
+}
+
+#if defined(DUK_USE_WEAK_REFERENCES)
+DUK_INTERNAL duk_hweakobject *duk_push_weakobject_raw(duk_context *ctx, duk_uint_t hobject_flags_and_class, duk_small_int_t prototype_bidx) {
+	duk_hthread *thr = (duk_hthread *) ctx;
+	duk_hweakobject *h;
+	duk_tval *tv_slot;
+
+	DUK_ASSERT(ctx != NULL);
+	DUK_ASSERT(prototype_bidx >= 0 && prototype_bidx < DUK_NUM_BUILTINS);
+
+	/* check stack first */
+	if (thr->valstack_top >= thr->valstack_end) {
+		DUK_ERROR(thr, DUK_ERR_API_ERROR, DUK_STR_PUSH_BEYOND_ALLOC_STACK);
+	}
+
+	h = duk_hweakobject_alloc(thr->heap, hobject_flags_and_class);
+	if (!h) {
+		DUK_ERROR(thr, DUK_ERR_ALLOC_ERROR, DUK_STR_OBJECT_ALLOC_FAILED);
+	}
+
+	tv_slot = thr->valstack_top;
+	DUK_TVAL_SET_OBJECT(tv_slot, (duk_hobject *) h);
+	DUK_HOBJECT_INCREF(thr, (duk_hobject *) h);
+	thr->valstack_top++;
+
+	DUK_HOBJECT_SET_PROTOTYPE_UPDREF(thr, (duk_hobject *) h, thr->builtins[prototype_bidx]);
+
+	return h;
+}
+#endif  /* DUK_USE_WEAK_REFERENCES */
+
 DUK_EXTERNAL duk_idx_t duk_push_object(duk_context *ctx) {
 	return duk_push_object_helper(ctx,
 	                              DUK_HOBJECT_FLAG_EXTENSIBLE |
@@ -3452,6 +3579,38 @@ DUK_EXTERNAL void *duk_push_dynamic_buffer(duk_context *ctx, duk_size_t size) {
 	return duk_push_buffer(ctx, size, 1);
 }
 
+/* Ownership of 'ptr' moves to Duktape only when the push succeeds: if an
+ * error is thrown, 'release_func' is not called.
+ */
+DUK_EXTERNAL void duk_push_external_buffer(duk_context *ctx, void *ptr, duk_size_t size, duk_free_function release_func, void *udata) {
+	duk_hthread *thr = (duk_hthread *) ctx;
+	duk_tval *tv_slot;
+	duk_hbuffer *h;
+
+	DUK_ASSERT(ctx != NULL);
+
+	if (thr->valstack_top >= thr->valstack_end) {
+		DUK_ERROR(thr, DUK_ERR_API_ERROR, DUK_STR_PUSH_BEYOND_ALLOC_STACK);
+	}
+
+	if (size > DUK_HBUFFER_MAX_BYTELEN) {
+		DUK_ERROR(thr, DUK_ERR_RANGE_ERROR, DUK_STR_BUFFER_TOO_LONG);
+	}
+	if (ptr == NULL && size > 0) {
+		DUK_ERROR(thr, DUK_ERR_API_ERROR, DUK_STR_INVALID_CALL_ARGS);
+	}
+
+	h = duk_hbuffer_alloc_external(thr->heap, ptr, size, release_func, udata);
+	if (!h) {
+		DUK_ERROR(thr, DUK_ERR_ALLOC_ERROR, DUK_STR_BUFFER_ALLOC_FAILED);
+	}
+
+	tv_slot = thr->valstack_top;
+	DUK_TVAL_SET_BUFFER(tv_slot, h);
+	DUK_HBUFFER_INCREF(thr, h);
+	thr->valstack_top++;
+}
+
 DUK_EXTERNAL duk_idx_t duk_push_heapptr(duk_context *ctx, void *ptr) {
 	duk_hthread *thr = (duk_hthread *) ctx;
 	duk_idx_t ret;
@@ -199,6 +199,31 @@ DUK_INTERNAL duk_double_t duk_bi_date_get_now(duk_context *ctx) {
 }
 #endif  /* DUK_USE_DATE_NOW_GETTIMEOFDAY */
 
+/* Current time in milliseconds with sub-millisecond resolution when the
+ * platform provides it.  Only used for measuring durations, e.g. for heap
+ * statistics, so must not throw.
+ */
+#if defined(DUK_USE_MARK_AND_SWEEP)
+#ifdef DUK_USE_DATE_NOW_GETTIMEOFDAY
+DUK_INTERNAL duk_double_t duk_bi_date_get_timestamp(duk_context *ctx) {
+	struct timeval tv;
+
+	DUK_UNREF(ctx);
+
+	if (gettimeofday(&tv, NULL) != 0) {
+		return 0.0;
+	}
+	return ((duk_double_t) tv.tv_sec) * 1000.0 +
+	       ((duk_double_t) tv.tv_usec) / 1000.0;
+}
+#else
+DUK_INTERNAL duk_double_t duk_bi_date_get_timestamp(duk_context *ctx) {
+	/* remaining providers don't throw */
+	return duk_bi_date_get_now(ctx);
+}
+#endif
+#endif  /* DUK_USE_MARK_AND_SWEEP */
+
 #ifdef DUK_USE_DATE_NOW_TIME
 /* Not a very good provider: only full seconds are available. */
 DUK_INTERNAL duk_double_t duk_bi_date_get_now(duk_context *ctx) {
@@ -52,6 +52,13 @@ DUK_INTERNAL duk_ret_t duk_bi_duktape_object_info(duk_context *ctx) {
 	switch ((duk_small_int_t) DUK_HEAPHDR_GET_TYPE(h)) {
 	case DUK_HTYPE_STRING: {
 		duk_hstring *h_str = (duk_hstring *) h;
+#if defined(DUK_USE_HSTRING_EXTDATA)
+		if (DUK_HSTRING_HAS_EXTDATA(h_str)) {
+			/* data is owned by user code, not counted */
+			duk_push_uint(ctx, (duk_uint_t) (sizeof(duk_hstring_external)));
+			break;
+		}
+#endif
 		duk_push_uint(ctx, (duk_uint_t) (sizeof(duk_hstring) + DUK_HSTRING_GET_BYTELEN(h_str) + 1));
 		break;
 	}
@@ -62,8 +69,14 @@ DUK_INTERNAL duk_ret_t duk_bi_duktape_object_info(duk_context *ctx) {
 			hdr_size = (duk_small_uint_t) sizeof(duk_hcompiledfunction);
 		} else if (DUK_HOBJECT_IS_NATIVEFUNCTION(h_obj)) {
 			hdr_size = (duk_small_uint_t) sizeof(duk_hnativefunction);
+		} else if (DUK_HOBJECT_IS_BUFFEROBJECT(h_obj)) {
+			hdr_size = (duk_small_uint_t) sizeof(duk_hbufferobject);
 		} else if (DUK_HOBJECT_IS_THREAD(h_obj)) {
 			hdr_size = (duk_small_uint_t) sizeof(duk_hthread);
+#if defined(DUK_USE_WEAK_REFERENCES)
+		} else if (DUK_HOBJECT_IS_WEAKOBJECT(h_obj)) {
+			hdr_size = (duk_small_uint_t) sizeof(duk_hweakobject);
+#endif
 		} else {
 			hdr_size = (duk_small_uint_t) sizeof(duk_hobject);
 		}
@@ -92,7 +105,10 @@ DUK_INTERNAL duk_ret_t duk_bi_duktape_object_info(duk_context *ctx) {
 	}
 	case DUK_HTYPE_BUFFER: {
 		duk_hbuffer *h_buf = (duk_hbuffer *) h;
-		if (DUK_HBUFFER_HAS_DYNAMIC(h_buf)) {
+		if (DUK_HBUFFER_HAS_EXTERNAL(h_buf)) {
+			/* data is owned by user code, not counted */
+			duk_push_uint(ctx, (duk_uint_t) (sizeof(duk_hbuffer_external)));
+		} else if (DUK_HBUFFER_HAS_DYNAMIC(h_buf)) {
 			/* XXX: when alloc_size == 0, dynamic buf ptr may now be NULL, in which case
 			 * the second allocation does not exist.
 			 */
@@ -172,6 +188,7 @@ DUK_INTERNAL duk_ret_t duk_bi_duktape_object_gc(duk_context *ctx) {
 	duk_bool_t rc;
 
 	flags = (duk_small_uint_t) duk_get_uint(ctx, 0);
+	flags = (flags & ~DUK_MS_REASON_MASK) | DUK_MS_REASON(DUK_GC_REASON_EXPLICIT);
 	rc = duk_heap_mark_and_sweep(thr->heap, flags);
 
 	/* XXX: Not sure what the best return value would be in the API.
@@ -185,6 +202,95 @@ DUK_INTERNAL duk_ret_t duk_bi_duktape_object_gc(duk_context *ctx) {
 #endif
 }
 
+/* Heap statistics from duk_get_heap_stats() as an object.  Like info(),
+ * only counts and sizes are exposed.
+ */
+DUK_LOCAL void duk__heap_stats_put_size(duk_context *ctx, const char *key, duk_size_t val) {
+	duk_push_number(ctx, (duk_double_t) val);
+	duk_put_prop_string(ctx, -2, key);
+}
+
+DUK_INTERNAL duk_ret_t duk_bi_duktape_object_heap_stats(duk_context *ctx) {
+	duk_heap_stats st;
+	duk_small_uint_t i;
+
+	duk_get_heap_stats(ctx, &st);
+
+	duk_push_object(ctx);
+
+	duk_push_object(ctx);
+	duk__heap_stats_put_size(ctx, "count", st.string_count);
+	duk__heap_stats_put_size(ctx, "bytes", st.string_bytes);
+	duk_put_prop_string(ctx, -2, "strings");
+
+	duk_push_object(ctx);
+	duk__heap_stats_put_size(ctx, "count", st.object_count);
+	duk__heap_stats_put_size(ctx, "bytes", st.object_bytes);
+	duk_push_object(ctx);
+	for (i = 0; i < DUK_HEAP_STATS_MAX_CLASSES; i++) {
+		if (st.classes[i].count == 0) {
+			continue;
+		}
+		duk_push_object(ctx);
+		duk__heap_stats_put_size(ctx, "count", st.classes[i].count);
+		duk__heap_stats_put_size(ctx, "bytes", st.classes[i].bytes);
+		duk_put_prop_string(ctx, -2, st.classes[i].name != NULL ? st.classes[i].name : "unknown");
+	}
+	duk_put_prop_string(ctx, -2, "classes");
+	duk_put_prop_string(ctx, -2, "objects");
+
+	duk_push_object(ctx);
+	duk__heap_stats_put_size(ctx, "count", st.function_count);
+	duk__heap_stats_put_size(ctx, "dataCount", st.function_data_count);
+	duk__heap_stats_put_size(ctx, "dataBytes", st.function_data_bytes);
+	duk__heap_stats_put_size(ctx, "bytecodeBytes", st.bytecode_bytes);
+	duk__heap_stats_put_size(ctx, "constants", st.constant_count);
+	duk_put_prop_string(ctx, -2, "functions");
+
+	duk_push_object(ctx);
+	duk__heap_stats_put_size(ctx, "count", st.buffer_count);
+	duk__heap_stats_put_size(ctx, "bytes", st.buffer_bytes);
+	duk_put_prop_string(ctx, -2, "buffers");
+
+	duk_push_object(ctx);
+	duk__heap_stats_put_size(ctx, "count", st.thread_count);
+	duk__heap_stats_put_size(ctx, "stackBytes", st.thread_stack_bytes);
+	duk_put_prop_string(ctx, -2, "threads");
+
+	duk_push_object(ctx);
+	duk__heap_stats_put_size(ctx, "size", st.strtab_size);
+	duk__heap_stats_put_size(ctx, "used", st.strtab_used);
+	duk__heap_stats_put_size(ctx, "deleted", st.strtab_deleted);
+	duk__heap_stats_put_size(ctx, "bytes", st.strtab_bytes);
+	duk_push_number(ctx, st.strtab_size > 0 ?
+	                     (duk_double_t) (st.strtab_used + st.strtab_deleted) / (duk_double_t) st.strtab_size :
+	                     0.0);
+	duk_put_prop_string(ctx, -2, "load");
+	duk_put_prop_string(ctx, -2, "stringTable");
+
+	duk_push_object(ctx);
+	duk__heap_stats_put_size(ctx, "heapAllocated", st.heap_allocated_count);
+	duk__heap_stats_put_size(ctx, "refzero", st.refzero_list_count);
+	duk__heap_stats_put_size(ctx, "finalize", st.finalize_list_count);
+	duk__heap_stats_put_size(ctx, "sweepFree", st.sweep_free_list_count);
+	duk_put_prop_string(ctx, -2, "lists");
+
+	duk_push_object(ctx);
+	duk__heap_stats_put_size(ctx, "count", st.ms_count);
+	duk__heap_stats_put_size(ctx, "emergencyCount", st.ms_emergency_count);
+	duk_push_number(ctx, st.ms_time_total);
+	duk_put_prop_string(ctx, -2, "timeTotal");
+	duk_push_number(ctx, st.ms_time_last);
+	duk_put_prop_string(ctx, -2, "timeLast");
+	duk_push_number(ctx, st.ms_time_max);
+	duk_put_prop_string(ctx, -2, "timeMax");
+	duk_put_prop_string(ctx, -2, "gc");
+
+	duk__heap_stats_put_size(ctx, "totalBytes", st.total_bytes);
+
+	return 1;
+}
+
 DUK_INTERNAL duk_ret_t duk_bi_duktape_object_fin(duk_context *ctx) {
 	(void) duk_require_hobject(ctx, 0);
 	if (duk_get_top(ctx) >= 2) {
@@ -233,7 +339,9 @@ DUK_INTERNAL duk_ret_t duk_bi_duktape_object_enc(duk_context *ctx) {
 		                             3 /*idx_space*/,
 		                             DUK_JSON_FLAG_EXT_CUSTOM |
 		                             DUK_JSON_FLAG_ASCII_ONLY |
-		                             DUK_JSON_FLAG_AVOID_KEY_QUOTES /*flags*/);
+		                             DUK_JSON_FLAG_AVOID_KEY_QUOTES /*flags*/,
+		                             NULL /*write_cb*/,
+		                             NULL /*write_udata*/);
 #endif
 #ifdef DUK_USE_JC
 	} else if (h_str == DUK_HTHREAD_STRING_JC(thr)) {
@@ -242,7 +350,9 @@ DUK_INTERNAL duk_ret_t duk_bi_duktape_object_enc(duk_context *ctx) {
 		                             2 /*idx_replacer*/,
 		                             3 /*idx_space*/,
 		                             DUK_JSON_FLAG_EXT_COMPATIBLE |
-		                             DUK_JSON_FLAG_ASCII_ONLY /*flags*/);
+		                             DUK_JSON_FLAG_ASCII_ONLY /*flags*/,
+		                             NULL /*write_cb*/,
+		                             NULL /*write_udata*/);
 #endif
 	} else {
 		return DUK_RET_TYPE_ERROR;
@@ -13,6 +13,7 @@
  *  Local defines and forward declarations.
  */
 
+DUK_LOCAL_DECL duk_uint8_t *duk__json_scan_plain(duk_uint8_t *p, duk_uint8_t *p_end, duk_bool_t stop_nonascii);
 DUK_LOCAL_DECL void duk__dec_syntax_error(duk_json_dec_ctx *js_ctx);
 DUK_LOCAL_DECL void duk__dec_eat_white(duk_json_dec_ctx *js_ctx);
 DUK_LOCAL_DECL duk_small_int_t duk__dec_peek(duk_json_dec_ctx *js_ctx);
@@ -21,6 +22,7 @@ DUK_LOCAL_DECL duk_small_int_t duk__dec_get_nonwhite(duk_json_dec_ctx *js_ctx);
 DUK_LOCAL_DECL duk_uint_fast32_t duk__dec_decode_hex_escape(duk_json_dec_ctx *js_ctx, duk_small_uint_t n);
 DUK_LOCAL_DECL void duk__dec_req_stridx(duk_json_dec_ctx *js_ctx, duk_small_uint_t stridx);
 DUK_LOCAL_DECL void duk__dec_string(duk_json_dec_ctx *js_ctx);
+DUK_LOCAL_DECL void duk__dec_key(duk_json_dec_ctx *js_ctx);
 #ifdef DUK_USE_JX
 DUK_LOCAL_DECL void duk__dec_plain_string(duk_json_dec_ctx *js_ctx);
 DUK_LOCAL_DECL void duk__dec_pointer(duk_json_dec_ctx *js_ctx);
@@ -36,8 +38,11 @@ DUK_LOCAL_DECL void duk__dec_reviver_walk(duk_json_dec_ctx *js_ctx);
 
 DUK_LOCAL_DECL void duk__emit_1(duk_json_enc_ctx *js_ctx, duk_uint_fast8_t ch);
 DUK_LOCAL_DECL void duk__emit_2(duk_json_enc_ctx *js_ctx, duk_uint_fast16_t packed_chars);
-DUK_LOCAL_DECL void duk__emit_esc_auto(duk_json_enc_ctx *js_ctx, duk_uint_fast32_t cp);
-DUK_LOCAL_DECL void duk__emit_xutf8(duk_json_enc_ctx *js_ctx, duk_uint_fast32_t cp);
+DUK_LOCAL_DECL duk_uint8_t *duk__emit_reserve(duk_json_enc_ctx *js_ctx, duk_size_t len);
+DUK_LOCAL_DECL void duk__emit_commit(duk_json_enc_ctx *js_ctx, duk_uint8_t *q);
+DUK_LOCAL_DECL void duk__emit_flush(duk_json_enc_ctx *js_ctx);
+DUK_LOCAL_DECL void duk__emit_bytes(duk_json_enc_ctx *js_ctx, const duk_uint8_t *p, duk_size_t len);
+DUK_LOCAL_DECL duk_uint8_t *duk__emit_esc_auto_fast(duk_json_enc_ctx *js_ctx, duk_uint_fast32_t cp, duk_uint8_t *q);
 DUK_LOCAL_DECL void duk__emit_hstring(duk_json_enc_ctx *js_ctx, duk_hstring *h);
 #if defined(DUK_USE_JX) || defined(DUK_USE_JC)
 DUK_LOCAL_DECL void duk__emit_cstring(duk_json_enc_ctx *js_ctx, const char *p);
@@ -52,6 +57,78 @@ DUK_LOCAL_DECL void duk__enc_array(duk_json_enc_ctx *js_ctx);
 DUK_LOCAL_DECL duk_bool_t duk__enc_value1(duk_json_enc_ctx *js_ctx, duk_idx_t idx_holder);
 DUK_LOCAL_DECL void duk__enc_value2(duk_json_enc_ctx *js_ctx);
 DUK_LOCAL_DECL duk_bool_t duk__enc_allow_into_proplist(duk_tval *tv);
+#if defined(DUK_USE_JSON_STRINGIFY_FASTPATH)
+DUK_NORETURN(DUK_LOCAL_DECL void duk__json_fast_abort(duk_json_enc_ctx *js_ctx));
+DUK_LOCAL_DECL duk_bool_t duk__json_fast_has_tojson(duk_json_enc_ctx *js_ctx, duk_hobject *obj);
+DUK_LOCAL_DECL void duk__json_fast_number(duk_json_enc_ctx *js_ctx, duk_double_t d);
+DUK_LOCAL_DECL duk_bool_t duk__json_fast_value(duk_json_enc_ctx *js_ctx, duk_tval *tv);
+DUK_LOCAL_DECL duk_ret_t duk__json_stringify_fast(duk_context *ctx);
+#endif
+
+/*
+ *  Scanning for plain string content.
+ *
+ *  Both the encoder and the decoder spend most of their time on string
+ *  content which needs no escaping or unescaping.  duk__json_scan_plain()
+ *  finds the end of such a run so that it can be copied in bulk.  The scan
+ *  tests a machine word at a time using portable "SIMD within a register"
+ *  tricks; the word is loaded with a memcpy() so there are no alignment
+ *  requirements.
+ *
+ *  The word tests may only have false positives (a flagged word is then
+ *  scanned bytewise), never false negatives.  Byte order doesn't matter
+ *  because only the existence of a special byte is tested.
+ */
+
+#if defined(DUK_USE_64BIT_OPS)
+typedef duk_uint64_t duk__json_word_t;
+#else
+typedef duk_uint32_t duk__json_word_t;
+#endif
+
+#define DUK__JSON_WORD_ONES            (((duk__json_word_t) -1) / 0xffU)  /* 0x0101...01 */
+#define DUK__JSON_WORD_HIGHS           (DUK__JSON_WORD_ONES * 0x80U)      /* 0x8080...80 */
+#define DUK__JSON_WORD_HAS_LESS(w,n)   (((w) - DUK__JSON_WORD_ONES * (n)) & ~(w) & DUK__JSON_WORD_HIGHS)
+#define DUK__JSON_WORD_HAS_BYTE(w,b)   DUK__JSON_WORD_HAS_LESS((w) ^ (DUK__JSON_WORD_ONES * (b)), 1U)
+
+/* Return a pointer to the first byte in [p,p_end[ which is a double quote,
+ * a backslash, or a control character (or, if 'stop_nonascii' is set, a
+ * byte >= 0x7f), or p_end if there is none.
+ */
+DUK_LOCAL duk_uint8_t *duk__json_scan_plain(duk_uint8_t *p, duk_uint8_t *p_end, duk_bool_t stop_nonascii) {
+	duk__json_word_t w;
+	duk__json_word_t m;
+	duk_uint8_t t;
+
+	while ((duk_size_t) (p_end - p) >= sizeof(duk__json_word_t)) {
+		DUK_MEMCPY((void *) &w, (const void *) p, sizeof(duk__json_word_t));
+		m = DUK__JSON_WORD_HAS_LESS(w, 0x20U) |
+		    DUK__JSON_WORD_HAS_BYTE(w, DUK_ASC_DOUBLEQUOTE) |
+		    DUK__JSON_WORD_HAS_BYTE(w, DUK_ASC_BACKSLASH);
+		if (stop_nonascii) {
+			/* Bytes >= 0x7f: either the high bit is already set or
+			 * adding one sets it.  A carry out of a byte only happens
+			 * for 0xff which is flagged anyway.
+			 */
+			m |= (w | (w + DUK__JSON_WORD_ONES)) & DUK__JSON_WORD_HIGHS;
+		}
+		if (m != 0) {
+			break;
+		}
+		p += sizeof(duk__json_word_t);
+	}
+
+	while (p < p_end) {
+		t = *p;
+		if (t < 0x20 || t == DUK_ASC_DOUBLEQUOTE || t == DUK_ASC_BACKSLASH ||
+		    (stop_nonascii && t >= 0x7f)) {
+			break;
+		}
+		p++;
+	}
+
+	return p;
+}
 
 /*
  *  Parsing implementation.
@@ -187,6 +264,7 @@ DUK_LOCAL void duk__dec_string(duk_json_dec_ctx *js_ctx) {
 	duk_hthread *thr = js_ctx->thr;
 	duk_context *ctx = (duk_context *) thr;
 	duk_hbuffer_dynamic *h_buf;
+	duk_uint8_t *p;
 	duk_small_int_t x;
 	duk_uint_fast32_t cp;
 
@@ -197,12 +275,30 @@ DUK_LOCAL void duk__dec_string(duk_json_dec_ctx *js_ctx) {
 	 * so they'll simply pass through (valid UTF-8 or not).
 	 */
 
+	/* Most strings have no escapes: intern them directly from the
+	 * input without an intermediate buffer.
+	 */
+	p = duk__json_scan_plain(js_ctx->p, js_ctx->p_end, 0 /*stop_nonascii*/);
+	if (DUK_LIKELY(p < js_ctx->p_end && *p == DUK_ASC_DOUBLEQUOTE)) {
+		duk_push_lstring(ctx, (const char *) js_ctx->p, (duk_size_t) (p - js_ctx->p));
+		js_ctx->p = p + 1;
+		return;
+	}
+
 	duk_push_dynamic_buffer(ctx, 0);
 	h_buf = (duk_hbuffer_dynamic *) duk_get_hbuffer(ctx, -1);
 	DUK_ASSERT(h_buf != NULL);
 	DUK_ASSERT(DUK_HBUFFER_HAS_DYNAMIC(h_buf));
 
 	for (;;) {
+		/* Copy a run of plain bytes in one go; the run is followed
+		 * by a double quote, a backslash, a control character, or EOF.
+		 */
+		if (p > js_ctx->p) {
+			duk_hbuffer_append_bytes(thr, h_buf, js_ctx->p, (duk_size_t) (p - js_ctx->p));
+			js_ctx->p = p;
+		}
+
 		x = duk__dec_get(js_ctx);
 		if (x == DUK_ASC_DOUBLEQUOTE) {
 			break;
@@ -248,12 +344,13 @@ DUK_LOCAL void duk__dec_string(duk_json_dec_ctx *js_ctx) {
 				goto syntax_error;
 			}
 			duk_hbuffer_append_xutf8(thr, h_buf, (duk_uint32_t) cp);
-		} else if (x < 0x20) {
-			/* catches EOF (-1) */
-			goto syntax_error;
 		} else {
-			duk_hbuffer_append_byte(thr, h_buf, (duk_uint8_t) x);
+			/* control character or EOF (-1) */
+			DUK_ASSERT(x < 0x20);
+			goto syntax_error;
 		}
+
+		p = duk__json_scan_plain(js_ctx->p, js_ctx->p_end, 0 /*stop_nonascii*/);
 	}
 
 	duk_to_string(ctx, -1);
@@ -267,6 +364,66 @@ DUK_LOCAL void duk__dec_string(duk_json_dec_ctx *js_ctx) {
 	DUK_UNREACHABLE();
 }
 
+/* Decode an object key.  Keys repeat a lot (e.g. in an array of records),
+ * so recently seen keys are kept in a small two-way cache on the value stack
+ * indexed by a cheap hash of the key length and a few key bytes.  A cache
+ * hit avoids hashing the whole key and probing the string table.  Keys with
+ * escapes are decoded normally.
+ */
+DUK_LOCAL void duk__dec_key(duk_json_dec_ctx *js_ctx) {
+	duk_hthread *thr = js_ctx->thr;
+	duk_context *ctx = (duk_context *) thr;
+	duk_uint8_t *p_start;
+	duk_uint8_t *p;
+	duk_size_t len;
+	duk_uint32_t hash;
+	duk_idx_t idx_set;
+	duk_tval *tv;
+	duk_hstring *h;
+	duk_small_int_t i;
+
+	/* '"' was eaten by caller */
+
+	p_start = js_ctx->p;
+	p = duk__json_scan_plain(p_start, js_ctx->p_end, 0 /*stop_nonascii*/);
+	if (DUK_UNLIKELY(p >= js_ctx->p_end || *p != DUK_ASC_DOUBLEQUOTE)) {
+		duk__dec_string(js_ctx);
+		return;
+	}
+	len = (duk_size_t) (p - p_start);
+	js_ctx->p = p + 1;
+
+	hash = (duk_uint32_t) len;
+	if (len > 0) {
+		hash = (hash << 8) ^ (duk_uint32_t) p_start[0];
+		hash = (hash << 8) ^ (duk_uint32_t) p_start[len >> 1];
+		hash = (hash << 8) ^ (duk_uint32_t) p_start[len - 1];
+	}
+	hash = (duk_uint32_t) (hash * 2654435761UL);  /* Fibonacci hashing, use top bits */
+	idx_set = js_ctx->idx_keycache + (duk_idx_t) ((hash >> (32 - DUK_JSON_DEC_KEYCACHE_BITS)) << 1);
+
+	for (i = 0; i < 2; i++) {
+		tv = thr->valstack_bottom + idx_set + i;
+		DUK_ASSERT(tv < thr->valstack_top);
+		if (DUK_TVAL_IS_STRING(tv)) {
+			h = DUK_TVAL_GET_STRING(tv);
+			DUK_ASSERT(h != NULL);
+			if (DUK_HSTRING_GET_BYTELEN(h) == len &&
+			    DUK_MEMCMP((const void *) DUK_HSTRING_GET_DATA(h), (const void *) p_start, len) == 0) {
+				duk_push_hstring(ctx, h);
+				return;
+			}
+		}
+	}
+
+	/* Miss: the older entry of the set is evicted. */
+	duk_push_lstring(ctx, (const char *) p_start, len);
+	duk_dup(ctx, idx_set);
+	duk_replace(ctx, idx_set + 1);
+	duk_dup_top(ctx);
+	duk_replace(ctx, idx_set);
+}
+
 #ifdef DUK_USE_JX
 /* Decode a plain string consisting entirely of identifier characters.
  * Used to parse plain keys (e.g. "foo: 123").
@@ -486,6 +643,10 @@ DUK_LOCAL void duk__dec_objarr_exit(duk_json_dec_ctx *js_ctx) {
 	js_ctx->recursion_depth--;
 }
 
+#if (DUK_JSON_DEC_KEYHINT_MAX >= DUK_HOBJECT_E_USE_HASH_LIMIT)
+#error JSON key count hint must stay below the hash part limit
+#endif
+
 DUK_LOCAL void duk__dec_object(duk_json_dec_ctx *js_ctx) {
 	duk_context *ctx = (duk_context *) js_ctx->thr;
 	duk_int_t key_count;  /* XXX: a "first" flag would suffice */
@@ -497,6 +658,18 @@ DUK_LOCAL void duk__dec_object(duk_json_dec_ctx *js_ctx) {
 
 	duk_push_object(ctx);
 
+	/* Objects at the same depth (e.g. records in an array) usually have
+	 * the same number of keys, so preallocate the entry part based on the
+	 * previous object.
+	 */
+	DUK_ASSERT(js_ctx->recursion_depth >= 1);
+	if (js_ctx->recursion_depth <= DUK_JSON_DEC_KEYHINT_DEPTH &&
+	    js_ctx->key_count_hint[js_ctx->recursion_depth - 1] > 0) {
+		duk_hobject_realloc_entry_part(js_ctx->thr,
+		                               duk_get_hobject(ctx, -1),
+		                               js_ctx->key_count_hint[js_ctx->recursion_depth - 1]);
+	}
+
 	/* Initial '{' has been checked and eaten by caller. */
 
 	key_count = 0;
@@ -528,7 +701,7 @@ DUK_LOCAL void duk__dec_object(duk_json_dec_ctx *js_ctx) {
 		/* parse key and value */
 
 		if (x == DUK_ASC_DOUBLEQUOTE) {
-			duk__dec_string(js_ctx);
+			duk__dec_key(js_ctx);
 #ifdef DUK_USE_JX
 		} else if (js_ctx->flag_ext_custom &&
 		           duk_unicode_is_identifier_start((duk_codepoint_t) x)) {
@@ -558,6 +731,11 @@ DUK_LOCAL void duk__dec_object(duk_json_dec_ctx *js_ctx) {
 
 	/* [ ... obj ] */
 
+	if (js_ctx->recursion_depth <= DUK_JSON_DEC_KEYHINT_DEPTH) {
+		js_ctx->key_count_hint[js_ctx->recursion_depth - 1] =
+		        (duk_uint32_t) (key_count <= DUK_JSON_DEC_KEYHINT_MAX ? key_count : DUK_JSON_DEC_KEYHINT_MAX);
+	}
+
 	DUK_DDD(DUK_DDDPRINT("parse_object: final object is %!T",
 	                     (duk_tval *) duk_get_tval(ctx, -1)));
 
@@ -803,23 +981,41 @@ DUK_LOCAL void duk__dec_reviver_walk(duk_json_dec_ctx *js_ctx) {
 
 #define DUK__EMIT_1(js_ctx,ch)          duk__emit_1((js_ctx), (duk_uint_fast8_t) (ch))
 #define DUK__EMIT_2(js_ctx,ch1,ch2)     duk__emit_2((js_ctx), (((duk_uint_fast16_t)(ch1)) << 8) + (duk_uint_fast16_t)(ch2))
-#define DUK__EMIT_ESC_AUTO(js_ctx,cp)   duk__emit_esc_auto((js_ctx), (cp))
-#define DUK__EMIT_XUTF8(js_ctx,cp)      duk__emit_xutf8((js_ctx), (cp))
 #define DUK__EMIT_HSTR(js_ctx,h)        duk__emit_hstring((js_ctx), (h))
 #if defined(DUK_USE_JX) || defined(DUK_USE_JC)
 #define DUK__EMIT_CSTR(js_ctx,p)        duk__emit_cstring((js_ctx), (p))
 #endif
 #define DUK__EMIT_STRIDX(js_ctx,i)      duk__emit_stridx((js_ctx), (i))
 
+/* Extra spare added when the output buffer is grown by duk__emit_reserve(). */
+#define DUK__JSON_BUF_SPARE_ADD         64
+
+/* Maximum output bytes produced for one input byte by duk__enc_quote_string():
+ * a single byte may become a '\u00XX' escape, and longer sequences never
+ * expand by more than that per byte.
+ */
+#define DUK__JSON_QUOTE_MAX_EXPAND      6
+
+/* Input bytes quoted per output buffer reservation; a codepoint started
+ * within the chunk may extend past it by DUK_UNICODE_MAX_XUTF8_LENGTH - 1.
+ */
+#define DUK__JSON_QUOTE_CHUNK           256
+
 DUK_LOCAL void duk__emit_1(duk_json_enc_ctx *js_ctx, duk_uint_fast8_t ch) {
-	duk_hbuffer_append_byte(js_ctx->thr, js_ctx->h_buf, (duk_uint8_t) ch);
+	duk_uint8_t *q;
+
+	q = duk__emit_reserve(js_ctx, 1);
+	*q++ = (duk_uint8_t) ch;
+	duk__emit_commit(js_ctx, q);
 }
 
 DUK_LOCAL void duk__emit_2(duk_json_enc_ctx *js_ctx, duk_uint_fast16_t packed_chars) {
-	duk_uint8_t buf[2];
-	buf[0] = (duk_uint8_t) (packed_chars >> 8);
-	buf[1] = (duk_uint8_t) (packed_chars & 0xff);
-	duk_hbuffer_append_bytes(js_ctx->thr, js_ctx->h_buf, (duk_uint8_t *) buf, 2);
+	duk_uint8_t *q;
+
+	q = duk__emit_reserve(js_ctx, 2);
+	*q++ = (duk_uint8_t) (packed_chars >> 8);
+	*q++ = (duk_uint8_t) (packed_chars & 0xff);
+	duk__emit_commit(js_ctx, q);
 }
 
 #define DUK__MKESC(nybbles,esc1,esc2)  \
@@ -827,11 +1023,95 @@ DUK_LOCAL void duk__emit_2(duk_json_enc_ctx *js_ctx, duk_uint_fast16_t packed_ch
 	(((duk_uint_fast32_t) (esc1)) << 8) | \
 	((duk_uint_fast32_t) (esc2))
 
-DUK_LOCAL void duk__emit_esc_auto(duk_json_enc_ctx *js_ctx, duk_uint_fast32_t cp) {
-	duk_uint8_t buf[2];
+/* Reserve space for 'len' bytes at the end of the output buffer and return
+ * a write pointer to the reserved area.  The caller writes at most 'len'
+ * bytes and then calls duk__emit_commit() with the final write pointer.
+ * The buffer is grown geometrically so that a long sequence of small
+ * reservations doesn't cause a resize for every call.  When writing to a
+ * sink, the buffer is flushed instead; it only needs to grow if a single
+ * reservation exceeds the chunk size (callers avoid that).
+ */
+DUK_LOCAL duk_uint8_t *duk__emit_reserve(duk_json_enc_ctx *js_ctx, duk_size_t len) {
+	duk_hbuffer_dynamic *h_buf = js_ctx->h_buf;
+	duk_size_t curr_size;
+	duk_size_t new_size;
+	duk_size_t new_alloc_size;
+
+	curr_size = DUK_HBUFFER_DYNAMIC_GET_SIZE(h_buf);
+	if (DUK_UNLIKELY(DUK_HBUFFER_DYNAMIC_GET_SPARE_SIZE(h_buf) < len)) {
+		if (js_ctx->write_cb != NULL) {
+			duk__emit_flush(js_ctx);
+			curr_size = 0;
+			if (DUK_HBUFFER_DYNAMIC_GET_SPARE_SIZE(h_buf) >= len) {
+				return (duk_uint8_t *) DUK_HBUFFER_DYNAMIC_GET_DATA_PTR(h_buf);
+			}
+		}
+
+		new_size = curr_size + len;
+		if (new_size < curr_size || new_size > DUK_HBUFFER_MAX_BYTELEN) {
+			DUK_ERROR(js_ctx->thr, DUK_ERR_RANGE_ERROR, DUK_STR_BUFFER_TOO_LONG);
+		}
+		new_alloc_size = new_size + (new_size >> 1) + DUK__JSON_BUF_SPARE_ADD;
+		if (new_alloc_size < new_size || new_alloc_size > DUK_HBUFFER_MAX_BYTELEN) {
+			new_alloc_size = DUK_HBUFFER_MAX_BYTELEN;
+		}
+		duk_hbuffer_resize(js_ctx->thr, h_buf, curr_size, new_alloc_size);
+	}
+	DUK_ASSERT(DUK_HBUFFER_DYNAMIC_GET_SPARE_SIZE(h_buf) >= len);
+
+	return (duk_uint8_t *) DUK_HBUFFER_DYNAMIC_GET_DATA_PTR(h_buf) + curr_size;
+}
+
+DUK_LOCAL void duk__emit_commit(duk_json_enc_ctx *js_ctx, duk_uint8_t *q) {
+	duk_hbuffer_dynamic *h_buf = js_ctx->h_buf;
+	duk_size_t new_size;
+
+	new_size = (duk_size_t) (q - (duk_uint8_t *) DUK_HBUFFER_DYNAMIC_GET_DATA_PTR(h_buf));
+	DUK_ASSERT(new_size >= DUK_HBUFFER_DYNAMIC_GET_SIZE(h_buf));
+	DUK_ASSERT(new_size <= DUK_HBUFFER_DYNAMIC_GET_ALLOC_SIZE(h_buf));
+	DUK_HBUFFER_DYNAMIC_SET_SIZE(h_buf, new_size);
+}
+
+/* Give current output buffer contents to the sink and empty the buffer. */
+DUK_LOCAL void duk__emit_flush(duk_json_enc_ctx *js_ctx) {
+	duk_hbuffer_dynamic *h_buf = js_ctx->h_buf;
+	duk_size_t size;
+
+	DUK_ASSERT(js_ctx->write_cb != NULL);
+
+	size = DUK_HBUFFER_DYNAMIC_GET_SIZE(h_buf);
+	if (size > 0) {
+		/* Reset size first: the callback may throw. */
+		DUK_HBUFFER_DYNAMIC_SET_SIZE(h_buf, 0);
+		js_ctx->write_cb(js_ctx->write_udata,
+		                 (const char *) DUK_HBUFFER_DYNAMIC_GET_DATA_PTR(h_buf),
+		                 size);
+	}
+}
+
+/* Emit bytes as is.  Long inputs are copied in pieces so that reservations
+ * stay below the sink chunk size.
+ */
+DUK_LOCAL void duk__emit_bytes(duk_json_enc_ctx *js_ctx, const duk_uint8_t *p, duk_size_t len) {
+	duk_uint8_t *q;
+	duk_size_t n;
+
+	do {
+		n = (len > DUK__JSON_QUOTE_CHUNK ? DUK__JSON_QUOTE_CHUNK : len);
+		q = duk__emit_reserve(js_ctx, n);
+		DUK_MEMCPY((void *) q, (const void *) p, n);
+		duk__emit_commit(js_ctx, q + n);
+		p += n;
+		len -= n;
+	} while (len > 0);
+}
+
+DUK_LOCAL duk_uint8_t *duk__emit_esc_auto_fast(duk_json_enc_ctx *js_ctx, duk_uint_fast32_t cp, duk_uint8_t *q) {
 	duk_uint_fast32_t tmp;
 	duk_small_uint_t dig;
 
+	DUK_UNREF(js_ctx);  /* unused without JX */
+
 	/* Select appropriate escape format automatically, and set 'tmp' to a
 	 * value encoding both the escape format character and the nybble count:
 	 *
@@ -865,34 +1145,28 @@ DUK_LOCAL void duk__emit_esc_auto(duk_json_enc_ctx *js_ctx, duk_uint_fast32_t cp
 		}
 	}
 
-	buf[0] = (duk_uint8_t) ((tmp >> 8) & 0xff);
-	buf[1] = (duk_uint8_t) (tmp & 0xff);
-	duk_hbuffer_append_bytes(js_ctx->thr, js_ctx->h_buf, buf, 2);
+	*q++ = (duk_uint8_t) ((tmp >> 8) & 0xff);
+	*q++ = (duk_uint8_t) (tmp & 0xff);
 
 	tmp = tmp >> 16;
 	while (tmp > 0) {
 		tmp--;
 		dig = (duk_small_uint_t) ((cp >> (4 * tmp)) & 0x0f);
-		duk_hbuffer_append_byte(js_ctx->thr, js_ctx->h_buf, duk_lc_digits[dig]);
+		*q++ = duk_lc_digits[dig];
 	}
-}
 
-DUK_LOCAL void duk__emit_xutf8(duk_json_enc_ctx *js_ctx, duk_uint_fast32_t cp) {
-	(void) duk_hbuffer_append_xutf8(js_ctx->thr, js_ctx->h_buf, cp);
+	return q;
 }
 
 DUK_LOCAL void duk__emit_hstring(duk_json_enc_ctx *js_ctx, duk_hstring *h) {
 	DUK_ASSERT(h != NULL);
-	duk_hbuffer_append_bytes(js_ctx->thr,
-	                         js_ctx->h_buf,
-	                         (duk_uint8_t *) DUK_HSTRING_GET_DATA(h),
-	                         (duk_size_t) DUK_HSTRING_GET_BYTELEN(h));
+	duk__emit_bytes(js_ctx, (const duk_uint8_t *) DUK_HSTRING_GET_DATA(h), (duk_size_t) DUK_HSTRING_GET_BYTELEN(h));
 }
 
 #if defined(DUK_USE_JX) || defined(DUK_USE_JC)
 DUK_LOCAL void duk__emit_cstring(duk_json_enc_ctx *js_ctx, const char *p) {
 	DUK_ASSERT(p != NULL);
-	(void) duk_hbuffer_append_cstring(js_ctx->thr, js_ctx->h_buf, p);
+	duk__emit_bytes(js_ctx, (const duk_uint8_t *) p, (duk_size_t) DUK_STRLEN(p));
 }
 #endif
 
@@ -958,8 +1232,10 @@ DUK_LOCAL duk_uint8_t duk__quote_esc[14] = {
 
 DUK_LOCAL void duk__enc_quote_string(duk_json_enc_ctx *js_ctx, duk_hstring *h_str) {
 	duk_hthread *thr = js_ctx->thr;
-	duk_uint8_t *p, *p_start, *p_end, *p_tmp;
+	duk_uint8_t *p, *p_start, *p_end, *p_chunk_end, *p_tmp;
+	duk_uint8_t *q;
 	duk_ucodepoint_t cp;  /* typed for duk_unicode_decode_xutf8() */
+	duk_size_t chunk_len;
 
 	DUK_DDD(DUK_DDDPRINT("duk__enc_quote_string: h_str=%!O", (duk_heaphdr *) h_str));
 
@@ -968,72 +1244,105 @@ DUK_LOCAL void duk__enc_quote_string(duk_json_enc_ctx *js_ctx, duk_hstring *h_st
 	p_end = p_start + DUK_HSTRING_GET_BYTELEN(h_str);
 	p = p_start;
 
-	DUK__EMIT_1(js_ctx, DUK_ASC_DOUBLEQUOTE);
+	/* Output is written directly into reserved buffer space, one input
+	 * chunk at a time, which avoids a buffer append call per character.
+	 * The reservation is a worst case estimate for the chunk.
+	 */
+
+	q = duk__emit_reserve(js_ctx, 1);
+	*q++ = DUK_ASC_DOUBLEQUOTE;
+	duk__emit_commit(js_ctx, q);
 
 	while (p < p_end) {
-		cp = *p;
+		chunk_len = (duk_size_t) (p_end - p);
+		if (chunk_len > DUK__JSON_QUOTE_CHUNK) {
+			chunk_len = DUK__JSON_QUOTE_CHUNK;
+		}
+		p_chunk_end = p + chunk_len;
+		q = duk__emit_reserve(js_ctx, DUK__JSON_QUOTE_MAX_EXPAND * (chunk_len + DUK_UNICODE_MAX_XUTF8_LENGTH));
+
+		while (p < p_chunk_end) {
+			/* Copy a run of printable ASCII without escapes in one go. */
+			p_tmp = duk__json_scan_plain(p, p_chunk_end, 1 /*stop_nonascii*/);
+			if (p_tmp > p) {
+				DUK_MEMCPY((void *) q, (const void *) p, (duk_size_t) (p_tmp - p));
+				q += p_tmp - p;
+				p = p_tmp;
+				if (p >= p_chunk_end) {
+					break;
+				}
+			}
 
-		if (DUK_LIKELY(cp <= 0x7f)) {
-			/* ascii fast path: avoid decoding utf-8 */
-			p++;
-			if (cp == 0x22 || cp == 0x5c) {
-				/* double quote or backslash */
-				DUK__EMIT_2(js_ctx, DUK_ASC_BACKSLASH, cp);
-			} else if (cp < 0x20) {
-				duk_uint_fast8_t esc_char;
-
-				/* This approach is a bit shorter than a straight
-				 * if-else-ladder and also a bit faster.
-				 */
-				if (cp < (sizeof(duk__quote_esc) / sizeof(duk_uint8_t)) &&
-				    (esc_char = duk__quote_esc[cp]) != 0) {
-					DUK__EMIT_2(js_ctx, DUK_ASC_BACKSLASH, esc_char);
+			cp = *p;
+
+			if (DUK_LIKELY(cp <= 0x7f)) {
+				/* ascii fast path: avoid decoding utf-8 */
+				p++;
+				if (cp == 0x22 || cp == 0x5c) {
+					/* double quote or backslash */
+					*q++ = DUK_ASC_BACKSLASH;
+					*q++ = (duk_uint8_t) cp;
+				} else if (cp < 0x20) {
+					duk_uint_fast8_t esc_char;
+
+					/* This approach is a bit shorter than a straight
+					 * if-else-ladder and also a bit faster.
+					 */
+					if (cp < (sizeof(duk__quote_esc) / sizeof(duk_uint8_t)) &&
+					    (esc_char = duk__quote_esc[cp]) != 0) {
+						*q++ = DUK_ASC_BACKSLASH;
+						*q++ = (duk_uint8_t) esc_char;
+					} else {
+						q = duk__emit_esc_auto_fast(js_ctx, cp, q);
+					}
+				} else if (cp == 0x7f && js_ctx->flag_ascii_only) {
+					q = duk__emit_esc_auto_fast(js_ctx, cp, q);
 				} else {
-					DUK__EMIT_ESC_AUTO(js_ctx, cp);
+					/* any other printable -> as is */
+					*q++ = (duk_uint8_t) cp;
 				}
-			} else if (cp == 0x7f && js_ctx->flag_ascii_only) {
-				DUK__EMIT_ESC_AUTO(js_ctx, cp);
 			} else {
-				/* any other printable -> as is */
-				DUK__EMIT_1(js_ctx, cp);
-			}
-		} else {
-			/* slow path decode */
-
-			/* If XUTF-8 decoding fails, treat the offending byte as a codepoint directly
-			 * and go forward one byte.  This is of course very lossy, but allows some kind
-			 * of output to be produced even for internal strings which don't conform to
-			 * XUTF-8.  All standard Ecmascript strings are always CESU-8, so this behavior
-			 * does not violate the Ecmascript specification.  The behavior is applied to
-			 * all modes, including Ecmascript standard JSON.  Because the current XUTF-8
-			 * decoding is not very strict, this behavior only really affects initial bytes
-			 * and truncated codepoints.
-			 *
-			 * XXX: another alternative would be to scan forwards to start of next codepoint
-			 * (or end of input) and emit just one replacement codepoint.
-			 */
+				/* slow path decode */
+
+				/* If XUTF-8 decoding fails, treat the offending byte as a codepoint directly
+				 * and go forward one byte.  This is of course very lossy, but allows some kind
+				 * of output to be produced even for internal strings which don't conform to
+				 * XUTF-8.  All standard Ecmascript strings are always CESU-8, so this behavior
+				 * does not violate the Ecmascript specification.  The behavior is applied to
+				 * all modes, including Ecmascript standard JSON.  Because the current XUTF-8
+				 * decoding is not very strict, this behavior only really affects initial bytes
+				 * and truncated codepoints.
+				 *
+				 * XXX: another alternative would be to scan forwards to start of next codepoint
+				 * (or end of input) and emit just one replacement codepoint.
+				 */
 
-			p_tmp = p;
-			if (!duk_unicode_decode_xutf8(thr, &p, p_start, p_end, &cp)) {
-				/* Decode failed. */
-				cp = *p_tmp;
-				p = p_tmp + 1;
-			}
+				p_tmp = p;
+				if (!duk_unicode_decode_xutf8(thr, &p, p_start, p_end, &cp)) {
+					/* Decode failed. */
+					cp = *p_tmp;
+					p = p_tmp + 1;
+				}
 
 #ifdef DUK_USE_NONSTD_JSON_ESC_U2028_U2029
-			if (js_ctx->flag_ascii_only || cp == 0x2028 || cp == 0x2029) {
+				if (js_ctx->flag_ascii_only || cp == 0x2028 || cp == 0x2029) {
 #else
-			if (js_ctx->flag_ascii_only) {
+				if (js_ctx->flag_ascii_only) {
 #endif
-				DUK__EMIT_ESC_AUTO(js_ctx, cp);
-			} else {
-				/* as is */
-				DUK__EMIT_XUTF8(js_ctx, cp);
+					q = duk__emit_esc_auto_fast(js_ctx, cp, q);
+				} else {
+					/* as is */
+					q += duk_unicode_encode_xutf8(cp, q);
+				}
 			}
 		}
+
+		duk__emit_commit(js_ctx, q);
 	}
 
-	DUK__EMIT_1(js_ctx, DUK_ASC_DOUBLEQUOTE);
+	q = duk__emit_reserve(js_ctx, 1);
+	*q++ = DUK_ASC_DOUBLEQUOTE;
+	duk__emit_commit(js_ctx, q);
 }
 
 /* Shared entry handling for object/array serialization: indent/stepback,
@@ -1549,18 +1858,38 @@ DUK_LOCAL void duk__enc_value2(duk_json_enc_ctx *js_ctx) {
 #if defined(DUK_USE_JX)
 		{
 			duk_uint8_t *p, *p_end;
+			duk_uint8_t *q;
+			duk_size_t off, n;
 			duk_small_uint_t x;
 			duk_hbuffer *h;
 
 			h = DUK_TVAL_GET_BUFFER(tv);
 			DUK_ASSERT(h != NULL);
-			p = (duk_uint8_t *) DUK_HBUFFER_GET_DATA_PTR(h);
-			p_end = p + DUK_HBUFFER_GET_SIZE(h);
 			DUK__EMIT_1(js_ctx, DUK_ASC_PIPE);
-			while (p < p_end) {
-				x = *p++;
-				duk_hbuffer_append_byte(js_ctx->thr, js_ctx->h_buf, duk_lc_digits[(x >> 4) & 0x0f]);
-				duk_hbuffer_append_byte(js_ctx->thr, js_ctx->h_buf, duk_lc_digits[x & 0x0f]);
+			for (off = 0; off < DUK_HBUFFER_GET_SIZE(h); off += n) {
+				q = duk__emit_reserve(js_ctx, 2 * DUK__JSON_QUOTE_CHUNK);
+
+				/* Look up data pointer and size only after the
+				 * reservation, which may call a sink.
+				 */
+				n = (DUK_HBUFFER_GET_SIZE(h) > off ? DUK_HBUFFER_GET_SIZE(h) - off : 0);
+				if (n > DUK__JSON_QUOTE_CHUNK) {
+					n = DUK__JSON_QUOTE_CHUNK;
+				}
+				p = (duk_uint8_t *) DUK_HBUFFER_GET_DATA_PTR(h) + off;
+				p_end = p + n;
+				while (p < p_end) {
+					x = *p++;
+#if defined(DUK_USE_HEX_FASTPATH)
+					/* 'q' may be unaligned */
+					DUK_MEMCPY((void *) q, (const void *) (duk_hex_enctab + x), 2);
+					q += 2;
+#else
+					*q++ = duk_lc_digits[(x >> 4) & 0x0f];
+					*q++ = duk_lc_digits[x & 0x0f];
+#endif
+				}
+				duk__emit_commit(js_ctx, q);
 			}
 			DUK__EMIT_1(js_ctx, DUK_ASC_PIPE);
 		}
@@ -1587,7 +1916,7 @@ DUK_LOCAL void duk__enc_value2(duk_json_enc_ctx *js_ctx) {
 		DUK__EMIT_STRIDX(js_ctx, js_ctx->stridx_custom_function);
 #else
 		/* Standard JSON omits functions */
-		DUK_NEVER_HERE();
+		DUK_UNREACHABLE();
 #endif
 		break;
 	}
@@ -1673,6 +2002,297 @@ DUK_LOCAL duk_bool_t duk__enc_allow_into_proplist(duk_tval *tv) {
 	return 0;
 }
 
+#if defined(DUK_USE_JSON_STRINGIFY_FASTPATH)
+/*
+ *  JSON.stringify() fast path
+ *
+ *  Plain objects, dense arrays and primitive values are serialized directly
+ *  from object property storage without the value stack juggling of the
+ *  standard algorithm.  The fast path is only used for standard JSON when
+ *  there's no replacer, property list, or indent.
+ *
+ *  When something is encountered which may have side effects or which needs
+ *  the full algorithm (toJSON(), accessors, Proxy objects, wrapper objects,
+ *  array gaps, lightfuncs, loops, deep nesting, etc), the fast path is
+ *  aborted with a longjmp and the caller restarts serialization from scratch
+ *  using the standard algorithm.  Restarting is safe because the fast path
+ *  has no side effects other than writing to the output buffer.
+ */
+
+DUK_LOCAL void duk__json_fast_abort(duk_json_enc_ctx *js_ctx) {
+	duk_hthread *thr = js_ctx->thr;
+
+	/* Throw directly without creating an error object: the value is
+	 * never visible to user code and an Error would go through the
+	 * error augmentation handlers.
+	 */
+	DUK_DD(DUK_DDPRINT("JSON.stringify() fast path aborted, falling back to slow path"));
+	duk_push_undefined((duk_context *) thr);
+	duk_err_setup_heap_ljstate(thr, DUK_LJ_TYPE_THROW);
+	duk_err_longjmp(thr);
+	DUK_UNREACHABLE();
+}
+
+/* Check whether 'obj' or any of its ancestors has a 'toJSON' property,
+ * aborting on Proxy objects whose traps can't be checked here.
+ */
+DUK_LOCAL duk_bool_t duk__json_fast_has_tojson(duk_json_enc_ctx *js_ctx, duk_hobject *obj) {
+	duk_hthread *thr = js_ctx->thr;
+	duk_hstring *h_key = DUK_HTHREAD_STRING_TO_JSON(thr);
+	duk_int_t e_idx;
+	duk_int_t h_idx;
+	duk_uint_t sanity;
+
+	sanity = DUK_HOBJECT_PROTOTYPE_CHAIN_SANITY;
+	do {
+		if (DUK_HOBJECT_HAS_EXOTIC_PROXYOBJ(obj)) {
+			duk__json_fast_abort(js_ctx);
+		}
+		duk_hobject_find_existing_entry(obj, h_key, &e_idx, &h_idx);
+		if (e_idx >= 0) {
+			return 1;
+		}
+		obj = DUK_HOBJECT_GET_PROTOTYPE(obj);
+	} while (obj != NULL && --sanity > 0);
+
+	return 0;
+}
+
+DUK_LOCAL void duk__json_fast_number(duk_json_enc_ctx *js_ctx, duk_double_t d) {
+	duk_context *ctx = (duk_context *) js_ctx->thr;
+	duk_small_int_t c;
+	duk_int32_t i32;
+	duk_uint32_t u32;
+	duk_uint8_t buf[11];
+	duk_uint8_t *p;
+	duk_uint8_t *q;
+	duk_size_t len;
+
+	c = (duk_small_int_t) DUK_FPCLASSIFY(d);
+	if (DUK_UNLIKELY(c == DUK_FP_INFINITE || c == DUK_FP_NAN)) {
+		DUK__EMIT_STRIDX(js_ctx, DUK_STRIDX_LC_NULL);
+		return;
+	}
+
+	if (d >= -2147483648.0 && d <= 2147483647.0) {
+		i32 = (duk_int32_t) d;
+		if ((duk_double_t) i32 == d) {
+			/* Integers (and negative zero, which serializes as '0')
+			 * are formatted inline without interning a string.
+			 */
+			u32 = (duk_uint32_t) i32;
+			if (i32 < 0) {
+				u32 = (duk_uint32_t) 0 - u32;
+			}
+			p = buf + sizeof(buf);
+			do {
+				*--p = (duk_uint8_t) (DUK_ASC_0 + (u32 % 10));
+				u32 /= 10;
+			} while (u32 > 0);
+			if (i32 < 0) {
+				*--p = (duk_uint8_t) DUK_ASC_MINUS;
+			}
+			len = (duk_size_t) (buf + sizeof(buf) - p);
+			q = duk__emit_reserve(js_ctx, len);
+			DUK_MEMCPY((void *) q, (const void *) p, len);
+			duk__emit_commit(js_ctx, q + len);
+			return;
+		}
+	}
+
+	duk_push_number(ctx, d);
+	duk_numconv_stringify(ctx, 10 /*radix*/, 0 /*digits*/, 0 /*flags*/);
+	DUK__EMIT_HSTR(js_ctx, duk_get_hstring(ctx, -1));
+	duk_pop(ctx);
+}
+
+/* Serialize a value.  Returns zero (and emits nothing) if the value would
+ * serialize to 'undefined' so that the caller can omit or replace it.
+ */
+DUK_LOCAL duk_bool_t duk__json_fast_value(duk_json_enc_ctx *js_ctx, duk_tval *tv) {
+	duk_hobject *obj;
+	duk_small_uint_t c;
+	duk_uint_fast32_t i, n;
+	duk_int_t depth;
+
+	DUK_ASSERT(tv != NULL);
+
+	switch (DUK_TVAL_GET_TAG(tv)) {
+	case DUK_TAG_UNDEFINED:
+	case DUK_TAG_POINTER:
+	case DUK_TAG_BUFFER: {
+		return 0;
+	}
+	case DUK_TAG_NULL: {
+		DUK__EMIT_STRIDX(js_ctx, DUK_STRIDX_LC_NULL);
+		return 1;
+	}
+	case DUK_TAG_BOOLEAN: {
+		DUK__EMIT_STRIDX(js_ctx, DUK_TVAL_GET_BOOLEAN(tv) ?
+		                 DUK_STRIDX_TRUE : DUK_STRIDX_FALSE);
+		return 1;
+	}
+	case DUK_TAG_STRING: {
+		duk__enc_quote_string(js_ctx, DUK_TVAL_GET_STRING(tv));
+		return 1;
+	}
+	case DUK_TAG_OBJECT: {
+		break;
+	}
+	case DUK_TAG_LIGHTFUNC: {
+		/* Would need a toJSON() lookup through Function.prototype. */
+		duk__json_fast_abort(js_ctx);
+		return 0;  /* unreachable */
+	}
+	default: {
+		DUK_ASSERT(DUK_TVAL_IS_NUMBER(tv));
+		duk__json_fast_number(js_ctx, DUK_TVAL_GET_NUMBER(tv));
+		return 1;
+	}
+	}
+
+	obj = DUK_TVAL_GET_OBJECT(tv);
+	DUK_ASSERT(obj != NULL);
+
+	if (duk__json_fast_has_tojson(js_ctx, obj)) {
+		duk__json_fast_abort(js_ctx);
+	}
+	if (DUK_HOBJECT_IS_CALLABLE(obj)) {
+		/* functions are not serialized */
+		return 0;
+	}
+
+	c = (duk_small_uint_t) DUK_HOBJECT_GET_CLASS_NUMBER(obj);
+	if (c == DUK_HOBJECT_CLASS_OBJECT) {
+		if (DUK_HOBJECT_HAS_EXOTIC_BEHAVIOR(obj) || DUK_HOBJECT_HAS_ARRAY_PART(obj)) {
+			duk__json_fast_abort(js_ctx);
+		}
+	} else if (c == DUK_HOBJECT_CLASS_ARRAY) {
+		if ((DUK_HEAPHDR_GET_FLAGS(&obj->hdr) & DUK_HOBJECT_EXOTIC_BEHAVIOR_FLAGS) != DUK_HOBJECT_FLAG_EXOTIC_ARRAY ||
+		    !DUK_HOBJECT_HAS_ARRAY_PART(obj)) {
+			duk__json_fast_abort(js_ctx);
+		}
+	} else {
+		/* wrapper objects, Date, RegExp, etc */
+		duk__json_fast_abort(js_ctx);
+	}
+
+	/* Loop detection: loops and deep nesting are left to the slow path
+	 * which throws the appropriate errors.
+	 */
+	depth = js_ctx->recursion_depth;
+	if (depth >= DUK_JSON_ENC_LOOPARRAY) {
+		duk__json_fast_abort(js_ctx);
+	}
+	for (i = 0; i < (duk_uint_fast32_t) depth; i++) {
+		if (js_ctx->visiting[i] == obj) {
+			duk__json_fast_abort(js_ctx);
+		}
+	}
+	js_ctx->visiting[depth] = obj;
+	js_ctx->recursion_depth = depth + 1;
+
+	if (c == DUK_HOBJECT_CLASS_OBJECT) {
+		duk_hstring *k;
+		duk_small_uint_t prop_flags;
+		duk_size_t prev_size;
+		duk_bool_t first = 1;
+
+		DUK__EMIT_1(js_ctx, DUK_ASC_LCURLY);
+
+		/* Key order matches duk_hobject_get_enumerated_keys() for own
+		 * properties: an object without an array part is enumerated in
+		 * entry part order.
+		 */
+		n = (duk_uint_fast32_t) DUK_HOBJECT_GET_ENEXT(obj);
+		for (i = 0; i < n; i++) {
+			k = DUK_HOBJECT_E_GET_KEY(obj, i);
+			if (k == NULL || DUK_HSTRING_HAS_INTERNAL(k)) {
+				continue;
+			}
+			prop_flags = (duk_small_uint_t) DUK_HOBJECT_E_GET_FLAGS(obj, i);
+			if (!(prop_flags & DUK_PROPDESC_FLAG_ENUMERABLE)) {
+				continue;
+			}
+			if (prop_flags & DUK_PROPDESC_FLAG_ACCESSOR) {
+				duk__json_fast_abort(js_ctx);
+			}
+
+			/* Emit key speculatively and rewind if the value turns
+			 * out to serialize to 'undefined'.
+			 */
+			prev_size = DUK_HBUFFER_DYNAMIC_GET_SIZE(js_ctx->h_buf);
+			if (!first) {
+				DUK__EMIT_1(js_ctx, DUK_ASC_COMMA);
+			}
+			duk__enc_quote_string(js_ctx, k);
+			DUK__EMIT_1(js_ctx, DUK_ASC_COLON);
+
+			if (duk__json_fast_value(js_ctx, DUK_HOBJECT_E_GET_VALUE_TVAL_PTR(obj, i))) {
+				first = 0;
+			} else {
+				DUK_HBUFFER_DYNAMIC_SET_SIZE(js_ctx->h_buf, prev_size);
+			}
+		}
+
+		DUK__EMIT_1(js_ctx, DUK_ASC_RCURLY);
+	} else {
+		duk_tval *tv_len;
+		duk_tval *tv_val;
+
+		tv_len = duk_hobject_find_existing_entry_tval_ptr(obj, DUK_HTHREAD_STRING_LENGTH(js_ctx->thr));
+		if (tv_len == NULL || !DUK_TVAL_IS_NUMBER(tv_len)) {
+			duk__json_fast_abort(js_ctx);
+		}
+		n = (duk_uint_fast32_t) DUK_TVAL_GET_NUMBER(tv_len);
+		if (n > (duk_uint_fast32_t) DUK_HOBJECT_GET_ASIZE(obj)) {
+			/* trailing gaps may be inherited */
+			duk__json_fast_abort(js_ctx);
+		}
+
+		DUK__EMIT_1(js_ctx, DUK_ASC_LBRACKET);
+
+		for (i = 0; i < n; i++) {
+			if (i > 0) {
+				DUK__EMIT_1(js_ctx, DUK_ASC_COMMA);
+			}
+			tv_val = DUK_HOBJECT_A_GET_VALUE_PTR(obj, i);
+			if (DUK_TVAL_IS_UNDEFINED_UNUSED(tv_val)) {
+				/* gaps may be inherited */
+				duk__json_fast_abort(js_ctx);
+			}
+			if (!duk__json_fast_value(js_ctx, tv_val)) {
+				DUK__EMIT_STRIDX(js_ctx, DUK_STRIDX_LC_NULL);
+			}
+		}
+
+		DUK__EMIT_1(js_ctx, DUK_ASC_RBRACKET);
+	}
+
+	js_ctx->recursion_depth = depth;
+	return 1;
+}
+
+/* Stack policy: [ ... value js_ctx_ptr ] -> [ ... value js_ctx_ptr ]. */
+DUK_LOCAL duk_ret_t duk__json_stringify_fast(duk_context *ctx) {
+	duk_json_enc_ctx *js_ctx;
+
+	js_ctx = (duk_json_enc_ctx *) duk_get_pointer(ctx, -1);
+	DUK_ASSERT(js_ctx != NULL);
+	DUK_ASSERT(js_ctx->recursion_depth == 0);
+
+	/* Number serialization needs a value stack slot. */
+	duk_require_stack(ctx, DUK_JSON_ENC_REQSTACK);
+
+	if (!duk__json_fast_value(js_ctx, duk_get_tval(ctx, -2))) {
+		/* Top level 'undefined' result is handled by the slow path. */
+		duk__json_fast_abort(js_ctx);
+	}
+
+	return 0;
+}
+#endif  /* DUK_USE_JSON_STRINGIFY_FASTPATH */
+
 /*
  *  Top level wrappers
  */
@@ -1727,7 +2347,17 @@ void duk_bi_json_parse_helper(duk_context *ctx,
 	js_ctx->p_end = ((duk_uint8_t *) DUK_HSTRING_GET_DATA(h_text)) +
 	                DUK_HSTRING_GET_BYTELEN(h_text);
 
-	duk__dec_value(js_ctx);  /* -> [ ... value ] */
+	/* Reserve value stack slots for the object key cache; they're
+	 * initialized to undefined and dropped when parsing is done.
+	 */
+	duk_require_stack(ctx, DUK_JSON_DEC_KEYCACHE_SIZE);
+	js_ctx->idx_keycache = duk_get_top(ctx);
+	duk_set_top(ctx, js_ctx->idx_keycache + DUK_JSON_DEC_KEYCACHE_SIZE);
+
+	duk__dec_value(js_ctx);  /* -> [ ... keycache value ] */
+
+	duk_replace(ctx, js_ctx->idx_keycache);
+	duk_set_top(ctx, js_ctx->idx_keycache + 1);  /* -> [ ... value ] */
 
 	/* Trailing whitespace has been eaten by duk__dec_value(), so if
 	 * we're not at end of input here, it's a SyntaxError.
@@ -1776,7 +2406,9 @@ void duk_bi_json_stringify_helper(duk_context *ctx,
                                   duk_idx_t idx_value,
                                   duk_idx_t idx_replacer,
                                   duk_idx_t idx_space,
-                                  duk_small_uint_t flags) {
+                                  duk_small_uint_t flags,
+                                  duk_json_write_function write_cb,
+                                  void *write_udata) {
 	duk_hthread *thr = (duk_hthread *) ctx;
 	duk_json_enc_ctx js_ctx_alloc;
 	duk_json_enc_ctx *js_ctx = &js_ctx_alloc;
@@ -1812,6 +2444,8 @@ void duk_bi_json_stringify_helper(duk_context *ctx,
 #endif
 	js_ctx->idx_proplist = -1;
 	js_ctx->recursion_limit = DUK_JSON_ENC_RECURSION_LIMIT;
+	js_ctx->write_cb = write_cb;
+	js_ctx->write_udata = write_udata;
 
 	/* Flag handling currently assumes that flags are consistent.  This is OK
 	 * because the call sites are now strictly controlled.
@@ -1875,6 +2509,10 @@ void duk_bi_json_stringify_helper(duk_context *ctx,
 	js_ctx->h_buf = (duk_hbuffer_dynamic *) duk_get_hbuffer(ctx, -1);
 	DUK_ASSERT(js_ctx->h_buf != NULL);
 	DUK_ASSERT(DUK_HBUFFER_HAS_DYNAMIC(js_ctx->h_buf));
+	if (write_cb != NULL) {
+		/* Output is flushed to the sink whenever the chunk fills up. */
+		duk_hbuffer_resize(thr, js_ctx->h_buf, 0, DUK_JSON_ENC_SINK_CHUNK);
+	}
 
 	js_ctx->idx_loop = duk_push_object_internal(ctx);
 	DUK_ASSERT(js_ctx->idx_loop >= 0);
@@ -1985,6 +2623,61 @@ void duk_bi_json_stringify_helper(duk_context *ctx,
 
 	/* [ ... buf loop (proplist) (gap) ] */
 
+	/*
+	 *  Fast path: serialize directly from property storage when there's
+	 *  no replacer, proplist, or indent.  If the fast path can't handle
+	 *  the value, it aborts and we fall back to the slow path below.
+	 *  Not used with a sink because output already given to the sink
+	 *  can't be taken back.
+	 */
+
+#if defined(DUK_USE_JSON_STRINGIFY_FASTPATH)
+	if (js_ctx->h_replacer == NULL &&
+	    js_ctx->idx_proplist == -1 &&
+	    js_ctx->h_gap == NULL &&
+	    js_ctx->flags == 0 &&
+	    js_ctx->write_cb == NULL) {
+		duk_int_t pcall_rc;
+#ifdef DUK_USE_MARK_AND_SWEEP
+		duk_small_uint_t prev_mark_and_sweep_base_flags;
+#endif
+
+		DUK_DDD(DUK_DDDPRINT("try JSON.stringify() fast path"));
+
+		/* Finalizers and object compaction are prevented while the
+		 * fast path runs: they could mutate or reallocate property
+		 * tables while they're being walked.
+		 */
+#ifdef DUK_USE_MARK_AND_SWEEP
+		prev_mark_and_sweep_base_flags = thr->heap->mark_and_sweep_base_flags;
+		thr->heap->mark_and_sweep_base_flags |=
+		        DUK_MS_FLAG_NO_FINALIZERS |
+		        DUK_MS_FLAG_NO_OBJECT_COMPACTION;
+#endif
+
+		duk_dup(ctx, idx_value);
+		duk_push_pointer(ctx, (void *) js_ctx);
+		pcall_rc = duk_safe_call(ctx, duk__json_stringify_fast, 2 /*nargs*/, 0 /*nret*/);
+
+#ifdef DUK_USE_MARK_AND_SWEEP
+		thr->heap->mark_and_sweep_base_flags = prev_mark_and_sweep_base_flags;
+#endif
+
+		if (pcall_rc == DUK_EXEC_SUCCESS) {
+			DUK_DDD(DUK_DDDPRINT("JSON.stringify() fast path successful"));
+			DUK_ASSERT(js_ctx->recursion_depth == 0);
+			duk_push_hbuffer(ctx, (duk_hbuffer *) js_ctx->h_buf);
+			duk_to_string(ctx, -1);
+			goto replace_finished;
+		}
+
+		/* Restart from scratch; the buffer allocation is kept. */
+		DUK_DDD(DUK_DDDPRINT("JSON.stringify() fast path failed, use slow path"));
+		DUK_HBUFFER_DYNAMIC_SET_SIZE(js_ctx->h_buf, 0);
+		js_ctx->recursion_depth = 0;
+	}
+#endif  /* DUK_USE_JSON_STRINGIFY_FASTPATH */
+
 	/*
 	 *  Create wrapper object and serialize
 	 */
@@ -2031,19 +2724,28 @@ void duk_bi_json_stringify_helper(duk_context *ctx,
 		duk_push_undefined(ctx);
 	} else {
 		/*
-		 *  Finish and convert buffer to result string
+		 *  Finish and convert buffer to result string, or flush
+		 *  the remaining output to the sink (result is true)
 		 */
 
 		duk__enc_value2(js_ctx);  /* [ ... key val ] -> [ ... ] */
 		DUK_ASSERT(js_ctx->h_buf != NULL);
-		duk_push_hbuffer(ctx, (duk_hbuffer *) js_ctx->h_buf);
-		duk_to_string(ctx, -1);
+		if (js_ctx->write_cb != NULL) {
+			duk__emit_flush(js_ctx);
+			duk_push_true(ctx);
+		} else {
+			duk_push_hbuffer(ctx, (duk_hbuffer *) js_ctx->h_buf);
+			duk_to_string(ctx, -1);
+		}
 	}
 
 	/* The stack has a variable shape here, so force it to the
 	 * desired one explicitly.
 	 */
 
+#if defined(DUK_USE_JSON_STRINGIFY_FASTPATH)
+ replace_finished:
+#endif
 	duk_replace(ctx, entry_top);
 	duk_set_top(ctx, entry_top + 1);
 
@@ -2076,6 +2778,8 @@ DUK_INTERNAL duk_ret_t duk_bi_json_object_stringify(duk_context *ctx) {
 	                             0 /*idx_value*/,
 	                             1 /*idx_replacer*/,
 	                             2 /*idx_space*/,
-	                             0 /*flags*/);
+	                             0 /*flags*/,
+	                             NULL /*write_cb*/,
+	                             NULL /*write_udata*/);
 	return 1;
 }
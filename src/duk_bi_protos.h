@@ -47,6 +47,16 @@ DUK_INTERNAL_DECL duk_ret_t duk_bi_boolean_prototype_tostring_shared(duk_context
 DUK_INTERNAL_DECL duk_ret_t duk_bi_buffer_constructor(duk_context *ctx);
 DUK_INTERNAL_DECL duk_ret_t duk_bi_buffer_prototype_tostring_shared(duk_context *ctx);
 
+DUK_INTERNAL_DECL duk_ret_t duk_bi_arraybuffer_constructor(duk_context *ctx);
+DUK_INTERNAL_DECL duk_ret_t duk_bi_arraybuffer_isview(duk_context *ctx);
+DUK_INTERNAL_DECL duk_ret_t duk_bi_arraybuffer_prototype_slice(duk_context *ctx);
+DUK_INTERNAL_DECL duk_ret_t duk_bi_typedarray_constructor(duk_context *ctx);
+DUK_INTERNAL_DECL duk_ret_t duk_bi_typedarray_set(duk_context *ctx);
+DUK_INTERNAL_DECL duk_ret_t duk_bi_typedarray_subarray(duk_context *ctx);
+DUK_INTERNAL_DECL duk_ret_t duk_bi_dataview_constructor(duk_context *ctx);
+DUK_INTERNAL_DECL duk_ret_t duk_bi_dataview_prototype_getter(duk_context *ctx);
+DUK_INTERNAL_DECL duk_ret_t duk_bi_dataview_prototype_setter(duk_context *ctx);
+
 DUK_INTERNAL_DECL duk_ret_t duk_bi_date_constructor(duk_context *ctx);
 DUK_INTERNAL_DECL duk_ret_t duk_bi_date_constructor_parse(duk_context *ctx);
 DUK_INTERNAL_DECL duk_ret_t duk_bi_date_constructor_utc(duk_context *ctx);
@@ -60,11 +70,15 @@ DUK_INTERNAL_DECL duk_ret_t duk_bi_date_prototype_set_shared(duk_context *ctx);
 DUK_INTERNAL_DECL duk_ret_t duk_bi_date_prototype_set_time(duk_context *ctx);
 /* Helpers exposed for internal use */
 DUK_INTERNAL_DECL duk_double_t duk_bi_date_get_now(duk_context *ctx);
+#if defined(DUK_USE_MARK_AND_SWEEP)
+DUK_INTERNAL_DECL duk_double_t duk_bi_date_get_timestamp(duk_context *ctx);
+#endif
 DUK_INTERNAL_DECL void duk_bi_date_format_timeval(duk_double_t timeval, duk_uint8_t *out_buf);
 
 DUK_INTERNAL_DECL duk_ret_t duk_bi_duktape_object_info(duk_context *ctx);
 DUK_INTERNAL_DECL duk_ret_t duk_bi_duktape_object_act(duk_context *ctx);
 DUK_INTERNAL_DECL duk_ret_t duk_bi_duktape_object_gc(duk_context *ctx);
+DUK_INTERNAL_DECL duk_ret_t duk_bi_duktape_object_heap_stats(duk_context *ctx);
 DUK_INTERNAL_DECL duk_ret_t duk_bi_duktape_object_fin(duk_context *ctx);
 DUK_INTERNAL_DECL duk_ret_t duk_bi_duktape_object_enc(duk_context *ctx);
 DUK_INTERNAL_DECL duk_ret_t duk_bi_duktape_object_dec(duk_context *ctx);
@@ -110,7 +124,9 @@ void duk_bi_json_stringify_helper(duk_context *ctx,
                                   duk_idx_t idx_value,
                                   duk_idx_t idx_replacer,
                                   duk_idx_t idx_space,
-                                  duk_small_uint_t flags);
+                                  duk_small_uint_t flags,
+                                  duk_json_write_function write_cb,
+                                  void *write_udata);
 DUK_INTERNAL_DECL duk_ret_t duk_bi_json_object_parse(duk_context *ctx);
 DUK_INTERNAL_DECL duk_ret_t duk_bi_json_object_stringify(duk_context *ctx);
 
@@ -180,6 +196,14 @@ DUK_INTERNAL_DECL duk_ret_t duk_bi_proxy_constructor(duk_context *ctx);
 DUK_INTERNAL_DECL duk_ret_t duk_bi_proxy_constructor_revocable(duk_context *ctx);
 #endif
 
+DUK_INTERNAL_DECL duk_ret_t duk_bi_weakmap_constructor(duk_context *ctx);
+DUK_INTERNAL_DECL duk_ret_t duk_bi_weakmap_prototype_delete(duk_context *ctx);
+DUK_INTERNAL_DECL duk_ret_t duk_bi_weakmap_prototype_get(duk_context *ctx);
+DUK_INTERNAL_DECL duk_ret_t duk_bi_weakmap_prototype_has(duk_context *ctx);
+DUK_INTERNAL_DECL duk_ret_t duk_bi_weakmap_prototype_set(duk_context *ctx);
+DUK_INTERNAL_DECL duk_ret_t duk_bi_weakref_constructor(duk_context *ctx);
+DUK_INTERNAL_DECL duk_ret_t duk_bi_weakref_prototype_deref(duk_context *ctx);
+
 DUK_INTERNAL_DECL duk_ret_t duk_bi_thread_constructor(duk_context *ctx);
 DUK_INTERNAL_DECL duk_ret_t duk_bi_thread_resume(duk_context *ctx);
 DUK_INTERNAL_DECL duk_ret_t duk_bi_thread_yield(duk_context *ctx);
@@ -0,0 +1,701 @@
+/*
+ *  ArrayBuffer, DataView, and typed array built-ins (ES6 / Khronos typed
+ *  arrays).
+ *
+ *  All of these are duk_hbufferobject instances backed by a plain
+ *  duk_hbuffer.  Views (typed arrays and DataView) reference a byte slice
+ *  of the underlying buffer so that creating a view or a subarray never
+ *  copies data.  Element reads and writes are handled by the property code
+ *  and executor fast paths using duk_hbufferobject_get_index() and
+ *  duk_hbufferobject_put_index().
+ *
+ *  Differences to ES6:
+ *
+ *    - There's no %TypedArray% constructor; the shared prototype of the
+ *      typed array prototypes exists but is not exposed.
+ *
+ *    - 'buffer', 'byteLength', 'byteOffset' and 'length' are non-writable
+ *      virtual own properties rather than inherited accessors.
+ *
+ *    - An ArrayBuffer can be constructed from a plain buffer or a
+ *      Duktape.Buffer object; the buffer data is then shared, not copied.
+ *      If such a buffer is dynamic and is resized so that a view's slice
+ *      is no longer covered, the view behaves as if it had zero length.
+ */
+
+#include "duk_internal.h"
+
+/* Element size log2, indexed by element type. */
+DUK_LOCAL const duk_uint8_t duk__elem_shift[DUK_HBUFFEROBJECT_ELEM_MAX + 1] = {
+	0,  /* DUK_HBUFFEROBJECT_ELEM_UINT8 */
+	0,  /* DUK_HBUFFEROBJECT_ELEM_UINT8CLAMPED */
+	0,  /* DUK_HBUFFEROBJECT_ELEM_INT8 */
+	1,  /* DUK_HBUFFEROBJECT_ELEM_UINT16 */
+	1,  /* DUK_HBUFFEROBJECT_ELEM_INT16 */
+	2,  /* DUK_HBUFFEROBJECT_ELEM_UINT32 */
+	2,  /* DUK_HBUFFEROBJECT_ELEM_INT32 */
+	2,  /* DUK_HBUFFEROBJECT_ELEM_FLOAT32 */
+	3   /* DUK_HBUFFEROBJECT_ELEM_FLOAT64 */
+};
+
+/* Typed array class number, indexed by element type. */
+DUK_LOCAL const duk_uint8_t duk__typedarray_classnum[DUK_HBUFFEROBJECT_ELEM_MAX + 1] = {
+	DUK_HOBJECT_CLASS_UINT8ARRAY,
+	DUK_HOBJECT_CLASS_UINT8CLAMPEDARRAY,
+	DUK_HOBJECT_CLASS_INT8ARRAY,
+	DUK_HOBJECT_CLASS_UINT16ARRAY,
+	DUK_HOBJECT_CLASS_INT16ARRAY,
+	DUK_HOBJECT_CLASS_UINT32ARRAY,
+	DUK_HOBJECT_CLASS_INT32ARRAY,
+	DUK_HOBJECT_CLASS_FLOAT32ARRAY,
+	DUK_HOBJECT_CLASS_FLOAT64ARRAY
+};
+
+/* Typed array prototype built-in index, indexed by element type. */
+DUK_LOCAL const duk_uint8_t duk__typedarray_proto_bidx[DUK_HBUFFEROBJECT_ELEM_MAX + 1] = {
+	DUK_BIDX_UINT8ARRAY_PROTOTYPE,
+	DUK_BIDX_UINT8CLAMPEDARRAY_PROTOTYPE,
+	DUK_BIDX_INT8ARRAY_PROTOTYPE,
+	DUK_BIDX_UINT16ARRAY_PROTOTYPE,
+	DUK_BIDX_INT16ARRAY_PROTOTYPE,
+	DUK_BIDX_UINT32ARRAY_PROTOTYPE,
+	DUK_BIDX_INT32ARRAY_PROTOTYPE,
+	DUK_BIDX_FLOAT32ARRAY_PROTOTYPE,
+	DUK_BIDX_FLOAT64ARRAY_PROTOTYPE
+};
+
+/*
+ *  Helpers
+ */
+
+/* Push a new fixed buffer which is zeroed regardless of
+ * DUK_USE_ZERO_BUFFER_DATA, as required by the typed array semantics.
+ */
+DUK_LOCAL duk_hbuffer *duk__push_zeroed_buffer(duk_context *ctx, duk_size_t size) {
+	void *p;
+
+	p = duk_push_fixed_buffer(ctx, size);
+#if !defined(DUK_USE_ZERO_BUFFER_DATA)
+	DUK_MEMZERO(p, size);
+#else
+	DUK_UNREF(p);
+#endif
+	return duk_get_hbuffer(ctx, -1);
+}
+
+/* Push a new buffer object sharing 'h_buf', which must be reachable. */
+DUK_LOCAL duk_hbufferobject *duk__push_bufobj(duk_context *ctx, duk_small_uint_t classnum, duk_small_int_t proto_bidx, duk_hbuffer *h_buf, duk_uint_t offset, duk_uint_t length) {
+	duk_hthread *thr = (duk_hthread *) ctx;
+	duk_hbufferobject *h;
+
+	DUK_ASSERT(h_buf != NULL);
+
+	h = duk_push_bufferobject_raw(ctx,
+	                              DUK_HOBJECT_FLAG_EXTENSIBLE |
+	                              DUK_HOBJECT_CLASS_AS_FLAGS(classnum),
+	                              proto_bidx);
+	DUK_ASSERT(h != NULL);
+	h->buf = h_buf;
+	DUK_HBUFFER_INCREF(thr, h_buf);
+	DUK_UNREF(thr);
+	h->offset = offset;
+	h->length = length;
+	h->shift = 0;
+	h->elem_type = DUK_HBUFFEROBJECT_ELEM_UINT8;
+	h->is_typedarray = 0;
+	return h;
+}
+
+DUK_LOCAL duk_hbufferobject *duk__push_typedarray(duk_context *ctx, duk_small_uint_t elem_type, duk_hbuffer *h_buf, duk_uint_t offset, duk_uint_t length) {
+	duk_hbufferobject *h;
+
+	DUK_ASSERT(elem_type <= DUK_HBUFFEROBJECT_ELEM_MAX);
+
+	h = duk__push_bufobj(ctx,
+	                     (duk_small_uint_t) duk__typedarray_classnum[elem_type],
+	                     (duk_small_int_t) duk__typedarray_proto_bidx[elem_type],
+	                     h_buf,
+	                     offset,
+	                     length);
+	h->shift = duk__elem_shift[elem_type];
+	h->elem_type = (duk_uint8_t) elem_type;
+	h->is_typedarray = 1;
+	return h;
+}
+
+/* Set the 'buffer' property backing of a view to an existing ArrayBuffer. */
+DUK_LOCAL void duk__set_buf_prop(duk_hthread *thr, duk_hbufferobject *h, duk_hobject *h_ab) {
+	DUK_ASSERT(h->buf_prop == NULL);
+	DUK_ASSERT(h_ab != NULL);
+	DUK_ASSERT(DUK_HOBJECT_GET_CLASS_NUMBER(h_ab) == DUK_HOBJECT_CLASS_ARRAYBUFFER);
+
+	h->buf_prop = h_ab;
+	DUK_HOBJECT_INCREF(thr, h_ab);
+	DUK_UNREF(thr);
+}
+
+/* Return the buffer object at 'index' if its class matches 'classnum', or
+ * if it is any typed array when 'classnum' is zero; NULL otherwise.
+ */
+DUK_LOCAL duk_hbufferobject *duk__get_bufobj(duk_context *ctx, duk_idx_t index, duk_small_uint_t classnum) {
+	duk_hobject *h;
+
+	h = duk_get_hobject(ctx, index);
+	if (h == NULL || !DUK_HOBJECT_HAS_BUFFEROBJECT(h)) {
+		return NULL;
+	}
+	if (classnum == 0) {
+		return (((duk_hbufferobject *) h)->is_typedarray ? (duk_hbufferobject *) h : NULL);
+	}
+	return (DUK_HOBJECT_GET_CLASS_NUMBER(h) == classnum ? (duk_hbufferobject *) h : NULL);
+}
+
+/* Like duk__get_bufobj() but for 'this', which is left on the stack top. */
+DUK_LOCAL duk_hbufferobject *duk__require_bufobj_this(duk_context *ctx, duk_small_uint_t classnum) {
+	duk_hthread *thr = (duk_hthread *) ctx;
+	duk_hbufferobject *h;
+
+	duk_push_this(ctx);
+	h = duk__get_bufobj(ctx, -1, classnum);
+	if (h == NULL) {
+		DUK_ERROR(thr, DUK_ERR_TYPE_ERROR, DUK_STR_NOT_BUFFER);
+	}
+	return h;
+}
+
+/* Byte length of the accessible slice, zero if the underlying buffer no
+ * longer covers it.
+ */
+DUK_LOCAL duk_uint_t duk__bufobj_valid_length(duk_hbufferobject *h) {
+	return (DUK_HBUFFEROBJECT_VALID_SLICE(h) ? h->length : 0);
+}
+
+/* Relative index as used by slice() and subarray(): negative values count
+ * from the end, result is clamped to [0,len].  Undefined maps to 'def'.
+ */
+DUK_LOCAL duk_int_t duk__clamp_relative_index(duk_context *ctx, duk_idx_t index, duk_int_t len, duk_int_t def) {
+	duk_int_t v;
+
+	if (duk_is_undefined(ctx, index)) {
+		return def;
+	}
+	v = duk_to_int_clamped(ctx, index, -len, len);
+	if (v < 0) {
+		v += len;
+	}
+	return v;
+}
+
+/* Copy an array-like object at 'src_index' into typed array 'h' starting
+ * from element 'dst_elem'.  Values are coerced one at a time and may have
+ * side effects, so every write goes through duk_hbufferobject_put_index().
+ */
+DUK_LOCAL void duk__copy_arraylike(duk_context *ctx, duk_hbufferobject *h, duk_uint32_t dst_elem, duk_idx_t src_index, duk_uint32_t count) {
+	duk_hthread *thr = (duk_hthread *) ctx;
+	duk_uint32_t i;
+
+	for (i = 0; i < count; i++) {
+		duk_get_prop_index(ctx, src_index, (duk_uarridx_t) i);
+		(void) duk_to_number(ctx, -1);
+		(void) duk_hbufferobject_put_index(thr, h, dst_elem + i, duk_get_tval(ctx, -1));
+		duk_pop(ctx);
+	}
+}
+
+/* Convert elements between typed arrays with different element types.
+ * The areas must not overlap.
+ */
+DUK_LOCAL void duk__convert_elems(duk_hthread *thr, duk_small_uint_t dst_type, duk_uint8_t *p_dst, duk_small_uint_t src_type, duk_uint8_t *p_src, duk_uint_t count) {
+	duk_small_uint_t dst_shift = duk__elem_shift[dst_type];
+	duk_small_uint_t src_shift = duk__elem_shift[src_type];
+	duk_uint_t i;
+
+	for (i = 0; i < count; i++) {
+		duk_hbufferobject_write_elem(thr, dst_type, p_dst, duk_hbufferobject_read_elem(src_type, p_src));
+		p_dst += ((duk_size_t) 1 << dst_shift);
+		p_src += ((duk_size_t) 1 << src_shift);
+	}
+}
+
+/*
+ *  ArrayBuffer
+ */
+
+DUK_INTERNAL duk_ret_t duk_bi_arraybuffer_constructor(duk_context *ctx) {
+	duk_hthread *thr = (duk_hthread *) ctx;
+	duk_hobject *h_obj;
+	duk_hbuffer *h_buf;
+
+	if (!duk_is_constructor_call(ctx)) {
+		return DUK_RET_TYPE_ERROR;
+	}
+
+	/* Duktape extension: wrap a plain buffer or the buffer of a
+	 * Duktape.Buffer object without copying.
+	 */
+	h_obj = duk_get_hobject(ctx, 0);
+	if (duk_is_buffer(ctx, 0)) {
+		h_buf = duk_get_hbuffer(ctx, 0);
+	} else if (h_obj != NULL && DUK_HOBJECT_GET_CLASS_NUMBER(h_obj) == DUK_HOBJECT_CLASS_BUFFER) {
+		h_buf = duk_hobject_get_internal_value_buffer(thr->heap, h_obj);
+	} else {
+		duk_int_t len;
+
+		len = duk_to_int_check_range(ctx, 0, 0, (duk_int_t) DUK_HBUFFER_MAX_BYTELEN);
+		h_buf = duk__push_zeroed_buffer(ctx, (duk_size_t) len);
+	}
+	DUK_ASSERT(h_buf != NULL);
+
+	(void) duk__push_bufobj(ctx,
+	                        DUK_HOBJECT_CLASS_ARRAYBUFFER,
+	                        DUK_BIDX_ARRAYBUFFER_PROTOTYPE,
+	                        h_buf,
+	                        0,
+	                        (duk_uint_t) DUK_HBUFFER_GET_SIZE(h_buf));
+	return 1;
+}
+
+DUK_INTERNAL duk_ret_t duk_bi_arraybuffer_isview(duk_context *ctx) {
+	duk_hobject *h;
+
+	h = duk_get_hobject(ctx, 0);
+	duk_push_boolean(ctx, (h != NULL &&
+	                       DUK_HOBJECT_HAS_BUFFEROBJECT(h) &&
+	                       DUK_HOBJECT_GET_CLASS_NUMBER(h) != DUK_HOBJECT_CLASS_ARRAYBUFFER));
+	return 1;
+}
+
+DUK_INTERNAL duk_ret_t duk_bi_arraybuffer_prototype_slice(duk_context *ctx) {
+	duk_hbufferobject *h_this;
+	duk_hbuffer *h_buf;
+	duk_int_t len;
+	duk_int_t start;
+	duk_int_t end;
+
+	h_this = duk__require_bufobj_this(ctx, DUK_HOBJECT_CLASS_ARRAYBUFFER);
+	len = (duk_int_t) duk__bufobj_valid_length(h_this);
+	start = duk__clamp_relative_index(ctx, 0, len, 0);
+	end = duk__clamp_relative_index(ctx, 1, len, len);
+	if (end < start) {
+		end = start;
+	}
+
+	h_buf = duk__push_zeroed_buffer(ctx, (duk_size_t) (end - start));
+	if (DUK_HBUFFEROBJECT_VALID_SLICE(h_this)) {
+		/* Revalidate, coercion side effects may have resized the buffer. */
+		DUK_MEMCPY((void *) DUK_HBUFFER_GET_DATA_PTR(h_buf),
+		           (const void *) (DUK_HBUFFEROBJECT_GET_SLICE_BASE(h_this) + start),
+		           (size_t) (end - start));
+	}
+
+	(void) duk__push_bufobj(ctx,
+	                        DUK_HOBJECT_CLASS_ARRAYBUFFER,
+	                        DUK_BIDX_ARRAYBUFFER_PROTOTYPE,
+	                        h_buf,
+	                        0,
+	                        (duk_uint_t) (end - start));
+	return 1;
+}
+
+/*
+ *  Typed array constructors, shared by all element types (magic is the
+ *  element type).
+ */
+
+DUK_INTERNAL duk_ret_t duk_bi_typedarray_constructor(duk_context *ctx) {
+	duk_hthread *thr = (duk_hthread *) ctx;
+	duk_small_uint_t elem_type;
+	duk_small_uint_t shift;
+	duk_uint_t mask;
+	duk_hobject *h_obj;
+	duk_hbufferobject *h_src;
+	duk_hbufferobject *h_res;
+	duk_hbuffer *h_buf;
+	duk_uint_t count;
+
+	if (!duk_is_constructor_call(ctx)) {
+		return DUK_RET_TYPE_ERROR;
+	}
+
+	elem_type = (duk_small_uint_t) duk_get_current_magic(ctx);
+	DUK_ASSERT(elem_type <= DUK_HBUFFEROBJECT_ELEM_MAX);
+	shift = duk__elem_shift[elem_type];
+	mask = ((duk_uint_t) 1 << shift) - 1;
+
+	h_obj = duk_get_hobject(ctx, 0);
+
+	h_src = duk__get_bufobj(ctx, 0, DUK_HOBJECT_CLASS_ARRAYBUFFER);
+	if (h_src != NULL) {
+		/* View of an existing ArrayBuffer, shares the data. */
+		duk_uint_t ab_len = h_src->length;
+		duk_uint_t offset;
+		duk_uint_t length;
+
+		offset = (duk_uint_t) duk_to_int_check_range(ctx, 1, 0, (duk_int_t) ab_len);
+		if (offset & mask) {
+			return DUK_RET_RANGE_ERROR;
+		}
+		if (duk_is_undefined(ctx, 2)) {
+			length = ab_len - offset;
+			if (length & mask) {
+				return DUK_RET_RANGE_ERROR;
+			}
+		} else {
+			length = (duk_uint_t) duk_to_int_check_range(ctx, 2, 0, (duk_int_t) ((ab_len - offset) >> shift)) << shift;
+		}
+
+		h_res = duk__push_typedarray(ctx, elem_type, h_src->buf, h_src->offset + offset, length);
+		duk__set_buf_prop(thr, h_res, (duk_hobject *) h_src);
+		return 1;
+	}
+
+	h_src = duk__get_bufobj(ctx, 0, 0);
+	if (h_src != NULL) {
+		/* Copy of another typed array, with element conversion. */
+		count = (duk_uint_t) DUK_HBUFFEROBJECT_GET_ELEM_COUNT(h_src);
+		if (!DUK_HBUFFEROBJECT_VALID_SLICE(h_src)) {
+			count = 0;
+		}
+		if (count > (duk_uint_t) (DUK_HBUFFER_MAX_BYTELEN >> shift)) {
+			return DUK_RET_RANGE_ERROR;
+		}
+
+		h_buf = duk__push_zeroed_buffer(ctx, (duk_size_t) count << shift);
+		h_res = duk__push_typedarray(ctx, elem_type, h_buf, 0, count << shift);
+		if (h_src->elem_type == elem_type) {
+			DUK_MEMCPY((void *) DUK_HBUFFER_GET_DATA_PTR(h_buf),
+			           (const void *) DUK_HBUFFEROBJECT_GET_SLICE_BASE(h_src),
+			           (size_t) count << shift);
+		} else {
+			duk__convert_elems(thr,
+			                   elem_type,
+			                   (duk_uint8_t *) DUK_HBUFFER_GET_DATA_PTR(h_buf),
+			                   h_src->elem_type,
+			                   DUK_HBUFFEROBJECT_GET_SLICE_BASE(h_src),
+			                   count);
+		}
+		return 1;
+	}
+
+	if (h_obj != NULL || duk_is_buffer(ctx, 0)) {
+		/* Array-like object (or a plain buffer), copy with coercion. */
+		duk_uint32_t len;
+
+		duk_get_prop_stridx(ctx, 0, DUK_STRIDX_LENGTH);
+		len = duk_to_uint32(ctx, -1);
+		duk_pop(ctx);
+		if (len > (duk_uint32_t) (DUK_HBUFFER_MAX_BYTELEN >> shift)) {
+			return DUK_RET_RANGE_ERROR;
+		}
+
+		h_buf = duk__push_zeroed_buffer(ctx, (duk_size_t) len << shift);
+		h_res = duk__push_typedarray(ctx, elem_type, h_buf, 0, (duk_uint_t) len << shift);
+		duk__copy_arraylike(ctx, h_res, 0, 0, len);
+		return 1;
+	}
+
+	/* Element count. */
+	count = (duk_uint_t) duk_to_int_check_range(ctx, 0, 0, (duk_int_t) (DUK_HBUFFER_MAX_BYTELEN >> shift));
+	h_buf = duk__push_zeroed_buffer(ctx, (duk_size_t) count << shift);
+	(void) duk__push_typedarray(ctx, elem_type, h_buf, 0, count << shift);
+	return 1;
+}
+
+/*
+ *  Typed array prototype methods
+ */
+
+DUK_INTERNAL duk_ret_t duk_bi_typedarray_set(duk_context *ctx) {
+	duk_hthread *thr = (duk_hthread *) ctx;
+	duk_hbufferobject *h_this;
+	duk_hbufferobject *h_src;
+	duk_uint_t dst_count;
+	duk_uint_t src_count;
+	duk_uint_t offset;
+
+	h_this = duk__require_bufobj_this(ctx, 0);
+	offset = (duk_uint_t) duk_to_int_check_range(ctx, 1, 0, DUK_INT_MAX);
+
+	/* The element count is fixed, only the slice validity may change
+	 * due to coercion side effects.
+	 */
+	dst_count = (duk_uint_t) DUK_HBUFFEROBJECT_GET_ELEM_COUNT(h_this);
+
+	h_src = duk__get_bufobj(ctx, 0, 0);
+	if (h_src != NULL) {
+		duk_uint8_t *p_dst;
+		duk_uint8_t *p_src;
+
+		src_count = (duk_uint_t) DUK_HBUFFEROBJECT_GET_ELEM_COUNT(h_src);
+		if (offset > dst_count || src_count > dst_count - offset) {
+			return DUK_RET_RANGE_ERROR;
+		}
+		if (!DUK_HBUFFEROBJECT_VALID_SLICE(h_this) || !DUK_HBUFFEROBJECT_VALID_SLICE(h_src)) {
+			return 0;
+		}
+
+		p_dst = DUK_HBUFFEROBJECT_GET_SLICE_BASE(h_this) + ((duk_size_t) offset << h_this->shift);
+		p_src = DUK_HBUFFEROBJECT_GET_SLICE_BASE(h_src);
+
+		if (h_src->elem_type == h_this->elem_type) {
+			/* Bulk copy, memmove() handles views of the same buffer. */
+			DUK_MEMMOVE((void *) p_dst, (const void *) p_src, (size_t) src_count << h_src->shift);
+		} else {
+			if (h_src->buf == h_this->buf) {
+				/* Views of the same buffer may overlap with different
+				 * element sizes; convert from a temporary copy.
+				 */
+				duk_uint8_t *p_tmp;
+
+				p_tmp = (duk_uint8_t *) duk_push_fixed_buffer(ctx, (duk_size_t) src_count << h_src->shift);
+				DUK_MEMCPY((void *) p_tmp, (const void *) p_src, (size_t) src_count << h_src->shift);
+				p_src = p_tmp;
+			}
+			duk__convert_elems(thr, h_this->elem_type, p_dst, h_src->elem_type, p_src, src_count);
+		}
+		return 0;
+	}
+
+	/* Array-like source. */
+	(void) duk_to_object(ctx, 0);
+	duk_get_prop_stridx(ctx, 0, DUK_STRIDX_LENGTH);
+	src_count = (duk_uint_t) duk_to_uint32(ctx, -1);
+	duk_pop(ctx);
+	if (offset > dst_count || src_count > dst_count - offset) {
+		return DUK_RET_RANGE_ERROR;
+	}
+	duk__copy_arraylike(ctx, h_this, (duk_uint32_t) offset, 0, (duk_uint32_t) src_count);
+	return 0;
+}
+
+DUK_INTERNAL duk_ret_t duk_bi_typedarray_subarray(duk_context *ctx) {
+	duk_hthread *thr = (duk_hthread *) ctx;
+	duk_hbufferobject *h_this;
+	duk_hbufferobject *h_res;
+	duk_hobject *h_ab;
+	duk_int_t len;
+	duk_int_t start;
+	duk_int_t end;
+
+	h_this = duk__require_bufobj_this(ctx, 0);
+	len = (duk_int_t) DUK_HBUFFEROBJECT_GET_ELEM_COUNT(h_this);
+	start = duk__clamp_relative_index(ctx, 0, len, 0);
+	end = duk__clamp_relative_index(ctx, 1, len, len);
+	if (end < start) {
+		end = start;
+	}
+
+	/* The result shares both the data and the 'buffer' ArrayBuffer. */
+	duk_hbufferobject_push_buffer_prop(thr, h_this);
+	h_ab = duk_get_hobject(ctx, -1);
+	DUK_ASSERT(h_ab != NULL);
+
+	h_res = duk__push_typedarray(ctx,
+	                             h_this->elem_type,
+	                             h_this->buf,
+	                             h_this->offset + ((duk_uint_t) start << h_this->shift),
+	                             (duk_uint_t) (end - start) << h_this->shift);
+	duk__set_buf_prop(thr, h_res, h_ab);
+	return 1;
+}
+
+/*
+ *  DataView
+ */
+
+DUK_INTERNAL duk_ret_t duk_bi_dataview_constructor(duk_context *ctx) {
+	duk_hthread *thr = (duk_hthread *) ctx;
+	duk_hbufferobject *h_ab;
+	duk_hbufferobject *h_res;
+	duk_uint_t offset;
+	duk_uint_t length;
+
+	if (!duk_is_constructor_call(ctx)) {
+		return DUK_RET_TYPE_ERROR;
+	}
+
+	h_ab = duk__get_bufobj(ctx, 0, DUK_HOBJECT_CLASS_ARRAYBUFFER);
+	if (h_ab == NULL) {
+		return DUK_RET_TYPE_ERROR;
+	}
+
+	offset = (duk_uint_t) duk_to_int_check_range(ctx, 1, 0, (duk_int_t) h_ab->length);
+	if (duk_is_undefined(ctx, 2)) {
+		length = h_ab->length - offset;
+	} else {
+		length = (duk_uint_t) duk_to_int_check_range(ctx, 2, 0, (duk_int_t) (h_ab->length - offset));
+	}
+
+	h_res = duk__push_bufobj(ctx,
+	                         DUK_HOBJECT_CLASS_DATAVIEW,
+	                         DUK_BIDX_DATAVIEW_PROTOTYPE,
+	                         h_ab->buf,
+	                         h_ab->offset + offset,
+	                         length);
+	duk__set_buf_prop(thr, h_res, (duk_hobject *) h_ab);
+	return 1;
+}
+
+/* Locate the bytes for a DataView access, RangeError if out of bounds. */
+DUK_LOCAL duk_uint8_t *duk__dataview_get_ptr(duk_context *ctx, duk_hbufferobject *h, duk_uint_t offset, duk_small_uint_t size) {
+	duk_hthread *thr = (duk_hthread *) ctx;
+
+	if (!DUK_HBUFFEROBJECT_VALID_SLICE(h) ||
+	    size > h->length ||
+	    offset > h->length - size) {
+		DUK_ERROR(thr, DUK_ERR_RANGE_ERROR, DUK_STR_NUMBER_OUTSIDE_RANGE);
+	}
+	return DUK_HBUFFEROBJECT_GET_SLICE_BASE(h) + offset;
+}
+
+/* Element bytes are converted through a host order temporary so that the
+ * element conversion helpers can be shared with typed arrays.  The host
+ * representation is reordered to big endian byte order using integer
+ * arithmetic, which also works for mixed endian doubles.
+ */
+DUK_LOCAL void duk__dataview_host_to_be(duk_uint8_t *p_host, duk_uint8_t *p_be, duk_small_uint_t size) {
+	duk_double_union du;
+	duk_uint32_t hi;
+	duk_uint32_t lo;
+	duk_uint16_t u16;
+
+	switch (size) {
+	case 1:
+		p_be[0] = p_host[0];
+		return;
+	case 2:
+		DUK_MEMCPY((void *) &u16, (const void *) p_host, 2);
+		hi = 0;
+		lo = (duk_uint32_t) u16;
+		break;
+	case 4:
+		DUK_MEMCPY((void *) &lo, (const void *) p_host, 4);
+		hi = 0;
+		break;
+	default:
+		DUK_ASSERT(size == 8);
+		DUK_MEMCPY((void *) du.uc, (const void *) p_host, 8);
+		hi = DUK_DBLUNION_GET_HIGH32(&du);
+		lo = DUK_DBLUNION_GET_LOW32(&du);
+		break;
+	}
+
+	if (size == 8) {
+		p_be[0] = (duk_uint8_t) (hi >> 24);
+		p_be[1] = (duk_uint8_t) (hi >> 16);
+		p_be[2] = (duk_uint8_t) (hi >> 8);
+		p_be[3] = (duk_uint8_t) hi;
+		p_be += 4;
+	}
+	if (size == 2) {
+		p_be[0] = (duk_uint8_t) (lo >> 8);
+		p_be[1] = (duk_uint8_t) lo;
+	} else {
+		p_be[0] = (duk_uint8_t) (lo >> 24);
+		p_be[1] = (duk_uint8_t) (lo >> 16);
+		p_be[2] = (duk_uint8_t) (lo >> 8);
+		p_be[3] = (duk_uint8_t) lo;
+	}
+}
+
+DUK_LOCAL void duk__dataview_be_to_host(duk_uint8_t *p_be, duk_uint8_t *p_host, duk_small_uint_t size) {
+	duk_double_union du;
+	duk_uint32_t hi;
+	duk_uint32_t lo;
+	duk_uint16_t u16;
+
+	switch (size) {
+	case 1:
+		p_host[0] = p_be[0];
+		break;
+	case 2:
+		u16 = (duk_uint16_t) (((duk_uint16_t) p_be[0] << 8) | (duk_uint16_t) p_be[1]);
+		DUK_MEMCPY((void *) p_host, (const void *) &u16, 2);
+		break;
+	case 4:
+		lo = ((duk_uint32_t) p_be[0] << 24) | ((duk_uint32_t) p_be[1] << 16) |
+		     ((duk_uint32_t) p_be[2] << 8) | (duk_uint32_t) p_be[3];
+		DUK_MEMCPY((void *) p_host, (const void *) &lo, 4);
+		break;
+	default:
+		DUK_ASSERT(size == 8);
+		hi = ((duk_uint32_t) p_be[0] << 24) | ((duk_uint32_t) p_be[1] << 16) |
+		     ((duk_uint32_t) p_be[2] << 8) | (duk_uint32_t) p_be[3];
+		lo = ((duk_uint32_t) p_be[4] << 24) | ((duk_uint32_t) p_be[5] << 16) |
+		     ((duk_uint32_t) p_be[6] << 8) | (duk_uint32_t) p_be[7];
+		DUK_DBLUNION_SET_HIGH32(&du, hi);
+		DUK_DBLUNION_SET_LOW32(&du, lo);
+		DUK_MEMCPY((void *) p_host, (const void *) du.uc, 8);
+		break;
+	}
+}
+
+DUK_LOCAL void duk__reverse_bytes(duk_uint8_t *p, duk_small_uint_t size) {
+	duk_small_uint_t i;
+	duk_uint8_t t;
+
+	for (i = 0; i < size / 2; i++) {
+		t = p[i];
+		p[i] = p[size - 1 - i];
+		p[size - 1 - i] = t;
+	}
+}
+
+DUK_INTERNAL duk_ret_t duk_bi_dataview_prototype_getter(duk_context *ctx) {
+	duk_hbufferobject *h_this;
+	duk_small_uint_t elem_type;
+	duk_small_uint_t size;
+	duk_uint_t offset;
+	duk_bool_t little_endian;
+	duk_uint8_t *p;
+	duk_uint8_t tmp_be[8];
+	duk_uint8_t tmp_host[8];
+
+	elem_type = (duk_small_uint_t) duk_get_current_magic(ctx);
+	DUK_ASSERT(elem_type <= DUK_HBUFFEROBJECT_ELEM_MAX);
+	size = (duk_small_uint_t) (1 << duk__elem_shift[elem_type]);
+
+	h_this = duk__require_bufobj_this(ctx, DUK_HOBJECT_CLASS_DATAVIEW);
+	offset = (duk_uint_t) duk_to_int_check_range(ctx, 0, 0, DUK_INT_MAX);
+	little_endian = duk_to_boolean(ctx, 1);
+
+	p = duk__dataview_get_ptr(ctx, h_this, offset, size);
+	DUK_MEMCPY((void *) tmp_be, (const void *) p, (size_t) size);
+	if (little_endian) {
+		duk__reverse_bytes(tmp_be, size);
+	}
+	duk__dataview_be_to_host(tmp_be, tmp_host, size);
+	duk_push_number(ctx, duk_hbufferobject_read_elem(elem_type, tmp_host));
+	return 1;
+}
+
+DUK_INTERNAL duk_ret_t duk_bi_dataview_prototype_setter(duk_context *ctx) {
+	duk_hthread *thr = (duk_hthread *) ctx;
+	duk_hbufferobject *h_this;
+	duk_small_uint_t elem_type;
+	duk_small_uint_t size;
+	duk_uint_t offset;
+	duk_double_t d;
+	duk_bool_t little_endian;
+	duk_uint8_t *p;
+	duk_uint8_t tmp_be[8];
+	duk_uint8_t tmp_host[8];
+
+	elem_type = (duk_small_uint_t) duk_get_current_magic(ctx);
+	DUK_ASSERT(elem_type <= DUK_HBUFFEROBJECT_ELEM_MAX);
+	size = (duk_small_uint_t) (1 << duk__elem_shift[elem_type]);
+
+	h_this = duk__require_bufobj_this(ctx, DUK_HOBJECT_CLASS_DATAVIEW);
+	offset = (duk_uint_t) duk_to_int_check_range(ctx, 0, 0, DUK_INT_MAX);
+	d = duk_to_number(ctx, 1);
+	little_endian = duk_to_boolean(ctx, 2);
+
+	duk_hbufferobject_write_elem(thr, elem_type, tmp_host, d);
+	duk__dataview_host_to_be(tmp_host, tmp_be, size);
+	if (little_endian) {
+		duk__reverse_bytes(tmp_be, size);
+	}
+	p = duk__dataview_get_ptr(ctx, h_this, offset, size);
+	DUK_MEMCPY((void *) p, (const void *) tmp_be, (size_t) size);
+	return 0;
+}
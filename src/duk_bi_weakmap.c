@@ -0,0 +1,215 @@
+/*
+ *  WeakMap (ES6 draft) and Duktape.WeakRef built-ins
+ *
+ *  Both are backed by duk_hweakobject, see duk_hweakobject.h.  Keys must
+ *  be objects; lightfuncs and plain buffers have no identity which could
+ *  be collected and are rejected like other primitive values.
+ */
+
+#include "duk_internal.h"
+
+#if defined(DUK_USE_WEAK_REFERENCES)
+
+/* Get 'this' as a weak object of the given class, left on the stack top. */
+DUK_LOCAL duk_hweakobject *duk__require_weakobject_this(duk_context *ctx, duk_small_uint_t classnum) {
+	duk_hthread *thr = (duk_hthread *) ctx;
+	duk_hobject *h;
+
+	duk_push_this(ctx);
+	h = duk_get_hobject(ctx, -1);
+	if (h == NULL || DUK_HOBJECT_GET_CLASS_NUMBER(h) != classnum) {
+		DUK_ERROR(thr, DUK_ERR_TYPE_ERROR, DUK_STR_UNEXPECTED_TYPE);
+	}
+	DUK_ASSERT(DUK_HOBJECT_IS_WEAKOBJECT(h));
+	return (duk_hweakobject *) h;
+}
+
+/*
+ *  WeakMap
+ */
+
+DUK_INTERNAL duk_ret_t duk_bi_weakmap_constructor(duk_context *ctx) {
+	duk_hthread *thr = (duk_hthread *) ctx;
+	duk_hweakobject *h;
+	duk_hobject *h_key;
+	duk_uint_t len;
+	duk_uint_t i;
+
+	if (!duk_is_constructor_call(ctx)) {
+		return DUK_RET_TYPE_ERROR;
+	}
+
+	duk_set_top(ctx, 1);
+	h = duk_push_weakobject_raw(ctx,
+	                            DUK_HOBJECT_FLAG_EXTENSIBLE |
+	                            DUK_HOBJECT_CLASS_AS_FLAGS(DUK_HOBJECT_CLASS_WEAKMAP),
+	                            DUK_BIDX_WEAKMAP_PROTOTYPE);
+	DUK_ASSERT(h != NULL);
+
+	/* ES6 accepts any iterable of [ key, value ] pairs.  There are no
+	 * iterators yet so accept an array-like instead.
+	 */
+	if (duk_is_null_or_undefined(ctx, 0)) {
+		return 1;
+	}
+	len = (duk_uint_t) duk_get_length(ctx, 0);
+	duk_to_object(ctx, 0);
+	for (i = 0; i < len; i++) {
+		duk_get_prop_index(ctx, 0, (duk_uarridx_t) i);  /* -> [ init map entry ] */
+		if (!duk_is_object(ctx, -1)) {
+			return DUK_RET_TYPE_ERROR;
+		}
+		duk_get_prop_index(ctx, 2, 0);
+		duk_get_prop_index(ctx, 2, 1);  /* -> [ init map entry key value ] */
+		h_key = duk_get_hobject(ctx, -2);
+		if (h_key == NULL) {
+			return DUK_RET_TYPE_ERROR;
+		}
+		duk_hweakobject_put(thr, h, h_key, duk_get_tval(ctx, -1));
+		duk_pop_3(ctx);
+	}
+
+	return 1;
+}
+
+DUK_INTERNAL duk_ret_t duk_bi_weakmap_prototype_delete(duk_context *ctx) {
+	duk_hthread *thr = (duk_hthread *) ctx;
+	duk_hweakobject *h;
+	duk_hobject *h_key;
+
+	h = duk__require_weakobject_this(ctx, DUK_HOBJECT_CLASS_WEAKMAP);
+	h_key = duk_get_hobject(ctx, 0);
+	duk_push_boolean(ctx, h_key != NULL && duk_hweakobject_remove(thr, h, h_key));
+	return 1;
+}
+
+DUK_INTERNAL duk_ret_t duk_bi_weakmap_prototype_get(duk_context *ctx) {
+	duk_hthread *thr = (duk_hthread *) ctx;
+	duk_hweakobject *h;
+	duk_hobject *h_key;
+	duk_weakentry *e;
+
+	h = duk__require_weakobject_this(ctx, DUK_HOBJECT_CLASS_WEAKMAP);
+	h_key = duk_get_hobject(ctx, 0);
+	if (h_key == NULL) {
+		return 0;
+	}
+	e = duk_hweakobject_find(thr->heap, h, h_key);
+	if (e == NULL) {
+		return 0;
+	}
+	duk_push_tval(ctx, &e->value);
+	return 1;
+}
+
+DUK_INTERNAL duk_ret_t duk_bi_weakmap_prototype_has(duk_context *ctx) {
+	duk_hthread *thr = (duk_hthread *) ctx;
+	duk_hweakobject *h;
+	duk_hobject *h_key;
+
+	h = duk__require_weakobject_this(ctx, DUK_HOBJECT_CLASS_WEAKMAP);
+	h_key = duk_get_hobject(ctx, 0);
+	duk_push_boolean(ctx, h_key != NULL && duk_hweakobject_find(thr->heap, h, h_key) != NULL);
+	return 1;
+}
+
+DUK_INTERNAL duk_ret_t duk_bi_weakmap_prototype_set(duk_context *ctx) {
+	duk_hthread *thr = (duk_hthread *) ctx;
+	duk_hweakobject *h;
+	duk_hobject *h_key;
+
+	duk_set_top(ctx, 2);
+	h = duk__require_weakobject_this(ctx, DUK_HOBJECT_CLASS_WEAKMAP);
+	h_key = duk_get_hobject(ctx, 0);
+	if (h_key == NULL) {
+		return DUK_RET_TYPE_ERROR;
+	}
+	duk_hweakobject_put(thr, h, h_key, duk_get_tval(ctx, 1));
+	return 1;  /* this */
+}
+
+/*
+ *  Duktape.WeakRef
+ */
+
+DUK_INTERNAL duk_ret_t duk_bi_weakref_constructor(duk_context *ctx) {
+	duk_hthread *thr = (duk_hthread *) ctx;
+	duk_hweakobject *h;
+	duk_hobject *h_target;
+	duk_tval tv_undef;
+
+	if (!duk_is_constructor_call(ctx)) {
+		return DUK_RET_TYPE_ERROR;
+	}
+
+	h_target = duk_get_hobject(ctx, 0);
+	if (h_target == NULL) {
+		return DUK_RET_TYPE_ERROR;
+	}
+	h = duk_push_weakobject_raw(ctx,
+	                            DUK_HOBJECT_FLAG_EXTENSIBLE |
+	                            DUK_HOBJECT_CLASS_AS_FLAGS(DUK_HOBJECT_CLASS_WEAKREF),
+	                            DUK_BIDX_WEAKREF_PROTOTYPE);
+	DUK_ASSERT(h != NULL);
+
+	DUK_TVAL_SET_UNDEFINED_ACTUAL(&tv_undef);
+	duk_hweakobject_put(thr, h, h_target, &tv_undef);
+	return 1;
+}
+
+DUK_INTERNAL duk_ret_t duk_bi_weakref_prototype_deref(duk_context *ctx) {
+	duk_hthread *thr = (duk_hthread *) ctx;
+	duk_hweakobject *h;
+	duk_uint32_t i;
+
+	h = duk__require_weakobject_this(ctx, DUK_HOBJECT_CLASS_WEAKREF);
+
+	/* At most one entry, which is removed once the target is freed. */
+	for (i = 0; i < h->size; i++) {
+		duk_weakentry *e = h->entries + i;
+		if (DUK_HWEAKOBJECT_ENTRY_IS_USED(thr->heap, e)) {
+			duk_push_hobject(ctx, e->key);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+#else  /* DUK_USE_WEAK_REFERENCES */
+
+DUK_INTERNAL duk_ret_t duk_bi_weakmap_constructor(duk_context *ctx) {
+	DUK_UNREF(ctx);
+	return DUK_RET_UNSUPPORTED_ERROR;
+}
+
+DUK_INTERNAL duk_ret_t duk_bi_weakmap_prototype_delete(duk_context *ctx) {
+	DUK_UNREF(ctx);
+	return DUK_RET_UNSUPPORTED_ERROR;
+}
+
+DUK_INTERNAL duk_ret_t duk_bi_weakmap_prototype_get(duk_context *ctx) {
+	DUK_UNREF(ctx);
+	return DUK_RET_UNSUPPORTED_ERROR;
+}
+
+DUK_INTERNAL duk_ret_t duk_bi_weakmap_prototype_has(duk_context *ctx) {
+	DUK_UNREF(ctx);
+	return DUK_RET_UNSUPPORTED_ERROR;
+}
+
+DUK_INTERNAL duk_ret_t duk_bi_weakmap_prototype_set(duk_context *ctx) {
+	DUK_UNREF(ctx);
+	return DUK_RET_UNSUPPORTED_ERROR;
+}
+
+DUK_INTERNAL duk_ret_t duk_bi_weakref_constructor(duk_context *ctx) {
+	DUK_UNREF(ctx);
+	return DUK_RET_UNSUPPORTED_ERROR;
+}
+
+DUK_INTERNAL duk_ret_t duk_bi_weakref_prototype_deref(duk_context *ctx) {
+	DUK_UNREF(ctx);
+	return DUK_RET_UNSUPPORTED_ERROR;
+}
+
+#endif  /* DUK_USE_WEAK_REFERENCES */
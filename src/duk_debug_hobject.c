@@ -150,6 +150,7 @@ DUK_INTERNAL void duk_debug_dump_hobject(duk_hobject *obj) {
 	DUK_D(DUK_DPRINT("  %sbound", (const char *) (DUK_HOBJECT_HAS_BOUND(obj) ? str_empty : str_excl)));
 	DUK_D(DUK_DPRINT("  %scompiledfunction", (const char *) (DUK_HOBJECT_HAS_COMPILEDFUNCTION(obj) ? str_empty : str_excl)));
 	DUK_D(DUK_DPRINT("  %snativefunction", (const char *) (DUK_HOBJECT_HAS_NATIVEFUNCTION(obj) ? str_empty : str_excl)));
+	DUK_D(DUK_DPRINT("  %sbufferobject", (const char *) (DUK_HOBJECT_HAS_BUFFEROBJECT(obj) ? str_empty : str_excl)));
 	DUK_D(DUK_DPRINT("  %sthread", (const char *) (DUK_HOBJECT_HAS_THREAD(obj) ? str_empty : str_excl)));
 	DUK_D(DUK_DPRINT("  %sarray_part", (const char *) (DUK_HOBJECT_HAS_ARRAY_PART(obj) ? str_empty : str_excl)));
 	DUK_D(DUK_DPRINT("  %sstrict", (const char *) (DUK_HOBJECT_HAS_STRICT(obj) ? str_empty : str_excl)));
@@ -219,6 +220,15 @@ DUK_INTERNAL void duk_debug_dump_hobject(duk_hobject *obj) {
 		DUK_D(DUK_DPRINT("  hnativefunction"));
 		/* XXX: h->func, cannot print function pointers portably */
 		DUK_D(DUK_DPRINT("  nargs: %ld", (long) h->nargs));
+	} else if (DUK_HOBJECT_IS_BUFFEROBJECT(obj)) {
+		duk_hbufferobject *h = (duk_hbufferobject *) obj;
+		DUK_UNREF(h);
+
+		DUK_D(DUK_DPRINT("  hbufferobject"));
+		DUK_D(DUK_DPRINT("  buf: %p, buf_prop: %p", (void *) h->buf, (void *) h->buf_prop));
+		DUK_D(DUK_DPRINT("  offset: %ld, length: %ld, shift: %ld, elem_type: %ld, is_typedarray: %ld",
+		                 (long) h->offset, (long) h->length, (long) h->shift,
+		                 (long) h->elem_type, (long) h->is_typedarray));
 	} else if (DUK_HOBJECT_IS_THREAD(obj)) {
 		duk_hthread *thr = (duk_hthread *) obj;
 		duk_tval *p;
@@ -346,9 +356,7 @@ DUK_INTERNAL void duk_debug_dump_hobject(duk_hobject *obj) {
 
 	if (DUK_HOBJECT_GET_PROPS(obj)) {
 		DUK_D(DUK_DPRINT("  props alloc size: %ld",
-		                 (long) DUK_HOBJECT_P_COMPUTE_SIZE(DUK_HOBJECT_GET_ESIZE(obj),
-		                                                   DUK_HOBJECT_GET_ASIZE(obj),
-		                                                   DUK_HOBJECT_GET_HSIZE(obj))));
+		                 (long) DUK_HOBJECT_E_ALLOC_SIZE(obj)));
 	} else {
 		DUK_D(DUK_DPRINT("  props alloc size: n/a"));
 	}
@@ -358,15 +366,16 @@ DUK_INTERNAL void duk_debug_dump_hobject(duk_hobject *obj) {
 		duk_hstring *k;
 		duk_propvalue *v;
 
-		k = DUK_HOBJECT_E_GET_KEY(obj, i);
-		v = DUK_HOBJECT_E_GET_VALUE_PTR(obj, i);
-		DUK_UNREF(v);
-
 		if (i >= DUK_HOBJECT_GET_ENEXT(obj)) {
+			/* Shaped objects have no key storage for unused slots. */
 			DUK_D(DUK_DPRINT("    [%ld]: UNUSED", (long) i));
 			continue;
 		}
 
+		k = DUK_HOBJECT_E_GET_KEY(obj, i);
+		v = DUK_HOBJECT_E_GET_VALUE_PTR(obj, i);
+		DUK_UNREF(v);
+
 		if (!k) {
 			DUK_D(DUK_DPRINT("    [%ld]: NULL", (long) i));
 			continue;
@@ -79,14 +79,14 @@ DUK_LOCAL const char *duk__bc_optab[] = {
 	"CLOSURE",  "GETPROP", 	"PUTPROP",  "DELPROP",  "CSPROP",   "CSPROPI",  "ADD",      "SUB",      "MUL",      "DIV",
 	"MOD",      "BAND",     "BOR",      "BXOR",     "BASL",     "BLSR", 	"BASR",     "BNOT", 	"LNOT",     "EQ",
 	"NEQ",      "SEQ",      "SNEQ",     "GT",       "GE",       "LT",       "LE",       "IF", 	"INSTOF",   "IN",
-	"JUMP",     "RETURN",   "CALL",     "CALLI",    "LABEL",    "ENDLABEL", "BREAK",    "CONTINUE", "TRYCATCH", "UNUSED59",
-	"UNUSED60", "EXTRA",    "DEBUG",    "INVALID",
+	"JUMP",     "RETURN",   "CALL",     "CALLI",    "LABEL",    "ENDLABEL", "BREAK",    "CONTINUE", "TRYCATCH", "IFCMP",
+	"UNUSED60", "UNUSED61", "EXTRA",    "INVALID",
 };
 
 DUK_LOCAL const char *duk__bc_extraoptab[] = {
 	"NOP", "LDTHIS", "LDUNDEF", "LDNULL", "LDTRUE", "LDFALSE", "NEWOBJ", "NEWARR", "SETALEN", "TYPEOF",
 	"TYPEOFID", "TONUM", "INITENUM", "NEXTENUM", "INITSET", "INITSETI", "INITGET", "INITGETI", "ENDTRY", "ENDCATCH",
-	"ENDFIN", "THROW", "INVLHS", "UNM", "UNP", "INC", "DEC", "XXX", "XXX", "XXX",
+	"ENDFIN", "THROW", "INVLHS", "UNM", "UNP", "INC", "DEC", "POSTINC", "POSTDEC", "XXX",
 	"XXX", "XXX", "XXX", "XXX", "XXX", "XXX", "XXX", "XXX", "XXX", "XXX",
 	"XXX", "XXX", "XXX", "XXX", "XXX", "XXX", "XXX", "XXX", "XXX", "XXX",
 
@@ -343,6 +343,8 @@ DUK_LOCAL void duk__print_hobject(duk__dprint_state *st, duk_hobject *h) {
 			duk_fb_sprintf(fb, "%sobject/compiledfunction %p%s", (const char *) brace1, (void *) h, (const char *) brace2);
 		} else if (DUK_HOBJECT_IS_NATIVEFUNCTION(h)) {
 			duk_fb_sprintf(fb, "%sobject/nativefunction %p%s", (const char *) brace1, (void *) h, (const char *) brace2);
+		} else if (DUK_HOBJECT_IS_BUFFEROBJECT(h)) {
+			duk_fb_sprintf(fb, "%sobject/bufferobject %p%s", (const char *) brace1, (void *) h, (const char *) brace2);
 		} else if (DUK_HOBJECT_IS_THREAD(h)) {
 			duk_fb_sprintf(fb, "%sobject/thread %p%s", (const char *) brace1, (void *) h, (const char *) brace2);
 		} else {
@@ -453,6 +455,11 @@ DUK_LOCAL void duk__print_hobject(duk__dprint_state *st, duk_hobject *h) {
 		} else {
 			;
 		}
+		if (DUK_HOBJECT_HAS_BUFFEROBJECT(h)) {
+			DUK__COMMA(); duk_fb_sprintf(fb, "__bufferobject:true");
+		} else {
+			;
+		}
 		if (DUK_HOBJECT_HAS_THREAD(h)) {
 			DUK__COMMA(); duk_fb_sprintf(fb, "__thread:true");
 		} else {
@@ -530,6 +537,16 @@ DUK_LOCAL void duk__print_hobject(duk__dprint_state *st, duk_hobject *h) {
 		DUK__COMMA(); duk_fb_sprintf(fb, "__func:");
 		duk_fb_put_funcptr(fb, (duk_uint8_t *) &f->func, sizeof(f->func));
 		DUK__COMMA(); duk_fb_sprintf(fb, "__nargs:%ld", (long) f->nargs);
+	} else if (st->internal && DUK_HOBJECT_IS_BUFFEROBJECT(h)) {
+		duk_hbufferobject *b = (duk_hbufferobject *) h;
+		DUK__COMMA(); duk_fb_sprintf(fb, "__buf:");
+		duk__print_hbuffer(st, (duk_hbuffer *) b->buf);
+		DUK__COMMA(); duk_fb_sprintf(fb, "__buf_prop:");
+		duk__print_hobject(st, (duk_hobject *) b->buf_prop);
+		DUK__COMMA(); duk_fb_sprintf(fb, "__offset:%ld", (long) b->offset);
+		DUK__COMMA(); duk_fb_sprintf(fb, "__length:%ld", (long) b->length);
+		DUK__COMMA(); duk_fb_sprintf(fb, "__shift:%ld", (long) b->shift);
+		DUK__COMMA(); duk_fb_sprintf(fb, "__elemtype:%ld", (long) b->elem_type);
 	} else if (st->internal && DUK_HOBJECT_IS_THREAD(h)) {
 		duk_hthread *t = (duk_hthread *) h;
 		DUK__COMMA(); duk_fb_sprintf(fb, "__strict:%ld", (long) t->strict);
@@ -612,7 +629,12 @@ DUK_LOCAL void duk__print_hbuffer(duk__dprint_state *st, duk_hbuffer *h) {
 		return;
 	}
 
-	if (DUK_HBUFFER_HAS_DYNAMIC(h)) {
+	if (DUK_HBUFFER_HAS_EXTERNAL(h)) {
+		duk_hbuffer_external *g = (duk_hbuffer_external *) h;
+		duk_fb_sprintf(fb, "buffer:external:%p:%ld",
+		               (void *) DUK_HBUFFER_EXTERNAL_GET_DATA_PTR(g),
+		               (long) DUK_HBUFFER_GET_SIZE(h));
+	} else if (DUK_HBUFFER_HAS_DYNAMIC(h)) {
 		duk_hbuffer_dynamic *g = (duk_hbuffer_dynamic *) h;
 		duk_fb_sprintf(fb, "buffer:dynamic:%p:%ld:%ld",
 		               (void *) DUK_HBUFFER_DYNAMIC_GET_DATA_PTR(g),
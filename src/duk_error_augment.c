@@ -157,8 +157,12 @@ DUK_LOCAL void duk__err_augment_user(duk_hthread *thr, duk_small_uint_t stridx_c
 #ifdef DUK_USE_TRACEBACKS
 DUK_LOCAL void duk__add_traceback(duk_hthread *thr, duk_hthread *thr_callstack, const char *filename, duk_int_t line, duk_bool_t noblame_fileline) {
 	duk_context *ctx = (duk_context *) thr;
+	duk_hobject *arr;
+	duk_tval *tv;
+	duk_tval *tv_len;
 	duk_small_uint_t depth;
 	duk_int_t i, i_min;
+	duk_uint32_t arr_size;
 	duk_uarridx_t arr_idx;
 	duk_double_t d;
 
@@ -174,72 +178,87 @@ DUK_LOCAL void duk__add_traceback(duk_hthread *thr, duk_hthread *thr_callstack,
 	 *  It should be decoded/accessed through version specific accessors only.
 	 *
 	 *  See doc/error-objects.txt.
+	 *
+	 *  Errors are often created and thrown without ever looking at their
+	 *  traceback, e.g. when code uses exceptions for control flow, so only
+	 *  a raw snapshot of the callstack is taken here: function values and
+	 *  packed pc/flags numbers are written directly into a preallocated
+	 *  array part.  Decoding the snapshot into 'stack', 'fileName' and
+	 *  'lineNumber' (pc-to-line lookups, string formatting) is done lazily
+	 *  by the Error.prototype accessors, see duk_bi_error.c.
 	 */
 
 	DUK_DDD(DUK_DDDPRINT("adding traceback to object: %!T",
 	                     (duk_tval *) duk_get_tval(ctx, -1)));
 
-	duk_push_array(ctx);  /* XXX: specify array size, as we know it */
-	arr_idx = 0;
-
-	/* filename/line from C macros (__FILE__, __LINE__) are added as an
-	 * entry with a special format: (string, number).  The number contains
-	 * the line and flags.
+	/* traceback depth doesn't take into account the filename/line
+	 * special handling below (intentional)
 	 */
+	depth = DUK_USE_TRACEBACK_DEPTH;
+	i_min = (thr_callstack->callstack_top > (duk_size_t) depth ? (duk_int_t) (thr_callstack->callstack_top - depth) : 0);
+	DUK_ASSERT(i_min >= 0);
+	DUK_ASSERT(thr_callstack->callstack_top <= DUK_INT_MAX);  /* callstack limits */
+
+	arr_size = (duk_uint32_t) (thr_callstack->callstack_top - (duk_size_t) i_min) * 2;
+	if (filename) {
+		arr_size += 2;
+	}
+
+	duk_push_array(ctx);
+	arr = duk_get_hobject(ctx, -1);
+	DUK_ASSERT(arr != NULL);
 
-	/* XXX: optimize: allocate an array part to the necessary size (upwards
-	 * estimate) and fill in the values directly into the array part; finally
-	 * update 'length'.
+	/* The filename string must be pushed before the array part is
+	 * allocated: a GC triggered by the allocation could otherwise
+	 * compact away the not yet filled array part.
 	 */
+	if (filename) {
+		duk_push_string(ctx, filename);
+	}
 
-	/* XXX: using duk_put_prop_index() would cause obscure error cases when Array.prototype
-	 * has write-protected array index named properties.  This was seen as DoubleErrors
-	 * in e.g. some test262 test cases.  Using duk_def_prop_index() is better but heavier.
-	 * The best fix is to fill in the tracedata directly into the array part.
+	/* [ ... error arr filename? ] */
+
+	duk_hobject_realloc_array_part(thr, arr, arr_size);
+
+	/*
+	 *  No side effects from here on until the array is filled, so the
+	 *  array part and callstack pointers remain valid.  Writing to the
+	 *  array part directly also avoids obscure errors (seen as DoubleErrors
+	 *  e.g. in some test262 cases) when Array.prototype has write-protected
+	 *  array index named properties.
 	 */
 
-	/* [ ... error arr ] */
+	arr_idx = 0;
+
+	/* filename/line from C macros (__FILE__, __LINE__) are added as an
+	 * entry with a special format: (string, number).  The number contains
+	 * the line and flags.
+	 */
 
 	if (filename) {
-		duk_push_string(ctx, filename);
-		duk_def_prop_index_wec(ctx, -2, arr_idx);
+		tv = DUK_HOBJECT_A_GET_VALUE_PTR(arr, arr_idx);
+		DUK_TVAL_SET_TVAL(tv, duk_get_tval(ctx, -1));
+		DUK_TVAL_INCREF(thr, tv);
 		arr_idx++;
 
 		d = (noblame_fileline ? ((duk_double_t) DUK_TB_FLAG_NOBLAME_FILELINE) * DUK_DOUBLE_2TO32 : 0.0) +
 		    (duk_double_t) line;
-		duk_push_number(ctx, d);
-		duk_def_prop_index_wec(ctx, -2, arr_idx);
+		tv = DUK_HOBJECT_A_GET_VALUE_PTR(arr, arr_idx);
+		DUK_TVAL_SET_NUMBER(tv, d);
 		arr_idx++;
 	}
 
-	/* traceback depth doesn't take into account the filename/line
-	 * special handling above (intentional)
-	 */
-	depth = DUK_USE_TRACEBACK_DEPTH;
-	i_min = (thr_callstack->callstack_top > (duk_size_t) depth ? (duk_int_t) (thr_callstack->callstack_top - depth) : 0);
-	DUK_ASSERT(i_min >= 0);
-
-	/* [ ... error arr ] */
-
-	DUK_ASSERT(thr_callstack->callstack_top <= DUK_INT_MAX);  /* callstack limits */
 	for (i = (duk_int_t) (thr_callstack->callstack_top - 1); i >= i_min; i--) {
+		duk_activation *act;
 		duk_uint32_t pc;
 
-		/*
-		 *  Note: each API operation potentially resizes the callstack,
-		 *  so be careful to re-lookup after every operation.  Currently
-		 *  these is no issue because we don't store a temporary 'act'
-		 *  pointer at all.  (This would be a non-issue if we operated
-		 *  directly on the array part.)
-		 */
-
-		/* [... arr] */
-
-		DUK_ASSERT_DISABLE(thr_callstack->callstack[i].pc >= 0);  /* unsigned */
+		act = thr_callstack->callstack + i;
+		DUK_ASSERT_DISABLE(act->pc >= 0);  /* unsigned */
 
 		/* Add function object. */
-		duk_push_tval(ctx, &(thr_callstack->callstack + i)->tv_func);
-		duk_def_prop_index_wec(ctx, -2, arr_idx);
+		tv = DUK_HOBJECT_A_GET_VALUE_PTR(arr, arr_idx);
+		DUK_TVAL_SET_TVAL(tv, &act->tv_func);
+		DUK_TVAL_INCREF(thr, tv);
 		arr_idx++;
 
 		/* Add a number containing: pc, activation flags.
@@ -247,21 +266,30 @@ DUK_LOCAL void duk__add_traceback(duk_hthread *thr, duk_hthread *thr_callstack,
 		 * PC points to next instruction, find offending PC.  Note that
 		 * PC == 0 for native code.
 		 */
-		pc = thr_callstack->callstack[i].pc;
+		pc = act->pc;
 		if (pc > 0) {
 			pc--;
 		}
 		DUK_ASSERT_DISABLE(pc >= 0);  /* unsigned */
 		DUK_ASSERT((duk_double_t) pc < DUK_DOUBLE_2TO32);  /* assume PC is at most 32 bits and non-negative */
-		d = ((duk_double_t) thr_callstack->callstack[i].flags) * DUK_DOUBLE_2TO32 + (duk_double_t) pc;
-		duk_push_number(ctx, d);  /* -> [... arr num] */
-		duk_def_prop_index_wec(ctx, -2, arr_idx);
+		d = ((duk_double_t) act->flags) * DUK_DOUBLE_2TO32 + (duk_double_t) pc;
+		tv = DUK_HOBJECT_A_GET_VALUE_PTR(arr, arr_idx);
+		DUK_TVAL_SET_NUMBER(tv, d);
 		arr_idx++;
 	}
 
-	/* XXX: set with duk_hobject_set_length() when tracedata is filled directly */
-	duk_push_uint(ctx, (duk_uint_t) arr_idx);
-	duk_def_prop_stridx(ctx, -2, DUK_STRIDX_LENGTH, DUK_PROPDESC_FLAGS_WC);
+	DUK_ASSERT(arr_idx == arr_size);
+
+	/* 'length' is a plain own property of a fresh array, and its
+	 * previous value is a number so no refcount update is needed.
+	 */
+	tv_len = duk_hobject_find_existing_entry_tval_ptr(arr, DUK_HTHREAD_STRING_LENGTH(thr));
+	DUK_ASSERT(tv_len != NULL && DUK_TVAL_IS_NUMBER(tv_len));
+	DUK_TVAL_SET_NUMBER(tv_len, (duk_double_t) arr_idx);
+
+	if (filename) {
+		duk_pop(ctx);  /* filename is now reachable through arr */
+	}
 
 	/* [ ... error arr ] */
 
@@ -27,6 +27,7 @@ DUK_INTERNAL void duk_err_create_and_throw(duk_hthread *thr, duk_errcode_t code)
 #endif
 	duk_context *ctx = (duk_context *) thr;
 	duk_bool_t double_error = thr->heap->handling_error;
+	duk_bool_t alloc_error = (code == DUK_ERR_ALLOC_ERROR);
 
 #ifdef DUK_USE_VERBOSE_ERRORS
 	DUK_DD(DUK_DDPRINT("duk_err_create_and_throw(): code=%ld, msg=%s, filename=%s, line=%ld",
@@ -39,6 +40,18 @@ DUK_INTERNAL void duk_err_create_and_throw(duk_hthread *thr, duk_errcode_t code)
 	DUK_ASSERT(thr != NULL);
 	DUK_ASSERT(ctx != NULL);
 
+	/* An allocation refused because of the heap's hard memory limit is
+	 * thrown as a RangeError; the heap remains usable.
+	 */
+	if (alloc_error && DUK_HEAP_HAS_MEM_LIMIT_REACHED(thr->heap)) {
+		DUK_D(DUK_DPRINT("alloc error caused by memory limit -> RangeError"));
+		DUK_HEAP_CLEAR_MEM_LIMIT_REACHED(thr->heap);
+		code = DUK_ERR_RANGE_ERROR;
+#ifdef DUK_USE_VERBOSE_ERRORS
+		msg = DUK_STR_MEMORY_LIMIT_EXCEEDED;
+#endif
+	}
+
 	thr->heap->handling_error = 1;
 
 	/*
@@ -87,7 +100,7 @@ DUK_INTERNAL void duk_err_create_and_throw(duk_hthread *thr, duk_errcode_t code)
 	 *  Augment error (throw time), unless alloc/double error
 	 */
 
-	if (double_error || code == DUK_ERR_ALLOC_ERROR) {
+	if (double_error || alloc_error) {
 		DUK_D(DUK_DPRINT("alloc or double error: skip throw augmenting to avoid further trouble"));
 	} else {
 #if defined(DUK_USE_AUGMENT_ERROR_THROW)
@@ -15,13 +15,18 @@ struct duk_jmpbuf;
 struct duk_heaphdr;
 struct duk_heaphdr_string;
 struct duk_hstring;
+struct duk_hstring_external;
 struct duk_hobject;
+struct duk_hshape;
 struct duk_hcompiledfunction;
 struct duk_hnativefunction;
+struct duk_hbufferobject;
+struct duk_hweakobject;
 struct duk_hthread;
 struct duk_hbuffer;
 struct duk_hbuffer_fixed;
 struct duk_hbuffer_dynamic;
+struct duk_hbuffer_external;
 
 struct duk_propaccessor;
 union duk_propvalue;
@@ -32,7 +37,18 @@ struct duk_heap;
 struct duk_activation;
 struct duk_catcher;
 struct duk_strcache;
+struct duk_weakentry;
 struct duk_ljstate;
+#if defined(DUK_USE_SLAB_ALLOC)
+struct duk_slab_page;
+struct duk_slab_chunk;
+struct duk_slab_class;
+struct duk_slab;
+#endif
+#if defined(DUK_USE_ARENA_ALLOC)
+struct duk_arena_chunk;
+struct duk_arena;
+#endif
 
 #ifdef DUK_USE_DEBUG
 struct duk_fixedbuffer;
@@ -59,13 +75,18 @@ typedef struct duk_jmpbuf duk_jmpbuf;
 typedef struct duk_heaphdr duk_heaphdr;
 typedef struct duk_heaphdr_string duk_heaphdr_string;
 typedef struct duk_hstring duk_hstring;
+typedef struct duk_hstring_external duk_hstring_external;
 typedef struct duk_hobject duk_hobject;
+typedef struct duk_hshape duk_hshape;
 typedef struct duk_hcompiledfunction duk_hcompiledfunction;
 typedef struct duk_hnativefunction duk_hnativefunction;
+typedef struct duk_hbufferobject duk_hbufferobject;
+typedef struct duk_hweakobject duk_hweakobject;
 typedef struct duk_hthread duk_hthread;
 typedef struct duk_hbuffer duk_hbuffer;
 typedef struct duk_hbuffer_fixed duk_hbuffer_fixed;
 typedef struct duk_hbuffer_dynamic duk_hbuffer_dynamic;
+typedef struct duk_hbuffer_external duk_hbuffer_external;
 
 typedef struct duk_propaccessor duk_propaccessor;
 typedef union duk_propvalue duk_propvalue;
@@ -76,7 +97,18 @@ typedef struct duk_heap duk_heap;
 typedef struct duk_activation duk_activation;
 typedef struct duk_catcher duk_catcher;
 typedef struct duk_strcache duk_strcache;
+typedef struct duk_weakentry duk_weakentry;
 typedef struct duk_ljstate duk_ljstate;
+#if defined(DUK_USE_SLAB_ALLOC)
+typedef struct duk_slab_page duk_slab_page;
+typedef struct duk_slab_chunk duk_slab_chunk;
+typedef struct duk_slab_class duk_slab_class;
+typedef struct duk_slab duk_slab;
+#endif
+#if defined(DUK_USE_ARENA_ALLOC)
+typedef struct duk_arena_chunk duk_arena_chunk;
+typedef struct duk_arena duk_arena;
+#endif
 
 #ifdef DUK_USE_DEBUG
 typedef struct duk_fixedbuffer duk_fixedbuffer;
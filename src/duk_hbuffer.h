@@ -5,8 +5,12 @@
  *
  *    1. A fixed size buffer (data follows header statically)
  *    2. A dynamic size buffer (data pointer follows header)
+ *    3. An external buffer (data pointer follows header, points to memory
+ *       owned by user code and released through a callback)
  *
  *  The data pointer for a variable size buffer of zero size may be NULL.
+ *  External buffers also have the DYNAMIC flag set because they share the
+ *  dynamic buffer data pointer, but they are never resized.
  */
 
 #ifndef DUK_HBUFFER_H_INCLUDED
@@ -16,13 +20,21 @@
  *  Flags
  */
 
-#define DUK_HBUFFER_FLAG_DYNAMIC                  DUK_HEAPHDR_USER_FLAG(0)  /* buffer is resizable */
+#define DUK_HBUFFER_FLAG_DYNAMIC                  DUK_HEAPHDR_USER_FLAG(0)  /* buffer data is behind a pointer (resizable unless external) */
+#define DUK_HBUFFER_FLAG_EXTERNAL                 DUK_HEAPHDR_USER_FLAG(1)  /* buffer data is user memory (not resizable) */
 
 #define DUK_HBUFFER_HAS_DYNAMIC(x)                DUK_HEAPHDR_CHECK_FLAG_BITS(&(x)->hdr, DUK_HBUFFER_FLAG_DYNAMIC)
+#define DUK_HBUFFER_HAS_EXTERNAL(x)               DUK_HEAPHDR_CHECK_FLAG_BITS(&(x)->hdr, DUK_HBUFFER_FLAG_EXTERNAL)
 
 #define DUK_HBUFFER_SET_DYNAMIC(x)                DUK_HEAPHDR_SET_FLAG_BITS(&(x)->hdr, DUK_HBUFFER_FLAG_DYNAMIC)
+#define DUK_HBUFFER_SET_EXTERNAL(x)               DUK_HEAPHDR_SET_FLAG_BITS(&(x)->hdr, DUK_HBUFFER_FLAG_EXTERNAL)
 
 #define DUK_HBUFFER_CLEAR_DYNAMIC(x)              DUK_HEAPHDR_CLEAR_FLAG_BITS(&(x)->hdr, DUK_HBUFFER_FLAG_DYNAMIC)
+#define DUK_HBUFFER_CLEAR_EXTERNAL(x)             DUK_HEAPHDR_CLEAR_FLAG_BITS(&(x)->hdr, DUK_HBUFFER_FLAG_EXTERNAL)
+
+/* A dynamic buffer which user code may resize. */
+#define DUK_HBUFFER_IS_RESIZABLE(x) \
+	(((x)->hdr.h_flags & (DUK_HBUFFER_FLAG_DYNAMIC | DUK_HBUFFER_FLAG_EXTERNAL)) == DUK_HBUFFER_FLAG_DYNAMIC)
 
 #define DUK_HBUFFER_FIXED_GET_DATA_PTR(x)         ((duk_uint8_t *) (((duk_hbuffer_fixed *) (x)) + 1))
 
@@ -123,14 +135,38 @@
 	} while (0)
 #endif
 
+/* External data is not a heap pointer so it can't be stored in the
+ * compressed 'curr_alloc16' field; it has a full pointer field instead.
+ * Without pointer compression the dynamic buffer field is used as is.
+ */
+#if defined(DUK_USE_HEAPPTR16)
+#define DUK_HBUFFER_EXTERNAL_GET_DATA_PTR(x)      ((x)->ext_data)
+#define DUK_HBUFFER_EXTERNAL_SET_DATA_PTR(x,v)    do { \
+		(x)->ext_data = (void *) (v); \
+	} while (0)
+#else
+#define DUK_HBUFFER_EXTERNAL_GET_DATA_PTR(x)      DUK_HBUFFER_DYNAMIC_GET_DATA_PTR(&(x)->dyn)
+#define DUK_HBUFFER_EXTERNAL_SET_DATA_PTR(x,v)    DUK_HBUFFER_DYNAMIC_SET_DATA_PTR(&(x)->dyn, (v))
+#endif
+
 /* Gets the actual buffer contents which matches the current allocation size
- * (may be NULL for zero size dynamic buffer).
+ * (may be NULL for zero size dynamic or external buffer).
  */
+#if defined(DUK_USE_HEAPPTR16)
 #define DUK_HBUFFER_GET_DATA_PTR(x)  ( \
+	DUK_HBUFFER_HAS_EXTERNAL((x)) ? \
+		DUK_HBUFFER_EXTERNAL_GET_DATA_PTR((duk_hbuffer_external *) (x)) : \
 	DUK_HBUFFER_HAS_DYNAMIC((x)) ? \
 		DUK_HBUFFER_DYNAMIC_GET_DATA_PTR((duk_hbuffer_dynamic *) (x)) : \
 		DUK_HBUFFER_FIXED_GET_DATA_PTR((duk_hbuffer_fixed *) (x)) \
 	)
+#else
+#define DUK_HBUFFER_GET_DATA_PTR(x)  ( \
+	DUK_HBUFFER_HAS_DYNAMIC((x)) ? \
+		DUK_HBUFFER_DYNAMIC_GET_DATA_PTR((duk_hbuffer_dynamic *) (x)) : \
+		DUK_HBUFFER_FIXED_GET_DATA_PTR((duk_hbuffer_fixed *) (x)) \
+	)
+#endif
 
 /* Growth parameters for dynamic buffers. */
 #define DUK_HBUFFER_SPARE_ADD      16
@@ -259,11 +295,31 @@ struct duk_hbuffer_dynamic {
 	 */
 };
 
+struct duk_hbuffer_external {
+	/* Dynamic buffer part: alloc size is always equal to size and the
+	 * data pointer is the user pointer (unless pointer compression is
+	 * enabled, see 'ext_data').  Because the DYNAMIC flag is also set,
+	 * code which only reads buffer data needs no special handling.
+	 */
+	duk_hbuffer_dynamic dyn;
+
+#if defined(DUK_USE_HEAPPTR16)
+	void *ext_data;
+#endif
+
+	/* Called as release_func(release_udata, data) when the buffer is
+	 * freed, may be NULL.  Must not call into Duktape.
+	 */
+	duk_free_function release_func;
+	void *release_udata;
+};
+
 /*
  *  Prototypes
  */
 
 DUK_INTERNAL_DECL duk_hbuffer *duk_hbuffer_alloc(duk_heap *heap, duk_size_t size, duk_bool_t dynamic);
+DUK_INTERNAL_DECL duk_hbuffer *duk_hbuffer_alloc_external(duk_heap *heap, void *data, duk_size_t size, duk_free_function release_func, void *release_udata);
 DUK_INTERNAL_DECL void *duk_hbuffer_get_dynalloc_ptr(void *ud);  /* indirect allocs */
 
 /* dynamic buffer ops */
@@ -274,7 +330,9 @@ DUK_INTERNAL_DECL void duk_hbuffer_compact(duk_hthread *thr, duk_hbuffer_dynamic
 #endif
 DUK_INTERNAL_DECL void duk_hbuffer_append_bytes(duk_hthread *thr, duk_hbuffer_dynamic *buf, duk_uint8_t *data, duk_size_t length);
 DUK_INTERNAL_DECL void duk_hbuffer_append_byte(duk_hthread *thr, duk_hbuffer_dynamic *buf, duk_uint8_t byte);
+#if 0  /*unused*/
 DUK_INTERNAL_DECL duk_size_t duk_hbuffer_append_cstring(duk_hthread *thr, duk_hbuffer_dynamic *buf, const char *str);
+#endif
 DUK_INTERNAL_DECL duk_size_t duk_hbuffer_append_hstring(duk_hthread *thr, duk_hbuffer_dynamic *buf, duk_hstring *str);
 DUK_INTERNAL_DECL duk_size_t duk_hbuffer_append_xutf8(duk_hthread *thr, duk_hbuffer_dynamic *buf, duk_ucodepoint_t codepoint);
 DUK_INTERNAL_DECL duk_size_t duk_hbuffer_append_cesu8(duk_hthread *thr, duk_hbuffer_dynamic *buf, duk_ucodepoint_t codepoint);
@@ -29,9 +29,9 @@ DUK_INTERNAL duk_hbuffer *duk_hbuffer_alloc(duk_heap *heap, duk_size_t size, duk
 
 #ifdef DUK_USE_ZERO_BUFFER_DATA
 	/* zero everything */
-	res = (duk_hbuffer *) DUK_ALLOC_ZEROED(heap, alloc_size);
+	res = (duk_hbuffer *) DUK_ALLOC_SLAB_ZEROED(heap, alloc_size);
 #else
-	res = (duk_hbuffer *) DUK_ALLOC(heap, alloc_size);
+	res = (duk_hbuffer *) DUK_ALLOC_SLAB(heap, alloc_size);
 #endif
 	if (!res) {
 		goto error;
@@ -81,10 +81,54 @@ DUK_INTERNAL duk_hbuffer *duk_hbuffer_alloc(duk_heap *heap, duk_size_t size, duk
  error:
 	DUK_DD(DUK_DDPRINT("hbuffer allocation failed"));
 
-	DUK_FREE(heap, res);
+	DUK_FREE_SLAB(heap, res, alloc_size);
 	return NULL;
 }
 
+/* Allocate a buffer header for user memory.  The data is not copied and is
+ * never freed by Duktape; 'release_func' (if non-NULL) is called when the
+ * buffer is freed.  If allocation fails, 'release_func' is not called and
+ * the memory is still owned by the caller.
+ */
+DUK_INTERNAL duk_hbuffer *duk_hbuffer_alloc_external(duk_heap *heap, void *data, duk_size_t size, duk_free_function release_func, void *release_udata) {
+	duk_hbuffer_external *res;
+
+	DUK_DDD(DUK_DDDPRINT("allocate external hbuffer"));
+
+	if (size > DUK_HBUFFER_MAX_BYTELEN) {
+		DUK_D(DUK_DPRINT("external hbuffer alloc failed: size too large: %ld", (long) size));
+		return NULL;
+	}
+
+	res = (duk_hbuffer_external *) DUK_ALLOC_SLAB(heap, sizeof(duk_hbuffer_external));
+	if (!res) {
+		DUK_DD(DUK_DDPRINT("external hbuffer allocation failed"));
+		return NULL;
+	}
+	DUK_MEMZERO((void *) res, sizeof(duk_hbuffer_external));
+
+#ifdef DUK_USE_EXPLICIT_NULL_INIT
+#if defined(DUK_USE_HEAPPTR16)
+	res->ext_data = NULL;
+#else
+	res->dyn.curr_alloc = NULL;
+#endif
+#endif
+	DUK_HBUFFER_EXTERNAL_SET_DATA_PTR(res, data);
+	DUK_HBUFFER_DYNAMIC_SET_ALLOC_SIZE(&res->dyn, size);
+	DUK_HBUFFER_SET_SIZE((duk_hbuffer *) res, size);
+	res->release_func = release_func;
+	res->release_udata = release_udata;
+
+	DUK_HEAPHDR_SET_TYPE(&res->dyn.hdr, DUK_HTYPE_BUFFER);
+	DUK_HBUFFER_SET_DYNAMIC((duk_hbuffer *) res);
+	DUK_HBUFFER_SET_EXTERNAL((duk_hbuffer *) res);
+	DUK_HEAP_INSERT_INTO_HEAP_ALLOCATED(heap, &res->dyn.hdr);
+
+	DUK_DDD(DUK_DDDPRINT("allocated external hbuffer: %p, data %p", (void *) res, (void *) data));
+	return (duk_hbuffer *) res;
+}
+
 /* For indirect allocs. */
 
 DUK_INTERNAL void *duk_hbuffer_get_dynalloc_ptr(void *ud) {
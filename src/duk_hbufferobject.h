@@ -0,0 +1,70 @@
+/*
+ *  Heap buffer object representation.  Used for ArrayBuffer, DataView and
+ *  the typed array views (Uint8Array etc).  All of them are backed by a
+ *  plain duk_hbuffer which may be shared by several buffer objects.
+ */
+
+#ifndef DUK_HBUFFEROBJECT_H_INCLUDED
+#define DUK_HBUFFEROBJECT_H_INCLUDED
+
+/* Element types, shift is element size log2. */
+#define DUK_HBUFFEROBJECT_ELEM_UINT8           0
+#define DUK_HBUFFEROBJECT_ELEM_UINT8CLAMPED    1
+#define DUK_HBUFFEROBJECT_ELEM_INT8            2
+#define DUK_HBUFFEROBJECT_ELEM_UINT16          3
+#define DUK_HBUFFEROBJECT_ELEM_INT16           4
+#define DUK_HBUFFEROBJECT_ELEM_UINT32          5
+#define DUK_HBUFFEROBJECT_ELEM_INT32           6
+#define DUK_HBUFFEROBJECT_ELEM_FLOAT32         7
+#define DUK_HBUFFEROBJECT_ELEM_FLOAT64         8
+#define DUK_HBUFFEROBJECT_ELEM_MAX             8
+
+/* Slice is valid if the underlying buffer (which may be a dynamic buffer
+ * resized after the buffer object was created) still covers it.  Creation
+ * ensures offset + length does not wrap.
+ */
+#define DUK_HBUFFEROBJECT_VALID_SLICE(h) \
+	((duk_size_t) (h)->offset + (duk_size_t) (h)->length <= DUK_HBUFFER_GET_SIZE((h)->buf))
+
+#define DUK_HBUFFEROBJECT_GET_SLICE_BASE(h) \
+	(((duk_uint8_t *) DUK_HBUFFER_GET_DATA_PTR((h)->buf)) + (h)->offset)
+
+/* Element count of a typed array view, ignores a partial last element. */
+#define DUK_HBUFFEROBJECT_GET_ELEM_COUNT(h) \
+	((h)->length >> (h)->shift)
+
+struct duk_hbufferobject {
+	/* shared object part */
+	duk_hobject obj;
+
+	/* Underlying plain buffer, never NULL once the object has been
+	 * initialized.  Counts as a strong reference.
+	 */
+	duk_hbuffer *buf;
+
+	/* ArrayBuffer object returned by the 'buffer' property of a view.
+	 * Created on demand so that a view constructed from a length does
+	 * not need two objects; NULL until needed.  Strong reference.
+	 */
+	duk_hobject *buf_prop;
+
+	/* Byte slice [offset, offset + length[ of 'buf'. */
+	duk_uint_t offset;
+	duk_uint_t length;
+
+	duk_uint8_t shift;          /* element size log2 */
+	duk_uint8_t elem_type;      /* DUK_HBUFFEROBJECT_ELEM_xxx */
+	duk_uint8_t is_typedarray;  /* virtual index properties and 'length' */
+};
+
+/*
+ *  Prototypes
+ */
+
+DUK_INTERNAL_DECL duk_double_t duk_hbufferobject_read_elem(duk_small_uint_t elem_type, duk_uint8_t *p);
+DUK_INTERNAL_DECL void duk_hbufferobject_write_elem(duk_hthread *thr, duk_small_uint_t elem_type, duk_uint8_t *p, duk_double_t d);
+DUK_INTERNAL_DECL duk_bool_t duk_hbufferobject_get_index(duk_hbufferobject *h, duk_uint32_t idx, duk_tval *tv_out);
+DUK_INTERNAL_DECL duk_bool_t duk_hbufferobject_put_index(duk_hthread *thr, duk_hbufferobject *h, duk_uint32_t idx, duk_tval *tv_val);
+DUK_INTERNAL_DECL void duk_hbufferobject_push_buffer_prop(duk_hthread *thr, duk_hbufferobject *h);
+
+#endif  /* DUK_HBUFFEROBJECT_H_INCLUDED */
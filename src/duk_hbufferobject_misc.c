@@ -0,0 +1,241 @@
+/*
+ *  duk_hbufferobject element access helpers.  Used by the property code,
+ *  the executor fast paths and the typed array built-ins.
+ *
+ *  Element data may be unaligned (views can be created at any byte offset
+ *  of a DataView-style slice, and the underlying buffer has no alignment
+ *  guarantees on all platforms) so values are always read and written with
+ *  DUK_MEMCPY() through a local temporary.
+ */
+
+#include "duk_internal.h"
+
+/* Largest double which rounds to a finite float under round-to-nearest. */
+#define DUK__FLOAT32_MAX_ROUNDABLE  3.4028235677973366e38
+
+DUK_INTERNAL duk_double_t duk_hbufferobject_read_elem(duk_small_uint_t elem_type, duk_uint8_t *p) {
+	duk_double_union du;
+	union {
+		duk_uint16_t u16;
+		duk_int16_t i16;
+		duk_uint32_t u32;
+		duk_int32_t i32;
+		float f;
+	} t;
+
+	DUK_ASSERT(elem_type <= DUK_HBUFFEROBJECT_ELEM_MAX);
+	DUK_ASSERT(p != NULL);
+
+	switch (elem_type) {
+	case DUK_HBUFFEROBJECT_ELEM_UINT8:
+	case DUK_HBUFFEROBJECT_ELEM_UINT8CLAMPED:
+		return (duk_double_t) p[0];
+	case DUK_HBUFFEROBJECT_ELEM_INT8:
+		return (duk_double_t) ((duk_int8_t) p[0]);
+	case DUK_HBUFFEROBJECT_ELEM_UINT16:
+		DUK_MEMCPY((void *) &t.u16, (const void *) p, 2);
+		return (duk_double_t) t.u16;
+	case DUK_HBUFFEROBJECT_ELEM_INT16:
+		DUK_MEMCPY((void *) &t.i16, (const void *) p, 2);
+		return (duk_double_t) t.i16;
+	case DUK_HBUFFEROBJECT_ELEM_UINT32:
+		DUK_MEMCPY((void *) &t.u32, (const void *) p, 4);
+		return (duk_double_t) t.u32;
+	case DUK_HBUFFEROBJECT_ELEM_INT32:
+		DUK_MEMCPY((void *) &t.i32, (const void *) p, 4);
+		return (duk_double_t) t.i32;
+	case DUK_HBUFFEROBJECT_ELEM_FLOAT32:
+		DUK_MEMCPY((void *) &t.f, (const void *) p, 4);
+		du.d = (duk_double_t) t.f;
+		DUK_DBLUNION_NORMALIZE_NAN_CHECK(&du);
+		return du.d;
+	default:
+		DUK_ASSERT(elem_type == DUK_HBUFFEROBJECT_ELEM_FLOAT64);
+		/* Arbitrary NaN bit patterns may be stored in the buffer,
+		 * normalize so that the value is safe to store in a duk_tval.
+		 */
+		DUK_MEMCPY((void *) du.uc, (const void *) p, 8);
+		DUK_DBLUNION_NORMALIZE_NAN_CHECK(&du);
+		return du.d;
+	}
+}
+
+/* ToUint32() for a number; ToInt32/ToInt16 etc are simple casts of it. */
+DUK_LOCAL duk_uint32_t duk__double_to_uint32(duk_hthread *thr, duk_double_t d) {
+	duk_tval tv_tmp;
+
+	if (d >= 0.0 && d < 4294967296.0) {
+		/* Truncation towards zero matches ToUint32() in this range,
+		 * common case for integer data.
+		 */
+		return (duk_uint32_t) d;
+	}
+	DUK_TVAL_SET_NUMBER(&tv_tmp, d);
+	return duk_js_touint32(thr, &tv_tmp);
+}
+
+/* ToUint8Clamp(): round half to even, NaN to zero. */
+DUK_LOCAL duk_uint8_t duk__double_to_uint8_clamped(duk_double_t d) {
+	duk_double_t t;
+	duk_uint8_t r;
+
+	if (!(d > 0.0)) {
+		/* also catches NaN */
+		return 0;
+	} else if (d >= 255.0) {
+		return 255;
+	}
+	t = d + 0.5;
+	r = (duk_uint8_t) t;
+	if ((duk_double_t) r == t && (r & 0x01)) {
+		/* exact tie, round to even */
+		r--;
+	}
+	return r;
+}
+
+DUK_INTERNAL void duk_hbufferobject_write_elem(duk_hthread *thr, duk_small_uint_t elem_type, duk_uint8_t *p, duk_double_t d) {
+	union {
+		duk_uint16_t u16;
+		duk_uint32_t u32;
+		float f;
+	} t;
+
+	DUK_ASSERT(elem_type <= DUK_HBUFFEROBJECT_ELEM_MAX);
+	DUK_ASSERT(p != NULL);
+
+	switch (elem_type) {
+	case DUK_HBUFFEROBJECT_ELEM_UINT8:
+	case DUK_HBUFFEROBJECT_ELEM_INT8:
+		p[0] = (duk_uint8_t) duk__double_to_uint32(thr, d);
+		break;
+	case DUK_HBUFFEROBJECT_ELEM_UINT8CLAMPED:
+		p[0] = duk__double_to_uint8_clamped(d);
+		break;
+	case DUK_HBUFFEROBJECT_ELEM_UINT16:
+	case DUK_HBUFFEROBJECT_ELEM_INT16:
+		t.u16 = (duk_uint16_t) duk__double_to_uint32(thr, d);
+		DUK_MEMCPY((void *) p, (const void *) &t.u16, 2);
+		break;
+	case DUK_HBUFFEROBJECT_ELEM_UINT32:
+	case DUK_HBUFFEROBJECT_ELEM_INT32:
+		t.u32 = duk__double_to_uint32(thr, d);
+		DUK_MEMCPY((void *) p, (const void *) &t.u32, 4);
+		break;
+	case DUK_HBUFFEROBJECT_ELEM_FLOAT32:
+		/* Out-of-range double-to-float conversion is undefined
+		 * behavior in C, so handle overflow explicitly.
+		 */
+		if (d > DUK__FLOAT32_MAX_ROUNDABLE) {
+			t.f = (float) DUK_DOUBLE_INFINITY;
+		} else if (d < -DUK__FLOAT32_MAX_ROUNDABLE) {
+			t.f = (float) -DUK_DOUBLE_INFINITY;
+		} else {
+			t.f = (float) d;
+		}
+		DUK_MEMCPY((void *) p, (const void *) &t.f, 4);
+		break;
+	default:
+		DUK_ASSERT(elem_type == DUK_HBUFFEROBJECT_ELEM_FLOAT64);
+		DUK_MEMCPY((void *) p, (const void *) &d, 8);
+		break;
+	}
+}
+
+/*
+ *  Index access for typed arrays.  The element range is empty when the
+ *  underlying buffer has been resized so that the slice is no longer covered.
+ */
+
+DUK_INTERNAL duk_bool_t duk_hbufferobject_get_index(duk_hbufferobject *h, duk_uint32_t idx, duk_tval *tv_out) {
+	DUK_ASSERT(h != NULL);
+	DUK_ASSERT(tv_out != NULL);
+
+	if (!h->is_typedarray ||
+	    !DUK_HBUFFEROBJECT_VALID_SLICE(h) ||
+	    idx >= (duk_uint32_t) DUK_HBUFFEROBJECT_GET_ELEM_COUNT(h)) {
+		return 0;
+	}
+	DUK_TVAL_SET_NUMBER(tv_out, duk_hbufferobject_read_elem(h->elem_type, DUK_HBUFFEROBJECT_GET_SLICE_BASE(h) + ((duk_size_t) idx << h->shift)));
+	return 1;
+}
+
+/* Returns 1 if the index was handled, 0 if the caller should fall back to
+ * ordinary property behavior (not a typed array).  Like in ES6, a write to
+ * an index outside the element range is ignored rather than creating an
+ * ordinary property.  A non-number value is coerced with ToNumber() which
+ * may have side effects, including resizing the underlying dynamic buffer,
+ * so the range is checked again afterwards.
+ */
+DUK_INTERNAL duk_bool_t duk_hbufferobject_put_index(duk_hthread *thr, duk_hbufferobject *h, duk_uint32_t idx, duk_tval *tv_val) {
+	duk_context *ctx = (duk_context *) thr;
+	duk_double_t d;
+
+	DUK_ASSERT(thr != NULL);
+	DUK_ASSERT(h != NULL);
+	DUK_ASSERT(tv_val != NULL);
+	DUK_ASSERT(idx != 0xffffffffUL);  /* valid array index */
+
+	if (!h->is_typedarray) {
+		return 0;
+	}
+	if (!DUK_HBUFFEROBJECT_VALID_SLICE(h) ||
+	    idx >= (duk_uint32_t) DUK_HBUFFEROBJECT_GET_ELEM_COUNT(h)) {
+		return 1;
+	}
+
+	if (DUK_TVAL_IS_NUMBER(tv_val)) {
+		d = DUK_TVAL_GET_NUMBER(tv_val);
+	} else {
+		/* Keep the buffer object reachable during coercion. */
+		duk_push_hobject(ctx, (duk_hobject *) h);
+		duk_push_tval(ctx, tv_val);
+		d = duk_to_number(ctx, -1);
+		duk_pop_2(ctx);
+
+		if (!DUK_HBUFFEROBJECT_VALID_SLICE(h) ||
+		    idx >= (duk_uint32_t) DUK_HBUFFEROBJECT_GET_ELEM_COUNT(h)) {
+			return 1;
+		}
+	}
+
+	duk_hbufferobject_write_elem(thr, h->elem_type, DUK_HBUFFEROBJECT_GET_SLICE_BASE(h) + ((duk_size_t) idx << h->shift), d);
+	return 1;
+}
+
+/* Push the ArrayBuffer backing a view, creating it on first access.  The
+ * ArrayBuffer covers the whole underlying buffer.
+ */
+DUK_INTERNAL void duk_hbufferobject_push_buffer_prop(duk_hthread *thr, duk_hbufferobject *h) {
+	duk_context *ctx = (duk_context *) thr;
+	duk_hbufferobject *h_ab;
+
+	DUK_ASSERT(thr != NULL);
+	DUK_ASSERT(h != NULL);
+
+	if (h->buf_prop == NULL) {
+		duk_push_hobject(ctx, (duk_hobject *) h);  /* keep reachable */
+		h_ab = duk_push_bufferobject_raw(ctx,
+		                                 DUK_HOBJECT_FLAG_EXTENSIBLE |
+		                                 DUK_HOBJECT_CLASS_AS_FLAGS(DUK_HOBJECT_CLASS_ARRAYBUFFER),
+		                                 DUK_BIDX_ARRAYBUFFER_PROTOTYPE);
+		DUK_ASSERT(h_ab != NULL);
+		h_ab->buf = h->buf;
+		DUK_HBUFFER_INCREF(thr, h->buf);
+		h_ab->offset = 0;
+		h_ab->length = (duk_uint_t) DUK_HBUFFER_GET_SIZE(h->buf);
+		h_ab->shift = 0;
+		h_ab->elem_type = DUK_HBUFFEROBJECT_ELEM_UINT8;
+		h_ab->is_typedarray = 0;
+
+		if (h->buf_prop == NULL) {
+			/* Not set by a side effect of the allocation above. */
+			h->buf_prop = (duk_hobject *) h_ab;
+			DUK_HOBJECT_INCREF(thr, (duk_hobject *) h_ab);
+		}
+		duk_pop_2(ctx);
+	}
+
+	DUK_ASSERT(h->buf_prop != NULL);
+	duk_push_hobject(ctx, h->buf_prop);
+}
@@ -15,9 +15,10 @@
  */
 
 #define DUK_HEAP_FLAG_MARKANDSWEEP_RUNNING                     (1 << 0)  /* mark-and-sweep is currently running */
-#define DUK_HEAP_FLAG_MARKANDSWEEP_RECLIMIT_REACHED            (1 << 1)  /* mark-and-sweep marking reached a recursion limit and must use multi-pass marking */
+#define DUK_HEAP_FLAG_MARKANDSWEEP_RECLIMIT_REACHED            (1 << 1)  /* mark-and-sweep mark stack could not grow, must use multi-pass marking */
 #define DUK_HEAP_FLAG_REFZERO_FREE_RUNNING                     (1 << 2)  /* refcount code is processing refzero list */
 #define DUK_HEAP_FLAG_ERRHANDLER_RUNNING                       (1 << 3)  /* an error handler (user callback to augment/replace error) is running */
+#define DUK_HEAP_FLAG_MEM_LIMIT_REACHED                        (1 << 4)  /* last allocation attempt was refused because of the hard memory limit */
 
 #define DUK__HEAP_HAS_FLAGS(heap,bits)               ((heap)->flags & (bits))
 #define DUK__HEAP_SET_FLAGS(heap,bits)  do { \
@@ -31,16 +32,19 @@
 #define DUK_HEAP_HAS_MARKANDSWEEP_RECLIMIT_REACHED(heap)   DUK__HEAP_HAS_FLAGS((heap), DUK_HEAP_FLAG_MARKANDSWEEP_RECLIMIT_REACHED)
 #define DUK_HEAP_HAS_REFZERO_FREE_RUNNING(heap)            DUK__HEAP_HAS_FLAGS((heap), DUK_HEAP_FLAG_REFZERO_FREE_RUNNING)
 #define DUK_HEAP_HAS_ERRHANDLER_RUNNING(heap)              DUK__HEAP_HAS_FLAGS((heap), DUK_HEAP_FLAG_ERRHANDLER_RUNNING)
+#define DUK_HEAP_HAS_MEM_LIMIT_REACHED(heap)               DUK__HEAP_HAS_FLAGS((heap), DUK_HEAP_FLAG_MEM_LIMIT_REACHED)
 
 #define DUK_HEAP_SET_MARKANDSWEEP_RUNNING(heap)            DUK__HEAP_SET_FLAGS((heap), DUK_HEAP_FLAG_MARKANDSWEEP_RUNNING)
 #define DUK_HEAP_SET_MARKANDSWEEP_RECLIMIT_REACHED(heap)   DUK__HEAP_SET_FLAGS((heap), DUK_HEAP_FLAG_MARKANDSWEEP_RECLIMIT_REACHED)
 #define DUK_HEAP_SET_REFZERO_FREE_RUNNING(heap)            DUK__HEAP_SET_FLAGS((heap), DUK_HEAP_FLAG_REFZERO_FREE_RUNNING)
 #define DUK_HEAP_SET_ERRHANDLER_RUNNING(heap)              DUK__HEAP_SET_FLAGS((heap), DUK_HEAP_FLAG_ERRHANDLER_RUNNING)
+#define DUK_HEAP_SET_MEM_LIMIT_REACHED(heap)               DUK__HEAP_SET_FLAGS((heap), DUK_HEAP_FLAG_MEM_LIMIT_REACHED)
 
 #define DUK_HEAP_CLEAR_MARKANDSWEEP_RUNNING(heap)          DUK__HEAP_CLEAR_FLAGS((heap), DUK_HEAP_FLAG_MARKANDSWEEP_RUNNING)
 #define DUK_HEAP_CLEAR_MARKANDSWEEP_RECLIMIT_REACHED(heap) DUK__HEAP_CLEAR_FLAGS((heap), DUK_HEAP_FLAG_MARKANDSWEEP_RECLIMIT_REACHED)
 #define DUK_HEAP_CLEAR_REFZERO_FREE_RUNNING(heap)          DUK__HEAP_CLEAR_FLAGS((heap), DUK_HEAP_FLAG_REFZERO_FREE_RUNNING)
 #define DUK_HEAP_CLEAR_ERRHANDLER_RUNNING(heap)            DUK__HEAP_CLEAR_FLAGS((heap), DUK_HEAP_FLAG_ERRHANDLER_RUNNING)
+#define DUK_HEAP_CLEAR_MEM_LIMIT_REACHED(heap)             DUK__HEAP_CLEAR_FLAGS((heap), DUK_HEAP_FLAG_MEM_LIMIT_REACHED)
 
 /*
  *  Longjmp types, also double as identifying continuation type for a rethrow (in 'finally')
@@ -71,6 +75,21 @@
 #define DUK_MS_FLAG_NO_FINALIZERS            (1 << 2)   /* don't run finalizers (which may have arbitrary side effects) */
 #define DUK_MS_FLAG_NO_OBJECT_COMPACTION     (1 << 3)   /* don't compact objects; needed during object property allocation resize */
 
+/* The reason for a mark-and-sweep run (DUK_GC_REASON_xxx) is passed in the
+ * high bits of the flags; it only affects GC hook reporting.
+ */
+#define DUK_MS_REASON_SHIFT                  8
+#define DUK_MS_REASON_MASK                   (0x0f << DUK_MS_REASON_SHIFT)
+#define DUK_MS_REASON(reason)                ((reason) << DUK_MS_REASON_SHIFT)
+
+/* GC hooks get the flags as is. */
+#if (DUK_MS_FLAG_EMERGENCY != DUK_GC_FLAG_EMERGENCY) || \
+    (DUK_MS_FLAG_NO_STRINGTABLE_RESIZE != DUK_GC_FLAG_NO_STRINGTABLE_RESIZE) || \
+    (DUK_MS_FLAG_NO_FINALIZERS != DUK_GC_FLAG_NO_FINALIZERS) || \
+    (DUK_MS_FLAG_NO_OBJECT_COMPACTION != DUK_GC_FLAG_NO_OBJECT_COMPACTION)
+#error mark-and-sweep flags must match DUK_GC_FLAG_xxx
+#endif
+
 /*
  *  Thread switching
  *
@@ -103,16 +122,19 @@
 #define DUK_HEAP_DEFAULT_CALL_RECURSION_LIMIT             60    /* assuming 0.5 kB between calls, about 30kB of stack */
 #endif
 
-/* Mark-and-sweep C recursion depth for marking phase; if reached,
- * mark object as a TEMPROOT and use multi-pass marking.
+/* Mark-and-sweep marking uses an explicit mark stack of objects whose
+ * children haven't been marked yet, so marking needs no C recursion.  The
+ * stack grows on demand up to a maximum size; if it can't grow, the object
+ * is marked as a TEMPROOT and multi-pass marking is used instead.  A stack
+ * up to the 'keep' size is kept between rounds.
  */
 #if defined(DUK_USE_MARK_AND_SWEEP)
+#define DUK_HEAP_MARK_STACK_INITIAL_SIZE          64
+#define DUK_HEAP_MARK_STACK_KEEP_SIZE             256
 #if defined(DUK_USE_GC_TORTURE)
-#define DUK_HEAP_MARK_AND_SWEEP_RECURSION_LIMIT   3
-#elif defined(DUK_USE_DEEP_C_STACK)
-#define DUK_HEAP_MARK_AND_SWEEP_RECURSION_LIMIT   256
+#define DUK_HEAP_MARK_STACK_MAX_SIZE              4  /* exercise multi-pass marking */
 #else
-#define DUK_HEAP_MARK_AND_SWEEP_RECURSION_LIMIT   32
+#define DUK_HEAP_MARK_STACK_MAX_SIZE              (DUK_SIZE_MAX / sizeof(duk_heaphdr *) / 2)
 #endif
 #endif
 
@@ -124,7 +146,11 @@
  *
  * 'SKIP' indicates how many (re)allocations to wait until a retry if
  * GC is skipped because there is no thread do it with yet (happens
- * only during init phases).
+ * only during init phases), or postponed because of the minimum interval
+ * of the trigger policy.
+ *
+ * MULT and ADD are the default trigger policy, which can be changed at
+ * runtime with duk_set_gc_policy().
  */
 #if defined(DUK_USE_MARK_AND_SWEEP)
 #if defined(DUK_USE_REFERENCE_COUNTING)
@@ -153,6 +179,21 @@
  */
 #ifdef DUK_USE_INTERRUPT_COUNTER
 #define DUK_HEAP_INTCTR_DEFAULT                           (256L * 1024L)
+#define DUK_HEAP_INTCTR_REFZERO                           1024L  /* while batched refzero work is pending */
+#endif
+
+/* Safe point for processing a batch of the refzero work list when
+ * refzero processing is batched (see gc_policy.refzero_step).  Used at
+ * executor restarts (calls, returns) and at the end of duk_handle_call().
+ */
+#if defined(DUK_USE_REFERENCE_COUNTING)
+#define DUK_HEAP_REFZERO_SAFE_POINT(thr)  do { \
+		if ((thr)->heap->refzero_list != NULL) { \
+			duk_heap_refzero_process_pending((thr), 0);  /* one batch */ \
+		} \
+	} while (0)
+#else
+#define DUK_HEAP_REFZERO_SAFE_POINT(thr)  do {} while (0)
 #endif
 
 /*
@@ -240,6 +281,23 @@ typedef void *(*duk_mem_getptr)(void *ud);
 #define DUK_REALLOC_INDIRECT(heap,cb,ud,newsize)        duk_heap_mem_realloc_indirect((heap), (cb), (ud), (newsize))
 #define DUK_FREE(heap,ptr)                              duk_heap_mem_free((heap), (ptr))
 
+/* Allocations whose size is known again when they are freed (heap object
+ * headers, property allocations) use the slab variants.  Such memory must
+ * be freed with DUK_FREE_SLAB() using the original size, and must never
+ * be reallocated.  The memory comes from the slab or arena allocator when
+ * either is enabled; otherwise these map to the ordinary calls and the
+ * size is not evaluated.
+ */
+#if defined(DUK_USE_SIZED_ALLOC)
+#define DUK_ALLOC_SLAB(heap,size)                       duk_heap_mem_alloc_slab((heap), (size))
+#define DUK_ALLOC_SLAB_ZEROED(heap,size)                duk_heap_mem_alloc_slab_zeroed((heap), (size))
+#define DUK_FREE_SLAB(heap,ptr,size)                    duk_heap_mem_free_slab((heap), (ptr), (size))
+#else
+#define DUK_ALLOC_SLAB(heap,size)                       DUK_ALLOC((heap), (size))
+#define DUK_ALLOC_SLAB_ZEROED(heap,size)                DUK_ALLOC_ZEROED((heap), (size))
+#define DUK_FREE_SLAB(heap,ptr,size)                    DUK_FREE((heap), (ptr))
+#endif
+
 /*
  *  Memory constants
  */
@@ -283,6 +341,117 @@ struct duk_ljstate {
 	duk_tval value2;          /* 2nd related value (type specific) */
 };
 
+/*
+ *  Slab allocator state, see duk_heap_slab.c.
+ *
+ *  Memory is requested from the heap allocation functions in chunks of
+ *  'chunk_pages' pages.  Pages are aligned to 'page_size' so that the page
+ *  of a slot can be found by masking its address.  Each page is assigned
+ *  to one size class while it has live slots, and returned to the free
+ *  page list when it becomes empty.  A chunk is released when all of its
+ *  pages are free.
+ */
+
+#if defined(DUK_USE_SLAB_ALLOC)
+#define DUK_SLAB_GRANULE             8     /* size class step, also slot alignment */
+#define DUK_SLAB_CLASS_NONE          0xffffUL
+#define DUK_SLAB_GET_CLASS_INDEX(size) \
+	(((size) - 1) / DUK_SLAB_GRANULE)
+
+/* Free slot, links to the next free slot of the same page. */
+typedef struct duk_slab_freeslot duk_slab_freeslot;
+struct duk_slab_freeslot {
+	duk_slab_freeslot *next;
+};
+
+/* Page header, located at the start of each page. */
+struct duk_slab_page {
+	duk_slab_page *next;         /* class partial list or free page list */
+	duk_slab_page *prev;
+	duk_slab_chunk *chunk;
+	duk_slab_freeslot *free;     /* slots freed after use */
+	duk_uint8_t *bump;           /* first slot never used since assignment */
+	duk_uint32_t used;           /* allocated slots */
+	duk_uint32_t class_index;    /* DUK_SLAB_CLASS_NONE if unassigned */
+};
+
+/* Chunk header, located after the last page of the chunk. */
+struct duk_slab_chunk {
+	duk_slab_chunk *next;
+	duk_slab_chunk *prev;
+	void *alloc_ptr;             /* pointer returned by the allocator */
+	duk_uint8_t *pages;          /* first (aligned) page */
+	duk_uint32_t free_pages;     /* pages not assigned to a class */
+};
+
+struct duk_slab_class {
+	/* Pages with at least one free slot, allocation happens from the
+	 * head page.  Full pages are not linked anywhere.
+	 */
+	duk_slab_page *partial;
+	duk_uint32_t slot_size;
+	duk_uint32_t slots_per_page;
+
+	/* statistics */
+	duk_size_t page_count;
+	duk_size_t used_count;
+	duk_size_t alloc_count;
+	duk_size_t free_count;
+};
+
+struct duk_slab {
+	duk_size_t page_size;        /* power of two */
+	duk_uintptr_t page_mask;
+	duk_size_t chunk_pages;
+	duk_size_t max_size;         /* largest size served, multiple of DUK_SLAB_GRANULE */
+	duk_small_uint_t class_count;
+
+	duk_slab_chunk *chunks;
+	duk_slab_page *free_pages;
+
+	/* statistics */
+	duk_size_t chunk_count;
+	duk_size_t free_page_count;
+	duk_size_t chunk_alloc_count;
+	duk_size_t chunk_free_count;
+
+	duk_slab_class classes[DUK_SLAB_MAX_CLASSES];
+};
+#endif  /* DUK_USE_SLAB_ALLOC */
+
+/*
+ *  Arena allocator state, see duk_heap_arena.c.
+ *
+ *  When arena mode is enabled for a heap, sized allocations are bump
+ *  allocated from chunks which are only released when the heap is
+ *  destroyed.  Sized frees leave holes which are never reused.
+ */
+
+#if defined(DUK_USE_ARENA_ALLOC)
+#define DUK_ARENA_ALIGN              8
+
+#define DUK_HEAP_ARENA_ENABLED(heap) ((heap)->arena.chunk_size != 0)
+
+/* Chunk header, located at the start of each chunk. */
+struct duk_arena_chunk {
+	duk_arena_chunk *next;
+	duk_size_t size;             /* usable bytes after the header */
+};
+
+struct duk_arena {
+	duk_size_t chunk_size;       /* 0 if arena mode is not enabled */
+	duk_uint8_t *curr;           /* bump pointer in the current chunk */
+	duk_uint8_t *end;
+	duk_arena_chunk *chunks;     /* all chunks, including dedicated ones */
+
+	/* statistics */
+	duk_size_t chunk_count;
+	duk_size_t chunk_bytes;
+	duk_size_t alloc_bytes;      /* bytes handed out, including holes */
+	duk_size_t hole_bytes;       /* bytes freed but not reusable */
+};
+#endif  /* DUK_USE_ARENA_ALLOC */
+
 /*
  *  Main heap structure
  */
@@ -296,6 +465,30 @@ struct duk_heap {
 	duk_free_function free_func;
 	void *alloc_udata;
 
+#if defined(DUK_USE_SLAB_ALLOC)
+	/* slab allocator for heap object headers and property allocations */
+	duk_slab slab;
+#endif
+#if defined(DUK_USE_ARENA_ALLOC)
+	/* arena allocator, used instead of the slab allocator if enabled */
+	duk_arena arena;
+#endif
+
+	/* Memory limit accounting.  If the heap has limits, the allocator
+	 * functions above are accounting wrappers (with the heap as udata)
+	 * and the user functions are stored here.  Without limits mem_used
+	 * stays zero and the soft trigger is DUK_SIZE_MAX.
+	 */
+	duk_alloc_function mem_alloc_func;   /* NULL if no limits */
+	duk_realloc_function mem_realloc_func;
+	duk_free_function mem_free_func;
+	void *mem_udata;
+	duk_size_t mem_used;
+	duk_size_t mem_peak;
+	duk_size_t mem_limit_soft;           /* DUK_SIZE_MAX if no soft limit */
+	duk_size_t mem_limit_hard;           /* DUK_SIZE_MAX if no hard limit */
+	duk_size_t mem_soft_trigger;         /* mem_used level for next soft limit GC */
+
 	/* Precomputed pointers when using 16-bit heap pointer packing. */
 #if defined(DUK_USE_HEAPPTR16)
 	duk_uint16_t heapptr_null16;
@@ -321,18 +514,54 @@ struct duk_heap {
 	duk_heaphdr *refzero_list_tail;
 #endif
 
+	/* all weak objects (WeakMap, WeakRef), whose entries need to be
+	 * removed when a key is freed; see duk_hweakobject.h
+	 */
+#if defined(DUK_USE_WEAK_REFERENCES)
+	duk_hweakobject *weak_objects;
+#endif
+
 #ifdef DUK_USE_MARK_AND_SWEEP
 	/* mark-and-sweep control */
 #ifdef DUK_USE_VOLUNTARY_GC
 	duk_int_t mark_and_sweep_trigger_counter;
+	duk_int_t mark_and_sweep_trigger_limit;    /* counter value after last reset */
+	duk_size_t mark_and_sweep_bytes;           /* bytes (re)allocated since last round */
+	duk_size_t mark_and_sweep_bytes_trigger;   /* DUK_SIZE_MAX if no byte trigger */
 #endif
-	duk_int_t mark_and_sweep_recursion_depth;
+	duk_int_t mark_and_sweep_recursion_depth;  /* nonzero while the mark stack is processed */
+
+	/* unreachable objects waiting to be freed, see gc_policy.sweep_step */
+	duk_heaphdr *sweep_free_list;
+
+	/* position in heap_allocated where budgeted compaction continues */
+	duk_size_t mark_and_sweep_compact_index;
+
+	/* explicit mark stack, allocated directly with alloc_func */
+	duk_heaphdr **mark_stack;
+	duk_size_t mark_stack_size;
+	duk_size_t mark_stack_top;
+
+	/* trigger policy, see duk_set_gc_policy() */
+	duk_gc_policy gc_policy;
+	duk_double_t mark_and_sweep_end_time;      /* timestamp when last round finished */
 
 	/* mark-and-sweep flags automatically active (used for critical sections) */
 	duk_small_uint_t mark_and_sweep_base_flags;
 
 	/* work list for objects to be finalized (by mark-and-sweep) */
 	duk_heaphdr *finalize_list;
+
+	/* statistics, see duk_get_heap_stats(); times in milliseconds */
+	duk_size_t mark_and_sweep_count;
+	duk_size_t mark_and_sweep_emergency_count;
+	duk_double_t mark_and_sweep_time_total;
+	duk_double_t mark_and_sweep_time_last;
+	duk_double_t mark_and_sweep_time_max;
+
+	/* user callback for mark-and-sweep start and end events */
+	duk_gc_hook_function gc_hook;
+	void *gc_hook_udata;
 #endif
 
 	/* longjmp state */
@@ -383,6 +612,18 @@ struct duk_heap {
 	 */
 	duk_strcache strcache[DUK_HEAP_STRCACHE_SIZE];
 
+#if defined(DUK_USE_INTSTR_CACHE)
+	/* interned strings for integers [0, DUK_USE_INTSTR_CACHE_SIZE), indexed
+	 * by value; 'weak' references like the string access cache.
+	 */
+	duk_hstring *intstr_cache[DUK_USE_INTSTR_CACHE_SIZE];
+#endif
+
+#if defined(DUK_USE_HOBJECT_SHAPES)
+	/* root of the shape transition tree (empty shape), never freed */
+	duk_hshape shape_root;
+#endif
+
 	/* built-in strings */
 #if defined(DUK_USE_HEAPPTR16)
 	duk_uint16_t strs16[DUK_HEAP_NUM_STRINGS];
@@ -400,9 +641,14 @@ duk_heap *duk_heap_alloc(duk_alloc_function alloc_func,
                          duk_realloc_function realloc_func,
                          duk_free_function free_func,
                          void *alloc_udata,
-                         duk_fatal_function fatal_func);
+                         duk_fatal_function fatal_func,
+                         const duk_heap_options *options);
 DUK_INTERNAL_DECL void duk_heap_free(duk_heap *heap);
 DUK_INTERNAL_DECL void duk_heap_free_heaphdr_raw(duk_heap *heap, duk_heaphdr *hdr);
+DUK_INTERNAL_DECL duk_size_t duk_heap_get_heaphdr_alloc_size(duk_heaphdr *hdr);
+#if defined(DUK_USE_MARK_AND_SWEEP)
+DUK_INTERNAL_DECL duk_size_t duk_heap_get_heaphdr_total_size(duk_heaphdr *hdr);
+#endif
 
 DUK_INTERNAL_DECL void duk_heap_insert_into_heap_allocated(duk_heap *heap, duk_heaphdr *hdr);
 #if defined(DUK_USE_DOUBLE_LINKED_HEAP) && defined(DUK_USE_REFERENCE_COUNTING)
@@ -417,6 +663,9 @@ DUK_INTERNAL_DECL duk_hstring *duk_heap_string_lookup(duk_heap *heap, duk_uint8_
 #endif
 DUK_INTERNAL_DECL duk_hstring *duk_heap_string_intern(duk_heap *heap, duk_uint8_t *str, duk_uint32_t blen);
 DUK_INTERNAL_DECL duk_hstring *duk_heap_string_intern_checked(duk_hthread *thr, duk_uint8_t *str, duk_uint32_t len);
+#if defined(DUK_USE_HSTRING_EXTDATA)
+DUK_INTERNAL_DECL duk_hstring *duk_heap_string_intern_external(duk_heap *heap, duk_uint8_t *str, duk_uint32_t blen, duk_free_function release_func, void *release_udata, duk_bool_t *out_used);
+#endif
 #if 0  /*unused*/
 DUK_INTERNAL_DECL duk_hstring *duk_heap_string_lookup_u32(duk_heap *heap, duk_uint32_t val);
 #endif
@@ -441,6 +690,28 @@ DUK_INTERNAL_DECL void *duk_heap_mem_alloc_zeroed(duk_heap *heap, duk_size_t siz
 DUK_INTERNAL_DECL void *duk_heap_mem_realloc(duk_heap *heap, void *ptr, duk_size_t newsize);
 DUK_INTERNAL_DECL void *duk_heap_mem_realloc_indirect(duk_heap *heap, duk_mem_getptr cb, void *ud, duk_size_t newsize);
 DUK_INTERNAL_DECL void duk_heap_mem_free(duk_heap *heap, void *ptr);
+DUK_INTERNAL_DECL void duk_heap_mem_limit_init(duk_heap *heap, const duk_heap_options *options);
+#if defined(DUK_USE_MARK_AND_SWEEP)
+DUK_INTERNAL_DECL void duk_heap_mem_limit_start(duk_heap *heap);
+DUK_INTERNAL_DECL void duk_heap_mem_limit_update_trigger(duk_heap *heap);
+#endif
+#if defined(DUK_USE_SIZED_ALLOC)
+DUK_INTERNAL_DECL void *duk_heap_mem_alloc_slab(duk_heap *heap, duk_size_t size);
+DUK_INTERNAL_DECL void *duk_heap_mem_alloc_slab_zeroed(duk_heap *heap, duk_size_t size);
+DUK_INTERNAL_DECL void duk_heap_mem_free_slab(duk_heap *heap, void *ptr, duk_size_t size);
+#endif
+#if defined(DUK_USE_SLAB_ALLOC)
+DUK_INTERNAL_DECL void duk_heap_slab_init(duk_heap *heap, const duk_heap_options *options);
+DUK_INTERNAL_DECL void duk_heap_slab_free_all(duk_heap *heap);
+DUK_INTERNAL_DECL void *duk_heap_slab_alloc(duk_heap *heap, duk_size_t size);
+DUK_INTERNAL_DECL void duk_heap_slab_free(duk_heap *heap, void *ptr, duk_size_t size);
+#endif
+#if defined(DUK_USE_ARENA_ALLOC)
+DUK_INTERNAL_DECL void duk_heap_arena_init(duk_heap *heap, const duk_heap_options *options);
+DUK_INTERNAL_DECL void duk_heap_arena_free_all(duk_heap *heap);
+DUK_INTERNAL_DECL void *duk_heap_arena_alloc(duk_heap *heap, duk_size_t size);
+DUK_INTERNAL_DECL void duk_heap_arena_free(duk_heap *heap, void *ptr, duk_size_t size);
+#endif
 
 #ifdef DUK_USE_REFERENCE_COUNTING
 DUK_INTERNAL_DECL void duk_heap_tval_incref(duk_tval *tv);
@@ -448,12 +719,18 @@ DUK_INTERNAL_DECL void duk_heap_tval_decref(duk_hthread *thr, duk_tval *tv);
 DUK_INTERNAL_DECL void duk_heap_heaphdr_incref(duk_heaphdr *h);
 DUK_INTERNAL_DECL void duk_heap_heaphdr_decref(duk_hthread *thr, duk_heaphdr *h);
 DUK_INTERNAL_DECL void duk_heap_refcount_finalize_heaphdr(duk_hthread *thr, duk_heaphdr *hdr);
+DUK_INTERNAL_DECL void duk_heap_refzero_process_pending(duk_hthread *thr, duk_bool_t all);
 #else
 /* no refcounting */
 #endif
 
 #ifdef DUK_USE_MARK_AND_SWEEP
 DUK_INTERNAL_DECL duk_bool_t duk_heap_mark_and_sweep(duk_heap *heap, duk_small_uint_t flags);
+DUK_INTERNAL_DECL void duk_heap_gc_policy_init(duk_heap *heap);
+#ifdef DUK_USE_VOLUNTARY_GC
+DUK_INTERNAL_DECL duk_bool_t duk_heap_mark_and_sweep_postpone(duk_heap *heap);
+#endif
+DUK_INTERNAL_DECL duk_size_t duk_heap_free_deferred(duk_heap *heap, duk_size_t budget);
 #endif
 
 DUK_INTERNAL_DECL duk_uint32_t duk_heap_hashstring(duk_heap *heap, duk_uint8_t *str, duk_size_t len);
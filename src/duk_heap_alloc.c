@@ -25,7 +25,12 @@ DUK_LOCAL void duk__free_hobject_inner(duk_heap *heap, duk_hobject *h) {
 	DUK_ASSERT(heap != NULL);
 	DUK_ASSERT(h != NULL);
 
-	DUK_FREE(heap, DUK_HOBJECT_GET_PROPS(h));
+	DUK_FREE_SLAB(heap, DUK_HOBJECT_GET_PROPS(h), DUK_HOBJECT_E_ALLOC_SIZE(h));
+#if defined(DUK_USE_HOBJECT_SHAPES)
+	if (DUK_HOBJECT_GET_SHAPE(h) != NULL) {
+		duk_hshape_decref(heap, DUK_HOBJECT_GET_SHAPE(h));
+	}
+#endif
 
 	if (DUK_HOBJECT_IS_COMPILEDFUNCTION(h)) {
 		duk_hcompiledfunction *f = (duk_hcompiledfunction *) h;
@@ -35,6 +40,10 @@ DUK_LOCAL void duk__free_hobject_inner(duk_heap *heap, duk_hobject *h) {
 		duk_hnativefunction *f = (duk_hnativefunction *) h;
 		DUK_UNREF(f);
 		/* Currently nothing to free */
+	} else if (DUK_HOBJECT_IS_BUFFEROBJECT(h)) {
+		duk_hbufferobject *b = (duk_hbufferobject *) h;
+		DUK_UNREF(b);
+		/* Currently nothing to free; 'buf' and 'buf_prop' are heap objects */
 	} else if (DUK_HOBJECT_IS_THREAD(h)) {
 		duk_hthread *t = (duk_hthread *) h;
 		DUK_FREE(heap, t->valstack);
@@ -49,6 +58,13 @@ DUK_LOCAL void duk__free_hobject_inner(duk_heap *heap, duk_hobject *h) {
 		 * to be unwound to update the 'caller' properties of
 		 * functions in the callstack.
 		 */
+#if defined(DUK_USE_WEAK_REFERENCES)
+	} else if (DUK_HOBJECT_IS_WEAKOBJECT(h)) {
+		/* Entry keys are weak and values have been decref'd by
+		 * refcount finalization (if any).
+		 */
+		duk_hweakobject_free_inner(heap, (duk_hweakobject *) h);
+#endif
 	}
 }
 
@@ -56,13 +72,121 @@ DUK_LOCAL void duk__free_hbuffer_inner(duk_heap *heap, duk_hbuffer *h) {
 	DUK_ASSERT(heap != NULL);
 	DUK_ASSERT(h != NULL);
 
-	if (DUK_HBUFFER_HAS_DYNAMIC(h)) {
+	if (DUK_HBUFFER_HAS_EXTERNAL(h)) {
+		/* Data is owned by user code, just notify it. */
+		duk_hbuffer_external *g = (duk_hbuffer_external *) h;
+		DUK_DDD(DUK_DDDPRINT("release external buffer %p", (void *) DUK_HBUFFER_EXTERNAL_GET_DATA_PTR(g)));
+		if (g->release_func != NULL) {
+			g->release_func(g->release_udata, DUK_HBUFFER_EXTERNAL_GET_DATA_PTR(g));
+		}
+	} else if (DUK_HBUFFER_HAS_DYNAMIC(h)) {
 		duk_hbuffer_dynamic *g = (duk_hbuffer_dynamic *) h;
 		DUK_DDD(DUK_DDDPRINT("free dynamic buffer %p", (void *) DUK_HBUFFER_DYNAMIC_GET_DATA_PTR(g)));
 		DUK_FREE(heap, DUK_HBUFFER_DYNAMIC_GET_DATA_PTR(g));
 	}
 }
 
+#if defined(DUK_USE_HSTRING_EXTDATA)
+DUK_LOCAL void duk__free_hstring_inner(duk_heap *heap, duk_hstring *h) {
+	DUK_ASSERT(heap != NULL);
+	DUK_ASSERT(h != NULL);
+	DUK_UNREF(heap);
+
+	if (DUK_HSTRING_HAS_EXTDATA(h)) {
+		duk_hstring_external *g = (duk_hstring_external *) h;
+		DUK_DDD(DUK_DDDPRINT("release external string data %p", (const void *) g->extdata));
+		if (g->release_func != NULL) {
+			g->release_func(g->release_udata, (void *) g->extdata);
+		}
+	}
+}
+#endif
+
+/* Allocation size of a heap object, must match the size given to
+ * DUK_ALLOC_SLAB() by the allocation functions.  Also used for heap
+ * statistics.
+ */
+DUK_INTERNAL duk_size_t duk_heap_get_heaphdr_alloc_size(duk_heaphdr *hdr) {
+	switch ((int) DUK_HEAPHDR_GET_TYPE(hdr)) {
+	case DUK_HTYPE_STRING: {
+		duk_hstring *h = (duk_hstring *) hdr;
+#if defined(DUK_USE_HSTRING_EXTDATA)
+		if (DUK_HSTRING_HAS_EXTDATA(h)) {
+			return sizeof(duk_hstring_external);
+		}
+#endif
+		return sizeof(duk_hstring) + DUK_HSTRING_GET_BYTELEN(h) + 1;
+	}
+	case DUK_HTYPE_OBJECT: {
+		duk_hobject *h = (duk_hobject *) hdr;
+		if (DUK_HOBJECT_IS_COMPILEDFUNCTION(h)) {
+			return sizeof(duk_hcompiledfunction);
+		} else if (DUK_HOBJECT_IS_NATIVEFUNCTION(h)) {
+			return sizeof(duk_hnativefunction);
+		} else if (DUK_HOBJECT_IS_BUFFEROBJECT(h)) {
+			return sizeof(duk_hbufferobject);
+		} else if (DUK_HOBJECT_IS_THREAD(h)) {
+			return sizeof(duk_hthread);
+		}
+#if defined(DUK_USE_WEAK_REFERENCES)
+		if (DUK_HOBJECT_IS_WEAKOBJECT(h)) {
+			return sizeof(duk_hweakobject);
+		}
+#endif
+		return sizeof(duk_hobject);
+	}
+	default: {
+		duk_hbuffer *h = (duk_hbuffer *) hdr;
+		DUK_ASSERT(DUK_HEAPHDR_GET_TYPE(hdr) == DUK_HTYPE_BUFFER);
+		if (DUK_HBUFFER_HAS_EXTERNAL(h)) {
+			return sizeof(duk_hbuffer_external);
+		} else if (DUK_HBUFFER_HAS_DYNAMIC(h)) {
+			return sizeof(duk_hbuffer_dynamic);
+		}
+		return sizeof(duk_hbuffer_fixed) + DUK_HBUFFER_GET_SIZE(h);
+	}
+	}
+}
+
+/* Like duk_heap_get_heaphdr_alloc_size() but also includes the auxiliary
+ * allocations owned by the heap object: property table, dynamic buffer
+ * data, thread stacks, and weak object entry tables.
+ */
+#if defined(DUK_USE_MARK_AND_SWEEP)
+DUK_INTERNAL duk_size_t duk_heap_get_heaphdr_total_size(duk_heaphdr *hdr) {
+	duk_size_t size = duk_heap_get_heaphdr_alloc_size(hdr);
+
+	switch ((int) DUK_HEAPHDR_GET_TYPE(hdr)) {
+	case DUK_HTYPE_OBJECT: {
+		duk_hobject *h = (duk_hobject *) hdr;
+		size += DUK_HOBJECT_E_ALLOC_SIZE(h);
+		if (DUK_HOBJECT_IS_THREAD(h)) {
+			duk_hthread *t = (duk_hthread *) h;
+			size += (duk_size_t) (t->valstack_end - t->valstack) * sizeof(duk_tval) +
+			        t->callstack_size * sizeof(duk_activation) +
+			        t->catchstack_size * sizeof(duk_catcher);
+		}
+#if defined(DUK_USE_WEAK_REFERENCES)
+		if (DUK_HOBJECT_IS_WEAKOBJECT(h)) {
+			size += (duk_size_t) ((duk_hweakobject *) h)->size * sizeof(duk_weakentry);
+		}
+#endif
+		break;
+	}
+	case DUK_HTYPE_BUFFER: {
+		duk_hbuffer *h = (duk_hbuffer *) hdr;
+		if (DUK_HBUFFER_HAS_DYNAMIC(h) && !DUK_HBUFFER_HAS_EXTERNAL(h)) {
+			size += DUK_HBUFFER_DYNAMIC_GET_ALLOC_SIZE((duk_hbuffer_dynamic *) h);
+		}
+		break;
+	}
+	default:
+		break;
+	}
+	return size;
+}
+#endif  /* DUK_USE_MARK_AND_SWEEP */
+
 DUK_INTERNAL void duk_heap_free_heaphdr_raw(duk_heap *heap, duk_heaphdr *hdr) {
 	DUK_ASSERT(heap);
 	DUK_ASSERT(hdr);
@@ -71,7 +195,10 @@ DUK_INTERNAL void duk_heap_free_heaphdr_raw(duk_heap *heap, duk_heaphdr *hdr) {
 
 	switch ((int) DUK_HEAPHDR_GET_TYPE(hdr)) {
 	case DUK_HTYPE_STRING:
-		/* no inner refs to free */
+		/* no inner refs to free, but external data must be released */
+#if defined(DUK_USE_HSTRING_EXTDATA)
+		duk__free_hstring_inner(heap, (duk_hstring *) hdr);
+#endif
 		break;
 	case DUK_HTYPE_OBJECT:
 		duk__free_hobject_inner(heap, (duk_hobject *) hdr);
@@ -83,7 +210,7 @@ DUK_INTERNAL void duk_heap_free_heaphdr_raw(duk_heap *heap, duk_heaphdr *hdr) {
 		DUK_UNREACHABLE();
 	}
 
-	DUK_FREE(heap, hdr);
+	DUK_FREE_SLAB(heap, hdr, duk_heap_get_heaphdr_alloc_size(hdr));
 }
 
 /*
@@ -157,6 +284,12 @@ DUK_LOCAL void duk__free_stringtable(duk_heap *heap) {
 	if (heap->strtable16) {
 #else
 	if (heap->strtable) {
+#endif
+#if defined(DUK_USE_ARENA_ALLOC) && !defined(DUK_USE_HSTRING_EXTDATA)
+		/* arena allocated strings are released with the arena chunks */
+		if (DUK_HEAP_ARENA_ENABLED(heap)) {
+			goto free_table;
+		}
 #endif
 		for (i = 0; i < (duk_uint_fast32_t) heap->st_size; i++) {
 			duk_hstring *e;
@@ -169,14 +302,26 @@ DUK_LOCAL void duk__free_stringtable(duk_heap *heap) {
 				continue;
 			}
 
-			/* strings have no inner allocations so free directly */
+			/* strings have no inner allocations so free directly,
+			 * unless external data must be released or the slab
+			 * allocator needs the allocation size
+			 */
 			DUK_DDD(DUK_DDDPRINT("FINALFREE (string): %!iO",
 			                     (duk_heaphdr *) e));
+#if defined(DUK_USE_HSTRING_EXTDATA) || defined(DUK_USE_SIZED_ALLOC)
+			if (e != NULL) {
+				duk_heap_free_heaphdr_raw(heap, (duk_heaphdr *) e);
+			}
+#else
 			DUK_FREE(heap, e);
+#endif
 #if 0  /* not strictly necessary */
 			heap->strtable[i] = NULL;
 #endif
 		}
+#if defined(DUK_USE_ARENA_ALLOC) && !defined(DUK_USE_HSTRING_EXTDATA)
+ free_table:
+#endif
 #if defined(DUK_USE_HEAPPTR16)
 		DUK_FREE(heap, heap->strtable16);
 #else
@@ -247,20 +392,32 @@ DUK_INTERNAL void duk_heap_free(duk_heap *heap) {
 	 *
 	 * XXX: this perhaps requires an execution time limit.
 	 */
-	DUK_D(DUK_DPRINT("execute finalizers before freeing heap"));
+	if (heap->heap_thread == NULL) {
+		/* heap init failed (e.g. memory limit), there can be
+		 * no finalizers
+		 */
+		DUK_D(DUK_DPRINT("no heap thread, skip finalizers"));
+	} else {
+		DUK_D(DUK_DPRINT("execute finalizers before freeing heap"));
 #ifdef DUK_USE_MARK_AND_SWEEP
-	/* run mark-and-sweep a few times just in case (unreachable
-	 * object finalizers run already here)
-	 */
-	duk_heap_mark_and_sweep(heap, 0);
-	duk_heap_mark_and_sweep(heap, 0);
+		/* run mark-and-sweep a few times just in case (unreachable
+		 * object finalizers run already here)
+		 */
+		duk_heap_mark_and_sweep(heap, DUK_MS_REASON(DUK_GC_REASON_HEAP_DESTROY));
+		duk_heap_mark_and_sweep(heap, DUK_MS_REASON(DUK_GC_REASON_HEAP_DESTROY));
 #endif
-	duk__free_run_finalizers(heap);
+		duk__free_run_finalizers(heap);
+	}
 
 	/* Note: heap->heap_thread, heap->curr_thread, heap->heap_object,
 	 * and heap->log_buffer are on the heap allocated list.
 	 */
 
+#ifdef DUK_USE_MARK_AND_SWEEP
+	DUK_D(DUK_DPRINT("freeing deferred sweep objects of heap: %p", (void *) heap));
+	(void) duk_heap_free_deferred(heap, 0);
+#endif
+
 	DUK_D(DUK_DPRINT("freeing heap objects of heap: %p", (void *) heap));
 	duk__free_allocated(heap);
 
@@ -272,13 +429,48 @@ DUK_INTERNAL void duk_heap_free(duk_heap *heap) {
 #ifdef DUK_USE_MARK_AND_SWEEP
 	DUK_D(DUK_DPRINT("freeing mark-and-sweep finalize list of heap: %p", (void *) heap));
 	duk__free_markandsweep_finalize_list(heap);
+
+	DUK_D(DUK_DPRINT("freeing mark stack of heap: %p", (void *) heap));
+	heap->free_func(heap->alloc_udata, (void *) heap->mark_stack);
+#endif
+
+#if defined(DUK_USE_WEAK_REFERENCES)
+	/* weak objects unlink themselves when freed */
+	DUK_ASSERT(heap->weak_objects == NULL);
+#endif
+
+#if defined(DUK_USE_HOBJECT_SHAPES)
+	/* all objects are freed, so only the heap reference to the root
+	 * shape remains and all other shapes have been freed
+	 */
+	DUK_ASSERT(heap->shape_root.refcount == 1);
+	DUK_ASSERT(heap->shape_root.child == NULL);
 #endif
 
 	DUK_D(DUK_DPRINT("freeing string table of heap: %p", (void *) heap));
 	duk__free_stringtable(heap);
 
+#if defined(DUK_USE_SLAB_ALLOC)
+	/* all slab allocated memory has been freed, release the chunks */
+	DUK_D(DUK_DPRINT("freeing slab allocator of heap: %p", (void *) heap));
+	duk_heap_slab_free_all(heap);
+#endif
+#if defined(DUK_USE_ARENA_ALLOC)
+	/* release arena chunks wholesale, sized frees above were no-ops */
+	DUK_D(DUK_DPRINT("freeing arena of heap: %p", (void *) heap));
+	duk_heap_arena_free_all(heap);
+#endif
+
 	DUK_D(DUK_DPRINT("freeing heap structure: %p", (void *) heap));
-	heap->free_func(heap->alloc_udata, heap);
+	if (heap->mem_alloc_func) {
+		/* the heap structure was allocated before the memory limit
+		 * wrappers were installed
+		 */
+		DUK_ASSERT(heap->mem_used == 0);
+		heap->mem_free_func(heap->mem_udata, heap);
+	} else {
+		heap->free_func(heap->alloc_udata, heap);
+	}
 }
 
 /*
@@ -381,6 +573,7 @@ DUK_LOCAL duk_bool_t duk__init_heap_strings(duk_heap *heap) {
 
 DUK_LOCAL duk_bool_t duk__init_heap_thread(duk_heap *heap) {
 	duk_hthread *thr;
+	duk_jmpbuf our_jmpbuf;
 
 	DUK_DD(DUK_DDPRINT("heap init: alloc heap thread"));
 	thr = duk_hthread_alloc(heap,
@@ -407,8 +600,21 @@ DUK_LOCAL duk_bool_t duk__init_heap_thread(duk_heap *heap) {
 		return 0;
 	}
 
-	/* XXX: this may now fail, and is not handled correctly */
+	/* Built-in creation throws on allocation failure (e.g. when a hard
+	 * memory limit is reached).  Catch the error with a bare setjmp
+	 * catchpoint: duk_safe_call() error handling itself needs value
+	 * stack space.  The heap is freed by the caller so the error value
+	 * and thread state don't need to be cleaned up.
+	 */
+	DUK_ASSERT(heap->lj.jmpbuf_ptr == NULL);
+	heap->lj.jmpbuf_ptr = &our_jmpbuf;
+	if (DUK_SETJMP(our_jmpbuf.jb) != 0) {
+		DUK_D(DUK_DPRINT("failed to create built-in objects"));
+		heap->lj.jmpbuf_ptr = NULL;
+		return 0;
+	}
 	duk_hthread_create_builtin_objects(thr);
+	heap->lj.jmpbuf_ptr = NULL;
 
 	/* default prototype (Note: 'thr' must be reachable) */
 	DUK_HOBJECT_SET_PROTOTYPE_UPDREF(thr, (duk_hobject *) thr, thr->builtins[DUK_BIDX_THREAD_PROTOTYPE]);
@@ -519,6 +725,7 @@ DUK_LOCAL void duk__dump_type_sizes(void) {
 	DUK__DUMPSZ(duk_hobject);
 	DUK__DUMPSZ(duk_hcompiledfunction);
 	DUK__DUMPSZ(duk_hnativefunction);
+	DUK__DUMPSZ(duk_hbufferobject);
 	DUK__DUMPSZ(duk_hthread);
 	DUK__DUMPSZ(duk_hbuffer);
 	DUK__DUMPSZ(duk_hbuffer_fixed);
@@ -601,7 +808,8 @@ duk_heap *duk_heap_alloc(duk_alloc_function alloc_func,
                          duk_realloc_function realloc_func,
                          duk_free_function free_func,
                          void *alloc_udata,
-                         duk_fatal_function fatal_func) {
+                         duk_fatal_function fatal_func,
+                         const duk_heap_options *options) {
 	duk_heap *res = NULL;
 
 	DUK_D(DUK_DPRINT("allocate heap"));
@@ -656,13 +864,22 @@ duk_heap *duk_heap_alloc(duk_alloc_function alloc_func,
 	/* explicit NULL inits */
 #ifdef DUK_USE_EXPLICIT_NULL_INIT
 	res->alloc_udata = NULL;
+	res->mem_alloc_func = NULL;
+	res->mem_udata = NULL;
 	res->heap_allocated = NULL;
 #ifdef DUK_USE_REFERENCE_COUNTING
 	res->refzero_list = NULL;
 	res->refzero_list_tail = NULL;
 #endif
+#if defined(DUK_USE_WEAK_REFERENCES)
+	res->weak_objects = NULL;
+#endif
 #ifdef DUK_USE_MARK_AND_SWEEP
 	res->finalize_list = NULL;
+	res->gc_hook = NULL;
+	res->gc_hook_udata = NULL;
+	res->sweep_free_list = NULL;
+	res->mark_stack = NULL;
 #endif
 	res->heap_thread = NULL;
 	res->curr_thread = NULL;
@@ -684,12 +901,33 @@ duk_heap *duk_heap_alloc(duk_alloc_function alloc_func,
 	res->alloc_udata = alloc_udata;
 	res->fatal_func = fatal_func;
 
+	/* may replace the allocation functions with accounting wrappers */
+	duk_heap_mem_limit_init(res, options);
+
+#if defined(DUK_USE_MARK_AND_SWEEP)
+	/* Object compaction needs a heap thread with a value stack, so it's
+	 * disabled until heap init is complete.  Emergency GCs caused by
+	 * allocation failures during init still run.
+	 */
+	res->mark_and_sweep_base_flags = DUK_MS_FLAG_NO_OBJECT_COMPACTION;
+#endif
+
+#if defined(DUK_USE_SLAB_ALLOC)
+	/* no allocations yet, chunks are allocated on demand */
+	duk_heap_slab_init(res, options);
+#endif
+#if defined(DUK_USE_ARENA_ALLOC)
+	duk_heap_arena_init(res, options);
+#endif
+
 #if defined(DUK_USE_HEAPPTR16)
 	res->heapptr_null16 = DUK_USE_HEAPPTR_ENC16((void *) NULL);
 	res->heapptr_deleted16 = DUK_USE_HEAPPTR_ENC16((void *) DUK_STRTAB_DELETED_MARKER(res));
 #endif
 
-	/* res->mark_and_sweep_trigger_counter == 0 -> now causes immediate GC; which is OK */
+#if defined(DUK_USE_MARK_AND_SWEEP)
+	duk_heap_gc_policy_init(res);
+#endif
 
 	res->call_recursion_depth = 0;
 	res->call_recursion_limit = DUK_HEAP_DEFAULT_CALL_RECURSION_LIMIT;
@@ -724,12 +962,12 @@ duk_heap *duk_heap_alloc(duk_alloc_function alloc_func,
 #endif
 
 #if defined(DUK_USE_HEAPPTR16)
-	res->strtable16 = (duk_uint16_t *) alloc_func(alloc_udata, sizeof(duk_uint16_t) * DUK_STRTAB_INITIAL_SIZE);
+	res->strtable16 = (duk_uint16_t *) res->alloc_func(res->alloc_udata, sizeof(duk_uint16_t) * DUK_STRTAB_INITIAL_SIZE);
 	if (!res->strtable16) {
 		goto error;
 	}
 #else
-	res->strtable = (duk_hstring **) alloc_func(alloc_udata, sizeof(duk_hstring *) * DUK_STRTAB_INITIAL_SIZE);
+	res->strtable = (duk_hstring **) res->alloc_func(res->alloc_udata, sizeof(duk_hstring *) * DUK_STRTAB_INITIAL_SIZE);
 	if (!res->strtable) {
 		goto error;
 	}
@@ -765,6 +1003,34 @@ duk_heap *duk_heap_alloc(duk_alloc_function alloc_func,
 	}
 #endif
 
+	/* integer string cache init */
+#if defined(DUK_USE_INTSTR_CACHE) && defined(DUK_USE_EXPLICIT_NULL_INIT)
+	{
+		duk_uint_fast32_t i;
+		for (i = 0; i < DUK_USE_INTSTR_CACHE_SIZE; i++) {
+			res->intstr_cache[i] = NULL;
+		}
+	}
+#endif
+
+	/* shape transition tree root: the heap holds one reference so that the
+	 * empty root shape is never freed
+	 */
+#if defined(DUK_USE_HOBJECT_SHAPES)
+#ifdef DUK_USE_EXPLICIT_NULL_INIT
+	res->shape_root.parent = NULL;
+	res->shape_root.child = NULL;
+	res->shape_root.next = NULL;
+	res->shape_root.prev = NULL;
+	res->shape_root.keys = NULL;
+	res->shape_root.flags = NULL;
+	res->shape_root.enum_shape = NULL;
+#endif
+	DUK_ASSERT(res->shape_root.count == 0);
+	DUK_ASSERT(res->shape_root.child_count == 0);
+	res->shape_root.refcount = 1;
+#endif
+
 	/* XXX: error handling is incomplete.  It would be cleanest if
 	 * there was a setjmp catchpoint, so that all init code could
 	 * freely throw errors.  If that were the case, the return code
@@ -803,6 +1069,11 @@ duk_heap *duk_heap_alloc(duk_alloc_function alloc_func,
 	}
 	DUK_HBUFFER_INCREF(res->heap_thread, res->log_buffer);
 
+#if defined(DUK_USE_MARK_AND_SWEEP)
+	res->mark_and_sweep_base_flags = 0;
+	duk_heap_mem_limit_start(res);
+#endif
+
 	DUK_D(DUK_DPRINT("allocated heap: %p", (void *) res));
 	return res;
 
@@ -816,6 +1087,12 @@ duk_heap *duk_heap_alloc(duk_alloc_function alloc_func,
 		DUK_ASSERT(res->alloc_func != NULL);
 		DUK_ASSERT(res->realloc_func != NULL);
 		DUK_ASSERT(res->free_func != NULL);
+
+		/* There can be no finalizers yet, and the heap thread may be
+		 * partially initialized: free the heap like one whose init
+		 * failed before the heap thread was created.
+		 */
+		res->heap_thread = NULL;
 		duk_heap_free(res);
 	}
 	return NULL;
@@ -0,0 +1,173 @@
+/*
+ *  Arena allocator for short lived heaps.
+ *
+ *  A heap created with DUK_HEAP_OPTION_ARENA serves all sized allocations
+ *  (heap object headers and property allocations, see DUK_ALLOC_SLAB())
+ *  by bumping a pointer in the current chunk.  Sized frees don't release
+ *  anything: the freed area becomes a hole which is never reused.  All
+ *  chunks are released in one go when the heap is destroyed, so heap
+ *  destruction doesn't need to free objects individually.
+ *
+ *  This suits heaps which run a short script and are then destroyed.  A
+ *  long running heap in arena mode grows without bound because garbage
+ *  collected objects only leave holes behind.
+ *
+ *  Allocations which are large compared to the chunk size get a dedicated
+ *  chunk so that they don't waste the rest of the current chunk.
+ */
+
+#include "duk_internal.h"
+
+#if defined(DUK_USE_ARENA_ALLOC)
+
+/* Chunk header size, keeps allocations aligned to DUK_ARENA_ALIGN. */
+#define DUK__ARENA_CHUNK_HDR_SIZE \
+	((sizeof(duk_arena_chunk) + (DUK_ARENA_ALIGN - 1)) & ~((duk_size_t) (DUK_ARENA_ALIGN - 1)))
+
+/* Limits for the chunk size given in heap options. */
+#define DUK__ARENA_MIN_CHUNK_SIZE   4096
+#define DUK__ARENA_MAX_CHUNK_SIZE   (64L * 1024L * 1024L)
+
+DUK_INTERNAL void duk_heap_arena_init(duk_heap *heap, const duk_heap_options *options) {
+	duk_arena *arena;
+	duk_size_t chunk_size;
+
+	DUK_ASSERT(heap != NULL);
+	arena = &heap->arena;
+
+	/* heap structure is zeroed so arena mode is disabled by default */
+	DUK_ASSERT(arena->chunk_size == 0);
+	DUK_ASSERT(arena->chunks == NULL);
+
+	if (options == NULL || !(options->flags & DUK_HEAP_OPTION_ARENA)) {
+		return;
+	}
+
+	chunk_size = DUK_USE_ARENA_CHUNK_SIZE;
+	if (options->arena_chunk_size > 0) {
+		chunk_size = options->arena_chunk_size;
+	}
+	if (chunk_size < DUK__ARENA_MIN_CHUNK_SIZE) {
+		chunk_size = DUK__ARENA_MIN_CHUNK_SIZE;
+	} else if (chunk_size > DUK__ARENA_MAX_CHUNK_SIZE) {
+		chunk_size = DUK__ARENA_MAX_CHUNK_SIZE;
+	}
+	chunk_size = (chunk_size + (DUK_ARENA_ALIGN - 1)) & ~((duk_size_t) (DUK_ARENA_ALIGN - 1));
+
+	arena->chunk_size = chunk_size;
+	arena->curr = NULL;
+	arena->end = NULL;
+
+	DUK_D(DUK_DPRINT("arena mode enabled: chunk_size=%ld", (long) chunk_size));
+}
+
+DUK_INTERNAL void duk_heap_arena_free_all(duk_heap *heap) {
+	duk_arena *arena;
+	duk_arena_chunk *chunk;
+	duk_arena_chunk *next;
+
+	DUK_ASSERT(heap != NULL);
+	arena = &heap->arena;
+
+	DUK_D(DUK_DPRINT("free arena: chunk_count=%ld, chunk_bytes=%ld, alloc_bytes=%ld, hole_bytes=%ld",
+	                 (long) arena->chunk_count, (long) arena->chunk_bytes,
+	                 (long) arena->alloc_bytes, (long) arena->hole_bytes));
+
+	chunk = arena->chunks;
+	while (chunk) {
+		next = chunk->next;
+		DUK_FREE(heap, (void *) chunk);
+		chunk = next;
+	}
+	arena->chunks = NULL;
+	arena->curr = NULL;
+	arena->end = NULL;
+	arena->chunk_count = 0;
+	arena->chunk_bytes = 0;
+}
+
+/* Allocate a chunk with 'size' usable bytes and link it to the chunk list.
+ * May trigger a mark-and-sweep which may in turn allocate from the arena,
+ * so the caller must re-read the arena state afterwards.
+ */
+DUK_LOCAL duk_uint8_t *duk__arena_alloc_chunk(duk_heap *heap, duk_size_t size) {
+	duk_arena *arena;
+	duk_arena_chunk *chunk;
+
+	arena = &heap->arena;
+
+	chunk = (duk_arena_chunk *) DUK_ALLOC(heap, DUK__ARENA_CHUNK_HDR_SIZE + size);
+	if (!chunk) {
+		return NULL;
+	}
+	chunk->size = size;
+	chunk->next = arena->chunks;
+	arena->chunks = chunk;
+	arena->chunk_count++;
+	arena->chunk_bytes += DUK__ARENA_CHUNK_HDR_SIZE + size;
+
+	DUK_DD(DUK_DDPRINT("arena chunk allocated: %p, size=%ld, chunk_count=%ld",
+	                   (void *) chunk, (long) size, (long) arena->chunk_count));
+
+	return (duk_uint8_t *) chunk + DUK__ARENA_CHUNK_HDR_SIZE;
+}
+
+DUK_INTERNAL void *duk_heap_arena_alloc(duk_heap *heap, duk_size_t size) {
+	duk_arena *arena;
+	duk_uint8_t *res;
+
+	DUK_ASSERT(heap != NULL);
+	DUK_ASSERT(DUK_HEAP_ARENA_ENABLED(heap));
+	DUK_ASSERT(size > 0);
+	arena = &heap->arena;
+
+	size = (size + (DUK_ARENA_ALIGN - 1)) & ~((duk_size_t) (DUK_ARENA_ALIGN - 1));
+	if (size == 0) {
+		/* wrapped */
+		return NULL;
+	}
+
+	/* fast path */
+	res = arena->curr;
+	if (res != NULL && (duk_size_t) (arena->end - res) >= size) {
+		arena->curr = res + size;
+		arena->alloc_bytes += size;
+		return (void *) res;
+	}
+
+	if (size > arena->chunk_size / 4) {
+		/* Large allocation: dedicated chunk, the current chunk is
+		 * left as is.
+		 */
+		res = duk__arena_alloc_chunk(heap, size);
+		if (!res) {
+			return NULL;
+		}
+	} else {
+		/* Start a new chunk, the rest of the current one is wasted. */
+		res = duk__arena_alloc_chunk(heap, arena->chunk_size);
+		if (!res) {
+			return NULL;
+		}
+		arena->curr = res + size;
+		arena->end = res + arena->chunk_size;
+	}
+	arena->alloc_bytes += size;
+
+	DUK_ASSERT(((duk_uintptr_t) res & (DUK_ARENA_ALIGN - 1)) == 0);
+	return (void *) res;
+}
+
+DUK_INTERNAL void duk_heap_arena_free(duk_heap *heap, void *ptr, duk_size_t size) {
+	DUK_ASSERT(heap != NULL);
+	DUK_ASSERT(DUK_HEAP_ARENA_ENABLED(heap));
+	DUK_ASSERT(ptr != NULL);
+	DUK_ASSERT(size > 0);
+	DUK_UNREF(ptr);
+
+	/* nothing to release, the memory is reclaimed with the chunks */
+	size = (size + (DUK_ARENA_ALIGN - 1)) & ~((duk_size_t) (DUK_ARENA_ALIGN - 1));
+	heap->arena.hole_bytes += size;
+}
+
+#endif  /* DUK_USE_ARENA_ALLOC */
@@ -75,28 +75,41 @@ DUK_LOCAL void duk__mark_hobject(duk_heap *heap, duk_hobject *h) {
 		duk_hobject **funcs, **funcs_end;
 
 		/* 'data' is reachable through every compiled function which
-		 * contains a reference.
+		 * contains a reference.  It is NULL if allocating it failed
+		 * while the compiler was creating the function.
 		 */
 
-		duk__mark_heaphdr(heap, (duk_heaphdr *) DUK_HCOMPILEDFUNCTION_GET_DATA(f));
+		if (DUK_HCOMPILEDFUNCTION_GET_DATA(f) != NULL) {
+			duk__mark_heaphdr(heap, (duk_heaphdr *) DUK_HCOMPILEDFUNCTION_GET_DATA(f));
 
-		tv = DUK_HCOMPILEDFUNCTION_GET_CONSTS_BASE(f);
-		tv_end = DUK_HCOMPILEDFUNCTION_GET_CONSTS_END(f);
-		while (tv < tv_end) {
-			duk__mark_tval(heap, tv);
-			tv++;
-		}
+			tv = DUK_HCOMPILEDFUNCTION_GET_CONSTS_BASE(f);
+			tv_end = DUK_HCOMPILEDFUNCTION_GET_CONSTS_END(f);
+			while (tv < tv_end) {
+				duk__mark_tval(heap, tv);
+				tv++;
+			}
 
-		funcs = DUK_HCOMPILEDFUNCTION_GET_FUNCS_BASE(f);
-		funcs_end = DUK_HCOMPILEDFUNCTION_GET_FUNCS_END(f);
-		while (funcs < funcs_end) {
-			duk__mark_heaphdr(heap, (duk_heaphdr *) *funcs);
-			funcs++;
+			funcs = DUK_HCOMPILEDFUNCTION_GET_FUNCS_BASE(f);
+			funcs_end = DUK_HCOMPILEDFUNCTION_GET_FUNCS_END(f);
+			while (funcs < funcs_end) {
+				duk__mark_heaphdr(heap, (duk_heaphdr *) *funcs);
+				funcs++;
+			}
 		}
 	} else if (DUK_HOBJECT_IS_NATIVEFUNCTION(h)) {
 		duk_hnativefunction *f = (duk_hnativefunction *) h;
 		DUK_UNREF(f);
 		/* nothing to mark */
+	} else if (DUK_HOBJECT_IS_BUFFEROBJECT(h)) {
+		duk_hbufferobject *b = (duk_hbufferobject *) h;
+		duk__mark_heaphdr(heap, (duk_heaphdr *) b->buf);
+		duk__mark_heaphdr(heap, (duk_heaphdr *) b->buf_prop);
+#if defined(DUK_USE_WEAK_REFERENCES)
+	} else if (DUK_HOBJECT_IS_WEAKOBJECT(h)) {
+		/* nothing to mark: keys are weak and values are marked
+		 * by duk__mark_weak_values() once their key is reachable
+		 */
+#endif
 	} else if (DUK_HOBJECT_IS_THREAD(h)) {
 		duk_hthread *t = (duk_hthread *) h;
 		duk_tval *tv;
@@ -132,7 +145,80 @@ DUK_LOCAL void duk__mark_hobject(duk_heap *heap, duk_hobject *h) {
 	}
 }
 
-/* recursion tracking happens here only */
+/*
+ *  Mark stack
+ *
+ *  Objects marked reachable are pushed on an explicit mark stack, and
+ *  their children are marked when they are popped.  Marking is depth
+ *  first and uses a bounded amount of C stack regardless of the shape
+ *  of the object graph.
+ *
+ *  The stack is allocated with the raw allocation functions so that no
+ *  recursive mark-and-sweep can be triggered.  If the stack can't grow,
+ *  the object is marked as a TEMPROOT and the caller finishes with the
+ *  multi-pass temproot heap scan.  If there is no stack at all, the
+ *  children of the outermost object are marked directly (becoming
+ *  temproots themselves) so that each scan pass makes progress.
+ */
+
+DUK_LOCAL duk_bool_t duk__mark_stack_grow(duk_heap *heap) {
+	duk_heaphdr **new_stack;
+	duk_size_t new_size;
+
+	if (heap->mark_stack_size >= DUK_HEAP_MARK_STACK_MAX_SIZE) {
+		return 0;
+	}
+	if (heap->mark_stack_size == 0) {
+		new_size = DUK_HEAP_MARK_STACK_INITIAL_SIZE;
+	} else {
+		new_size = heap->mark_stack_size * 2;
+	}
+	if (new_size > DUK_HEAP_MARK_STACK_MAX_SIZE) {
+		new_size = DUK_HEAP_MARK_STACK_MAX_SIZE;
+	}
+
+	new_stack = (duk_heaphdr **) heap->realloc_func(heap->alloc_udata, (void *) heap->mark_stack,
+	                                                sizeof(duk_heaphdr *) * new_size);
+	if (!new_stack) {
+		DUK_D(DUK_DPRINT("failed to grow mark stack to %ld entries", (long) new_size));
+		return 0;
+	}
+	DUK_DD(DUK_DDPRINT("mark stack grown to %ld entries", (long) new_size));
+	heap->mark_stack = new_stack;
+	heap->mark_stack_size = new_size;
+	return 1;
+}
+
+DUK_LOCAL void duk__mark_stack_process(duk_heap *heap) {
+	duk_heaphdr *h;
+
+	DUK_ASSERT(heap->mark_and_sweep_recursion_depth == 0);
+	heap->mark_and_sweep_recursion_depth++;
+
+	while (heap->mark_stack_top > 0) {
+		h = heap->mark_stack[--heap->mark_stack_top];
+		DUK_ASSERT(h != NULL);
+		DUK_ASSERT(DUK_HEAPHDR_GET_TYPE(h) == DUK_HTYPE_OBJECT);
+		duk__mark_hobject(heap, (duk_hobject *) h);
+	}
+
+	heap->mark_and_sweep_recursion_depth--;
+}
+
+/* Free a large mark stack after marking so that a single deep structure
+ * doesn't keep the memory reserved.
+ */
+DUK_LOCAL void duk__mark_stack_trim(duk_heap *heap) {
+	DUK_ASSERT(heap->mark_stack_top == 0);
+
+	if (heap->mark_stack_size > DUK_HEAP_MARK_STACK_KEEP_SIZE) {
+		DUK_DD(DUK_DDPRINT("free mark stack of %ld entries", (long) heap->mark_stack_size));
+		heap->free_func(heap->alloc_udata, (void *) heap->mark_stack);
+		heap->mark_stack = NULL;
+		heap->mark_stack_size = 0;
+	}
+}
+
 DUK_LOCAL void duk__mark_heaphdr(duk_heap *heap, duk_heaphdr *h) {
 	DUK_DDD(DUK_DDDPRINT("duk__mark_heaphdr %p, type %ld",
 	                     (void *) h,
@@ -147,32 +233,47 @@ DUK_LOCAL void duk__mark_heaphdr(duk_heap *heap, duk_heaphdr *h) {
 	}
 	DUK_HEAPHDR_SET_REACHABLE(h);
 
-	if (heap->mark_and_sweep_recursion_depth >= DUK_HEAP_MARK_AND_SWEEP_RECURSION_LIMIT) {
-		/* log this with a normal debug level because this should be relatively rare */
-		DUK_D(DUK_DPRINT("mark-and-sweep recursion limit reached, marking as temproot: %p", (void *) h));
-		DUK_HEAP_SET_MARKANDSWEEP_RECLIMIT_REACHED(heap);
-		DUK_HEAPHDR_SET_TEMPROOT(h);
-		return;
-	}
-
-	heap->mark_and_sweep_recursion_depth++;
-
 	switch ((int) DUK_HEAPHDR_GET_TYPE(h)) {
 	case DUK_HTYPE_STRING:
 		duk__mark_hstring(heap, (duk_hstring *) h);
-		break;
+		return;
 	case DUK_HTYPE_OBJECT:
-		duk__mark_hobject(heap, (duk_hobject *) h);
 		break;
 	case DUK_HTYPE_BUFFER:
 		/* nothing to mark */
-		break;
+		return;
 	default:
 		DUK_D(DUK_DPRINT("attempt to mark heaphdr %p with invalid htype %ld", (void *) h, (long) DUK_HEAPHDR_GET_TYPE(h)));
 		DUK_UNREACHABLE();
 	}
 
-	heap->mark_and_sweep_recursion_depth--;
+	if (heap->mark_stack_top >= heap->mark_stack_size && !duk__mark_stack_grow(heap)) {
+		if (heap->mark_and_sweep_recursion_depth == 0) {
+			/* No mark stack at all (allocation failed): mark the
+			 * children directly so that the temproot heap scan
+			 * makes progress.
+			 */
+			DUK_ASSERT(heap->mark_stack_top == 0);
+			heap->mark_and_sweep_recursion_depth++;
+			duk__mark_hobject(heap, (duk_hobject *) h);
+			heap->mark_and_sweep_recursion_depth--;
+			return;
+		}
+
+		/* log this with a normal debug level because this should be relatively rare */
+		DUK_D(DUK_DPRINT("mark stack full, marking as temproot: %p", (void *) h));
+		DUK_HEAP_SET_MARKANDSWEEP_RECLIMIT_REACHED(heap);
+		DUK_HEAPHDR_SET_TEMPROOT(h);
+		return;
+	}
+	heap->mark_stack[heap->mark_stack_top++] = h;
+
+	/* Only the outermost call processes the stack; nested calls made
+	 * while processing just push.
+	 */
+	if (heap->mark_and_sweep_recursion_depth == 0) {
+		duk__mark_stack_process(heap);
+	}
 }
 
 DUK_LOCAL void duk__mark_tval(duk_heap *heap, duk_tval *tv) {
@@ -301,7 +402,7 @@ DUK_LOCAL void duk__mark_finalizable(duk_heap *heap) {
 		hdr = DUK_HEAPHDR_GET_NEXT(hdr);
 	}
 
-	/* Caller will finish the marking process if we hit a recursion limit. */
+	/* Caller will finish the marking process if the mark stack overflowed. */
 }
 
 /*
@@ -335,9 +436,9 @@ DUK_LOCAL void duk__mark_finalize_list(duk_heap *heap) {
 }
 
 /*
- *  Fallback marking handler if recursion limit is reached.
+ *  Fallback marking handler if the mark stack can't grow.
  *
- *  Iterates 'temproots' until recursion limit is no longer hit.  Note
+ *  Iterates 'temproots' until the mark stack no longer overflows.  Note
  *  that temproots may reside either in heap allocated list or the
  *  refzero work list.  This is a slow scan, but guarantees that we
  *  finish with a bounded C stack.
@@ -377,7 +478,7 @@ DUK_LOCAL void duk__mark_temproots_by_heap_scan(duk_heap *heap) {
 	DUK_DD(DUK_DDPRINT("duk__mark_temproots_by_heap_scan: %p", (void *) heap));
 
 	while (DUK_HEAP_HAS_MARKANDSWEEP_RECLIMIT_REACHED(heap)) {
-		DUK_DD(DUK_DDPRINT("recursion limit reached, doing heap scan to continue from temproots"));
+		DUK_DD(DUK_DDPRINT("mark stack overflowed, doing heap scan to continue from temproots"));
 
 #ifdef DUK_USE_DEBUG
 		count = 0;
@@ -413,6 +514,95 @@ DUK_LOCAL void duk__mark_temproots_by_heap_scan(duk_heap *heap) {
 	}
 }
 
+/*
+ *  Weak object values (ephemerons).
+ *
+ *  A value in a reachable weak object is reachable if its key is
+ *  reachable.  Marking a value may make further keys reachable, so the
+ *  caller repeats until nothing new gets marked.
+ */
+
+#if defined(DUK_USE_WEAK_REFERENCES)
+DUK_LOCAL duk_bool_t duk__mark_weak_values(duk_heap *heap) {
+	duk_hweakobject *h;
+	duk_weakentry *e;
+	duk_uint32_t i;
+	duk_bool_t marked = 0;
+
+	for (h = heap->weak_objects; h != NULL; h = h->next) {
+		if (h->used == 0 || !DUK_HEAPHDR_HAS_REACHABLE((duk_heaphdr *) h)) {
+			continue;
+		}
+		for (i = 0; i < h->size; i++) {
+			e = h->entries + i;
+			if (!DUK_HWEAKOBJECT_ENTRY_IS_USED(heap, e) ||
+			    !DUK_HEAPHDR_HAS_REACHABLE((duk_heaphdr *) e->key) ||
+			    !DUK_TVAL_IS_HEAP_ALLOCATED(&e->value) ||
+			    DUK_HEAPHDR_HAS_REACHABLE(DUK_TVAL_GET_HEAPHDR(&e->value))) {
+				continue;
+			}
+			DUK_DDD(DUK_DDDPRINT("weak object %p: key %p reachable, mark value",
+			                     (void *) h, (void *) e->key));
+			duk__mark_tval(heap, &e->value);
+			marked = 1;
+		}
+	}
+
+	return marked;
+}
+
+DUK_LOCAL void duk__mark_weak_objects(duk_heap *heap) {
+	DUK_DD(DUK_DDPRINT("duk__mark_weak_objects: %p", (void *) heap));
+
+	while (duk__mark_weak_values(heap)) {
+		duk__mark_temproots_by_heap_scan(heap);
+	}
+}
+
+/* Remove entries whose key is about to be swept, and release the entries
+ * of unreachable weak objects.  Must happen before any object is freed
+ * so that no weak object is left with a dangling key.  Decrefs have no
+ * side effects while mark-and-sweep is running.
+ */
+DUK_LOCAL void duk__sweep_weak_objects(duk_heap *heap) {
+	duk_hthread *thr;
+	duk_hweakobject *h;
+	duk_weakentry *e;
+	duk_uint32_t i;
+	duk_bool_t owner_reachable;
+
+	thr = duk__get_temp_hthread(heap);
+	DUK_ASSERT(thr != NULL);
+
+	DUK_DD(DUK_DDPRINT("duk__sweep_weak_objects: %p", (void *) heap));
+
+	for (h = heap->weak_objects; h != NULL; h = h->next) {
+		owner_reachable = DUK_HEAPHDR_HAS_REACHABLE((duk_heaphdr *) h);
+		for (i = 0; i < h->size; i++) {
+			e = h->entries + i;
+			if (!DUK_HWEAKOBJECT_ENTRY_IS_USED(heap, e) ||
+			    DUK_HEAPHDR_HAS_REACHABLE((duk_heaphdr *) e->key)) {
+				continue;
+			}
+			/* Refcount finalization of the key must not scan
+			 * the weak objects again.
+			 */
+			DUK_HOBJECT_CLEAR_WEAKKEY(e->key);
+			if (owner_reachable) {
+				DUK_DDD(DUK_DDDPRINT("weak object %p: key %p unreachable, remove entry",
+				                     (void *) h, (void *) e->key));
+				duk_hweakobject_delete_entry(thr, h, e);
+			}
+		}
+		if (owner_reachable) {
+			duk_hweakobject_release_if_empty(heap, h);
+		} else {
+			duk_hweakobject_clear(thr, h);
+		}
+	}
+}
+#endif  /* DUK_USE_WEAK_REFERENCES */
+
 /*
  *  Finalize refcounts for heap elements just about to be freed.
  *  This must be done for all objects before freeing to avoid any
@@ -506,13 +696,12 @@ DUK_LOCAL void duk__clear_finalize_list_flags(duk_heap *heap) {
  *  Sweep stringtable
  */
 
-DUK_LOCAL void duk__sweep_stringtable(duk_heap *heap, duk_size_t *out_count_keep) {
+DUK_LOCAL void duk__sweep_stringtable(duk_heap *heap, duk_size_t *out_count_keep, duk_size_t *out_count_free, duk_size_t *out_bytes_free) {
 	duk_hstring *h;
 	duk_uint_fast32_t i;
-#ifdef DUK_USE_DEBUG
 	duk_size_t count_free = 0;
-#endif
 	duk_size_t count_keep = 0;
+	duk_size_t bytes_free = 0;
 
 	DUK_DD(DUK_DDPRINT("duk__sweep_stringtable: %p", (void *) heap));
 
@@ -530,9 +719,10 @@ DUK_LOCAL void duk__sweep_stringtable(duk_heap *heap, duk_size_t *out_count_keep
 			continue;
 		}
 
-#ifdef DUK_USE_DEBUG
 		count_free++;
-#endif
+		if (heap->gc_hook) {
+			bytes_free += duk_heap_get_heaphdr_total_size((duk_heaphdr *) h);
+		}
 
 #if defined(DUK_USE_REFERENCE_COUNTING)
 		/* Non-zero refcounts should not happen for unreachable strings,
@@ -559,38 +749,41 @@ DUK_LOCAL void duk__sweep_stringtable(duk_heap *heap, duk_size_t *out_count_keep
 #endif
 
 		/* then free */
-#if 1
-		DUK_FREE(heap, (duk_heaphdr *) h);  /* no inner refs/allocs, just free directly */
+#if defined(DUK_USE_HSTRING_EXTDATA) || defined(DUK_USE_SIZED_ALLOC)
+		duk_heap_free_heaphdr_raw(heap, (duk_heaphdr *) h);  /* external data release, slab alloc size */
 #else
-		duk_heap_free_heaphdr_raw(heap, (duk_heaphdr *) h);  /* this would be OK but unnecessary */
+		DUK_FREE(heap, (duk_heaphdr *) h);  /* no inner refs/allocs, just free directly */
 #endif
 	}
 
-#ifdef DUK_USE_DEBUG
 	DUK_D(DUK_DPRINT("mark-and-sweep sweep stringtable: %ld freed, %ld kept",
 	                 (long) count_free, (long) count_keep));
-#endif
 	*out_count_keep = count_keep;
+	*out_count_free = count_free;
+	*out_bytes_free = bytes_free;
 }
 
 /*
  *  Sweep heap
  */
 
-DUK_LOCAL void duk__sweep_heap(duk_heap *heap, duk_int_t flags, duk_size_t *out_count_keep) {
+DUK_LOCAL void duk__sweep_heap(duk_heap *heap, duk_int_t flags, duk_size_t *out_count_keep, duk_size_t *out_count_free, duk_size_t *out_bytes_free, duk_size_t *out_count_finalize) {
 	duk_heaphdr *prev;  /* last element that was left in the heap */
 	duk_heaphdr *curr;
 	duk_heaphdr *next;
-#ifdef DUK_USE_DEBUG
 	duk_size_t count_free = 0;
 	duk_size_t count_finalize = 0;
+#ifdef DUK_USE_DEBUG
 	duk_size_t count_rescue = 0;
 #endif
 	duk_size_t count_keep = 0;
+	duk_size_t bytes_free = 0;
+	duk_bool_t defer_free;
 
-	DUK_UNREF(flags);
 	DUK_DD(DUK_DDPRINT("duk__sweep_heap: %p", (void *) heap));
 
+	defer_free = (heap->gc_policy.sweep_step > 0 && !(flags & DUK_MS_FLAG_EMERGENCY));
+
 	prev = NULL;
 	curr = heap->heap_allocated;
 	heap->heap_allocated = NULL;
@@ -627,9 +820,7 @@ DUK_LOCAL void duk__sweep_heap(duk_heap *heap, duk_int_t flags, duk_size_t *out_
 #endif
 				DUK_HEAPHDR_SET_NEXT(curr, heap->finalize_list);
 				heap->finalize_list = curr;
-#ifdef DUK_USE_DEBUG
 				count_finalize++;
-#endif
 			} else {
 				/*
 				 *  Object will be kept; queue object back to heap_allocated (to tail)
@@ -700,16 +891,23 @@ DUK_LOCAL void duk__sweep_heap(duk_heap *heap, duk_int_t flags, duk_size_t *out_
 			 * and are handled above.
 			 */
 
-#ifdef DUK_USE_DEBUG
 			count_free++;
-#endif
+			if (heap->gc_hook) {
+				bytes_free += duk_heap_get_heaphdr_total_size(curr);
+			}
 
-			/* weak refs should be handled here, but no weak refs for
-			 * any non-string objects exist right now.
+			/* weak object entries referring to this object have
+			 * been removed by duk__sweep_weak_objects()
 			 */
 
-			/* free object and all auxiliary (non-heap) allocs */
-			duk_heap_free_heaphdr_raw(heap, curr);
+			if (defer_free) {
+				/* nothing refers to the object anymore, free later */
+				DUK_HEAPHDR_SET_NEXT(curr, heap->sweep_free_list);
+				heap->sweep_free_list = curr;
+			} else {
+				/* free object and all auxiliary (non-heap) allocs */
+				duk_heap_free_heaphdr_raw(heap, curr);
+			}
 
 			curr = next;
 		}
@@ -723,6 +921,33 @@ DUK_LOCAL void duk__sweep_heap(duk_heap *heap, duk_int_t flags, duk_size_t *out_
 	                 (long) count_free, (long) count_keep, (long) count_rescue, (long) count_finalize));
 #endif
 	*out_count_keep = count_keep;
+	*out_count_free = count_free;
+	*out_bytes_free = bytes_free;
+	*out_count_finalize = count_finalize;
+}
+
+/*
+ *  Free unreachable objects left on the sweep free list by a round with
+ *  deferred freeing, at most 'budget' objects (all if zero).  Returns the
+ *  number of objects freed.  Never causes a mark-and-sweep.
+ */
+
+DUK_INTERNAL duk_size_t duk_heap_free_deferred(duk_heap *heap, duk_size_t budget) {
+	duk_heaphdr *curr;
+	duk_size_t count = 0;
+
+	while ((curr = heap->sweep_free_list) != NULL) {
+		if (budget > 0 && count >= budget) {
+			break;
+		}
+		heap->sweep_free_list = DUK_HEAPHDR_GET_NEXT(curr);
+		duk_heap_free_heaphdr_raw(heap, curr);
+		count++;
+	}
+
+	DUK_DDD(DUK_DDDPRINT("freed %ld deferred objects, more left: %ld",
+	                     (long) count, (long) (heap->sweep_free_list != NULL)));
+	return count;
 }
 
 /*
@@ -816,9 +1041,7 @@ DUK_LOCAL void duk__compact_object_list(duk_heap *heap, duk_hthread *thr, duk_he
 		obj = (duk_hobject *) curr;
 
 #ifdef DUK_USE_DEBUG
-		old_size = DUK_HOBJECT_P_COMPUTE_SIZE(DUK_HOBJECT_GET_ESIZE(obj),
-		                                      DUK_HOBJECT_GET_ASIZE(obj),
-		                                      DUK_HOBJECT_GET_HSIZE(obj));
+		old_size = DUK_HOBJECT_E_ALLOC_SIZE(obj);
 #endif
 
 		DUK_DD(DUK_DDPRINT("compact object: %p", (void *) obj));
@@ -827,9 +1050,7 @@ DUK_LOCAL void duk__compact_object_list(duk_heap *heap, duk_hthread *thr, duk_he
 		duk_safe_call((duk_context *) thr, duk__protected_compact_object, 1, 0);
 
 #ifdef DUK_USE_DEBUG
-		new_size = DUK_HOBJECT_P_COMPUTE_SIZE(DUK_HOBJECT_GET_ESIZE(obj),
-		                                      DUK_HOBJECT_GET_ASIZE(obj),
-		                                      DUK_HOBJECT_GET_HSIZE(obj));
+		new_size = DUK_HOBJECT_E_ALLOC_SIZE(obj);
 #endif
 
 #ifdef DUK_USE_DEBUG
@@ -879,6 +1100,42 @@ DUK_LOCAL void duk__compact_objects(duk_heap *heap) {
 #endif
 }
 
+/* Compact at most 'budget' objects of heap_allocated, continuing from
+ * where the previous budgeted round stopped.  The position is an index
+ * into the list, so it is only approximate if objects have been allocated
+ * or freed in between, which is fine for compaction.
+ */
+DUK_LOCAL void duk__compact_objects_budget(duk_heap *heap, duk_size_t budget) {
+	duk_hthread *thr;
+	duk_heaphdr *curr;
+	duk_size_t idx = 0;
+	duk_size_t count = 0;
+
+	DUK_DD(DUK_DDPRINT("duk__compact_objects_budget: %p, budget %ld, start %ld",
+	                   (void *) heap, (long) budget, (long) heap->mark_and_sweep_compact_index));
+
+	thr = duk__get_temp_hthread(heap);
+	DUK_ASSERT(thr != NULL);
+
+	curr = heap->heap_allocated;
+	while (curr && idx < heap->mark_and_sweep_compact_index) {
+		curr = DUK_HEAPHDR_GET_NEXT(curr);
+		idx++;
+	}
+
+	while (curr && count < budget) {
+		if (DUK_HEAPHDR_GET_TYPE(curr) == DUK_HTYPE_OBJECT) {
+			duk_push_hobject((duk_context *) thr, (duk_hobject *) curr);
+			duk_safe_call((duk_context *) thr, duk__protected_compact_object, 1, 0);
+			count++;
+		}
+		curr = DUK_HEAPHDR_GET_NEXT(curr);
+		idx++;
+	}
+
+	heap->mark_and_sweep_compact_index = (curr != NULL ? idx : 0);  /* wrap around at end */
+}
+
 /*
  *  Assertion helpers.
  */
@@ -940,6 +1197,71 @@ DUK_LOCAL void duk__assert_valid_refcounts(duk_heap *heap) {
 #endif  /* DUK_USE_REFERENCE_COUNTING */
 #endif  /* DUK_USE_ASSERTIONS */
 
+/*
+ *  Trigger policy.
+ */
+
+DUK_INTERNAL void duk_heap_gc_policy_init(duk_heap *heap) {
+	DUK_MEMZERO((void *) &heap->gc_policy, sizeof(heap->gc_policy));
+	heap->gc_policy.trigger_mult = DUK_HEAP_MARK_AND_SWEEP_TRIGGER_MULT;
+	heap->gc_policy.trigger_add = DUK_HEAP_MARK_AND_SWEEP_TRIGGER_ADD;
+	heap->gc_policy.idle_threshold = 0.5;
+	heap->mark_and_sweep_end_time = 0.0;
+#ifdef DUK_USE_VOLUNTARY_GC
+	/* counter == 0 causes an immediate GC attempt, which is OK */
+	heap->mark_and_sweep_trigger_limit = 0;
+	heap->mark_and_sweep_bytes = 0;
+	heap->mark_and_sweep_bytes_trigger = DUK_SIZE_MAX;
+#endif
+}
+
+#ifdef DUK_USE_VOLUNTARY_GC
+/* Check the minimum interval of the trigger policy.  A postponed round
+ * is retried after a few more operations, or after a sixteenth of the
+ * byte trigger, to avoid checking the time on every allocation.
+ */
+DUK_INTERNAL duk_bool_t duk_heap_mark_and_sweep_postpone(duk_heap *heap) {
+	duk_double_t now;
+
+	if (heap->gc_policy.min_interval <= 0.0 || heap->heap_thread == NULL) {
+		return 0;
+	}
+	now = duk_bi_date_get_timestamp((duk_context *) heap->heap_thread);
+	if (now - heap->mark_and_sweep_end_time >= heap->gc_policy.min_interval ||
+	    now < heap->mark_and_sweep_end_time) {
+		/* also if the wall clock went backwards */
+		return 0;
+	}
+
+	heap->mark_and_sweep_trigger_counter = DUK_HEAP_MARK_AND_SWEEP_TRIGGER_SKIP;
+	if (heap->mark_and_sweep_bytes_trigger != DUK_SIZE_MAX) {
+		heap->mark_and_sweep_bytes_trigger = heap->mark_and_sweep_bytes + heap->gc_policy.trigger_bytes / 16;
+	}
+	return 1;
+}
+
+/* Reset the voluntary trigger after a round based on the live object and
+ * string count.  Computed with doubles so that a large multiplier can't
+ * overflow.
+ */
+DUK_LOCAL void duk__reset_trigger(duk_heap *heap, duk_size_t count_keep) {
+	duk_double_t trigger;
+
+	trigger = (duk_double_t) (count_keep / 256) * (duk_double_t) heap->gc_policy.trigger_mult +
+	          (duk_double_t) heap->gc_policy.trigger_add;
+	if (trigger > (duk_double_t) DUK_INT_MAX) {
+		trigger = (duk_double_t) DUK_INT_MAX;
+	} else if (trigger < 1.0) {
+		trigger = 1.0;
+	}
+	heap->mark_and_sweep_trigger_counter = (duk_int_t) trigger;
+	heap->mark_and_sweep_trigger_limit = heap->mark_and_sweep_trigger_counter;
+	heap->mark_and_sweep_bytes = 0;
+	heap->mark_and_sweep_bytes_trigger = (heap->gc_policy.trigger_bytes > 0 ?
+	                                      heap->gc_policy.trigger_bytes : DUK_SIZE_MAX);
+}
+#endif  /* DUK_USE_VOLUNTARY_GC */
+
 /*
  *  Main mark-and-sweep function.
  *
@@ -950,9 +1272,16 @@ DUK_LOCAL void duk__assert_valid_refcounts(duk_heap *heap) {
  */
 
 DUK_INTERNAL duk_bool_t duk_heap_mark_and_sweep(duk_heap *heap, duk_small_uint_t flags) {
+	duk_context *ctx;
+	duk_gc_event ev;
 	duk_size_t count_keep_obj;
 	duk_size_t count_keep_str;
 	duk_size_t tmp;
+	duk_double_t time_start;
+	duk_double_t time_used;
+	duk_double_t t0, t1;
+	duk_uint32_t st_size_before;
+	duk_bool_t prev_handling_error;
 
 	/* XXX: thread selection for mark-and-sweep is currently a hack.
 	 * If we don't have a thread, the entire mark-and-sweep is now
@@ -973,6 +1302,51 @@ DUK_INTERNAL duk_bool_t duk_heap_mark_and_sweep(duk_heap *heap, duk_small_uint_t
 
 	flags |= heap->mark_and_sweep_base_flags;
 
+	/* Errors thrown and caught by compaction and finalizers clear
+	 * heap->handling_error.  Restore it at the end so that an error
+	 * being created when this GC was triggered (e.g. its allocation
+	 * hit a memory limit) still detects a double error.
+	 */
+	prev_handling_error = heap->handling_error;
+
+#if defined(DUK_USE_ARENA_ALLOC)
+	/* In arena mode compacted property allocations would only leave
+	 * holes behind, so compaction can't free any memory.
+	 */
+	if (DUK_HEAP_ARENA_ENABLED(heap)) {
+		flags |= DUK_MS_FLAG_NO_OBJECT_COMPACTION;
+	}
+#endif
+
+	if (heap->gc_policy.flags & DUK_GC_POLICY_NO_OBJECT_COMPACTION) {
+		flags |= DUK_MS_FLAG_NO_OBJECT_COMPACTION;
+	}
+	if (heap->gc_policy.flags & DUK_GC_POLICY_NO_STRINGTABLE_RESIZE) {
+		flags |= DUK_MS_FLAG_NO_STRINGTABLE_RESIZE;
+	}
+
+	DUK_MEMZERO((void *) &ev, sizeof(ev));
+	ev.reason = (duk_uint_t) ((flags & DUK_MS_REASON_MASK) >> DUK_MS_REASON_SHIFT);
+	ev.flags = (duk_uint_t) (flags & ~DUK_MS_REASON_MASK);
+	ev.count = heap->mark_and_sweep_count + 1;
+	if (heap->gc_hook) {
+		/* The hook must not call into Duktape, so no state needs to
+		 * be protected here.
+		 */
+		ev.event = DUK_GC_EVENT_START;
+		heap->gc_hook(heap->gc_hook_udata, &ev);
+	}
+
+	ctx = (duk_context *) duk__get_temp_hthread(heap);
+	time_start = duk_bi_date_get_timestamp(ctx);
+
+	/*
+	 *  Free objects left over by the previous round if it deferred
+	 *  freeing (see gc_policy.sweep_step).
+	 */
+
+	(void) duk_heap_free_deferred(heap, 0);
+
 	/*
 	 *  Assertions before
 	 */
@@ -997,8 +1371,8 @@ DUK_INTERNAL duk_bool_t duk_heap_mark_and_sweep(duk_heap *heap, duk_small_uint_t
 	DUK_HEAP_SET_MARKANDSWEEP_RUNNING(heap);
 
 	/*
-	 *  Mark roots, hoping that recursion limit is not normally hit.
-	 *  If recursion limit is hit, run additional reachability rounds
+	 *  Mark roots, hoping that the mark stack doesn't normally overflow.
+	 *  If it does, run additional reachability rounds
 	 *  starting from "temproots" until marking is complete.
 	 *
 	 *  Marking happens in two phases: first we mark actual reachability
@@ -1017,10 +1391,21 @@ DUK_INTERNAL duk_bool_t duk_heap_mark_and_sweep(duk_heap *heap, duk_small_uint_t
 	duk__mark_refzero_list(heap);             /* refzero_list treated as reachability roots */
 #endif
 	duk__mark_temproots_by_heap_scan(heap);   /* temproots */
+#if defined(DUK_USE_WEAK_REFERENCES)
+	duk__mark_weak_objects(heap);             /* values of reachable weak keys */
+#endif
+	t0 = duk_bi_date_get_timestamp(ctx);
+	ev.time_mark = t0 - time_start;
 
 	duk__mark_finalizable(heap);              /* mark finalizable as reachability roots */
 	duk__mark_finalize_list(heap);            /* mark finalizer work list as reachability roots */
 	duk__mark_temproots_by_heap_scan(heap);   /* temproots */
+#if defined(DUK_USE_WEAK_REFERENCES)
+	duk__mark_weak_objects(heap);             /* values of keys reachable from finalizable objects */
+#endif
+	duk__mark_stack_trim(heap);
+	t1 = duk_bi_date_get_timestamp(ctx);
+	ev.time_mark_finalizable = t1 - t0;
 
 	/*
 	 *  Sweep garbage and remove marking flags, and move objects with
@@ -1038,18 +1423,29 @@ DUK_INTERNAL duk_bool_t duk_heap_mark_and_sweep(duk_heap *heap, duk_small_uint_t
 
 	/* XXX: more emergency behavior, e.g. find smaller hash sizes etc */
 
+#if defined(DUK_USE_WEAK_REFERENCES)
+	duk__sweep_weak_objects(heap);
+#endif
 #ifdef DUK_USE_REFERENCE_COUNTING
 	duk__finalize_refcounts(heap);
 #endif
-	duk__sweep_heap(heap, flags, &count_keep_obj);
-	duk__sweep_stringtable(heap, &count_keep_str);
+	duk__sweep_heap(heap, flags, &count_keep_obj, &ev.objects_freed, &ev.bytes_freed, &ev.objects_finalizable);
+	t0 = duk_bi_date_get_timestamp(ctx);
+	ev.time_sweep = t0 - t1;
+	duk__sweep_stringtable(heap, &count_keep_str, &ev.strings_freed, &tmp);
+	ev.bytes_freed += tmp;
 #ifdef DUK_USE_REFERENCE_COUNTING
 	duk__clear_refzero_list_flags(heap);
 #endif
 	duk__clear_finalize_list_flags(heap);
+	t1 = duk_bi_date_get_timestamp(ctx);
+	ev.time_sweep_strings = t1 - t0;
+	ev.objects_kept = count_keep_obj;
+	ev.strings_kept = count_keep_str;
 
 	/*
-	 *  Object compaction (emergency only).
+	 *  Object compaction (emergency only, unless the trigger policy asks
+ *  for it in every round).
 	 *
 	 *  Object compaction is a separate step after sweeping, as there is
 	 *  more free memory for it to work with.  Also, currently compaction
@@ -1065,10 +1461,17 @@ DUK_INTERNAL duk_bool_t duk_heap_mark_and_sweep(duk_heap *heap, duk_small_uint_t
 	 *  cause an infinite loop (they are not compacted).
 	 */
 
-	if ((flags & DUK_MS_FLAG_EMERGENCY) &&
+	if (((flags & DUK_MS_FLAG_EMERGENCY) ||
+	     (heap->gc_policy.flags & DUK_GC_POLICY_ALWAYS_COMPACT)) &&
 	    !(flags & DUK_MS_FLAG_NO_OBJECT_COMPACTION)) {
-		duk__compact_objects(heap);
+		if (heap->gc_policy.compact_step > 0 && !(flags & DUK_MS_FLAG_EMERGENCY)) {
+			duk__compact_objects_budget(heap, heap->gc_policy.compact_step);
+		} else {
+			duk__compact_objects(heap);
+		}
 	}
+	t0 = duk_bi_date_get_timestamp(ctx);
+	ev.time_compaction = t0 - t1;
 
 	/*
 	 *  String table resize check.
@@ -1081,6 +1484,7 @@ DUK_INTERNAL duk_bool_t duk_heap_mark_and_sweep(duk_heap *heap, duk_small_uint_t
 
 	/* XXX: stringtable emergency compaction? */
 
+	st_size_before = heap->st_size;
 #if defined(DUK_USE_MS_STRINGTABLE_RESIZE)
 	if (!(flags & DUK_MS_FLAG_NO_STRINGTABLE_RESIZE)) {
 		DUK_DD(DUK_DDPRINT("resize stringtable: %p", (void *) heap));
@@ -1089,6 +1493,10 @@ DUK_INTERNAL duk_bool_t duk_heap_mark_and_sweep(duk_heap *heap, duk_small_uint_t
 		DUK_D(DUK_DPRINT("stringtable resize skipped because DUK_MS_FLAG_NO_STRINGTABLE_RESIZE is set"));
 	}
 #endif
+	ev.stringtable_resized = (heap->st_size != st_size_before);
+	ev.stringtable_size = (duk_size_t) heap->st_size;
+	t1 = duk_bi_date_get_timestamp(ctx);
+	ev.time_stringtable_resize = t1 - t0;
 
 	/*
 	 *  Finalize objects in the finalization work list.  Finalized
@@ -1129,6 +1537,25 @@ DUK_INTERNAL duk_bool_t duk_heap_mark_and_sweep(duk_heap *heap, duk_small_uint_t
 
 	DUK_HEAP_CLEAR_MARKANDSWEEP_RUNNING(heap);
 
+	t0 = duk_bi_date_get_timestamp(ctx);
+	ev.time_finalizers = t0 - t1;
+	time_used = t0 - time_start;
+	if (time_used < 0.0) {
+		/* wall clock went backwards */
+		time_used = 0.0;
+	}
+	ev.time_total = time_used;
+	heap->mark_and_sweep_count++;
+	if (flags & DUK_MS_FLAG_EMERGENCY) {
+		heap->mark_and_sweep_emergency_count++;
+	}
+	heap->mark_and_sweep_time_total += time_used;
+	heap->mark_and_sweep_time_last = time_used;
+	heap->mark_and_sweep_end_time = t0;
+	if (time_used > heap->mark_and_sweep_time_max) {
+		heap->mark_and_sweep_time_max = time_used;
+	}
+
 	/*
 	 *  Assertions after
 	 */
@@ -1151,16 +1578,23 @@ DUK_INTERNAL duk_bool_t duk_heap_mark_and_sweep(duk_heap *heap, duk_small_uint_t
 	 */
 
 #ifdef DUK_USE_VOLUNTARY_GC
-	tmp = (count_keep_obj + count_keep_str) / 256;
-	heap->mark_and_sweep_trigger_counter = (duk_int_t) (
-	    (tmp * DUK_HEAP_MARK_AND_SWEEP_TRIGGER_MULT) +
-	    DUK_HEAP_MARK_AND_SWEEP_TRIGGER_ADD);
+	duk__reset_trigger(heap, count_keep_obj + count_keep_str);
 	DUK_D(DUK_DPRINT("garbage collect (mark-and-sweep) finished: %ld objects kept, %ld strings kept, trigger reset to %ld",
 	                 (long) count_keep_obj, (long) count_keep_str, (long) heap->mark_and_sweep_trigger_counter));
 #else
 	DUK_D(DUK_DPRINT("garbage collect (mark-and-sweep) finished: %ld objects kept, %ld strings kept, no voluntary trigger",
 	                 (long) count_keep_obj, (long) count_keep_str));
 #endif
+
+	duk_heap_mem_limit_update_trigger(heap);
+
+	if (heap->gc_hook) {
+		ev.event = DUK_GC_EVENT_END;
+		heap->gc_hook(heap->gc_hook_udata, &ev);
+	}
+
+	heap->handling_error = prev_handling_error;
+
 	return 0;  /* OK */
 }
 
@@ -12,10 +12,25 @@
  *  inlined in size optimized builds).
  */
 
+#if defined(DUK_USE_MARK_AND_SWEEP)
+/* Free a few objects left on the sweep free list by a round with deferred
+ * freeing.
+ */
+#define DUK__DEFERRED_FREE_STEP(heap)  do { \
+		if ((heap)->sweep_free_list != NULL) { \
+			(void) duk_heap_free_deferred((heap), (heap)->gc_policy.sweep_step); \
+		} \
+	} while (0)
+#else
+#define DUK__DEFERRED_FREE_STEP(heap)  /* no deferred freeing */
+#endif
+
 #if defined(DUK_USE_MARK_AND_SWEEP) && defined(DUK_USE_VOLUNTARY_GC)
-#define DUK__VOLUNTARY_PERIODIC_GC(heap)  do { \
+#define DUK__VOLUNTARY_PERIODIC_GC(heap,size)  do { \
 		(heap)->mark_and_sweep_trigger_counter--; \
-		if ((heap)->mark_and_sweep_trigger_counter <= 0) { \
+		(heap)->mark_and_sweep_bytes += (size); \
+		if ((heap)->mark_and_sweep_trigger_counter <= 0 || \
+		    (heap)->mark_and_sweep_bytes > (heap)->mark_and_sweep_bytes_trigger) { \
 			duk__run_voluntary_gc(heap); \
 		} \
 	} while (0)
@@ -23,20 +38,216 @@
 DUK_LOCAL void duk__run_voluntary_gc(duk_heap *heap) {
 	if (DUK_HEAP_HAS_MARKANDSWEEP_RUNNING(heap)) {
 		DUK_DD(DUK_DDPRINT("mark-and-sweep in progress -> skip voluntary mark-and-sweep now"));
+	} else if (duk_heap_mark_and_sweep_postpone(heap)) {
+		DUK_DD(DUK_DDPRINT("minimum interval not reached -> postpone voluntary mark-and-sweep"));
 	} else {
 		duk_small_uint_t flags;
 		duk_bool_t rc;
 
 		DUK_D(DUK_DPRINT("triggering voluntary mark-and-sweep"));
-		flags = 0;
+		flags = DUK_MS_REASON(DUK_GC_REASON_VOLUNTARY);
 		rc = duk_heap_mark_and_sweep(heap, flags);
 		DUK_UNREF(rc);
 	}
 }
 #else
-#define DUK__VOLUNTARY_PERIODIC_GC(heap)  /* no voluntary gc */
+#define DUK__VOLUNTARY_PERIODIC_GC(heap,size)  /* no voluntary gc */
 #endif  /* DUK_USE_MARK_AND_SWEEP && DUK_USE_VOLUNTARY_GC */
 
+#if defined(DUK_USE_MARK_AND_SWEEP)
+/* Written so that it cannot wrap; without limits mem_used is zero and
+ * the trigger is DUK_SIZE_MAX so this is never true.
+ */
+#define DUK__SOFT_LIMIT_GC(heap,size)  do { \
+		if (DUK_UNLIKELY((size) > (heap)->mem_soft_trigger || \
+		                 (heap)->mem_used > (heap)->mem_soft_trigger - (size))) { \
+			duk__run_soft_limit_gc((heap)); \
+		} \
+	} while (0)
+
+DUK_LOCAL void duk__run_soft_limit_gc(duk_heap *heap) {
+	if (DUK_HEAP_HAS_MARKANDSWEEP_RUNNING(heap)) {
+		DUK_DD(DUK_DDPRINT("mark-and-sweep in progress -> skip soft memory limit mark-and-sweep now"));
+	} else {
+		duk_bool_t rc;
+
+		DUK_D(DUK_DPRINT("soft memory limit reached (used %ld, limit %ld), triggering emergency mark-and-sweep",
+		                 (long) heap->mem_used, (long) heap->mem_limit_soft));
+		rc = duk_heap_mark_and_sweep(heap, DUK_MS_FLAG_EMERGENCY | DUK_MS_REASON(DUK_GC_REASON_SOFT_LIMIT));
+		DUK_UNREF(rc);
+	}
+}
+#endif  /* DUK_USE_MARK_AND_SWEEP */
+
+/*
+ *  Memory limits
+ *
+ *  A heap created with memory limits gets accounting wrappers in place of
+ *  the user allocation functions.  Each allocation is prefixed with a
+ *  header holding its size so that realloc and free can keep a running
+ *  byte count.  The count covers the requested sizes, not the headers.
+ *  Because the wrappers replace the heap allocation functions, raw
+ *  allocations and duk_get_memory_functions() use them too.
+ *
+ *  The hard limit is enforced by the wrappers: an allocation which would
+ *  exceed it fails and DUK_HEAP_FLAG_MEM_LIMIT_REACHED is set, so that
+ *  the resulting alloc error is thrown as a RangeError.  The soft limit
+ *  is checked by the allocation calls which are allowed to run a GC.  If
+ *  usage is still above the soft limit after a GC, the next soft limit
+ *  GC happens once usage has grown by a quarter of the soft limit.
+ *  Soft limit GCs are only enabled once heap init is complete; until
+ *  then the trigger stays at DUK_SIZE_MAX.
+ */
+
+typedef union {
+	duk_size_t size;
+	duk_double_t d;  /* for alignment */
+	void *p;
+} duk__mem_limit_hdr;
+
+DUK_LOCAL void duk__mem_limit_add(duk_heap *heap, duk_size_t size) {
+	heap->mem_used += size;
+	if (heap->mem_used > heap->mem_peak) {
+		heap->mem_peak = heap->mem_used;
+	}
+	DUK_HEAP_CLEAR_MEM_LIMIT_REACHED(heap);
+}
+
+DUK_LOCAL duk_bool_t duk__mem_limit_exceeded(duk_heap *heap, duk_size_t growth, duk_size_t size) {
+	if (growth > heap->mem_limit_hard - heap->mem_used ||
+	    size > DUK_SIZE_MAX - sizeof(duk__mem_limit_hdr)) {
+		DUK_D(DUK_DPRINT("hard memory limit reached (used %ld, growth %ld, limit %ld)",
+		                 (long) heap->mem_used, (long) growth, (long) heap->mem_limit_hard));
+		DUK_HEAP_SET_MEM_LIMIT_REACHED(heap);
+		return 1;
+	}
+	return 0;
+}
+
+DUK_LOCAL void *duk__mem_limit_alloc(void *udata, duk_size_t size) {
+	duk_heap *heap = (duk_heap *) udata;
+	duk__mem_limit_hdr *hdr;
+
+	if (size == 0) {
+		/* NULL is allowed for zero size allocations */
+		return NULL;
+	}
+	if (duk__mem_limit_exceeded(heap, size, size)) {
+		return NULL;
+	}
+	hdr = (duk__mem_limit_hdr *) heap->mem_alloc_func(heap->mem_udata, size + sizeof(duk__mem_limit_hdr));
+	if (!hdr) {
+		DUK_HEAP_CLEAR_MEM_LIMIT_REACHED(heap);
+		return NULL;
+	}
+	hdr->size = size;
+	duk__mem_limit_add(heap, size);
+	return (void *) (hdr + 1);
+}
+
+DUK_LOCAL void duk__mem_limit_free(void *udata, void *ptr) {
+	duk_heap *heap = (duk_heap *) udata;
+	duk__mem_limit_hdr *hdr;
+
+	if (!ptr) {
+		return;
+	}
+	hdr = ((duk__mem_limit_hdr *) ptr) - 1;
+	DUK_ASSERT(heap->mem_used >= hdr->size);
+	heap->mem_used -= hdr->size;
+	heap->mem_free_func(heap->mem_udata, (void *) hdr);
+}
+
+DUK_LOCAL void *duk__mem_limit_realloc(void *udata, void *ptr, duk_size_t newsize) {
+	duk_heap *heap = (duk_heap *) udata;
+	duk__mem_limit_hdr *hdr;
+	duk_size_t oldsize;
+
+	if (!ptr) {
+		return duk__mem_limit_alloc(udata, newsize);
+	}
+	if (newsize == 0) {
+		duk__mem_limit_free(udata, ptr);
+		return NULL;
+	}
+
+	hdr = ((duk__mem_limit_hdr *) ptr) - 1;
+	oldsize = hdr->size;
+	if (newsize > oldsize && duk__mem_limit_exceeded(heap, newsize - oldsize, newsize)) {
+		return NULL;
+	}
+	hdr = (duk__mem_limit_hdr *) heap->mem_realloc_func(heap->mem_udata, (void *) hdr, newsize + sizeof(duk__mem_limit_hdr));
+	if (!hdr) {
+		/* original allocation is untouched */
+		DUK_HEAP_CLEAR_MEM_LIMIT_REACHED(heap);
+		return NULL;
+	}
+	hdr->size = newsize;
+	heap->mem_used -= oldsize;
+	duk__mem_limit_add(heap, newsize);
+	return (void *) (hdr + 1);
+}
+
+DUK_INTERNAL void duk_heap_mem_limit_init(duk_heap *heap, const duk_heap_options *options) {
+	DUK_ASSERT(heap != NULL);
+	DUK_ASSERT(heap->mem_used == 0);
+
+	heap->mem_limit_soft = DUK_SIZE_MAX;
+	heap->mem_limit_hard = DUK_SIZE_MAX;
+	heap->mem_soft_trigger = DUK_SIZE_MAX;
+
+	if (!options || (options->mem_limit_soft == 0 && options->mem_limit_hard == 0)) {
+		return;
+	}
+	if (options->mem_limit_soft != 0) {
+		heap->mem_limit_soft = options->mem_limit_soft;
+	}
+	if (options->mem_limit_hard != 0) {
+		heap->mem_limit_hard = options->mem_limit_hard;
+	}
+	DUK_D(DUK_DPRINT("heap memory limits: soft %ld, hard %ld",
+	                 (long) heap->mem_limit_soft, (long) heap->mem_limit_hard));
+
+	heap->mem_alloc_func = heap->alloc_func;
+	heap->mem_realloc_func = heap->realloc_func;
+	heap->mem_free_func = heap->free_func;
+	heap->mem_udata = heap->alloc_udata;
+	heap->alloc_func = duk__mem_limit_alloc;
+	heap->realloc_func = duk__mem_limit_realloc;
+	heap->free_func = duk__mem_limit_free;
+	heap->alloc_udata = (void *) heap;
+}
+
+#if defined(DUK_USE_MARK_AND_SWEEP)
+/* Called when heap init is complete to enable soft limit GCs. */
+DUK_INTERNAL void duk_heap_mem_limit_start(duk_heap *heap) {
+	DUK_ASSERT(heap->mem_soft_trigger == DUK_SIZE_MAX);
+
+	if (heap->mem_limit_soft != DUK_SIZE_MAX) {
+		heap->mem_soft_trigger = heap->mem_limit_soft;
+	}
+}
+
+/* Called after a mark-and-sweep to compute the usage level for the next
+ * soft limit GC.
+ */
+DUK_INTERNAL void duk_heap_mem_limit_update_trigger(duk_heap *heap) {
+	duk_size_t slack;
+
+	if (heap->mem_soft_trigger == DUK_SIZE_MAX) {
+		return;
+	}
+	slack = heap->mem_limit_soft / 4;
+	if (heap->mem_used <= heap->mem_limit_soft) {
+		heap->mem_soft_trigger = heap->mem_limit_soft;
+	} else if (heap->mem_used > DUK_SIZE_MAX - 1 - slack) {
+		heap->mem_soft_trigger = DUK_SIZE_MAX - 1;
+	} else {
+		heap->mem_soft_trigger = heap->mem_used + slack;
+	}
+}
+#endif  /* DUK_USE_MARK_AND_SWEEP */
+
 /*
  *  Allocate memory with garbage collection
  */
@@ -51,10 +262,12 @@ DUK_INTERNAL void *duk_heap_mem_alloc(duk_heap *heap, duk_size_t size) {
 	DUK_ASSERT_DISABLE(size >= 0);
 
 	/*
-	 *  Voluntary periodic GC (if enabled)
+	 *  Deferred frees and voluntary periodic GC (if enabled)
 	 */
 
-	DUK__VOLUNTARY_PERIODIC_GC(heap);
+	DUK__DEFERRED_FREE_STEP(heap);
+	DUK__VOLUNTARY_PERIODIC_GC(heap, size);
+	DUK__SOFT_LIMIT_GC(heap, size);
 
 	/*
 	 *  First attempt
@@ -100,7 +313,7 @@ DUK_INTERNAL void *duk_heap_mem_alloc(duk_heap *heap, duk_size_t size) {
 	for (i = 0; i < DUK_HEAP_ALLOC_FAIL_MARKANDSWEEP_LIMIT; i++) {
 		duk_small_uint_t flags;
 
-		flags = 0;
+		flags = DUK_MS_REASON(DUK_GC_REASON_ALLOC_RETRY);
 		if (i >= DUK_HEAP_ALLOC_FAIL_MARKANDSWEEP_EMERGENCY_LIMIT - 1) {
 			flags |= DUK_MS_FLAG_EMERGENCY;
 		}
@@ -161,10 +374,12 @@ DUK_INTERNAL void *duk_heap_mem_realloc(duk_heap *heap, void *ptr, duk_size_t ne
 	DUK_ASSERT_DISABLE(newsize >= 0);
 
 	/*
-	 *  Voluntary periodic GC (if enabled)
+	 *  Deferred frees and voluntary periodic GC (if enabled)
 	 */
 
-	DUK__VOLUNTARY_PERIODIC_GC(heap);
+	DUK__DEFERRED_FREE_STEP(heap);
+	DUK__VOLUNTARY_PERIODIC_GC(heap, newsize);
+	DUK__SOFT_LIMIT_GC(heap, newsize);  /* conservative, old size is not known */
 
 	/*
 	 *  First attempt
@@ -208,7 +423,7 @@ DUK_INTERNAL void *duk_heap_mem_realloc(duk_heap *heap, void *ptr, duk_size_t ne
 	for (i = 0; i < DUK_HEAP_ALLOC_FAIL_MARKANDSWEEP_LIMIT; i++) {
 		duk_small_uint_t flags;
 
-		flags = 0;
+		flags = DUK_MS_REASON(DUK_GC_REASON_ALLOC_RETRY);
 		if (i >= DUK_HEAP_ALLOC_FAIL_MARKANDSWEEP_EMERGENCY_LIMIT - 1) {
 			flags |= DUK_MS_FLAG_EMERGENCY;
 		}
@@ -254,10 +469,12 @@ DUK_INTERNAL void *duk_heap_mem_realloc_indirect(duk_heap *heap, duk_mem_getptr
 	DUK_ASSERT_DISABLE(newsize >= 0);
 
 	/*
-	 *  Voluntary periodic GC (if enabled)
+	 *  Deferred frees and voluntary periodic GC (if enabled)
 	 */
 
-	DUK__VOLUNTARY_PERIODIC_GC(heap);
+	DUK__DEFERRED_FREE_STEP(heap);
+	DUK__VOLUNTARY_PERIODIC_GC(heap, newsize);
+	DUK__SOFT_LIMIT_GC(heap, newsize);  /* conservative, old size is not known */
 
 	/*
 	 *  First attempt
@@ -309,7 +526,7 @@ DUK_INTERNAL void *duk_heap_mem_realloc_indirect(duk_heap *heap, duk_mem_getptr
 #ifdef DUK_USE_ASSERTIONS
 		ptr_pre = cb(ud);
 #endif
-		flags = 0;
+		flags = DUK_MS_REASON(DUK_GC_REASON_ALLOC_RETRY);
 		if (i >= DUK_HEAP_ALLOC_FAIL_MARKANDSWEEP_EMERGENCY_LIMIT - 1) {
 			flags |= DUK_MS_FLAG_EMERGENCY;
 		}
@@ -382,3 +599,111 @@ DUK_INTERNAL void duk_heap_mem_free(duk_heap *heap, void *ptr) {
 	heap->free_func(heap->alloc_udata, ptr);
 }
 #endif
+
+/*
+ *  Slab and arena allocation
+ *
+ *  Sizes not served by the slab allocator go to the ordinary calls.  The
+ *  slab allocator only calls the allocation functions when it needs a new
+ *  chunk, and that call goes through duk_heap_mem_alloc() so it gets the
+ *  usual mark-and-sweep retries.  Voluntary GC and GC torture are handled
+ *  here so that they're also triggered by slab allocations which don't
+ *  need a new chunk.
+ *
+ *  A heap in arena mode serves all non-zero sizes from the arena instead;
+ *  frees only update arena statistics.
+ */
+
+#if defined(DUK_USE_SIZED_ALLOC)
+DUK_LOCAL void duk__sized_alloc_gc(duk_heap *heap, duk_size_t size) {
+	DUK_UNREF(heap);
+	DUK_UNREF(size);
+
+	DUK__DEFERRED_FREE_STEP(heap);
+	DUK__VOLUNTARY_PERIODIC_GC(heap, size);
+
+#if defined(DUK_USE_MARK_AND_SWEEP) && defined(DUK_USE_GC_TORTURE)
+	/* run a mark-and-sweep on every alloc (except when mark-and-sweep is running) */
+	if (!DUK_HEAP_HAS_MARKANDSWEEP_RUNNING(heap)) {
+		DUK_DDD(DUK_DDDPRINT("gc torture enabled, mark-and-sweep before sized alloc"));
+		(void) duk_heap_mark_and_sweep(heap, DUK_MS_REASON(DUK_GC_REASON_TORTURE));
+	}
+#endif
+}
+
+DUK_INTERNAL void *duk_heap_mem_alloc_slab(duk_heap *heap, duk_size_t size) {
+	DUK_ASSERT(heap != NULL);
+	DUK_ASSERT_DISABLE(size >= 0);
+
+	if (size == 0) {
+		return duk_heap_mem_alloc(heap, size);
+	}
+
+#if defined(DUK_USE_ARENA_ALLOC)
+	if (DUK_HEAP_ARENA_ENABLED(heap)) {
+		duk__sized_alloc_gc(heap, size);
+		return duk_heap_arena_alloc(heap, size);
+	}
+#endif
+
+#if defined(DUK_USE_SLAB_ALLOC)
+	if (size <= heap->slab.max_size) {
+		duk__sized_alloc_gc(heap, size);
+		return duk_heap_slab_alloc(heap, size);
+	}
+#endif
+
+	return duk_heap_mem_alloc(heap, size);
+}
+
+DUK_INTERNAL void *duk_heap_mem_alloc_slab_zeroed(duk_heap *heap, duk_size_t size) {
+	void *res;
+
+	DUK_ASSERT(heap != NULL);
+	DUK_ASSERT_DISABLE(size >= 0);
+
+	res = duk_heap_mem_alloc_slab(heap, size);
+	if (res) {
+		/* assume memset with zero size is OK */
+		DUK_MEMZERO(res, size);
+	}
+	return res;
+}
+
+DUK_INTERNAL void duk_heap_mem_free_slab(duk_heap *heap, void *ptr, duk_size_t size) {
+	DUK_ASSERT(heap != NULL);
+	/* ptr may be NULL */
+
+	if (ptr == NULL) {
+		return;
+	}
+	if (size == 0) {
+		duk_heap_mem_free(heap, ptr);
+		return;
+	}
+
+#if defined(DUK_USE_ARENA_ALLOC)
+	if (DUK_HEAP_ARENA_ENABLED(heap)) {
+		duk_heap_arena_free(heap, ptr, size);
+		goto counted;
+	}
+#endif
+
+#if defined(DUK_USE_SLAB_ALLOC)
+	if (size <= heap->slab.max_size) {
+		duk_heap_slab_free(heap, ptr, size);
+		goto counted;
+	}
+#endif
+
+	duk_heap_mem_free(heap, ptr);
+	return;
+
+ counted:
+	/* counted toward triggering a GC like duk_heap_mem_free() */
+#if defined(DUK_USE_MARK_AND_SWEEP) && defined(DUK_USE_VOLUNTARY_GC)
+	heap->mark_and_sweep_trigger_counter--;
+#endif
+	return;
+}
+#endif  /* DUK_USE_SIZED_ALLOC */
@@ -86,27 +86,34 @@ DUK_LOCAL void duk__refcount_finalize_hobject(duk_hthread *thr, duk_hobject *h)
 		duk_tval *tv, *tv_end;
 		duk_hobject **funcs, **funcs_end;
 
-		DUK_ASSERT(DUK_HCOMPILEDFUNCTION_GET_DATA(f) != NULL);  /* compiled functions must be created 'atomically' */
+		/* 'data' is NULL if allocating it failed while the compiler
+		 * was creating the function (e.g. memory limit reached).
+		 */
+		if (DUK_HCOMPILEDFUNCTION_GET_DATA(f) != NULL) {
+			tv = DUK_HCOMPILEDFUNCTION_GET_CONSTS_BASE(f);
+			tv_end = DUK_HCOMPILEDFUNCTION_GET_CONSTS_END(f);
+			while (tv < tv_end) {
+				duk_heap_tval_decref(thr, tv);
+				tv++;
+			}
 
-		tv = DUK_HCOMPILEDFUNCTION_GET_CONSTS_BASE(f);
-		tv_end = DUK_HCOMPILEDFUNCTION_GET_CONSTS_END(f);
-		while (tv < tv_end) {
-			duk_heap_tval_decref(thr, tv);
-			tv++;
-		}
+			funcs = DUK_HCOMPILEDFUNCTION_GET_FUNCS_BASE(f);
+			funcs_end = DUK_HCOMPILEDFUNCTION_GET_FUNCS_END(f);
+			while (funcs < funcs_end) {
+				duk_heap_heaphdr_decref(thr, (duk_heaphdr *) *funcs);
+				funcs++;
+			}
 
-		funcs = DUK_HCOMPILEDFUNCTION_GET_FUNCS_BASE(f);
-		funcs_end = DUK_HCOMPILEDFUNCTION_GET_FUNCS_END(f);
-		while (funcs < funcs_end) {
-			duk_heap_heaphdr_decref(thr, (duk_heaphdr *) *funcs);
-			funcs++;
+			duk_heap_heaphdr_decref(thr, (duk_heaphdr *) DUK_HCOMPILEDFUNCTION_GET_DATA(f));
 		}
-
-		duk_heap_heaphdr_decref(thr, (duk_heaphdr *) DUK_HCOMPILEDFUNCTION_GET_DATA(f));
 	} else if (DUK_HOBJECT_IS_NATIVEFUNCTION(h)) {
 		duk_hnativefunction *f = (duk_hnativefunction *) h;
 		DUK_UNREF(f);
 		/* nothing to finalize */
+	} else if (DUK_HOBJECT_IS_BUFFEROBJECT(h)) {
+		duk_hbufferobject *b = (duk_hbufferobject *) h;
+		duk_heap_heaphdr_decref(thr, (duk_heaphdr *) b->buf);
+		duk_heap_heaphdr_decref(thr, (duk_heaphdr *) b->buf_prop);
 	} else if (DUK_HOBJECT_IS_THREAD(h)) {
 		duk_hthread *t = (duk_hthread *) h;
 		duk_tval *tv;
@@ -138,7 +145,23 @@ DUK_LOCAL void duk__refcount_finalize_hobject(duk_hthread *thr, duk_hobject *h)
 		}
 
 		duk_heap_heaphdr_decref(thr, (duk_heaphdr *) t->resumer);
+#if defined(DUK_USE_WEAK_REFERENCES)
+	} else if (DUK_HOBJECT_IS_WEAKOBJECT(h)) {
+		/* keys are weak, values are strong */
+		duk_hweakobject_clear(thr, (duk_hweakobject *) h);
+#endif
 	}
+
+#if defined(DUK_USE_WEAK_REFERENCES)
+	/* An object used as a weak key must be removed from weak objects
+	 * before it is freed.  Mark-and-sweep clears the flag for keys it
+	 * has already handled.
+	 */
+	if (DUK_HOBJECT_HAS_WEAKKEY(h)) {
+		DUK_HOBJECT_CLEAR_WEAKKEY(h);
+		duk_hweakobject_key_freed(thr, h);
+	}
+#endif
 }
 
 DUK_INTERNAL void duk_heap_refcount_finalize_heaphdr(duk_hthread *thr, duk_heaphdr *hdr) {
@@ -162,14 +185,18 @@ DUK_INTERNAL void duk_heap_refcount_finalize_heaphdr(duk_hthread *thr, duk_heaph
  *  Refcount memory freeing loop.
  *
  *  Frees objects in the refzero_pending list until the list becomes
- *  empty.  When an object is freed, its references get decref'd and
- *  may cause further objects to be queued for freeing.
+ *  empty, or until 'budget' objects have been processed if it is nonzero.
+ *  When an object is freed, its references get decref'd and may cause
+ *  further objects to be queued for freeing.
  *
- *  This could be expanded to allow incremental freeing: just bail out
- *  early and resume at a future alloc/decref/refzero.
+ *  With a budget the rest of the list is left for later batches, which
+ *  happen at the next refzero, at safe points in the executor and call
+ *  handling, and in executor interrupts.  Objects on the list are
+ *  reachability roots for mark-and-sweep so nothing they refer to is
+ *  freed in the meantime.
  */
 
-DUK_LOCAL void duk__refzero_free_pending(duk_hthread *thr) {
+DUK_LOCAL void duk__refzero_free_pending(duk_hthread *thr, duk_size_t budget) {
 	duk_heaphdr *h1, *h2;
 	duk_heap *heap;
 	duk_int_t count = 0;
@@ -197,6 +224,11 @@ DUK_LOCAL void duk__refzero_free_pending(duk_hthread *thr) {
 		duk_hobject *obj;
 		duk_bool_t rescued = 0;
 
+		if (budget > 0 && (duk_size_t) count >= budget) {
+			DUK_DDD(DUK_DDDPRINT("refzero batch done, rest left for later"));
+			break;
+		}
+
 		/*
 		 *  Pick an object from the head (don't remove yet).
 		 */
@@ -299,9 +331,10 @@ DUK_LOCAL void duk__refzero_free_pending(duk_hthread *thr) {
 	 * which happens in memory block (re)allocation.
 	 */
 	heap->mark_and_sweep_trigger_counter -= count;
-	if (heap->mark_and_sweep_trigger_counter <= 0) {
+	if (heap->mark_and_sweep_trigger_counter <= 0 &&
+	    !duk_heap_mark_and_sweep_postpone(heap)) {
 		duk_bool_t rc;
-		duk_small_uint_t flags = 0;  /* not emergency */
+		duk_small_uint_t flags = DUK_MS_REASON(DUK_GC_REASON_VOLUNTARY);  /* not emergency */
 		DUK_D(DUK_DPRINT("refcount triggering mark-and-sweep"));
 		rc = duk_heap_mark_and_sweep(heap, flags);
 		DUK_UNREF(rc);
@@ -310,6 +343,33 @@ DUK_LOCAL void duk__refzero_free_pending(duk_hthread *thr) {
 #endif  /* DUK_USE_MARK_AND_SWEEP && DUK_USE_VOLUNTARY_GC */
 }
 
+/* Process the refzero work list at a safe point: one batch, or the whole
+ * list if 'all' is set.
+ */
+DUK_INTERNAL void duk_heap_refzero_process_pending(duk_hthread *thr, duk_bool_t all) {
+	duk_heap *heap;
+	duk_size_t budget = 0;
+
+	DUK_ASSERT(thr != NULL);
+	heap = thr->heap;
+	DUK_ASSERT(heap != NULL);
+
+#if defined(DUK_USE_MARK_AND_SWEEP)
+	/* objects on the list are mark-and-sweep roots, it will leave them alone */
+	if (DUK_HEAP_HAS_MARKANDSWEEP_RUNNING(heap)) {
+		return;
+	}
+	if (!all) {
+		budget = heap->gc_policy.refzero_step;
+	}
+#else
+	DUK_UNREF(heap);
+	DUK_UNREF(all);
+#endif
+
+	duk__refzero_free_pending(thr, budget);
+}
+
 /*
  *  Incref and decref functions.
  *
@@ -443,7 +503,11 @@ DUK_INTERNAL void duk_heap_heaphdr_decref(duk_hthread *thr, duk_heaphdr *h) {
 
 		duk_heap_remove_any_from_heap_allocated(heap, h);
 		duk__queue_refzero(heap, h);
-		duk__refzero_free_pending(thr);
+#if defined(DUK_USE_MARK_AND_SWEEP)
+		duk__refzero_free_pending(thr, heap->gc_policy.refzero_step);
+#else
+		duk__refzero_free_pending(thr, 0);
+#endif
 		break;
 
 	case DUK_HTYPE_BUFFER:
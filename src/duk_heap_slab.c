@@ -0,0 +1,423 @@
+/*
+ *  Slab allocator for heap object headers and small property allocations.
+ *
+ *  Allocations up to 'max_size' bytes are rounded up to a multiple of
+ *  DUK_SLAB_GRANULE and served from per size class pages.  Pages are
+ *  carved out of larger chunks requested from the heap allocation
+ *  functions and are aligned to the page size, so that the page header
+ *  of any slot is found by masking the slot address.  Callers always
+ *  provide the allocation size when freeing (see DUK_FREE_SLAB()), which
+ *  is what allows slots to be allocated without any per-slot header.
+ *
+ *  Page state:
+ *
+ *    - Unassigned: linked into the heap wide free page list.
+ *
+ *    - Assigned to a class with free slots: linked into the class partial
+ *      list.  Never used slots are handed out by bumping a pointer so that
+ *      a new page doesn't need to be initialized as a whole.
+ *
+ *    - Assigned to a class and full: not linked anywhere.
+ *
+ *  An assigned page whose last slot is freed goes back to the free page
+ *  list, except for the last partial page of a class which is kept to
+ *  avoid page churn when a single object is allocated and freed over and
+ *  over.  A chunk is released when all of its pages are free, except for
+ *  the last chunk of the heap.
+ */
+
+#include "duk_internal.h"
+
+#if defined(DUK_USE_SLAB_ALLOC)
+
+/* Page header size, keeps slots aligned to 16 bytes relative to the page. */
+#define DUK__SLAB_PAGE_HDR_SIZE  ((sizeof(duk_slab_page) + 15) & ~((duk_size_t) 15))
+
+/* Limits for sizes given in heap options.  The page size must be large
+ * enough to fit a few of the largest slots.
+ */
+#define DUK__SLAB_MIN_PAGE_SIZE     1024
+#define DUK__SLAB_MAX_PAGE_SIZE     (1024L * 1024L)
+#define DUK__SLAB_MAX_CHUNK_BYTES   (16L * 1024L * 1024L)
+#define DUK__SLAB_MIN_SLOTS         4
+
+#define DUK__SLAB_PAGE_OF(slab,ptr) \
+	((duk_slab_page *) (void *) ((duk_uintptr_t) (ptr) & (slab)->page_mask))
+
+DUK_INTERNAL void duk_heap_slab_init(duk_heap *heap, const duk_heap_options *options) {
+	duk_slab *slab;
+	duk_size_t page_size;
+	duk_size_t chunk_pages;
+	duk_size_t max_size;
+	duk_size_t limit;
+	duk_small_uint_t i;
+
+	DUK_ASSERT(heap != NULL);
+	slab = &heap->slab;
+
+	page_size = DUK_USE_SLAB_PAGE_SIZE;
+	chunk_pages = DUK_USE_SLAB_CHUNK_PAGES;
+	max_size = DUK_USE_SLAB_MAX_SIZE;
+	if (options != NULL) {
+		if (options->slab_page_size > 0) {
+			page_size = options->slab_page_size;
+		}
+		if (options->slab_chunk_pages > 0) {
+			chunk_pages = options->slab_chunk_pages;
+		}
+		if (options->slab_max_size > 0) {
+			max_size = options->slab_max_size;
+		}
+	}
+
+	/* Sanitize instead of failing: round the page size up to a power of
+	 * two and clamp everything into a workable range.
+	 */
+	if (page_size > DUK__SLAB_MAX_PAGE_SIZE) {
+		page_size = DUK__SLAB_MAX_PAGE_SIZE;
+	}
+	limit = DUK__SLAB_MIN_PAGE_SIZE;
+	while (limit < page_size) {
+		limit <<= 1;
+	}
+	page_size = limit;
+
+	if (chunk_pages > DUK__SLAB_MAX_CHUNK_BYTES / page_size) {
+		chunk_pages = DUK__SLAB_MAX_CHUNK_BYTES / page_size;
+	}
+	DUK_ASSERT(chunk_pages >= 1);
+
+	limit = (page_size - DUK__SLAB_PAGE_HDR_SIZE) / DUK__SLAB_MIN_SLOTS;
+	if (limit > DUK_SLAB_MAX_CLASSES * DUK_SLAB_GRANULE) {
+		limit = DUK_SLAB_MAX_CLASSES * DUK_SLAB_GRANULE;
+	}
+	limit = limit / DUK_SLAB_GRANULE * DUK_SLAB_GRANULE;
+	max_size = (max_size + DUK_SLAB_GRANULE - 1) / DUK_SLAB_GRANULE * DUK_SLAB_GRANULE;
+	if (max_size > limit) {
+		max_size = limit;
+	}
+	DUK_ASSERT(max_size >= DUK_SLAB_GRANULE);
+
+	slab->page_size = page_size;
+	slab->page_mask = ~((duk_uintptr_t) page_size - 1);
+	slab->chunk_pages = chunk_pages;
+	slab->max_size = max_size;
+	slab->class_count = (duk_small_uint_t) (max_size / DUK_SLAB_GRANULE);
+	DUK_ASSERT(slab->class_count <= DUK_SLAB_MAX_CLASSES);
+
+	/* heap has been zeroed, so only non-zero fields are initialized */
+#ifdef DUK_USE_EXPLICIT_NULL_INIT
+	slab->chunks = NULL;
+	slab->free_pages = NULL;
+#endif
+	for (i = 0; i < slab->class_count; i++) {
+		duk_slab_class *cls = slab->classes + i;
+
+#ifdef DUK_USE_EXPLICIT_NULL_INIT
+		cls->partial = NULL;
+#endif
+		cls->slot_size = (duk_uint32_t) ((i + 1) * DUK_SLAB_GRANULE);
+		cls->slots_per_page = (duk_uint32_t) ((page_size - DUK__SLAB_PAGE_HDR_SIZE) / cls->slot_size);
+		DUK_ASSERT(cls->slots_per_page >= DUK__SLAB_MIN_SLOTS);
+	}
+
+	DUK_D(DUK_DPRINT("slab allocator: page_size=%ld, chunk_pages=%ld, max_size=%ld, class_count=%ld",
+	                 (long) slab->page_size, (long) slab->chunk_pages,
+	                 (long) slab->max_size, (long) slab->class_count));
+}
+
+DUK_INTERNAL void duk_heap_slab_free_all(duk_heap *heap) {
+	duk_slab *slab;
+	duk_slab_chunk *chunk;
+	duk_slab_chunk *next;
+
+	DUK_ASSERT(heap != NULL);
+	slab = &heap->slab;
+
+	DUK_D(DUK_DPRINT("free slab allocator: %ld chunks, %ld free pages, %ld chunks allocated, %ld chunks freed",
+	                 (long) slab->chunk_count, (long) slab->free_page_count,
+	                 (long) slab->chunk_alloc_count, (long) slab->chunk_free_count));
+
+	chunk = slab->chunks;
+	while (chunk != NULL) {
+		next = chunk->next;
+		DUK_FREE(heap, chunk->alloc_ptr);
+		chunk = next;
+	}
+	slab->chunks = NULL;
+	slab->free_pages = NULL;
+	slab->chunk_count = 0;
+	slab->free_page_count = 0;
+}
+
+/* Allocate a new chunk and add its pages to the free page list.  The
+ * allocation may run a mark-and-sweep (including finalizers) which can
+ * allocate and free slab memory, so slab state is only touched after it.
+ */
+DUK_LOCAL duk_bool_t duk__slab_alloc_chunk(duk_heap *heap) {
+	duk_slab *slab = &heap->slab;
+	duk_slab_chunk *chunk;
+	duk_uint8_t *ptr;
+	duk_uint8_t *pages;
+	duk_size_t i;
+
+	ptr = (duk_uint8_t *) DUK_ALLOC(heap, slab->chunk_pages * slab->page_size + (slab->page_size - 1) + sizeof(duk_slab_chunk));
+	if (ptr == NULL) {
+		DUK_D(DUK_DPRINT("failed to allocate slab chunk"));
+		return 0;
+	}
+
+	pages = (duk_uint8_t *) (void *) (((duk_uintptr_t) ptr + slab->page_size - 1) & slab->page_mask);
+	chunk = (duk_slab_chunk *) (void *) (pages + slab->chunk_pages * slab->page_size);
+	chunk->alloc_ptr = (void *) ptr;
+	chunk->pages = pages;
+	chunk->free_pages = (duk_uint32_t) slab->chunk_pages;
+	chunk->prev = NULL;
+	chunk->next = slab->chunks;
+	if (slab->chunks != NULL) {
+		slab->chunks->prev = chunk;
+	}
+	slab->chunks = chunk;
+
+	/* Link in reverse so that the first page ends up at the list head. */
+	i = slab->chunk_pages;
+	while (i > 0) {
+		duk_slab_page *page;
+
+		i--;
+		page = (duk_slab_page *) (void *) (pages + i * slab->page_size);
+		page->chunk = chunk;
+		page->class_index = DUK_SLAB_CLASS_NONE;
+		page->used = 0;
+		page->free = NULL;
+		page->bump = NULL;
+		page->prev = NULL;
+		page->next = slab->free_pages;
+		if (slab->free_pages != NULL) {
+			slab->free_pages->prev = page;
+		}
+		slab->free_pages = page;
+	}
+
+	slab->chunk_count++;
+	slab->chunk_alloc_count++;
+	slab->free_page_count += slab->chunk_pages;
+
+	DUK_DD(DUK_DDPRINT("allocated slab chunk %p, pages at %p, chunk count %ld",
+	                   (void *) ptr, (void *) pages, (long) slab->chunk_count));
+	return 1;
+}
+
+DUK_LOCAL void duk__slab_free_chunk(duk_heap *heap, duk_slab_chunk *chunk) {
+	duk_slab *slab = &heap->slab;
+	duk_size_t i;
+
+	DUK_ASSERT(chunk->free_pages == slab->chunk_pages);
+
+	for (i = 0; i < slab->chunk_pages; i++) {
+		duk_slab_page *page = (duk_slab_page *) (void *) (chunk->pages + i * slab->page_size);
+
+		DUK_ASSERT(page->class_index == DUK_SLAB_CLASS_NONE);
+		if (page->prev != NULL) {
+			page->prev->next = page->next;
+		} else {
+			DUK_ASSERT(slab->free_pages == page);
+			slab->free_pages = page->next;
+		}
+		if (page->next != NULL) {
+			page->next->prev = page->prev;
+		}
+	}
+	slab->free_page_count -= slab->chunk_pages;
+
+	if (chunk->prev != NULL) {
+		chunk->prev->next = chunk->next;
+	} else {
+		DUK_ASSERT(slab->chunks == chunk);
+		slab->chunks = chunk->next;
+	}
+	if (chunk->next != NULL) {
+		chunk->next->prev = chunk->prev;
+	}
+	slab->chunk_count--;
+	slab->chunk_free_count++;
+
+	DUK_DD(DUK_DDPRINT("freed slab chunk %p, chunk count %ld",
+	                   (void *) chunk->alloc_ptr, (long) slab->chunk_count));
+	DUK_FREE(heap, chunk->alloc_ptr);
+}
+
+/* Get a page with free slots for a class, assigning a free page (and
+ * allocating a chunk) if necessary.
+ */
+DUK_LOCAL duk_slab_page *duk__slab_get_partial_page(duk_heap *heap, duk_small_uint_t class_index) {
+	duk_slab *slab = &heap->slab;
+	duk_slab_class *cls = slab->classes + class_index;
+	duk_slab_page *page;
+
+	for (;;) {
+		/* Re-check on every round, a mark-and-sweep triggered by a
+		 * chunk allocation may have freed slots of this class.
+		 */
+		if (cls->partial != NULL) {
+			return cls->partial;
+		}
+
+		page = slab->free_pages;
+		if (page != NULL) {
+			break;
+		}
+		if (!duk__slab_alloc_chunk(heap)) {
+			return NULL;
+		}
+	}
+
+	DUK_ASSERT(page->class_index == DUK_SLAB_CLASS_NONE);
+	DUK_ASSERT(page->prev == NULL);
+	slab->free_pages = page->next;
+	if (page->next != NULL) {
+		page->next->prev = NULL;
+	}
+	slab->free_page_count--;
+	DUK_ASSERT(page->chunk->free_pages > 0);
+	page->chunk->free_pages--;
+
+	page->class_index = class_index;
+	page->used = 0;
+	page->free = NULL;
+	page->bump = (duk_uint8_t *) (void *) page + DUK__SLAB_PAGE_HDR_SIZE;
+	page->next = NULL;
+	page->prev = NULL;
+	cls->partial = page;
+	cls->page_count++;
+
+	return page;
+}
+
+DUK_LOCAL void duk__slab_release_page(duk_heap *heap, duk_slab_class *cls, duk_slab_page *page) {
+	duk_slab *slab = &heap->slab;
+	duk_slab_chunk *chunk;
+
+	DUK_ASSERT(page->used == 0);
+
+	if (page->prev != NULL) {
+		page->prev->next = page->next;
+	} else {
+		DUK_ASSERT(cls->partial == page);
+		cls->partial = page->next;
+	}
+	if (page->next != NULL) {
+		page->next->prev = page->prev;
+	}
+	cls->page_count--;
+
+	page->class_index = DUK_SLAB_CLASS_NONE;
+	page->prev = NULL;
+	page->next = slab->free_pages;
+	if (slab->free_pages != NULL) {
+		slab->free_pages->prev = page;
+	}
+	slab->free_pages = page;
+	slab->free_page_count++;
+
+	chunk = page->chunk;
+	chunk->free_pages++;
+	if (chunk->free_pages == slab->chunk_pages && slab->chunk_count > 1) {
+		duk__slab_free_chunk(heap, chunk);
+	}
+}
+
+/* Allocate a slot, returns NULL if a new chunk is needed and cannot be
+ * allocated.  Caller handles sizes which are not served by the slabs.
+ */
+DUK_INTERNAL void *duk_heap_slab_alloc(duk_heap *heap, duk_size_t size) {
+	duk_slab *slab;
+	duk_slab_class *cls;
+	duk_slab_page *page;
+	duk_small_uint_t class_index;
+	void *res;
+
+	DUK_ASSERT(heap != NULL);
+	slab = &heap->slab;
+	DUK_ASSERT(size > 0 && size <= slab->max_size);
+
+	class_index = (duk_small_uint_t) DUK_SLAB_GET_CLASS_INDEX(size);
+	cls = slab->classes + class_index;
+	page = cls->partial;
+	if (DUK_UNLIKELY(page == NULL)) {
+		page = duk__slab_get_partial_page(heap, class_index);
+		if (page == NULL) {
+			return NULL;
+		}
+	}
+	DUK_ASSERT(page->class_index == class_index);
+	DUK_ASSERT(page->used < cls->slots_per_page);
+
+	if (page->free != NULL) {
+		res = (void *) page->free;
+		page->free = page->free->next;
+	} else {
+		res = (void *) page->bump;
+		page->bump += cls->slot_size;
+		DUK_ASSERT(page->bump <= (duk_uint8_t *) (void *) page + slab->page_size);
+	}
+	page->used++;
+	if (page->used == cls->slots_per_page) {
+		/* page is now full, unlink from the head of the partial list */
+		DUK_ASSERT(cls->partial == page);
+		DUK_ASSERT(page->prev == NULL);
+		DUK_ASSERT(page->free == NULL);
+		cls->partial = page->next;
+		if (page->next != NULL) {
+			page->next->prev = NULL;
+		}
+		page->next = NULL;
+	}
+
+	cls->used_count++;
+	cls->alloc_count++;
+	DUK_ASSERT(((duk_uintptr_t) res & (DUK_SLAB_GRANULE - 1)) == 0);
+	return res;
+}
+
+DUK_INTERNAL void duk_heap_slab_free(duk_heap *heap, void *ptr, duk_size_t size) {
+	duk_slab *slab;
+	duk_slab_class *cls;
+	duk_slab_page *page;
+	duk_slab_freeslot *slot;
+
+	DUK_ASSERT(heap != NULL);
+	DUK_ASSERT(ptr != NULL);
+	slab = &heap->slab;
+	DUK_ASSERT(size > 0 && size <= slab->max_size);
+
+	page = DUK__SLAB_PAGE_OF(slab, ptr);
+	cls = slab->classes + DUK_SLAB_GET_CLASS_INDEX(size);
+	DUK_ASSERT(page->class_index == (duk_uint32_t) DUK_SLAB_GET_CLASS_INDEX(size));
+	DUK_ASSERT(page->used > 0);
+
+	if (page->used == cls->slots_per_page) {
+		/* full page gets a free slot, link to the partial list */
+		page->prev = NULL;
+		page->next = cls->partial;
+		if (cls->partial != NULL) {
+			cls->partial->prev = page;
+		}
+		cls->partial = page;
+	}
+
+	slot = (duk_slab_freeslot *) ptr;
+	slot->next = page->free;
+	page->free = slot;
+	page->used--;
+
+	cls->used_count--;
+	cls->free_count++;
+
+	if (page->used == 0 && (page->prev != NULL || page->next != NULL)) {
+		/* Empty and not the last partial page of the class. */
+		duk__slab_release_page(heap, cls, page);
+	}
+}
+
+#endif  /* DUK_USE_SLAB_ALLOC */
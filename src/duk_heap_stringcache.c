@@ -10,7 +10,7 @@
 #include "duk_internal.h"
 
 /*
- *  Delete references to given hstring from the heap string cache.
+ *  Delete references to given hstring from the heap string caches.
  *
  *  String cache references are 'weak': they are not counted towards
  *  reference counts, nor serve as roots for mark-and-sweep.  When an
@@ -32,6 +32,17 @@ DUK_INTERNAL void duk_heap_strcache_string_remove(duk_heap *heap, duk_hstring *h
 			 */
 		}
 	}
+
+#if defined(DUK_USE_INTSTR_CACHE)
+	if (DUK_HSTRING_HAS_ARRIDX(h)) {
+		duk_uint32_t val = duk_js_to_arrayindex_string_helper(h);
+		if (val < DUK_USE_INTSTR_CACHE_SIZE && heap->intstr_cache[val] == h) {
+			DUK_DD(DUK_DDPRINT("deleting weak intstr cache reference to hstring %p from heap %p",
+			                   (void *) h, (void *) heap));
+			heap->intstr_cache[val] = NULL;
+		}
+	}
+#endif
 }
 
 /*
@@ -15,13 +15,17 @@
  *  The caller must place the interned string into the stringtable
  *  immediately (without chance of a longjmp); otherwise the string
  *  is lost.
+ *
+ *  If 'extdata' is non-NULL (only with DUK_USE_HSTRING_EXTDATA), 'str'
+ *  is user memory which is referenced instead of copied.
  */
 
 DUK_LOCAL
 duk_hstring *duk__alloc_init_hstring(duk_heap *heap,
                                      duk_uint8_t *str,
                                      duk_uint32_t blen,
-                                     duk_uint32_t strhash) {
+                                     duk_uint32_t strhash,
+                                     duk_bool_t extdata) {
 	duk_hstring *res = NULL;
 	duk_uint8_t *data;
 	duk_size_t alloc_size;
@@ -36,15 +40,36 @@ duk_hstring *duk__alloc_init_hstring(duk_heap *heap,
 	}
 #endif
 
-	/* NUL terminate for convenient C access */
+#if defined(DUK_USE_HSTRING_EXTDATA)
+	if (extdata) {
+		/* user memory is already NUL terminated */
+		DUK_ASSERT(str[blen] == (duk_uint8_t) 0);
+		res = (duk_hstring *) DUK_ALLOC_SLAB(heap, sizeof(duk_hstring_external));
+		if (!res) {
+			goto alloc_error;
+		}
+		DUK_MEMZERO(res, sizeof(duk_hstring_external));
+#ifdef DUK_USE_EXPLICIT_NULL_INIT
+		((duk_hstring_external *) res)->release_func = NULL;
+		((duk_hstring_external *) res)->release_udata = NULL;
+#endif
+		((duk_hstring_external *) res)->extdata = (const duk_uint8_t *) str;
+	} else
+#else
+	DUK_UNREF(extdata);
+	DUK_ASSERT(!extdata);
+#endif
+	{
+		/* NUL terminate for convenient C access */
 
-	alloc_size = (duk_size_t) (sizeof(duk_hstring) + blen + 1);
-	res = (duk_hstring *) DUK_ALLOC(heap, alloc_size);
-	if (!res) {
-		goto alloc_error;
-	}
+		alloc_size = (duk_size_t) (sizeof(duk_hstring) + blen + 1);
+		res = (duk_hstring *) DUK_ALLOC_SLAB(heap, alloc_size);
+		if (!res) {
+			goto alloc_error;
+		}
 
-	DUK_MEMZERO(res, sizeof(duk_hstring));
+		DUK_MEMZERO(res, sizeof(duk_hstring));
+	}
 #ifdef DUK_USE_EXPLICIT_NULL_INIT
 	DUK_HEAPHDR_STRING_INIT_NULLS(&res->hdr);
 #endif
@@ -71,9 +96,16 @@ duk_hstring *duk__alloc_init_hstring(duk_heap *heap,
 	DUK_ASSERT(clen <= blen);
 	DUK_HSTRING_SET_CHARLEN(res, clen);
 
-	data = (duk_uint8_t *) (res + 1);
-	DUK_MEMCPY(data, str, blen);
-	data[blen] = (duk_uint8_t) 0;
+#if defined(DUK_USE_HSTRING_EXTDATA)
+	if (extdata) {
+		DUK_HSTRING_SET_EXTDATA(res);
+	} else
+#endif
+	{
+		data = (duk_uint8_t *) (res + 1);
+		DUK_MEMCPY(data, str, blen);
+		data[blen] = (duk_uint8_t) 0;
+	}
 
 	DUK_DDD(DUK_DDDPRINT("interned string, hash=0x%08lx, blen=%ld, clen=%ld, has_arridx=%ld",
 	                     (unsigned long) DUK_HSTRING_GET_HASH(res),
@@ -449,7 +481,7 @@ DUK_LOCAL duk_bool_t duk__recheck_strtab_size(duk_heap *heap, duk_uint32_t new_u
  *  Raw intern and lookup
  */
 
-DUK_LOCAL duk_hstring *duk__do_intern(duk_heap *heap, duk_uint8_t *str, duk_uint32_t blen, duk_uint32_t strhash) {
+DUK_LOCAL duk_hstring *duk__do_intern(duk_heap *heap, duk_uint8_t *str, duk_uint32_t blen, duk_uint32_t strhash, duk_bool_t extdata) {
 	duk_hstring *res;
 
 	if (duk__recheck_strtab_size(heap, heap->st_used + 1)) {
@@ -473,7 +505,7 @@ DUK_LOCAL duk_hstring *duk__do_intern(duk_heap *heap, duk_uint8_t *str, duk_uint
 	}
 #endif
 
-	res = duk__alloc_init_hstring(heap, str, blen, strhash);
+	res = duk__alloc_init_hstring(heap, str, blen, strhash, extdata);
 	if (!res) {
 		return NULL;
 	}
@@ -539,10 +571,43 @@ DUK_INTERNAL duk_hstring *duk_heap_string_intern(duk_heap *heap, duk_uint8_t *st
 		return res;
 	}
 
-	res = duk__do_intern(heap, str, blen, strhash);
+	res = duk__do_intern(heap, str, blen, strhash, 0 /*extdata*/);
 	return res;  /* may be NULL */
 }
 
+#if defined(DUK_USE_HSTRING_EXTDATA)
+/* Like duk_heap_string_intern() but if the string is not yet interned, the
+ * new string references 'str' (which must be NUL terminated) instead of
+ * copying it.  Sets '*out_used' to indicate whether 'str' was taken into
+ * use; if not, the caller still owns it.
+ */
+DUK_INTERNAL duk_hstring *duk_heap_string_intern_external(duk_heap *heap, duk_uint8_t *str, duk_uint32_t blen, duk_free_function release_func, void *release_udata, duk_bool_t *out_used) {
+	duk_hstring *res;
+	duk_uint32_t strhash;
+
+	DUK_ASSERT(blen <= DUK_HSTRING_MAX_BYTELEN);
+	DUK_ASSERT(str != NULL);
+	DUK_ASSERT(out_used != NULL);
+
+	*out_used = 0;
+
+	res = duk__do_lookup(heap, str, blen, &strhash);
+	if (res) {
+		return res;
+	}
+
+	res = duk__do_intern(heap, str, blen, strhash, 1 /*extdata*/);
+	if (res) {
+		/* No side effects between the intern and this. */
+		DUK_ASSERT(DUK_HSTRING_HAS_EXTDATA(res));
+		((duk_hstring_external *) res)->release_func = release_func;
+		((duk_hstring_external *) res)->release_udata = release_udata;
+		*out_used = 1;
+	}
+	return res;  /* may be NULL */
+}
+#endif
+
 DUK_INTERNAL duk_hstring *duk_heap_string_intern_checked(duk_hthread *thr, duk_uint8_t *str, duk_uint32_t blen) {
 	duk_hstring *res = duk_heap_string_intern(thr->heap, str, blen);
 	if (!res) {
@@ -563,10 +628,32 @@ DUK_INTERNAL duk_hstring *duk_heap_string_lookup_u32(duk_heap *heap, duk_uint32_
 
 DUK_INTERNAL duk_hstring *duk_heap_string_intern_u32(duk_heap *heap, duk_uint32_t val) {
 	char buf[DUK_STRTAB_U32_MAX_STRLEN+1];
+	duk_hstring *res;
+
+#if defined(DUK_USE_INTSTR_CACHE)
+	if (val < DUK_USE_INTSTR_CACHE_SIZE) {
+		res = heap->intstr_cache[val];
+		if (res != NULL) {
+			DUK_ASSERT(DUK_HSTRING_GET_ARRIDX_SLOW(res) == val);
+			return res;
+		}
+	}
+#endif
+
 	DUK_SNPRINTF(buf, sizeof(buf), "%lu", (unsigned long) val);
 	buf[sizeof(buf) - 1] = (char) 0;
 	DUK_ASSERT(DUK_STRLEN(buf) <= DUK_UINT32_MAX);  /* formatted result limited */
-	return duk_heap_string_intern(heap, (duk_uint8_t *) buf, (duk_uint32_t) DUK_STRLEN(buf));
+	res = duk_heap_string_intern(heap, (duk_uint8_t *) buf, (duk_uint32_t) DUK_STRLEN(buf));
+
+#if defined(DUK_USE_INTSTR_CACHE)
+	if (val < DUK_USE_INTSTR_CACHE_SIZE && res != NULL) {
+		/* Weak reference, removed when the string is freed, see
+		 * duk_heap_strcache_string_remove().
+		 */
+		heap->intstr_cache[val] = res;
+	}
+#endif
+	return res;
 }
 
 DUK_INTERNAL duk_hstring *duk_heap_string_intern_u32_checked(duk_hthread *thr, duk_uint32_t val) {
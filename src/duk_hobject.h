@@ -36,6 +36,7 @@
 #define DUK_HOBJECT_FLAG_EXTENSIBLE            DUK_HEAPHDR_USER_FLAG(0)   /* object is extensible */
 #define DUK_HOBJECT_FLAG_CONSTRUCTABLE         DUK_HEAPHDR_USER_FLAG(1)   /* object is constructable */
 #define DUK_HOBJECT_FLAG_BOUND                 DUK_HEAPHDR_USER_FLAG(2)   /* object established using Function.prototype.bind() */
+#define DUK_HOBJECT_FLAG_BUFFEROBJECT          DUK_HEAPHDR_USER_FLAG(3)   /* object is a buffer object (duk_hbufferobject), exotic index/length behavior */
 #define DUK_HOBJECT_FLAG_COMPILEDFUNCTION      DUK_HEAPHDR_USER_FLAG(4)   /* object is a compiled function (duk_hcompiledfunction) */
 #define DUK_HOBJECT_FLAG_NATIVEFUNCTION        DUK_HEAPHDR_USER_FLAG(5)   /* object is a native function (duk_hnativefunction) */
 #define DUK_HOBJECT_FLAG_THREAD                DUK_HEAPHDR_USER_FLAG(6)   /* object is a thread (duk_hthread) */
@@ -52,7 +53,7 @@
 #define DUK_HOBJECT_FLAG_EXOTIC_DUKFUNC        DUK_HEAPHDR_USER_FLAG(17)  /* Duktape/C (nativefunction) object, exotic 'length' */
 #define DUK_HOBJECT_FLAG_EXOTIC_BUFFEROBJ      DUK_HEAPHDR_USER_FLAG(18)  /* 'Buffer' object, array index exotic behavior, virtual 'length' */
 #define DUK_HOBJECT_FLAG_EXOTIC_PROXYOBJ       DUK_HEAPHDR_USER_FLAG(19)  /* 'Proxy' object */
-/* bit 20 unused */
+#define DUK_HOBJECT_FLAG_WEAKKEY               DUK_HEAPHDR_USER_FLAG(20)  /* object is or has been a WeakMap key or WeakRef target */
 
 #define DUK_HOBJECT_FLAG_CLASS_BASE            DUK_HEAPHDR_USER_FLAG_NUMBER(21)
 #define DUK_HOBJECT_FLAG_CLASS_BITS            5
@@ -89,6 +90,19 @@
 #define DUK_HOBJECT_CLASS_BUFFER               16  /* custom */
 #define DUK_HOBJECT_CLASS_POINTER              17  /* custom */
 #define DUK_HOBJECT_CLASS_THREAD               18  /* custom */
+#define DUK_HOBJECT_CLASS_ARRAYBUFFER          19  /* typed array classes, ES6 */
+#define DUK_HOBJECT_CLASS_DATAVIEW             20
+#define DUK_HOBJECT_CLASS_INT8ARRAY            21
+#define DUK_HOBJECT_CLASS_UINT8ARRAY           22
+#define DUK_HOBJECT_CLASS_UINT8CLAMPEDARRAY    23
+#define DUK_HOBJECT_CLASS_INT16ARRAY           24
+#define DUK_HOBJECT_CLASS_UINT16ARRAY          25
+#define DUK_HOBJECT_CLASS_INT32ARRAY           26
+#define DUK_HOBJECT_CLASS_UINT32ARRAY          27
+#define DUK_HOBJECT_CLASS_FLOAT32ARRAY         28
+#define DUK_HOBJECT_CLASS_FLOAT64ARRAY         29
+#define DUK_HOBJECT_CLASS_WEAKMAP              30  /* weak object classes (duk_hweakobject) */
+#define DUK_HOBJECT_CLASS_WEAKREF              31  /* custom */
 
 #define DUK_HOBJECT_IS_OBJENV(h)               (DUK_HOBJECT_GET_CLASS_NUMBER((h)) == DUK_HOBJECT_CLASS_OBJENV)
 #define DUK_HOBJECT_IS_DECENV(h)               (DUK_HOBJECT_GET_CLASS_NUMBER((h)) == DUK_HOBJECT_CLASS_DECENV)
@@ -97,6 +111,9 @@
 #define DUK_HOBJECT_IS_COMPILEDFUNCTION(h)     DUK_HEAPHDR_CHECK_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_FLAG_COMPILEDFUNCTION)
 #define DUK_HOBJECT_IS_NATIVEFUNCTION(h)       DUK_HEAPHDR_CHECK_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_FLAG_NATIVEFUNCTION)
 #define DUK_HOBJECT_IS_THREAD(h)               DUK_HEAPHDR_CHECK_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_FLAG_THREAD)
+#define DUK_HOBJECT_IS_BUFFEROBJECT(h)         DUK_HEAPHDR_CHECK_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_FLAG_BUFFEROBJECT)
+#define DUK_HOBJECT_IS_WEAKOBJECT(h)           (DUK_HOBJECT_GET_CLASS_NUMBER((h)) == DUK_HOBJECT_CLASS_WEAKMAP || \
+                                                DUK_HOBJECT_GET_CLASS_NUMBER((h)) == DUK_HOBJECT_CLASS_WEAKREF)
 
 #define DUK_HOBJECT_IS_NONBOUND_FUNCTION(h)    DUK_HEAPHDR_CHECK_FLAG_BITS(&(h)->hdr, \
                                                         DUK_HOBJECT_FLAG_COMPILEDFUNCTION | \
@@ -118,6 +135,7 @@
                                                 DUK_HOBJECT_FLAG_EXOTIC_STRINGOBJ | \
                                                 DUK_HOBJECT_FLAG_EXOTIC_DUKFUNC | \
                                                 DUK_HOBJECT_FLAG_EXOTIC_BUFFEROBJ | \
+                                                DUK_HOBJECT_FLAG_BUFFEROBJECT | \
                                                 DUK_HOBJECT_FLAG_EXOTIC_PROXYOBJ)
 
 #define DUK_HOBJECT_HAS_EXOTIC_BEHAVIOR(h)     DUK_HEAPHDR_CHECK_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_EXOTIC_BEHAVIOR_FLAGS)
@@ -125,6 +143,7 @@
 #define DUK_HOBJECT_HAS_EXTENSIBLE(h)          DUK_HEAPHDR_CHECK_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_FLAG_EXTENSIBLE)
 #define DUK_HOBJECT_HAS_CONSTRUCTABLE(h)       DUK_HEAPHDR_CHECK_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_FLAG_CONSTRUCTABLE)
 #define DUK_HOBJECT_HAS_BOUND(h)               DUK_HEAPHDR_CHECK_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_FLAG_BOUND)
+#define DUK_HOBJECT_HAS_BUFFEROBJECT(h)        DUK_HEAPHDR_CHECK_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_FLAG_BUFFEROBJECT)
 #define DUK_HOBJECT_HAS_COMPILEDFUNCTION(h)    DUK_HEAPHDR_CHECK_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_FLAG_COMPILEDFUNCTION)
 #define DUK_HOBJECT_HAS_NATIVEFUNCTION(h)      DUK_HEAPHDR_CHECK_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_FLAG_NATIVEFUNCTION)
 #define DUK_HOBJECT_HAS_THREAD(h)              DUK_HEAPHDR_CHECK_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_FLAG_THREAD)
@@ -141,10 +160,12 @@
 #define DUK_HOBJECT_HAS_EXOTIC_DUKFUNC(h)      DUK_HEAPHDR_CHECK_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_FLAG_EXOTIC_DUKFUNC)
 #define DUK_HOBJECT_HAS_EXOTIC_BUFFEROBJ(h)    DUK_HEAPHDR_CHECK_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_FLAG_EXOTIC_BUFFEROBJ)
 #define DUK_HOBJECT_HAS_EXOTIC_PROXYOBJ(h)     DUK_HEAPHDR_CHECK_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_FLAG_EXOTIC_PROXYOBJ)
+#define DUK_HOBJECT_HAS_WEAKKEY(h)             DUK_HEAPHDR_CHECK_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_FLAG_WEAKKEY)
 
 #define DUK_HOBJECT_SET_EXTENSIBLE(h)          DUK_HEAPHDR_SET_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_FLAG_EXTENSIBLE)
 #define DUK_HOBJECT_SET_CONSTRUCTABLE(h)       DUK_HEAPHDR_SET_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_FLAG_CONSTRUCTABLE)
 #define DUK_HOBJECT_SET_BOUND(h)               DUK_HEAPHDR_SET_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_FLAG_BOUND)
+#define DUK_HOBJECT_SET_BUFFEROBJECT(h)        DUK_HEAPHDR_SET_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_FLAG_BUFFEROBJECT)
 #define DUK_HOBJECT_SET_COMPILEDFUNCTION(h)    DUK_HEAPHDR_SET_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_FLAG_COMPILEDFUNCTION)
 #define DUK_HOBJECT_SET_NATIVEFUNCTION(h)      DUK_HEAPHDR_SET_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_FLAG_NATIVEFUNCTION)
 #define DUK_HOBJECT_SET_THREAD(h)              DUK_HEAPHDR_SET_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_FLAG_THREAD)
@@ -161,10 +182,12 @@
 #define DUK_HOBJECT_SET_EXOTIC_DUKFUNC(h)      DUK_HEAPHDR_SET_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_FLAG_EXOTIC_DUKFUNC)
 #define DUK_HOBJECT_SET_EXOTIC_BUFFEROBJ(h)    DUK_HEAPHDR_SET_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_FLAG_EXOTIC_BUFFEROBJ)
 #define DUK_HOBJECT_SET_EXOTIC_PROXYOBJ(h)     DUK_HEAPHDR_SET_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_FLAG_EXOTIC_PROXYOBJ)
+#define DUK_HOBJECT_SET_WEAKKEY(h)             DUK_HEAPHDR_SET_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_FLAG_WEAKKEY)
 
 #define DUK_HOBJECT_CLEAR_EXTENSIBLE(h)        DUK_HEAPHDR_CLEAR_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_FLAG_EXTENSIBLE)
 #define DUK_HOBJECT_CLEAR_CONSTRUCTABLE(h)     DUK_HEAPHDR_CLEAR_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_FLAG_CONSTRUCTABLE)
 #define DUK_HOBJECT_CLEAR_BOUND(h)             DUK_HEAPHDR_CLEAR_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_FLAG_BOUND)
+#define DUK_HOBJECT_CLEAR_BUFFEROBJECT(h)      DUK_HEAPHDR_CLEAR_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_FLAG_BUFFEROBJECT)
 #define DUK_HOBJECT_CLEAR_COMPILEDFUNCTION(h)  DUK_HEAPHDR_CLEAR_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_FLAG_COMPILEDFUNCTION)
 #define DUK_HOBJECT_CLEAR_NATIVEFUNCTION(h)    DUK_HEAPHDR_CLEAR_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_FLAG_NATIVEFUNCTION)
 #define DUK_HOBJECT_CLEAR_THREAD(h)            DUK_HEAPHDR_CLEAR_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_FLAG_THREAD)
@@ -181,6 +204,7 @@
 #define DUK_HOBJECT_CLEAR_EXOTIC_DUKFUNC(h)    DUK_HEAPHDR_CLEAR_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_FLAG_EXOTIC_DUKFUNC)
 #define DUK_HOBJECT_CLEAR_EXOTIC_BUFFEROBJ(h)  DUK_HEAPHDR_CLEAR_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_FLAG_EXOTIC_BUFFEROBJ)
 #define DUK_HOBJECT_CLEAR_EXOTIC_PROXYOBJ(h)   DUK_HEAPHDR_CLEAR_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_FLAG_EXOTIC_PROXYOBJ)
+#define DUK_HOBJECT_CLEAR_WEAKKEY(h)           DUK_HEAPHDR_CLEAR_FLAG_BITS(&(h)->hdr, DUK_HOBJECT_FLAG_WEAKKEY)
 
 /* flags used for property attributes in duk_propdesc and packed flags */
 #define DUK_PROPDESC_FLAG_WRITABLE              (1 << 0)    /* E5 Section 8.6.1 */
@@ -232,25 +256,25 @@
 
 #if defined(DUK_USE_HOBJECT_LAYOUT_1)
 /* LAYOUT 1 */
-#define DUK_HOBJECT_E_GET_KEY_BASE(h)           \
+#define DUK_HOBJECT_E_GET_KEY_BASE_DICT(h)      \
 	((duk_hstring **) ( \
 		DUK_HOBJECT_GET_PROPS((h)) \
 	))
-#define DUK_HOBJECT_E_GET_VALUE_BASE(h)         \
+#define DUK_HOBJECT_E_GET_VALUE_BASE_DICT(h)    \
 	((duk_propvalue *) ( \
 		DUK_HOBJECT_GET_PROPS((h)) + \
 			DUK_HOBJECT_GET_ESIZE((h)) * sizeof(duk_hstring *) \
 	))
-#define DUK_HOBJECT_E_GET_FLAGS_BASE(h)         \
+#define DUK_HOBJECT_E_GET_FLAGS_BASE_DICT(h)    \
 	((duk_uint8_t *) ( \
 		DUK_HOBJECT_GET_PROPS((h)) + DUK_HOBJECT_GET_ESIZE((h)) * (sizeof(duk_hstring *) + sizeof(duk_propvalue)) \
 	))
-#define DUK_HOBJECT_A_GET_BASE(h)               \
+#define DUK_HOBJECT_A_GET_BASE_DICT(h)          \
 	((duk_tval *) ( \
 		DUK_HOBJECT_GET_PROPS((h)) + \
 			DUK_HOBJECT_GET_ESIZE((h)) * (sizeof(duk_hstring *) + sizeof(duk_propvalue) + sizeof(duk_uint8_t)) \
 	))
-#define DUK_HOBJECT_H_GET_BASE(h)               \
+#define DUK_HOBJECT_H_GET_BASE_DICT(h)          \
 	((duk_uint32_t *) ( \
 		DUK_HOBJECT_GET_PROPS((h)) + \
 			DUK_HOBJECT_GET_ESIZE((h)) * (sizeof(duk_hstring *) + sizeof(duk_propvalue) + sizeof(duk_uint8_t)) + \
@@ -278,26 +302,26 @@
 #else
 #define DUK_HOBJECT_E_FLAG_PADDING(e_sz) 0
 #endif
-#define DUK_HOBJECT_E_GET_KEY_BASE(h)           \
+#define DUK_HOBJECT_E_GET_KEY_BASE_DICT(h)      \
 	((duk_hstring **) ( \
 		DUK_HOBJECT_GET_PROPS((h)) + \
 			DUK_HOBJECT_GET_ESIZE((h)) * sizeof(duk_propvalue) \
 	))
-#define DUK_HOBJECT_E_GET_VALUE_BASE(h)         \
+#define DUK_HOBJECT_E_GET_VALUE_BASE_DICT(h)    \
 	((duk_propvalue *) ( \
 		DUK_HOBJECT_GET_PROPS((h)) \
 	))
-#define DUK_HOBJECT_E_GET_FLAGS_BASE(h)         \
+#define DUK_HOBJECT_E_GET_FLAGS_BASE_DICT(h)    \
 	((duk_uint8_t *) ( \
 		DUK_HOBJECT_GET_PROPS((h)) + DUK_HOBJECT_GET_ESIZE((h)) * (sizeof(duk_hstring *) + sizeof(duk_propvalue)) \
 	))
-#define DUK_HOBJECT_A_GET_BASE(h)               \
+#define DUK_HOBJECT_A_GET_BASE_DICT(h)          \
 	((duk_tval *) ( \
 		DUK_HOBJECT_GET_PROPS((h)) + \
 			DUK_HOBJECT_GET_ESIZE((h)) * (sizeof(duk_hstring *) + sizeof(duk_propvalue) + sizeof(duk_uint8_t)) + \
 			DUK_HOBJECT_E_FLAG_PADDING(DUK_HOBJECT_GET_ESIZE((h))) \
 	))
-#define DUK_HOBJECT_H_GET_BASE(h)               \
+#define DUK_HOBJECT_H_GET_BASE_DICT(h)          \
 	((duk_uint32_t *) ( \
 		DUK_HOBJECT_GET_PROPS((h)) + \
 			DUK_HOBJECT_GET_ESIZE((h)) * (sizeof(duk_hstring *) + sizeof(duk_propvalue) + sizeof(duk_uint8_t)) + \
@@ -322,29 +346,29 @@
 	} while (0)
 #elif defined(DUK_USE_HOBJECT_LAYOUT_3)
 /* LAYOUT 3 */
-#define DUK_HOBJECT_E_GET_KEY_BASE(h)           \
+#define DUK_HOBJECT_E_GET_KEY_BASE_DICT(h)      \
 	((duk_hstring **) ( \
 		DUK_HOBJECT_GET_PROPS((h)) + \
 			DUK_HOBJECT_GET_ESIZE((h)) * sizeof(duk_propvalue) + \
 			DUK_HOBJECT_GET_ASIZE((h)) * sizeof(duk_tval) \
 	))
-#define DUK_HOBJECT_E_GET_VALUE_BASE(h)         \
+#define DUK_HOBJECT_E_GET_VALUE_BASE_DICT(h)    \
 	((duk_propvalue *) ( \
 		DUK_HOBJECT_GET_PROPS((h)) \
 	))
-#define DUK_HOBJECT_E_GET_FLAGS_BASE(h)         \
+#define DUK_HOBJECT_E_GET_FLAGS_BASE_DICT(h)    \
 	((duk_uint8_t *) ( \
 		DUK_HOBJECT_GET_PROPS((h)) + \
 			DUK_HOBJECT_GET_ESIZE((h)) * (sizeof(duk_propvalue) + sizeof(duk_hstring *)) + \
 			DUK_HOBJECT_GET_ASIZE((h)) * sizeof(duk_tval) + \
 			DUK_HOBJECT_GET_HSIZE((h)) * sizeof(duk_uint32_t) \
 	))
-#define DUK_HOBJECT_A_GET_BASE(h)               \
+#define DUK_HOBJECT_A_GET_BASE_DICT(h)          \
 	((duk_tval *) ( \
 		DUK_HOBJECT_GET_PROPS((h)) + \
 			DUK_HOBJECT_GET_ESIZE((h)) * sizeof(duk_propvalue) \
 	))
-#define DUK_HOBJECT_H_GET_BASE(h)               \
+#define DUK_HOBJECT_H_GET_BASE_DICT(h)          \
 	((duk_uint32_t *) ( \
 		DUK_HOBJECT_GET_PROPS((h)) + \
 			DUK_HOBJECT_GET_ESIZE((h)) * (sizeof(duk_propvalue) + sizeof(duk_hstring *)) + \
@@ -367,7 +391,61 @@
 #error invalid hobject layout defines
 #endif  /* hobject property layout */
 
+/*
+ *  Shaped objects (DUK_USE_HOBJECT_SHAPES) keep their entry keys and flags
+ *  in a shared duk_hshape, so that 'props' only contains entry values and
+ *  the optional array part:
+ *
+ *    e_size * sizeof(duk_propvalue)         bytes of   entry values (e_next gc reachable)
+ *    a_size * sizeof(duk_tval)              bytes of   (opt) array values (plain only) (all gc reachable)
+ *
+ *  Shaped objects never have a hash part.  Objects with a NULL shape use
+ *  the normal "dictionary" layout selected above.
+ */
+
+#if defined(DUK_USE_HOBJECT_SHAPES)
+#define DUK_HOBJECT_GET_SHAPE(h)                ((h)->shape)
+#define DUK_HOBJECT_SET_SHAPE(h,v)  do { \
+		(h)->shape = (v); \
+	} while (0)
+#define DUK_HOBJECT_E_GET_KEY_BASE(h)           \
+	(DUK_HOBJECT_GET_SHAPE((h)) != NULL ? \
+		DUK_HOBJECT_GET_SHAPE((h))->keys : \
+		DUK_HOBJECT_E_GET_KEY_BASE_DICT((h)))
+#define DUK_HOBJECT_E_GET_VALUE_BASE(h)         \
+	(DUK_HOBJECT_GET_SHAPE((h)) != NULL ? \
+		(duk_propvalue *) DUK_HOBJECT_GET_PROPS((h)) : \
+		DUK_HOBJECT_E_GET_VALUE_BASE_DICT((h)))
+#define DUK_HOBJECT_E_GET_FLAGS_BASE(h)         \
+	(DUK_HOBJECT_GET_SHAPE((h)) != NULL ? \
+		DUK_HOBJECT_GET_SHAPE((h))->flags : \
+		DUK_HOBJECT_E_GET_FLAGS_BASE_DICT((h)))
+#define DUK_HOBJECT_A_GET_BASE(h)               \
+	(DUK_HOBJECT_GET_SHAPE((h)) != NULL ? \
+		(duk_tval *) (DUK_HOBJECT_GET_PROPS((h)) + \
+			DUK_HOBJECT_GET_ESIZE((h)) * sizeof(duk_propvalue)) : \
+		DUK_HOBJECT_A_GET_BASE_DICT((h)))
+#define DUK_HOBJECT_H_GET_BASE(h)               \
+	DUK_HOBJECT_H_GET_BASE_DICT((h))  /* h_size is always 0 for shaped objects */
+#define DUK_HOBJECT_P_COMPUTE_SIZE_SHAPED(n_ent,n_arr) \
+	( \
+		(n_ent) * sizeof(duk_propvalue) + \
+		(n_arr) * sizeof(duk_tval) \
+	)
+#define DUK_HOBJECT_E_ALLOC_SIZE(h) \
+	(DUK_HOBJECT_GET_SHAPE((h)) != NULL ? \
+		DUK_HOBJECT_P_COMPUTE_SIZE_SHAPED(DUK_HOBJECT_GET_ESIZE((h)), DUK_HOBJECT_GET_ASIZE((h))) : \
+		DUK_HOBJECT_P_COMPUTE_SIZE(DUK_HOBJECT_GET_ESIZE((h)), DUK_HOBJECT_GET_ASIZE((h)), DUK_HOBJECT_GET_HSIZE((h))))
+#define DUK_HOBJECT_ASSERT_NOT_SHAPED(h)        DUK_ASSERT(DUK_HOBJECT_GET_SHAPE((h)) == NULL)
+#else  /* DUK_USE_HOBJECT_SHAPES */
+#define DUK_HOBJECT_E_GET_KEY_BASE(h)           DUK_HOBJECT_E_GET_KEY_BASE_DICT((h))
+#define DUK_HOBJECT_E_GET_VALUE_BASE(h)         DUK_HOBJECT_E_GET_VALUE_BASE_DICT((h))
+#define DUK_HOBJECT_E_GET_FLAGS_BASE(h)         DUK_HOBJECT_E_GET_FLAGS_BASE_DICT((h))
+#define DUK_HOBJECT_A_GET_BASE(h)               DUK_HOBJECT_A_GET_BASE_DICT((h))
+#define DUK_HOBJECT_H_GET_BASE(h)               DUK_HOBJECT_H_GET_BASE_DICT((h))
 #define DUK_HOBJECT_E_ALLOC_SIZE(h) DUK_HOBJECT_P_COMPUTE_SIZE(DUK_HOBJECT_GET_ESIZE((h)), DUK_HOBJECT_GET_ASIZE((h)), DUK_HOBJECT_GET_HSIZE((h)))
+#define DUK_HOBJECT_ASSERT_NOT_SHAPED(h)        do { } while (0)
+#endif  /* DUK_USE_HOBJECT_SHAPES */
 
 #define DUK_HOBJECT_E_GET_KEY(h,i)              (DUK_HOBJECT_E_GET_KEY_BASE((h))[(i)])
 #define DUK_HOBJECT_E_GET_KEY_PTR(h,i)          (&DUK_HOBJECT_E_GET_KEY_BASE((h))[(i)])
@@ -387,6 +465,7 @@
 #define DUK_HOBJECT_H_GET_INDEX_PTR(h,i)        (&DUK_HOBJECT_H_GET_BASE((h))[(i)])
 
 #define DUK_HOBJECT_E_SET_KEY(h,i,k)  do { \
+		DUK_HOBJECT_ASSERT_NOT_SHAPED((h)); \
 		DUK_HOBJECT_E_GET_KEY((h),(i)) = (k); \
 	} while (0)
 #define DUK_HOBJECT_E_SET_VALUE(h,i,v)  do { \
@@ -402,6 +481,7 @@
 		DUK_HOBJECT_E_GET_VALUE((h),(i)).a.set = (v); \
 	} while (0)
 #define DUK_HOBJECT_E_SET_FLAGS(h,i,f)  do { \
+		DUK_HOBJECT_ASSERT_NOT_SHAPED((h)); \
 		DUK_HOBJECT_E_GET_FLAGS((h),(i)) = (f); \
 	} while (0)
 #define DUK_HOBJECT_A_SET_VALUE(h,i,v)  do { \
@@ -413,10 +493,12 @@
 	} while (0)
 
 #define DUK_HOBJECT_E_SET_FLAG_BITS(h,i,mask)  do { \
+		DUK_HOBJECT_ASSERT_NOT_SHAPED((h)); \
 		DUK_HOBJECT_E_GET_FLAGS_BASE((h))[(i)] |= (mask); \
 	} while (0)
 
 #define DUK_HOBJECT_E_CLEAR_FLAG_BITS(h,i,mask)  do { \
+		DUK_HOBJECT_ASSERT_NOT_SHAPED((h)); \
 		DUK_HOBJECT_E_GET_FLAGS_BASE((h))[(i)] &= ~(mask); \
 	} while (0)
 
@@ -623,6 +705,49 @@ struct duk_propdesc {
 	duk_int_t a_idx;	/* prop index in 'array part', < 0 if not there */
 };
 
+/*
+ *  Shape (hidden class) for DUK_USE_HOBJECT_SHAPES.  A shape is an immutable,
+ *  ordered list of entry part keys and their property flags.  Objects which
+ *  get the same properties added in the same order share a single shape, and
+ *  shapes form a transition tree rooted at heap->shape_root: adding a property
+ *  moves an object from its current shape to a child shape with one more key.
+ *
+ *  Shapes are not heap objects.  An object holds a reference to each of its
+ *  own keys as usual (so refcounting and mark-and-sweep handle keys exactly
+ *  like in the dictionary layout), and the shape just borrows them.  A shape
+ *  is referenced by the objects using it and by its child shapes, and it is
+ *  freed when that count drops to zero.  The heap root shape is never freed.
+ *
+ *  Keys and flags are allocated together with the shape struct.
+ *
+ *  A shape may also cache the shape of the enumerator object created for
+ *  its objects (see duk_hobject_enum.c); the cached shape is referenced
+ *  until this shape is freed.
+ *
+ *  Transitions are found with a linear scan of the children, so the number
+ *  of children is capped; an object whose next key would need a transition
+ *  beyond the cap is converted to the dictionary layout.  Shapes are also
+ *  kept below DUK_HOBJECT_E_USE_HASH_LIMIT keys (shaped objects have no
+ *  hash part), which bounds the keys and flags copied into each shape.
+ */
+
+#define DUK_HSHAPE_MAX_CHILDREN  64
+#define DUK_HSHAPE_MAX_COUNT     (DUK_HOBJECT_E_USE_HASH_LIMIT - 1)
+
+struct duk_hshape {
+	duk_hshape *parent;     /* NULL for heap root shape */
+	duk_hshape *child;      /* first transition from this shape */
+	duk_hshape *next;       /* next transition of 'parent' */
+	duk_hshape *prev;       /* previous transition of 'parent' */
+	duk_hstring **keys;     /* 'count' keys */
+	duk_uint8_t *flags;     /* 'count' property flags */
+	duk_uint32_t count;     /* number of keys, matches e_next of objects using the shape */
+	duk_uint32_t refcount;  /* objects and child shapes using this shape */
+	duk_uint32_t child_count;  /* number of transitions, at most DUK_HSHAPE_MAX_CHILDREN */
+	duk_hshape *enum_shape; /* cached enumerator shape, NULL if none */
+	duk_small_uint_t enum_flags;  /* enum flags used for 'enum_shape' */
+};
+
 struct duk_hobject {
 	duk_heaphdr hdr;
 
@@ -707,6 +832,11 @@ struct duk_hobject {
 	duk_hobject *prototype;
 #endif
 
+#if defined(DUK_USE_HOBJECT_SHAPES)
+	/* shared keys and flags, NULL if object uses the dictionary layout */
+	duk_hshape *shape;
+#endif
+
 #if defined(DUK_USE_OBJSIZES16)
 	duk_uint16_t e_size16;
 	duk_uint16_t e_next16;
@@ -743,6 +873,10 @@ DUK_INTERNAL_DECL duk_hobject *duk_hobject_alloc_checked(duk_hthread *thr, duk_u
 #endif
 DUK_INTERNAL_DECL duk_hcompiledfunction *duk_hcompiledfunction_alloc(duk_heap *heap, duk_uint_t hobject_flags);
 DUK_INTERNAL_DECL duk_hnativefunction *duk_hnativefunction_alloc(duk_heap *heap, duk_uint_t hobject_flags);
+DUK_INTERNAL_DECL duk_hbufferobject *duk_hbufferobject_alloc(duk_heap *heap, duk_uint_t hobject_flags);
+#if defined(DUK_USE_WEAK_REFERENCES)
+DUK_INTERNAL_DECL duk_hweakobject *duk_hweakobject_alloc(duk_heap *heap, duk_uint_t hobject_flags);
+#endif
 DUK_INTERNAL_DECL duk_hthread *duk_hthread_alloc(duk_heap *heap, duk_uint_t hobject_flags);
 
 /* low-level property functions */
@@ -781,8 +915,29 @@ DUK_INTERNAL_DECL duk_hstring *duk_hobject_get_internal_value_string(duk_heap *h
 DUK_INTERNAL_DECL duk_hbuffer *duk_hobject_get_internal_value_buffer(duk_heap *heap, duk_hobject *obj);
 
 /* hobject management functions */
+#if defined(DUK_USE_TRACEBACKS)
+DUK_INTERNAL_DECL void duk_hobject_realloc_array_part(duk_hthread *thr, duk_hobject *obj, duk_uint32_t new_a_size);
+#endif
+DUK_INTERNAL_DECL void duk_hobject_realloc_entry_part(duk_hthread *thr, duk_hobject *obj, duk_uint32_t new_e_size);
 DUK_INTERNAL_DECL void duk_hobject_compact_props(duk_hthread *thr, duk_hobject *obj);
 
+/* shapes */
+#if defined(DUK_USE_HOBJECT_SHAPES)
+DUK_INTERNAL_DECL void duk_hobject_unshape(duk_hthread *thr, duk_hobject *obj);
+DUK_INTERNAL_DECL void duk_hobject_extend_to_shape(duk_hthread *thr, duk_hobject *obj, duk_hshape *shape);
+DUK_INTERNAL_DECL duk_hshape *duk_hshape_get_transition(duk_hthread *thr, duk_hshape *shape, duk_hstring *key, duk_small_uint_t flags);
+DUK_INTERNAL_DECL void duk_hshape_decref(duk_heap *heap, duk_hshape *shape);
+#define DUK_HSHAPE_INCREF(s)  do { (s)->refcount++; } while (0)
+/* Convert to dictionary layout before modifying existing keys or flags. */
+#define DUK_HOBJECT_UNSHAPE(thr,h)  do { \
+		if (DUK_HOBJECT_GET_SHAPE((h)) != NULL) { \
+			duk_hobject_unshape((thr), (h)); \
+		} \
+	} while (0)
+#else
+#define DUK_HOBJECT_UNSHAPE(thr,h)  do { } while (0)
+#endif
+
 /* ES6 proxy */
 #if defined(DUK_USE_ES6_PROXY)
 DUK_INTERNAL_DECL duk_bool_t duk_hobject_proxy_check(duk_hthread *thr, duk_hobject *obj, duk_hobject **out_target, duk_hobject **out_handler);
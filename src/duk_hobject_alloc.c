@@ -2,8 +2,9 @@
  *  Hobject allocation.
  *
  *  Provides primitive allocation functions for all object types (plain object,
- *  compiled function, native function, thread).  The object return is not yet
- *  in "heap allocated" list and has a refcount of zero, so caller must careful.
+ *  compiled function, native function, buffer object, weak object, thread).
+ *  The object return is not yet in "heap allocated" list and has a refcount
+ *  of zero, so caller must careful.
  */
 
 #include "duk_internal.h"
@@ -13,6 +14,12 @@ DUK_LOCAL void duk__init_object_parts(duk_heap *heap, duk_hobject *obj, duk_uint
 	DUK_HOBJECT_SET_PROPS(obj, NULL);
 #endif
 
+#if defined(DUK_USE_HOBJECT_SHAPES)
+	/* all objects start out shaped, with the empty root shape */
+	DUK_HOBJECT_SET_SHAPE(obj, &heap->shape_root);
+	DUK_HSHAPE_INCREF(&heap->shape_root);
+#endif
+
 	/* XXX: macro? sets both heaphdr and object flags */
 	obj->hdr.h_flags = hobject_flags;
 	DUK_HEAPHDR_SET_TYPE(&obj->hdr, DUK_HTYPE_OBJECT);  /* also goes into flags */
@@ -53,9 +60,10 @@ DUK_INTERNAL duk_hobject *duk_hobject_alloc(duk_heap *heap, duk_uint_t hobject_f
 	/* different memory layout, alloc size, and init */
 	DUK_ASSERT((hobject_flags & DUK_HOBJECT_FLAG_COMPILEDFUNCTION) == 0);
 	DUK_ASSERT((hobject_flags & DUK_HOBJECT_FLAG_NATIVEFUNCTION) == 0);
+	DUK_ASSERT((hobject_flags & DUK_HOBJECT_FLAG_BUFFEROBJECT) == 0);
 	DUK_ASSERT((hobject_flags & DUK_HOBJECT_FLAG_THREAD) == 0);
 
-	res = (duk_hobject *) DUK_ALLOC(heap, sizeof(duk_hobject));
+	res = (duk_hobject *) DUK_ALLOC_SLAB(heap, sizeof(duk_hobject));
 	if (!res) {
 		return NULL;
 	}
@@ -69,7 +77,10 @@ DUK_INTERNAL duk_hobject *duk_hobject_alloc(duk_heap *heap, duk_uint_t hobject_f
 DUK_INTERNAL duk_hcompiledfunction *duk_hcompiledfunction_alloc(duk_heap *heap, duk_uint_t hobject_flags) {
 	duk_hcompiledfunction *res;
 
-	res = (duk_hcompiledfunction *) DUK_ALLOC(heap, sizeof(duk_hcompiledfunction));
+	/* flag determines the free size, see duk_heap_free_heaphdr_raw() */
+	DUK_ASSERT((hobject_flags & DUK_HOBJECT_FLAG_COMPILEDFUNCTION) != 0);
+
+	res = (duk_hcompiledfunction *) DUK_ALLOC_SLAB(heap, sizeof(duk_hcompiledfunction));
 	if (!res) {
 		return NULL;
 	}
@@ -93,7 +104,10 @@ DUK_INTERNAL duk_hcompiledfunction *duk_hcompiledfunction_alloc(duk_heap *heap,
 DUK_INTERNAL duk_hnativefunction *duk_hnativefunction_alloc(duk_heap *heap, duk_uint_t hobject_flags) {
 	duk_hnativefunction *res;
 
-	res = (duk_hnativefunction *) DUK_ALLOC(heap, sizeof(duk_hnativefunction));
+	/* flag determines the free size, see duk_heap_free_heaphdr_raw() */
+	DUK_ASSERT((hobject_flags & DUK_HOBJECT_FLAG_NATIVEFUNCTION) != 0);
+
+	res = (duk_hnativefunction *) DUK_ALLOC_SLAB(heap, sizeof(duk_hnativefunction));
 	if (!res) {
 		return NULL;
 	}
@@ -108,6 +122,59 @@ DUK_INTERNAL duk_hnativefunction *duk_hnativefunction_alloc(duk_heap *heap, duk_
 	return res;
 }
 
+DUK_INTERNAL duk_hbufferobject *duk_hbufferobject_alloc(duk_heap *heap, duk_uint_t hobject_flags) {
+	duk_hbufferobject *res;
+
+	DUK_ASSERT((hobject_flags & DUK_HOBJECT_FLAG_BUFFEROBJECT) != 0);
+
+	res = (duk_hbufferobject *) DUK_ALLOC_SLAB(heap, sizeof(duk_hbufferobject));
+	if (!res) {
+		return NULL;
+	}
+	DUK_MEMZERO(res, sizeof(duk_hbufferobject));
+
+	duk__init_object_parts(heap, &res->obj, hobject_flags);
+
+#ifdef DUK_USE_EXPLICIT_NULL_INIT
+	res->buf = NULL;
+	res->buf_prop = NULL;
+#endif
+
+	return res;
+}
+
+/* Allocate a weak object (WeakMap, WeakRef) and link it into the heap
+ * weak object list; unlinked when the object is freed.
+ */
+#if defined(DUK_USE_WEAK_REFERENCES)
+DUK_INTERNAL duk_hweakobject *duk_hweakobject_alloc(duk_heap *heap, duk_uint_t hobject_flags) {
+	duk_hweakobject *res;
+
+	res = (duk_hweakobject *) DUK_ALLOC_SLAB(heap, sizeof(duk_hweakobject));
+	if (!res) {
+		return NULL;
+	}
+	DUK_MEMZERO(res, sizeof(duk_hweakobject));
+
+	duk__init_object_parts(heap, &res->obj, hobject_flags);
+
+	/* class number determines the free size, see duk_heap_free_heaphdr_raw() */
+	DUK_ASSERT(DUK_HOBJECT_IS_WEAKOBJECT(&res->obj));
+
+#ifdef DUK_USE_EXPLICIT_NULL_INIT
+	res->prev = NULL;
+	res->entries = NULL;
+#endif
+	res->next = heap->weak_objects;
+	if (heap->weak_objects != NULL) {
+		heap->weak_objects->prev = res;
+	}
+	heap->weak_objects = res;
+
+	return res;
+}
+#endif  /* DUK_USE_WEAK_REFERENCES */
+
 /*
  *  Allocate a new thread.
  *
@@ -119,7 +186,10 @@ DUK_INTERNAL duk_hnativefunction *duk_hnativefunction_alloc(duk_heap *heap, duk_
 DUK_INTERNAL duk_hthread *duk_hthread_alloc(duk_heap *heap, duk_uint_t hobject_flags) {
 	duk_hthread *res;
 
-	res = (duk_hthread *) DUK_ALLOC(heap, sizeof(duk_hthread));
+	/* flag determines the free size, see duk_heap_free_heaphdr_raw() */
+	DUK_ASSERT((hobject_flags & DUK_HOBJECT_FLAG_THREAD) != 0);
+
+	res = (duk_hthread *) DUK_ALLOC_SLAB(heap, sizeof(duk_hthread));
 	if (!res) {
 		return NULL;
 	}
@@ -15,15 +15,37 @@
  *  the enumeration target, running multiple long-lived enumerators at the
  *  same time, garbage collection details, etc.  The downside is that the
  *  enumerator object is memory inefficient especially for iterating arrays.
+ *
+ *  Two shortcuts reduce the snapshot cost:
+ *
+ *    - When the target has a dense array part (indices [0,N) in use), the
+ *      index keys are not added to the enumerator.  The enumerator gets an
+ *      internal _Limit property (N) and index keys are created on the fly
+ *      by duk_hobject_enumerator_next().
+ *
+ *    - With DUK_USE_HOBJECT_SHAPES, the target's shape caches the shape of
+ *      the resulting enumerator object.  When the key list only depends on
+ *      the target's shape, a later enumeration of an object with the same
+ *      shape creates the enumerator directly from the cached shape.
  */
 
 #include "duk_internal.h"
 
 /* XXX: identify enumeration target with an object index (not top of stack) */
 
-/* must match exactly the number of internal properties inserted to enumerator */
+/* must match exactly the number of internal properties inserted to enumerator
+ * (not counting _Limit which is only present for the dense array fast path)
+ */
 #define DUK__ENUM_START_INDEX  2
 
+/* Enumeration flags for which the enumerator key list may be cached.  Other
+ * flags (internal keys, array index filtering and sorting) are uncommon and
+ * are always handled by the slow path.
+ */
+#define DUK__ENUM_CACHE_FLAGS  (DUK_ENUM_OWN_PROPERTIES_ONLY | \
+                                DUK_ENUM_INCLUDE_NONENUMERABLE | \
+                                DUK_ENUM_NO_PROXY_BEHAVIOR)
+
 /*
  *  Helper to sort array index keys.  The keys are in the enumeration object
  *  entry part, starting from DUK__ENUM_START_INDEX, and the entry part is dense.
@@ -40,14 +62,15 @@
  *    "1" -> true, "3" -> true, "2" -> true
  *
  *  so it suffices to only work in the key part without exchanging any keys,
- *  simplifying the sort.
+ *  simplifying the sort.  Keys are modified in place so a shaped object must
+ *  first be converted to the dictionary layout.
  *
  *  http://en.wikipedia.org/wiki/Insertion_sort
  *
  *  (Compiles to about 160 bytes now as a stand-alone function.)
  */
 
-DUK_LOCAL void duk__sort_array_indices(duk_hobject *h_obj) {
+DUK_LOCAL void duk__sort_array_indices(duk_hthread *thr, duk_hobject *h_obj) {
 	duk_hstring **keys;
 	duk_hstring **p_curr, **p_insert, **p_end;
 	duk_hstring *h_curr;
@@ -60,6 +83,9 @@ DUK_LOCAL void duk__sort_array_indices(duk_hobject *h_obj) {
 		return;
 	}
 
+	DUK_HOBJECT_UNSHAPE(thr, h_obj);
+	DUK_UNREF(thr);
+
 	keys = DUK_HOBJECT_E_GET_KEY_BASE(h_obj);
 	p_end = keys + DUK_HOBJECT_GET_ENEXT(h_obj);
 	keys += DUK__ENUM_START_INDEX;
@@ -150,6 +176,157 @@ DUK_LOCAL void duk__sort_array_indices(duk_hobject *h_obj) {
 #endif
 }
 
+/*
+ *  Dense array fast path: return N if the array part of 'obj' has exactly
+ *  the indices [0,N) in use, zero otherwise.  Prototype keys would need to
+ *  be merged with the index range if sorting is requested, so the fast path
+ *  is not used in that case.
+ */
+
+DUK_LOCAL duk_uint32_t duk__get_dense_array_limit(duk_hobject *obj, duk_small_uint_t enum_flags) {
+	duk_uint_fast32_t i, a_size;
+	duk_uint32_t limit;
+
+	DUK_ASSERT(obj != NULL);
+
+	if (DUK_HOBJECT_HAS_EXOTIC_STRINGOBJ(obj) ||
+	    DUK_HOBJECT_HAS_EXOTIC_BUFFEROBJ(obj)) {
+		return 0;
+	}
+	if ((enum_flags & DUK_ENUM_SORT_ARRAY_INDICES) &&
+	    !(enum_flags & DUK_ENUM_OWN_PROPERTIES_ONLY)) {
+		return 0;
+	}
+
+	a_size = (duk_uint_fast32_t) DUK_HOBJECT_GET_ASIZE(obj);
+	for (i = 0; i < a_size; i++) {
+		if (DUK_TVAL_IS_UNDEFINED_UNUSED(DUK_HOBJECT_A_GET_VALUE_PTR(obj, i))) {
+			break;
+		}
+	}
+	limit = (duk_uint32_t) i;
+	for (; i < a_size; i++) {
+		if (!DUK_TVAL_IS_UNDEFINED_UNUSED(DUK_HOBJECT_A_GET_VALUE_PTR(obj, i))) {
+			return 0;
+		}
+	}
+	return limit;
+}
+
+/* Get the dense array limit of an enumerator object, zero if not used. */
+DUK_LOCAL duk_uint32_t duk__get_enum_array_limit(duk_hthread *thr, duk_hobject *e) {
+	duk_tval *tv;
+
+	if (DUK_HOBJECT_GET_ENEXT(e) > DUK__ENUM_START_INDEX &&
+	    DUK_HOBJECT_E_GET_KEY(e, DUK__ENUM_START_INDEX) == DUK_HTHREAD_STRING_INT_LIMIT(thr)) {
+		tv = DUK_HOBJECT_E_GET_VALUE_TVAL_PTR(e, DUK__ENUM_START_INDEX);
+		DUK_ASSERT(DUK_TVAL_IS_NUMBER(tv));
+		return (duk_uint32_t) DUK_TVAL_GET_NUMBER(tv);
+	}
+	return 0;
+}
+
+#if defined(DUK_USE_HOBJECT_SHAPES)
+/*
+ *  Enumeration cache.  The enumerator key list depends only on the target's
+ *  shape if the target has no virtual keys or array part entries, and no
+ *  object in the prototype chain contributes any keys.  In that case return
+ *  the target's shape, otherwise NULL.
+ *
+ *  The prototype chain is checked on every call instead of being part of the
+ *  cache key, so modifying a prototype needs no explicit invalidation.
+ */
+
+DUK_LOCAL duk_hshape *duk__enum_cache_check(duk_hthread *thr, duk_hobject *enum_target, duk_small_uint_t enum_flags) {
+	duk_hshape *shape;
+	duk_hobject *curr;
+	duk_uint_fast32_t i;
+
+	if (enum_flags & ~DUK__ENUM_CACHE_FLAGS) {
+		return NULL;
+	}
+	shape = DUK_HOBJECT_GET_SHAPE(enum_target);
+	if (shape == NULL || shape == &thr->heap->shape_root) {
+		return NULL;
+	}
+
+	curr = enum_target;
+	for (;;) {
+		if (DUK_HOBJECT_HAS_EXOTIC_STRINGOBJ(curr) ||
+		    DUK_HOBJECT_HAS_EXOTIC_BUFFEROBJ(curr) ||
+		    DUK_HOBJECT_HAS_BUFFEROBJECT(curr)) {
+			return NULL;
+		}
+		if ((enum_flags & DUK_ENUM_INCLUDE_NONENUMERABLE) &&
+		    DUK_HOBJECT_HAS_EXOTIC_DUKFUNC(curr)) {
+			return NULL;
+		}
+		for (i = 0; i < (duk_uint_fast32_t) DUK_HOBJECT_GET_ASIZE(curr); i++) {
+			if (!DUK_TVAL_IS_UNDEFINED_UNUSED(DUK_HOBJECT_A_GET_VALUE_PTR(curr, i))) {
+				return NULL;
+			}
+		}
+
+		if (enum_flags & DUK_ENUM_OWN_PROPERTIES_ONLY) {
+			break;
+		}
+		curr = DUK_HOBJECT_GET_PROTOTYPE(curr);
+		if (curr == NULL) {
+			break;
+		}
+
+		for (i = 0; i < (duk_uint_fast32_t) DUK_HOBJECT_GET_ENEXT(curr); i++) {
+			duk_hstring *k;
+
+			k = DUK_HOBJECT_E_GET_KEY(curr, i);
+			if (k == NULL || DUK_HSTRING_HAS_INTERNAL(k)) {
+				continue;
+			}
+			if (!DUK_HOBJECT_E_SLOT_IS_ENUMERABLE(curr, i) &&
+			    !(enum_flags & DUK_ENUM_INCLUDE_NONENUMERABLE)) {
+				continue;
+			}
+			return NULL;
+		}
+	}
+
+	return shape;
+}
+
+DUK_LOCAL void duk__enum_cache_store(duk_hthread *thr, duk_hshape *shape, duk_hobject *e, duk_small_uint_t enum_flags) {
+	duk_hshape *enum_shape;
+	duk_hshape *old_shape;
+	duk_hshape *t;
+
+	enum_shape = DUK_HOBJECT_GET_SHAPE(e);
+	if (enum_shape == NULL) {
+		/* too many keys for a shape */
+		return;
+	}
+
+	/* An enumerator shape which is the shape itself or one of its
+	 * descendants (only possible for objects with enumerator-like
+	 * internal keys) would create a reference loop.
+	 */
+	for (t = enum_shape; t != NULL; t = t->parent) {
+		if (t == shape) {
+			return;
+		}
+	}
+
+	DUK_DDD(DUK_DDDPRINT("enumeration cache store: shape %p -> enum shape %p, flags 0x%lx",
+	                     (void *) shape, (void *) enum_shape, (unsigned long) enum_flags));
+
+	old_shape = shape->enum_shape;
+	DUK_HSHAPE_INCREF(enum_shape);
+	shape->enum_shape = enum_shape;
+	shape->enum_flags = enum_flags;
+	if (old_shape) {
+		duk_hshape_decref(thr->heap, old_shape);
+	}
+}
+#endif  /* DUK_USE_HOBJECT_SHAPES */
+
 /*
  *  Create an internal enumerator object E, which has its keys ordered
  *  to match desired enumeration ordering.  Also initialize internal control
@@ -169,12 +346,20 @@ DUK_INTERNAL void duk_hobject_enumerator_create(duk_context *ctx, duk_small_uint
 	duk_hobject *h_proxy_handler;
 	duk_hobject *h_trap_result;
 #endif
+#if defined(DUK_USE_HOBJECT_SHAPES)
+	duk_hshape *cache_shape;
+#endif
+	duk_uint32_t arr_limit;
 	duk_uint_fast32_t i, len;  /* used for array, stack, and entry indices */
 
 	DUK_ASSERT(ctx != NULL);
 
 	DUK_DDD(DUK_DDDPRINT("create enumerator, stack top: %ld", (long) duk_get_top(ctx)));
 
+#if defined(DUK_USE_HOBJECT_SHAPES)
+	cache_shape = NULL;
+#endif
+
 	enum_target = duk_require_hobject(ctx, -1);
 	DUK_ASSERT(enum_target != NULL);
 
@@ -276,6 +461,41 @@ DUK_INTERNAL void duk_hobject_enumerator_create(duk_context *ctx, duk_small_uint
  skip_proxy:
 #endif  /* DUK_USE_ES6_PROXY */
 
+#if defined(DUK_USE_HOBJECT_SHAPES)
+	cache_shape = duk__enum_cache_check(thr, enum_target, enum_flags);
+	if (cache_shape != NULL &&
+	    cache_shape->enum_shape != NULL &&
+	    cache_shape->enum_flags == enum_flags &&
+	    DUK_HOBJECT_GET_SHAPE(res) != NULL &&
+	    DUK_HOBJECT_GET_ENEXT(res) == DUK__ENUM_START_INDEX) {
+		duk_hshape *enum_shape = cache_shape->enum_shape;
+
+		DUK_DDD(DUK_DDDPRINT("enumeration cache hit, enum shape %p", (void *) enum_shape));
+
+		/* [enum_target res] */
+
+		duk_hobject_extend_to_shape(thr, res, enum_shape);
+		for (i = DUK__ENUM_START_INDEX; i < (duk_uint_fast32_t) enum_shape->count; i++) {
+			DUK_TVAL_SET_BOOLEAN_TRUE(DUK_HOBJECT_E_GET_VALUE_TVAL_PTR(res, i));
+		}
+		duk_remove(ctx, -2);
+		goto done;
+	}
+#endif
+
+	arr_limit = duk__get_dense_array_limit(enum_target, enum_flags);
+	if (arr_limit > 0) {
+		DUK_DDD(DUK_DDDPRINT("dense array part, limit %ld", (long) arr_limit));
+
+		/* _Limit must be the first key after the other control keys;
+		 * _Next becomes a virtual index, see duk_hobject_enumerator_next().
+		 */
+		duk_push_uint(ctx, (duk_uint_t) arr_limit);
+		duk_put_prop_stridx(ctx, -2, DUK_STRIDX_INT_LIMIT);
+		duk_push_int(ctx, 0);
+		duk_put_prop_stridx(ctx, -2, DUK_STRIDX_INT_NEXT);
+	}
+
 	curr = enum_target;
 	while (curr) {
 		/*
@@ -304,7 +524,7 @@ DUK_INTERNAL void duk_hobject_enumerator_create(duk_context *ctx, duk_small_uint
 				len = (duk_uint_fast32_t) DUK_HBUFFER_GET_SIZE(h_val);
 			}
 
-			for (i = 0; i < len; i++) {
+			for (i = arr_limit; i < len; i++) {
 				duk_hstring *k;
 
 				k = duk_heap_string_intern_u32_checked(thr, i);
@@ -327,6 +547,43 @@ DUK_INTERNAL void duk_hobject_enumerator_create(duk_context *ctx, duk_small_uint
 				duk_push_true(ctx);
 				duk_put_prop(ctx, -3);
 			}
+		} else if (DUK_HOBJECT_HAS_BUFFEROBJECT(curr)) {
+			duk_hbufferobject *h_bufobj = (duk_hbufferobject *) curr;
+
+			/* Typed array indices are enumerable, other virtual
+			 * properties ('length', 'byteLength' etc) are not.
+			 */
+			if (h_bufobj->is_typedarray && DUK_HBUFFEROBJECT_VALID_SLICE(h_bufobj)) {
+				len = (duk_uint_fast32_t) DUK_HBUFFEROBJECT_GET_ELEM_COUNT(h_bufobj);
+				for (i = 0; i < len; i++) {
+					duk_hstring *k;
+
+					k = duk_heap_string_intern_u32_checked(thr, i);
+					DUK_ASSERT(k);
+					duk_push_hstring(ctx, k);
+					duk_push_true(ctx);
+					duk_put_prop(ctx, -3);
+				}
+			}
+
+			if (enum_flags & DUK_ENUM_INCLUDE_NONENUMERABLE) {
+				if (h_bufobj->is_typedarray) {
+					duk_push_hstring_stridx(ctx, DUK_STRIDX_LENGTH);
+					duk_push_true(ctx);
+					duk_put_prop(ctx, -3);
+				}
+				duk_push_hstring_stridx(ctx, DUK_STRIDX_BYTE_LENGTH);
+				duk_push_true(ctx);
+				duk_put_prop(ctx, -3);
+				if (DUK_HOBJECT_GET_CLASS_NUMBER(curr) != DUK_HOBJECT_CLASS_ARRAYBUFFER) {
+					duk_push_hstring_stridx(ctx, DUK_STRIDX_BYTE_OFFSET);
+					duk_push_true(ctx);
+					duk_put_prop(ctx, -3);
+					duk_push_hstring_stridx(ctx, DUK_STRIDX_LC_BUFFER);
+					duk_push_true(ctx);
+					duk_put_prop(ctx, -3);
+				}
+			}
 		} else if (DUK_HOBJECT_HAS_EXOTIC_DUKFUNC(curr)) {
 			if (enum_flags & DUK_ENUM_INCLUDE_NONENUMERABLE) {
 				duk_push_hstring_stridx(ctx, DUK_STRIDX_LENGTH);
@@ -343,7 +600,14 @@ DUK_INTERNAL void duk_hobject_enumerator_create(duk_context *ctx, duk_small_uint
 		 *  must be the same.
 		 */
 
-		for (i = 0; i < (duk_uint_fast32_t) DUK_HOBJECT_GET_ASIZE(curr); i++) {
+		i = 0;
+		if (arr_limit > 0) {
+			/* target indices [0,arr_limit[ are enumerated by
+			 * duk_hobject_enumerator_next() and must not be duplicated
+			 */
+			i = (curr == enum_target ? DUK_HOBJECT_GET_ASIZE(curr) : arr_limit);
+		}
+		for (; i < (duk_uint_fast32_t) DUK_HOBJECT_GET_ASIZE(curr); i++) {
 			duk_hstring *k;
 			duk_tval *tv;
 
@@ -386,6 +650,11 @@ DUK_INTERNAL void duk_hobject_enumerator_create(duk_context *ctx, duk_small_uint
 			    (DUK_HSTRING_GET_ARRIDX_SLOW(k) == DUK_HSTRING_NO_ARRAY_INDEX)) {
 				continue;
 			}
+			if (arr_limit > 0 &&
+			    DUK_HSTRING_HAS_ARRIDX(k) &&
+			    DUK_HSTRING_GET_ARRIDX_SLOW(k) < arr_limit) {
+				continue;
+			}
 
 			DUK_ASSERT(DUK_HOBJECT_E_SLOT_IS_ACCESSOR(curr, i) ||
 			           !DUK_TVAL_IS_UNDEFINED_UNUSED(&DUK_HOBJECT_E_GET_VALUE_PTR(curr, i)->v));
@@ -413,7 +682,8 @@ DUK_INTERNAL void duk_hobject_enumerator_create(duk_context *ctx, duk_small_uint
 	/* [res] */
 
 	if ((enum_flags & (DUK_ENUM_ARRAY_INDICES_ONLY | DUK_ENUM_SORT_ARRAY_INDICES)) ==
-	                  (DUK_ENUM_ARRAY_INDICES_ONLY | DUK_ENUM_SORT_ARRAY_INDICES)) {
+	                  (DUK_ENUM_ARRAY_INDICES_ONLY | DUK_ENUM_SORT_ARRAY_INDICES) &&
+	    arr_limit == 0) {
 		/*
 		 *  Some E5/E5.1 algorithms require that array indices are iterated
 		 *  in a strictly ascending order.  This is the case for e.g.
@@ -423,7 +693,8 @@ DUK_INTERNAL void duk_hobject_enumerator_create(duk_context *ctx, duk_small_uint
 		 *  To ensure this property for arrays with an array part (and
 		 *  arbitrary objects too, since e.g. forEach() can be applied
 		 *  to an array), the caller can request that we sort the keys
-		 *  here.
+		 *  here.  The dense array fast path is only used when the result
+		 *  is already sorted.
 		 */
 
 		/* XXX: avoid this at least when enum_target is an Array, it has an
@@ -434,7 +705,7 @@ DUK_INTERNAL void duk_hobject_enumerator_create(duk_context *ctx, duk_small_uint
 		/* XXX: may need a 'length' filter for forEach()
 		 */
 		DUK_DDD(DUK_DDDPRINT("sort array indices by caller request"));
-		duk__sort_array_indices(res);
+		duk__sort_array_indices(thr, res);
 	}
 
 #if defined(DUK_USE_ES6_PROXY)
@@ -443,6 +714,16 @@ DUK_INTERNAL void duk_hobject_enumerator_create(duk_context *ctx, duk_small_uint
 	/* compact; no need to seal because object is internal */
 	duk_hobject_compact_props(thr, res);
 
+#if defined(DUK_USE_HOBJECT_SHAPES)
+	/* enum_target is still reachable through res._Target; if its shape
+	 * changed while the enumerator was built, don't cache the result.
+	 */
+	if (cache_shape != NULL && DUK_HOBJECT_GET_SHAPE(enum_target) == cache_shape) {
+		duk__enum_cache_store(thr, cache_shape, res, enum_flags);
+	}
+
+ done:
+#endif
 	DUK_DDD(DUK_DDDPRINT("created enumerator object: %!iT", (duk_tval *) duk_get_tval(ctx, -1)));
 }
 
@@ -459,7 +740,10 @@ DUK_INTERNAL duk_bool_t duk_hobject_enumerator_next(duk_context *ctx, duk_bool_t
 	duk_hobject *e;
 	duk_hobject *enum_target;
 	duk_hstring *res = NULL;
+	duk_tval *tv;
 	duk_uint_fast32_t idx;
+	duk_uint_fast32_t e_idx;
+	duk_uint32_t arr_limit;
 	duk_bool_t check_existence;
 
 	DUK_ASSERT(ctx != NULL);
@@ -468,10 +752,15 @@ DUK_INTERNAL duk_bool_t duk_hobject_enumerator_next(duk_context *ctx, duk_bool_t
 
 	e = duk_require_hobject(ctx, -1);
 
-	/* XXX use get tval ptr, more efficient */
-	duk_get_prop_stridx(ctx, -1, DUK_STRIDX_INT_NEXT);
-	idx = (duk_uint_fast32_t) duk_require_uint(ctx, -1);
-	duk_pop(ctx);
+	/* The control properties are read and written directly: this avoids
+	 * property calls and, more importantly, any allocation between
+	 * interning an array index key below and pushing it to the stack.
+	 */
+	tv = duk_hobject_find_existing_entry_tval_ptr(e, DUK_HTHREAD_STRING_INT_NEXT(thr));
+	if (!tv || !DUK_TVAL_IS_NUMBER(tv)) {
+		DUK_ERROR(thr, DUK_ERR_TYPE_ERROR, DUK_STR_NOT_NUMBER);
+	}
+	idx = (duk_uint_fast32_t) DUK_TVAL_GET_NUMBER(tv);
 	DUK_DDD(DUK_DDDPRINT("enumeration: index is: %ld", (long) idx));
 
 	/* Enumeration keys are checked against the enumeration target (to see
@@ -479,33 +768,63 @@ DUK_INTERNAL duk_bool_t duk_hobject_enumerator_next(duk_context *ctx, duk_bool_t
 	 * be the proxy, and checking key existence against the proxy is not
 	 * required (or sensible, as the keys may be fully virtual).
 	 */
-	duk_get_prop_stridx(ctx, -1, DUK_STRIDX_INT_TARGET);
-	enum_target = duk_require_hobject(ctx, -1);
+	tv = duk_hobject_find_existing_entry_tval_ptr(e, DUK_HTHREAD_STRING_INT_TARGET(thr));
+	if (!tv || !DUK_TVAL_IS_OBJECT(tv)) {
+		DUK_ERROR(thr, DUK_ERR_TYPE_ERROR, DUK_STR_UNEXPECTED_TYPE);
+	}
+	enum_target = DUK_TVAL_GET_OBJECT(tv);  /* reachable through enumerator */
 	DUK_ASSERT(enum_target != NULL);
 #if defined(DUK_USE_ES6_PROXY)
 	check_existence = (!DUK_HOBJECT_HAS_EXOTIC_PROXYOBJ(enum_target));
 #else
 	check_existence = 1;
 #endif
-	duk_pop(ctx);  /* still reachable */
 
 	DUK_DDD(DUK_DDDPRINT("getting next enum value, enum_target=%!iO, enumerator=%!iT",
 	                     (duk_heaphdr *) enum_target, (duk_tval *) duk_get_tval(ctx, -1)));
 
+	/* With the dense array fast path the index is virtual: [0,arr_limit[
+	 * are array indices of the target, followed by the enumerator entry
+	 * keys starting after _Limit.  Otherwise the index is an entry index.
+	 */
+	arr_limit = duk__get_enum_array_limit(thr, e);
+
 	/* no array part */
 	for (;;) {
 		duk_hstring *k;
 
-		if (idx >= DUK_HOBJECT_GET_ENEXT(e)) {
+		if (idx < arr_limit) {
+			duk_bool_t exists;
+
+			exists = (idx < DUK_HOBJECT_GET_ASIZE(enum_target) &&
+			          !DUK_TVAL_IS_UNDEFINED_UNUSED(DUK_HOBJECT_A_GET_VALUE_PTR(enum_target, idx)));
+
+			/* no side effects until the key is pushed below */
+			k = duk_heap_string_intern_u32_checked(thr, (duk_uint32_t) idx);
+			DUK_ASSERT(k != NULL);
+			idx++;
+
+			if (!exists && check_existence && !duk_hobject_hasprop_raw(thr, enum_target, k)) {
+				DUK_DDD(DUK_DDDPRINT("array index deleted during enumeration, skip"));
+				continue;
+			}
+
+			DUK_DDD(DUK_DDDPRINT("enumeration: found array index, key: %!O", (duk_heaphdr *) k));
+			res = k;
+			break;
+		}
+
+		e_idx = (arr_limit > 0 ? idx - arr_limit + DUK__ENUM_START_INDEX + 1 : idx);
+		if (e_idx >= DUK_HOBJECT_GET_ENEXT(e)) {
 			DUK_DDD(DUK_DDDPRINT("enumeration: ran out of elements"));
 			break;
 		}
 
 		/* we know these because enum objects are internally created */
-		k = DUK_HOBJECT_E_GET_KEY(e, idx);
+		k = DUK_HOBJECT_E_GET_KEY(e, e_idx);
 		DUK_ASSERT(k != NULL);
-		DUK_ASSERT(!DUK_HOBJECT_E_SLOT_IS_ACCESSOR(e, idx));
-		DUK_ASSERT(!DUK_TVAL_IS_UNDEFINED_UNUSED(&DUK_HOBJECT_E_GET_VALUE(e, idx).v));
+		DUK_ASSERT(!DUK_HOBJECT_E_SLOT_IS_ACCESSOR(e, e_idx));
+		DUK_ASSERT(!DUK_TVAL_IS_UNDEFINED_UNUSED(&DUK_HOBJECT_E_GET_VALUE(e, e_idx).v));
 
 		idx++;
 
@@ -522,8 +841,13 @@ DUK_INTERNAL duk_bool_t duk_hobject_enumerator_next(duk_context *ctx, duk_bool_t
 
 	DUK_DDD(DUK_DDDPRINT("enumeration: updating next index to %ld", (long) idx));
 
-	duk_push_number(ctx, (double) idx);
-	duk_put_prop_stridx(ctx, -2, DUK_STRIDX_INT_NEXT);
+	/* The previous value is a number so no refcount update is needed.
+	 * Look up the slot again: hasprop checks above may have side effects
+	 * (e.g. GC compacting the enumerator).
+	 */
+	tv = duk_hobject_find_existing_entry_tval_ptr(e, DUK_HTHREAD_STRING_INT_NEXT(thr));
+	DUK_ASSERT(tv != NULL && DUK_TVAL_IS_NUMBER(tv));
+	DUK_TVAL_SET_NUMBER(tv, (duk_double_t) idx);
 
 	/* [... enum] */
 
@@ -551,9 +875,11 @@ DUK_INTERNAL duk_bool_t duk_hobject_enumerator_next(duk_context *ctx, duk_bool_t
  */
 
 DUK_INTERNAL duk_ret_t duk_hobject_get_enumerated_keys(duk_context *ctx, duk_small_uint_t enum_flags) {
+	duk_hthread *thr = (duk_hthread *) ctx;
 	duk_hobject *e;
 	duk_uint_fast32_t i;
 	duk_uint_fast32_t idx;
+	duk_uint32_t arr_limit;
 
 	DUK_ASSERT(ctx != NULL);
 	DUK_ASSERT(duk_get_hobject(ctx, -1) != NULL);
@@ -572,7 +898,16 @@ DUK_INTERNAL duk_ret_t duk_hobject_get_enumerated_keys(duk_context *ctx, duk_sma
 	DUK_ASSERT(e != NULL);
 
 	idx = 0;
-	for (i = DUK__ENUM_START_INDEX; i < (duk_uint_fast32_t) DUK_HOBJECT_GET_ENEXT(e); i++) {
+	arr_limit = duk__get_enum_array_limit(thr, e);
+	for (i = 0; i < (duk_uint_fast32_t) arr_limit; i++) {
+		/* dense array part indices */
+		duk_push_hstring(ctx, duk_heap_string_intern_u32_checked(thr, (duk_uint32_t) i));
+		duk_put_prop_index(ctx, -2, idx);
+		idx++;
+	}
+
+	i = (arr_limit > 0 ? DUK__ENUM_START_INDEX + 1 : DUK__ENUM_START_INDEX);
+	for (; i < (duk_uint_fast32_t) DUK_HOBJECT_GET_ENEXT(e); i++) {
 		duk_hstring *k;
 
 		k = DUK_HOBJECT_E_GET_KEY(e, i);
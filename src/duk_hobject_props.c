@@ -124,6 +124,21 @@ DUK_LOCAL duk_uint32_t duk__push_tval_to_hstring_arr_idx(duk_context *ctx, duk_t
 	DUK_ASSERT(tv != NULL);
 	DUK_ASSERT(out_h != NULL);
 
+#if defined(DUK_USE_INTSTR_CACHE)
+	/* Small integer keys are common for objects without an array part
+	 * (or beyond it); skip the coercion and use the cached string.
+	 */
+	if (DUK_TVAL_IS_NUMBER(tv)) {
+		arr_idx = duk__tval_number_to_arr_idx(tv);
+		if (arr_idx < DUK_USE_INTSTR_CACHE_SIZE) {
+			h = duk_heap_string_intern_u32_checked((duk_hthread *) ctx, arr_idx);
+			duk_push_hstring(ctx, h);
+			*out_h = h;
+			return arr_idx;
+		}
+	}
+#endif
+
 	duk_push_tval(ctx, tv);
 	duk_to_string(ctx, -1);
 	h = duk_get_hstring(ctx, -1);
@@ -425,6 +440,11 @@ DUK_LOCAL duk_bool_t duk__proxy_check_prop(duk_hthread *thr, duk_hobject *obj, d
  *  Note: because we need to potentially resize the valstack (as part
  *  of abandoning the array part), any tval pointers to the valstack
  *  will become invalid after this call.
+ *
+ *  Note: a shaped object (DUK_USE_HOBJECT_SHAPES) keeps its shape and only
+ *  its values are reallocated, unless the resize abandons the array part,
+ *  needs a hash part, or the caller requests 'unshape'.  In these cases the
+ *  object is converted into the dictionary layout.
  */
 
 DUK_LOCAL
@@ -433,7 +453,8 @@ void duk__realloc_props(duk_hthread *thr,
                         duk_uint32_t new_e_size,
                         duk_uint32_t new_a_size,
                         duk_uint32_t new_h_size,
-                        duk_bool_t abandon_array) {
+                        duk_bool_t abandon_array,
+                        duk_bool_t unshape) {
 	duk_context *ctx = (duk_context *) thr;
 #ifdef DUK_USE_MARK_AND_SWEEP
 	duk_small_uint_t prev_mark_and_sweep_base_flags;
@@ -448,11 +469,15 @@ void duk__realloc_props(duk_hthread *thr,
 	duk_uint32_t *new_h;
 	duk_uint32_t new_e_next;
 	duk_uint_fast32_t i;
+#if defined(DUK_USE_HOBJECT_SHAPES)
+	duk_bool_t new_shaped;
+#endif
 
 	DUK_ASSERT(thr != NULL);
 	DUK_ASSERT(ctx != NULL);
 	DUK_ASSERT(obj != NULL);
 	DUK_ASSERT(!abandon_array || new_a_size == 0);  /* if abandon_array, new_a_size must be 0 */
+	DUK_UNREF(unshape);
 	DUK_ASSERT(DUK_HOBJECT_GET_PROPS(obj) != NULL || (DUK_HOBJECT_GET_ESIZE(obj) == 0 && DUK_HOBJECT_GET_ASIZE(obj) == 0));
 	DUK_ASSERT(new_h_size == 0 || new_h_size >= new_e_size);  /* required to guarantee success of rehashing,
 	                                                           * intentionally use unadjusted new_e_size
@@ -467,6 +492,12 @@ void duk__realloc_props(duk_hthread *thr,
 	/* XXX: pre-checks (such as no duplicate keys) */
 #endif
 
+#if defined(DUK_USE_HOBJECT_SHAPES)
+	new_shaped = (DUK_HOBJECT_GET_SHAPE(obj) != NULL &&
+	              !unshape && !abandon_array && new_h_size == 0);
+	DUK_ASSERT(!new_shaped || new_e_size >= DUK_HOBJECT_GET_ENEXT(obj));
+#endif
+
 	/*
 	 *  For property layout 1, tweak e_size to ensure that the whole entry
 	 *  part (key + val + flags) is a suitable multiple for alignment
@@ -498,9 +529,7 @@ void duk__realloc_props(duk_hthread *thr,
 	DUK_DDD(DUK_DDDPRINT("attempt to resize hobject %p props (%ld -> %ld bytes), from {p=%p,e_size=%ld,e_next=%ld,a_size=%ld,h_size=%ld} to "
 	                     "{e_size=%ld,a_size=%ld,h_size=%ld}, abandon_array=%ld, unadjusted new_e_size=%ld",
 	                     (void *) obj,
-	                     (long) DUK_HOBJECT_P_COMPUTE_SIZE(DUK_HOBJECT_GET_ESIZE(obj),
-	                                                       DUK_HOBJECT_GET_ASIZE(obj),
-	                                                       DUK_HOBJECT_GET_HSIZE(obj)),
+	                     (long) DUK_HOBJECT_E_ALLOC_SIZE(obj),
 	                     (long) DUK_HOBJECT_P_COMPUTE_SIZE(new_e_size_adjusted, new_a_size, new_h_size),
 	                     (void *) DUK_HOBJECT_GET_PROPS(obj),
 	                     (long) DUK_HOBJECT_GET_ESIZE(obj),
@@ -531,9 +560,12 @@ void duk__realloc_props(duk_hthread *thr,
 	/*
 	 *  Compute new alloc size and alloc new area.
 	 *
-	 *  The new area is allocated as a dynamic buffer and placed into the
-	 *  valstack for reachability.  The actual buffer is then detached at
-	 *  the end.
+	 *  The new area is not reachable for GC until it is switched in at the
+	 *  end, which is fine because it contains no references until then
+	 *  (keys interned for an array abandon are kept reachable separately).
+	 *  The area must be freed explicitly on the error path.  It's always
+	 *  freed with the size computed from the object sizes, so it can be
+	 *  allocated with DUK_ALLOC_SLAB().
 	 *
 	 *  Note: heap_mark_and_sweep_base_flags are altered here to ensure
 	 *  no-one touches this object while we're resizing and rehashing it.
@@ -549,10 +581,16 @@ void duk__realloc_props(duk_hthread *thr,
 	        DUK_MS_FLAG_NO_OBJECT_COMPACTION;   /* avoid attempt to compact the current object */
 #endif
 
-	new_alloc_size = DUK_HOBJECT_P_COMPUTE_SIZE(new_e_size_adjusted, new_a_size, new_h_size);
+#if defined(DUK_USE_HOBJECT_SHAPES)
+	if (new_shaped) {
+		new_alloc_size = DUK_HOBJECT_P_COMPUTE_SIZE_SHAPED(new_e_size_adjusted, new_a_size);
+	} else
+#endif
+	{
+		new_alloc_size = DUK_HOBJECT_P_COMPUTE_SIZE(new_e_size_adjusted, new_a_size, new_h_size);
+	}
 	DUK_DDD(DUK_DDDPRINT("new hobject allocation size is %ld", (long) new_alloc_size));
 	if (new_alloc_size == 0) {
-		/* for zero size, don't push anything on valstack */
 		DUK_ASSERT(new_e_size_adjusted == 0);
 		DUK_ASSERT(new_a_size == 0);
 		DUK_ASSERT(new_h_size == 0);
@@ -564,19 +602,32 @@ void duk__realloc_props(duk_hthread *thr,
 		 * the object we're resizing etc.
 		 */
 
-		/* Note: buffer is dynamic so that we can 'steal' the actual
-		 * allocation later.
-		 */
-
-		new_p = (duk_uint8_t *) duk_push_dynamic_buffer(ctx, new_alloc_size);  /* errors out if out of memory */
-		DUK_ASSERT(new_p != NULL);  /* since new_alloc_size > 0 */
+		new_p = (duk_uint8_t *) DUK_ALLOC_SLAB(thr->heap, new_alloc_size);
+		if (!new_p) {
+#ifdef DUK_USE_MARK_AND_SWEEP
+			thr->heap->mark_and_sweep_base_flags = prev_mark_and_sweep_base_flags;
+#endif
+			DUK_ERROR(thr, DUK_ERR_ALLOC_ERROR, DUK_STR_OBJECT_RESIZE_FAILED);
+		}
 	}
 
 	/* Set up pointers to the new property area: this is hidden behind a macro
 	 * because it is memory layout specific.
 	 */
-	DUK_HOBJECT_P_SET_REALLOC_PTRS(new_p, new_e_k, new_e_pv, new_e_f, new_a, new_h,
-	                               new_e_size_adjusted, new_a_size, new_h_size);
+#if defined(DUK_USE_HOBJECT_SHAPES)
+	if (new_shaped) {
+		/* keys and flags stay in the shape, there is no hash part */
+		new_e_k = NULL;
+		new_e_f = NULL;
+		new_h = NULL;
+		new_e_pv = (duk_propvalue *) (void *) new_p;
+		new_a = (duk_tval *) (void *) (new_p != NULL ? new_p + new_e_size_adjusted * sizeof(duk_propvalue) : NULL);
+	} else
+#endif
+	{
+		DUK_HOBJECT_P_SET_REALLOC_PTRS(new_p, new_e_k, new_e_pv, new_e_f, new_a, new_h,
+		                               new_e_size_adjusted, new_a_size, new_h_size);
+	}
 	DUK_UNREF(new_h);  /* happens when hash part dropped */
 	new_e_next = 0;
 
@@ -684,6 +735,17 @@ void duk__realloc_props(duk_hthread *thr,
 			continue;
 		}
 
+#if defined(DUK_USE_HOBJECT_SHAPES)
+		if (new_shaped) {
+			/* shapes have no deleted keys, so entry indices don't change */
+			DUK_ASSERT(new_p != NULL && new_e_pv != NULL);
+			DUK_ASSERT(new_e_next == i);
+			new_e_pv[new_e_next] = DUK_HOBJECT_E_GET_VALUE(obj, i);
+			new_e_next++;
+			continue;
+		}
+#endif
+
 		DUK_ASSERT(new_p != NULL && new_e_k != NULL &&
 		           new_e_pv != NULL && new_e_f != NULL);
 
@@ -792,9 +854,7 @@ void duk__realloc_props(duk_hthread *thr,
 	DUK_DD(DUK_DDPRINT("resized hobject %p props (%ld -> %ld bytes), from {p=%p,e_size=%ld,e_next=%ld,a_size=%ld,h_size=%ld} to "
 	                   "{p=%p,e_size=%ld,e_next=%ld,a_size=%ld,h_size=%ld}, abandon_array=%ld, unadjusted new_e_size=%ld",
 	                   (void *) obj,
-	                   (long) DUK_HOBJECT_P_COMPUTE_SIZE(DUK_HOBJECT_GET_ESIZE(obj),
-	                                                     DUK_HOBJECT_GET_ASIZE(obj),
-	                                                     DUK_HOBJECT_GET_HSIZE(obj)),
+	                   (long) DUK_HOBJECT_E_ALLOC_SIZE(obj),
 	                   (long) new_alloc_size,
 	                   (void *) DUK_HOBJECT_GET_PROPS(obj),
 	                   (long) DUK_HOBJECT_GET_ESIZE(obj),
@@ -813,36 +873,23 @@ void duk__realloc_props(duk_hthread *thr,
 	 *  All done, switch properties ('p') allocation to new one.
 	 */
 
-	DUK_FREE(thr->heap, DUK_HOBJECT_GET_PROPS(obj));  /* NULL obj->p is OK */
+	DUK_FREE_SLAB(thr->heap, DUK_HOBJECT_GET_PROPS(obj), DUK_HOBJECT_E_ALLOC_SIZE(obj));  /* NULL obj->p is OK */
 	DUK_HOBJECT_SET_PROPS(obj, new_p);
 	DUK_HOBJECT_SET_ESIZE(obj, new_e_size_adjusted);
 	DUK_HOBJECT_SET_ENEXT(obj, new_e_next);
 	DUK_HOBJECT_SET_ASIZE(obj, new_a_size);
 	DUK_HOBJECT_SET_HSIZE(obj, new_h_size);
-
-	if (new_p) {
-		/*
-		 *  Detach actual buffer from dynamic buffer in valstack, and
-		 *  pop it from the stack.
-		 *
-		 *  XXX: the buffer object is certainly not reachable at this point,
-		 *  so it would be nice to free it forcibly even with only
-		 *  mark-and-sweep enabled.  Not a big issue though.
+#if defined(DUK_USE_HOBJECT_SHAPES)
+	if (DUK_HOBJECT_GET_SHAPE(obj) != NULL && !new_shaped) {
+		/* keys were copied to the new entry part, the object's key
+		 * references are unchanged so only the shape is released
 		 */
-		duk_hbuffer_dynamic *buf;
-		DUK_ASSERT(new_alloc_size > 0);
-		DUK_ASSERT(duk_is_buffer(ctx, -1));
-		buf = (duk_hbuffer_dynamic *) duk_require_hbuffer(ctx, -1);
-		DUK_ASSERT(buf != NULL);
-		DUK_ASSERT(DUK_HBUFFER_HAS_DYNAMIC(buf));
-		DUK_HBUFFER_DYNAMIC_SET_DATA_PTR_NULL(buf);
-		DUK_HBUFFER_DYNAMIC_SET_SIZE(buf, 0);  /* these size resets are not strictly necessary, but nice for consistency */
-		DUK_HBUFFER_DYNAMIC_SET_ALLOC_SIZE(buf, 0);
-		duk_pop(ctx);
-	} else {
-		DUK_ASSERT(new_alloc_size == 0);
-		/* no need to pop, nothing was pushed */
+		duk_hshape *shape = DUK_HOBJECT_GET_SHAPE(obj);
+		DUK_DD(DUK_DDPRINT("object %p converted to dictionary layout", (void *) obj));
+		DUK_HOBJECT_SET_SHAPE(obj, NULL);
+		duk_hshape_decref(thr->heap, shape);
 	}
+#endif
 
 	/* clear array part flag only after switching */
 	if (abandon_array) {
@@ -866,7 +913,8 @@ void duk__realloc_props(duk_hthread *thr,
 
 	/*
 	 *  Abandon array failed, need to decref keys already inserted
-	 *  into the beginning of new_e_k before unwinding valstack.
+	 *  into the beginning of new_e_k before unwinding valstack, and
+	 *  free the new area.
 	 */
 
  abandon_error:
@@ -878,6 +926,7 @@ void duk__realloc_props(duk_hthread *thr,
 		DUK_ASSERT(new_e_k[i] != NULL);
 		DUK_HSTRING_DECREF(thr, new_e_k[i]);
 	}
+	DUK_FREE_SLAB(thr->heap, new_p, new_alloc_size);
 
 #ifdef DUK_USE_MARK_AND_SWEEP
 	thr->heap->mark_and_sweep_base_flags = prev_mark_and_sweep_base_flags;
@@ -917,7 +966,7 @@ DUK_LOCAL void duk__grow_props_for_new_entry_item(duk_hthread *thr, duk_hobject
 	new_a_size = DUK_HOBJECT_GET_ASIZE(obj);
 	DUK_ASSERT(new_e_size >= old_e_used + 1);  /* duk__get_min_grow_e() is always >= 1 */
 
-	duk__realloc_props(thr, obj, new_e_size, new_a_size, new_h_size, 0);
+	duk__realloc_props(thr, obj, new_e_size, new_a_size, new_h_size, 0, 0);
 }
 
 /* Grow array part for a new highest array index. */
@@ -937,7 +986,7 @@ DUK_LOCAL void duk__grow_props_for_array_item(duk_hthread *thr, duk_hobject *obj
 	new_a_size = highest_arr_idx + duk__get_min_grow_a(highest_arr_idx);
 	DUK_ASSERT(new_a_size >= highest_arr_idx + 1);  /* duk__get_min_grow_a() is always >= 1 */
 
-	duk__realloc_props(thr, obj, new_e_size, new_a_size, new_h_size, 0);
+	duk__realloc_props(thr, obj, new_e_size, new_a_size, new_h_size, 0, 0);
 }
 
 /* Abandon array part, moving array entries into entries part.
@@ -980,7 +1029,66 @@ DUK_LOCAL void duk__abandon_array_checked(duk_hthread *thr, duk_hobject *obj) {
 	                   (void *) obj, (long) e_used, (long) a_used, (long) a_size,
 	                   (long) new_e_size, (long) new_a_size, (long) new_h_size));
 
-	duk__realloc_props(thr, obj, new_e_size, new_a_size, new_h_size, 1);
+	duk__realloc_props(thr, obj, new_e_size, new_a_size, new_h_size, 1, 0);
+}
+
+/*
+ *  Preallocate the array part of an object so that a caller creating an
+ *  array of known size can write the values directly into the array part
+ *  (and update 'length' itself).  Entry and hash parts are kept as is.
+ *  Unused array entries are initialized to "undefined unused".
+ *
+ *  The call may fail due to allocation error.  Currently only used for
+ *  tracebacks.
+ */
+
+#if defined(DUK_USE_TRACEBACKS)
+DUK_INTERNAL void duk_hobject_realloc_array_part(duk_hthread *thr, duk_hobject *obj, duk_uint32_t new_a_size) {
+	DUK_ASSERT(thr != NULL);
+	DUK_ASSERT(obj != NULL);
+	DUK_ASSERT(DUK_HOBJECT_HAS_ARRAY_PART(obj));
+	DUK_ASSERT(new_a_size >= DUK_HOBJECT_GET_ASIZE(obj));
+
+	duk__realloc_props(thr,
+	                   obj,
+	                   DUK_HOBJECT_GET_ESIZE(obj),
+	                   new_a_size,
+	                   DUK_HOBJECT_GET_HSIZE(obj),
+	                   0,
+	                   0);
+}
+#endif  /* DUK_USE_TRACEBACKS */
+
+/*
+ *  Preallocate the entry part of an object so that a caller about to add
+ *  a known (or expected) number of properties avoids repeated growth
+ *  steps.  The hash part is sized to match as in a normal grow.
+ *
+ *  The call may fail due to allocation error.
+ */
+
+DUK_INTERNAL void duk_hobject_realloc_entry_part(duk_hthread *thr, duk_hobject *obj, duk_uint32_t new_e_size) {
+	duk_uint32_t new_h_size;
+
+	DUK_ASSERT(thr != NULL);
+	DUK_ASSERT(obj != NULL);
+	DUK_ASSERT(new_e_size >= DUK_HOBJECT_GET_ESIZE(obj));
+	/* A hash part is only built for an object which already has properties. */
+	DUK_ASSERT(DUK_HOBJECT_GET_PROPS(obj) != NULL || new_e_size < DUK_HOBJECT_E_USE_HASH_LIMIT);
+
+#if defined(DUK_USE_HOBJECT_HASH_PART)
+	new_h_size = duk__get_default_h_size(new_e_size);
+#else
+	new_h_size = 0;
+#endif
+
+	duk__realloc_props(thr,
+	                   obj,
+	                   new_e_size,
+	                   DUK_HOBJECT_GET_ASIZE(obj),
+	                   new_h_size,
+	                   0,
+	                   0);
 }
 
 /*
@@ -1038,8 +1146,93 @@ DUK_INTERNAL void duk_hobject_compact_props(duk_hthread *thr, duk_hobject *obj)
 	DUK_DD(DUK_DDPRINT("compacting hobject -> new e_size %ld, new a_size=%ld, new h_size=%ld, abandon_array=%ld",
 	                   (long) e_size, (long) a_size, (long) h_size, (long) abandon_array));
 
-	duk__realloc_props(thr, obj, e_size, a_size, h_size, abandon_array);
+	duk__realloc_props(thr, obj, e_size, a_size, h_size, abandon_array, 0);
+}
+
+/*
+ *  Convert a shaped object into the dictionary layout.  Called before any
+ *  operation which modifies existing keys or property attributes in place
+ *  (delete, attribute changes, etc), as the shape is shared.  Entry indices
+ *  don't change so a previous property lookup remains valid, but any value
+ *  pointers must be looked up again.
+ */
+
+#if defined(DUK_USE_HOBJECT_SHAPES)
+DUK_INTERNAL void duk_hobject_unshape(duk_hthread *thr, duk_hobject *obj) {
+	DUK_ASSERT(thr != NULL);
+	DUK_ASSERT(obj != NULL);
+	DUK_ASSERT(DUK_HOBJECT_GET_SHAPE(obj) != NULL);
+	DUK_ASSERT(DUK_HOBJECT_GET_HSIZE(obj) == 0);
+
+	DUK_DD(DUK_DDPRINT("unshape object %p, e_next=%ld", (void *) obj, (long) DUK_HOBJECT_GET_ENEXT(obj)));
+
+	/* Shaped objects are small (below DUK_HOBJECT_E_USE_HASH_LIMIT) so no
+	 * hash part is needed.
+	 */
+	duk__realloc_props(thr,
+	                   obj,
+	                   DUK_HOBJECT_GET_ESIZE(obj),
+	                   DUK_HOBJECT_GET_ASIZE(obj),
+	                   0,
+	                   0 /*abandon_array*/,
+	                   1 /*unshape*/);
+	DUK_ASSERT(DUK_HOBJECT_GET_SHAPE(obj) == NULL);
+}
+
+/*
+ *  Move a shaped object directly to a descendant 'shape' of its current
+ *  shape, i.e. add all the missing keys of 'shape' in one step without
+ *  walking the transitions.  The new entries get an 'undefined' value;
+ *  the caller must fill in the actual values (and the flags in 'shape'
+ *  must be suitable for that).  Used to create cached enumerator objects.
+ */
+
+DUK_INTERNAL void duk_hobject_extend_to_shape(duk_hthread *thr, duk_hobject *obj, duk_hshape *shape) {
+	duk_hshape *old_shape;
+	duk_uint_fast32_t i;
+
+	DUK_ASSERT(thr != NULL);
+	DUK_ASSERT(obj != NULL);
+	DUK_ASSERT(shape != NULL);
+	DUK_ASSERT(DUK_HOBJECT_GET_SHAPE(obj) != NULL);
+	DUK_ASSERT(DUK_HOBJECT_GET_SHAPE(obj)->count == DUK_HOBJECT_GET_ENEXT(obj));
+	DUK_ASSERT(shape->count >= DUK_HOBJECT_GET_ENEXT(obj));
+#ifdef DUK_USE_ASSERTIONS
+	{
+		duk_hshape *t = shape;
+		while (t->count > DUK_HOBJECT_GET_ENEXT(obj)) {
+			t = t->parent;
+		}
+		DUK_ASSERT(t == DUK_HOBJECT_GET_SHAPE(obj));
+	}
+#endif
+
+	if (shape->count > DUK_HOBJECT_GET_ESIZE(obj)) {
+		duk__realloc_props(thr,
+		                   obj,
+		                   shape->count,
+		                   DUK_HOBJECT_GET_ASIZE(obj),
+		                   0,
+		                   0 /*abandon_array*/,
+		                   0 /*unshape*/);
+	}
+	DUK_ASSERT(DUK_HOBJECT_GET_SHAPE(obj) != NULL);
+	DUK_ASSERT(shape->count <= DUK_HOBJECT_GET_ESIZE(obj));
+
+	/* no side effects from here on */
+
+	for (i = DUK_HOBJECT_GET_ENEXT(obj); i < shape->count; i++) {
+		DUK_TVAL_SET_UNDEFINED_ACTUAL(DUK_HOBJECT_E_GET_VALUE_TVAL_PTR(obj, i));
+		DUK_HSTRING_INCREF(thr, shape->keys[i]);
+	}
+
+	old_shape = DUK_HOBJECT_GET_SHAPE(obj);
+	DUK_HSHAPE_INCREF(shape);
+	DUK_HOBJECT_SET_SHAPE(obj, shape);
+	DUK_HOBJECT_SET_ENEXT(obj, shape->count);
+	duk_hshape_decref(thr->heap, old_shape);
 }
+#endif  /* DUK_USE_HOBJECT_SHAPES */
 
 /*
  *  Find an existing key from entry part either by linear scan or by
@@ -1188,12 +1381,14 @@ DUK_INTERNAL duk_tval *duk_hobject_find_existing_array_entry_tval_ptr(duk_hobjec
  *  Allocate and initialize a new entry, resizing the properties allocation
  *  if necessary.  Returns entry index (e_idx) or throws an error if alloc fails.
  *
- *  Sets the key of the entry (increasing the key's refcount), and updates
- *  the hash part if it exists.  Caller must set value and flags, and update
- *  the entry value refcount.  A decref for the previous value is not necessary.
+ *  Sets the key and flags of the entry (increasing the key's refcount), and
+ *  updates the hash part if it exists.  For a shaped object the key and flags
+ *  are set by transitioning to a child shape.  Caller must set value and
+ *  update the entry value refcount.  A decref for the previous value is not
+ *  necessary.
  */
 
-DUK_LOCAL duk_bool_t duk__alloc_entry_checked(duk_hthread *thr, duk_hobject *obj, duk_hstring *key) {
+DUK_LOCAL duk_bool_t duk__alloc_entry_checked(duk_hthread *thr, duk_hobject *obj, duk_hstring *key, duk_small_uint_t propflags) {
 	duk_uint32_t idx;
 
 	DUK_ASSERT(thr != NULL);
@@ -1217,10 +1412,42 @@ DUK_LOCAL duk_bool_t duk__alloc_entry_checked(duk_hthread *thr, duk_hobject *obj
 		duk__grow_props_for_new_entry_item(thr, obj);
 	}
 	DUK_ASSERT(DUK_HOBJECT_GET_ENEXT(obj) < DUK_HOBJECT_GET_ESIZE(obj));
+
+#if defined(DUK_USE_HOBJECT_SHAPES)
+	if (DUK_HOBJECT_GET_SHAPE(obj) != NULL) {
+		duk_hshape *old_shape = DUK_HOBJECT_GET_SHAPE(obj);
+		duk_hshape *new_shape;
+
+		/* Transition before e_next is updated: the shape allocation may
+		 * trigger a GC which must see a consistent object.
+		 */
+		DUK_ASSERT(old_shape->count == DUK_HOBJECT_GET_ENEXT(obj));
+		DUK_ASSERT(DUK_HOBJECT_GET_HSIZE(obj) == 0);
+		new_shape = duk_hshape_get_transition(thr, old_shape, key, (duk_uint8_t) propflags);
+		if (new_shape != NULL) {
+			DUK_HOBJECT_SET_SHAPE(obj, new_shape);
+			duk_hshape_decref(thr->heap, old_shape);
+
+			idx = DUK_HOBJECT_POSTINC_ENEXT(obj);
+			DUK_ASSERT(DUK_HOBJECT_E_GET_KEY(obj, idx) == key);
+			DUK_HSTRING_INCREF(thr, key);
+			return idx;
+		}
+
+		/* Too many keys or transitions: continue in the dictionary
+		 * layout.  Entry part size is unchanged by unshaping.
+		 */
+		duk_hobject_unshape(thr, obj);
+		DUK_ASSERT(DUK_HOBJECT_GET_SHAPE(obj) == NULL);
+		DUK_ASSERT(DUK_HOBJECT_GET_ENEXT(obj) < DUK_HOBJECT_GET_ESIZE(obj));
+	}
+#endif
+
 	idx = DUK_HOBJECT_POSTINC_ENEXT(obj);
 
 	/* previous value is assumed to be garbage, so don't touch it */
 	DUK_HOBJECT_E_SET_KEY(obj, idx, key);
+	DUK_HOBJECT_E_SET_FLAGS(obj, idx, propflags);
 	DUK_HSTRING_INCREF(thr, key);
 
 #if defined(DUK_USE_HOBJECT_HASH_PART)
@@ -1721,6 +1948,56 @@ DUK_LOCAL duk_bool_t duk__get_own_property_desc_raw(duk_hthread *thr, duk_hobjec
 			DUK_ASSERT(!DUK_HOBJECT_HAS_EXOTIC_ARGUMENTS(obj));
 			return 1;  /* cannot be arguments exotic */
 		}
+	} else if (DUK_HOBJECT_HAS_BUFFEROBJECT(obj)) {
+		duk_hbufferobject *h_bufobj = (duk_hbufferobject *) obj;
+
+		DUK_DDD(DUK_DDDPRINT("buffer object (ArrayBuffer, view) property get for key: %!O, arr_idx: %ld",
+		                     (duk_heaphdr *) key, (long) arr_idx));
+
+		if (arr_idx != DUK__NO_ARRAY_INDEX) {
+			duk_tval tv_elem;
+
+			if (duk_hbufferobject_get_index(h_bufobj, arr_idx, &tv_elem)) {
+				DUK_DDD(DUK_DDDPRINT("-> found, array index inside typed array"));
+				if (flags & DUK__DESC_FLAG_PUSH_VALUE) {
+					duk_push_tval(ctx, &tv_elem);
+				}
+				out_desc->flags = DUK_PROPDESC_FLAG_WRITABLE |
+				                  DUK_PROPDESC_FLAG_ENUMERABLE |
+				                  DUK_PROPDESC_FLAG_VIRTUAL;
+
+				DUK_ASSERT(!DUK_HOBJECT_HAS_EXOTIC_ARGUMENTS(obj));
+				return 1;
+			}
+			/* index outside element range (or not a typed array) -> normal property */
+		} else if ((key == DUK_HTHREAD_STRING_LENGTH(thr) && h_bufobj->is_typedarray) ||
+		           key == DUK_HTHREAD_STRING_BYTE_LENGTH(thr) ||
+		           ((key == DUK_HTHREAD_STRING_BYTE_OFFSET(thr) || key == DUK_HTHREAD_STRING_LC_BUFFER(thr)) &&
+		            DUK_HOBJECT_GET_CLASS_NUMBER(obj) != DUK_HOBJECT_CLASS_ARRAYBUFFER)) {
+			/* Read-only virtual properties.  ES6 has these as prototype
+			 * accessors; own virtual properties are much cheaper here.
+			 * A view whose buffer has been resized so that the slice is
+			 * no longer covered reports zero lengths.
+			 */
+			DUK_DDD(DUK_DDDPRINT("-> found, buffer object virtual property"));
+			if (flags & DUK__DESC_FLAG_PUSH_VALUE) {
+				if (key == DUK_HTHREAD_STRING_LC_BUFFER(thr)) {
+					duk_hbufferobject_push_buffer_prop(thr, h_bufobj);
+				} else if (!DUK_HBUFFEROBJECT_VALID_SLICE(h_bufobj)) {
+					duk_push_uint(ctx, 0);
+				} else if (key == DUK_HTHREAD_STRING_LENGTH(thr)) {
+					duk_push_uint(ctx, (duk_uint_t) DUK_HBUFFEROBJECT_GET_ELEM_COUNT(h_bufobj));
+				} else if (key == DUK_HTHREAD_STRING_BYTE_LENGTH(thr)) {
+					duk_push_uint(ctx, (duk_uint_t) h_bufobj->length);
+				} else {
+					duk_push_uint(ctx, (duk_uint_t) h_bufobj->offset);
+				}
+			}
+			out_desc->flags = DUK_PROPDESC_FLAG_VIRTUAL;
+
+			DUK_ASSERT(!DUK_HOBJECT_HAS_EXOTIC_ARGUMENTS(obj));
+			return 1;
+		}
 	} else if (DUK_HOBJECT_HAS_EXOTIC_DUKFUNC(obj)) {
 		DUK_DDD(DUK_DDDPRINT("duktape/c object exotic property get for key: %!O, arr_idx: %ld",
 		                     (duk_heaphdr *) key, (long) arr_idx));
@@ -2166,6 +2443,22 @@ DUK_INTERNAL duk_bool_t duk_hobject_getprop(duk_hthread *thr, duk_tval *tv_obj,
 			return 1;
 		}
 
+		if (DUK_HOBJECT_HAS_BUFFEROBJECT(curr) && DUK_TVAL_IS_NUMBER(tv_key)) {
+			duk_tval tv_elem;
+
+			arr_idx = duk__tval_number_to_arr_idx(tv_key);
+			if (arr_idx != DUK__NO_ARRAY_INDEX &&
+			    duk_hbufferobject_get_index((duk_hbufferobject *) curr, arr_idx, &tv_elem)) {
+				duk_push_tval(ctx, &tv_elem);
+
+				DUK_DDD(DUK_DDDPRINT("-> %!T (base is buffer object, key is a number, "
+				                     "element fast path)",
+				                     (duk_tval *) duk_get_tval(ctx, -1)));
+				return 1;
+			}
+			arr_idx = DUK__NO_ARRAY_INDEX;
+		}
+
 		if (DUK_HOBJECT_HAS_EXOTIC_ARGUMENTS(curr)) {
 			arr_idx = duk__push_tval_to_hstring_arr_idx(ctx, tv_key, &key);
 			DUK_ASSERT(key != NULL);
@@ -3027,7 +3320,6 @@ DUK_INTERNAL duk_bool_t duk_hobject_putprop(duk_hthread *thr, duk_tval *tv_obj,
 	}
 
 	case DUK_TAG_OBJECT: {
-		/* Note: no fast paths for property put now */
 		orig = DUK_TVAL_GET_OBJECT(tv_obj);
 		DUK_ASSERT(orig != NULL);
 
@@ -3091,6 +3383,18 @@ DUK_INTERNAL duk_bool_t duk_hobject_putprop(duk_hthread *thr, duk_tval *tv_obj,
 		}
 #endif  /* DUK_USE_ES6_PROXY */
 
+		/* Typed array element fast path, the only property put fast
+		 * path for objects now.
+		 */
+		if (DUK_HOBJECT_HAS_BUFFEROBJECT(orig) && DUK_TVAL_IS_NUMBER(tv_key)) {
+			arr_idx = duk__tval_number_to_arr_idx(tv_key);
+			if (arr_idx != DUK__NO_ARRAY_INDEX &&
+			    duk_hbufferobject_put_index(thr, (duk_hbufferobject *) orig, arr_idx, tv_val)) {
+				DUK_DDD(DUK_DDDPRINT("result: success (buffer object element fast path)"));
+				return 1;
+			}
+		}
+
 		curr = orig;
 		break;
 	}
@@ -3186,6 +3490,16 @@ DUK_INTERNAL duk_bool_t duk_hobject_putprop(duk_hthread *thr, duk_tval *tv_obj,
 	arr_idx = duk__push_tval_to_hstring_arr_idx(ctx, tv_key, &key);
 	DUK_ASSERT(key != NULL);
 
+	/* Typed array element write with a non-number key (e.g. '5'): like
+	 * in the number key fast path, an index outside the element range
+	 * is ignored instead of creating an ordinary property.
+	 */
+	if (orig != NULL && DUK_HOBJECT_HAS_BUFFEROBJECT(orig) && arr_idx != DUK__NO_ARRAY_INDEX &&
+	    duk_hbufferobject_put_index(thr, (duk_hbufferobject *) orig, arr_idx, tv_val)) {
+		DUK_DDD(DUK_DDDPRINT("result: success (buffer object element, coerced key)"));
+		goto success_no_arguments_exotic;
+	}
+
  lookup:
 
 	/*
@@ -3287,6 +3601,12 @@ DUK_INTERNAL duk_bool_t duk_hobject_putprop(duk_hthread *thr, duk_tval *tv_obj,
 						duk_pop(ctx);
 						goto success_no_arguments_exotic;
 					}
+				} else if (DUK_HOBJECT_HAS_BUFFEROBJECT(curr)) {
+					DUK_DD(DUK_DDPRINT("writable virtual property is a typed array element"));
+					if (arr_idx != DUK__NO_ARRAY_INDEX &&
+					    duk_hbufferobject_put_index(thr, (duk_hbufferobject *) curr, arr_idx, tv_val)) {
+						goto success_no_arguments_exotic;
+					}
 				}
 
 				goto fail_internal;  /* should not happen */
@@ -3579,14 +3899,13 @@ DUK_INTERNAL duk_bool_t duk_hobject_putprop(duk_hthread *thr, duk_tval *tv_obj,
 	 * refcount; may need a props allocation resize but doesn't
 	 * 'recheck' the valstack.
 	 */
-	e_idx = duk__alloc_entry_checked(thr, orig, key);
+	e_idx = duk__alloc_entry_checked(thr, orig, key, DUK_PROPDESC_FLAGS_WEC);
 	DUK_ASSERT(e_idx >= 0);
 
 	tv = DUK_HOBJECT_E_GET_VALUE_TVAL_PTR(orig, e_idx);
 	/* prev value can be garbage, no decref */
 	DUK_TVAL_SET_TVAL(tv, tv_val);
 	DUK_TVAL_INCREF(thr, tv);
-	DUK_HOBJECT_E_SET_FLAGS(orig, e_idx, DUK_PROPDESC_FLAGS_WEC);
 	goto entry_updated;
 
  entry_updated:
@@ -3772,6 +4091,9 @@ DUK_INTERNAL duk_bool_t duk_hobject_delprop_raw(duk_hthread *thr, duk_hobject *o
 	} else {
 		DUK_ASSERT(desc.a_idx < 0);
 
+		/* a shared shape cannot have gaps, entry index is preserved */
+		DUK_HOBJECT_UNSHAPE(thr, obj);
+
 		/* remove hash entry (no decref) */
 #if defined(DUK_USE_HOBJECT_HASH_PART)
 		if (desc.h_idx >= 0) {
@@ -4102,7 +4424,10 @@ DUK_INTERNAL void duk_hobject_define_property_internal(duk_hthread *thr, duk_hob
 				goto error_internal;
 			}
 
-			DUK_HOBJECT_E_SET_FLAGS(obj, desc.e_idx, propflags);
+			if (DUK_HOBJECT_E_GET_FLAGS(obj, desc.e_idx) != propflags) {
+				DUK_HOBJECT_UNSHAPE(thr, obj);
+				DUK_HOBJECT_E_SET_FLAGS(obj, desc.e_idx, propflags);
+			}
 			tv1 = DUK_HOBJECT_E_GET_VALUE_TVAL_PTR(obj, desc.e_idx);
 		} else if (desc.a_idx >= 0) {
 			if (flags & DUK_PROPDESC_FLAG_NO_OVERWRITE) {
@@ -4146,9 +4471,8 @@ DUK_INTERNAL void duk_hobject_define_property_internal(duk_hthread *thr, duk_hob
 	}
 
 	DUK_DDD(DUK_DDDPRINT("property does not exist, object belongs in entry part -> allocate new entry and write value and attributes"));
-	e_idx = duk__alloc_entry_checked(thr, obj, key);  /* increases key refcount */
+	e_idx = duk__alloc_entry_checked(thr, obj, key, propflags);  /* increases key refcount */
 	DUK_ASSERT(e_idx >= 0);
-	DUK_HOBJECT_E_SET_FLAGS(obj, e_idx, propflags);
 	tv1 = DUK_HOBJECT_E_GET_VALUE_TVAL_PTR(obj, e_idx);
 	/* new entry: previous value is garbage; set to undefined to share write_value */
 	DUK_TVAL_SET_UNDEFINED_ACTUAL(tv1);
@@ -4266,9 +4590,14 @@ DUK_INTERNAL void duk_hobject_define_accessor_internal(duk_hthread *thr, duk_hob
 
 	DUK_ASSERT_VALSTACK_SPACE(thr, DUK__VALSTACK_SPACE);
 
-	/* force the property to 'undefined' to create a slot for it */
+	/* Force the property to 'undefined' to create a slot for it.  The
+	 * accessor flag is only set once the slot has been unshaped and is
+	 * about to get its getter and setter: unshaping allocates, and
+	 * mark-and-sweep must not see an accessor slot holding a tval.
+	 */
 	duk_push_undefined(ctx);
-	duk_hobject_define_property_internal(thr, obj, key, propflags);
+	duk_hobject_define_property_internal(thr, obj, key, propflags & ~DUK_PROPDESC_FLAG_ACCESSOR);
+	DUK_HOBJECT_UNSHAPE(thr, obj);  /* accessor flag is modified in place */
 	duk_hobject_find_existing_entry(obj, key, &e_idx, &h_idx);
 	DUK_DDD(DUK_DDDPRINT("accessor slot: e_idx=%ld, h_idx=%ld", (long) e_idx, (long) h_idx));
 	DUK_ASSERT(e_idx >= 0);
@@ -4822,7 +5151,7 @@ DUK_INTERNAL duk_ret_t duk_hobject_object_define_property(duk_context *ctx) {
 			}
 
 			/* write to entry part */
-			e_idx = duk__alloc_entry_checked(thr, obj, key);
+			e_idx = duk__alloc_entry_checked(thr, obj, key, new_flags);
 			DUK_ASSERT(e_idx >= 0);
 
 			DUK_HOBJECT_E_SET_VALUE_GETTER(obj, e_idx, get);
@@ -4830,7 +5159,6 @@ DUK_INTERNAL duk_ret_t duk_hobject_object_define_property(duk_context *ctx) {
 			DUK_HOBJECT_INCREF(thr, get);
 			DUK_HOBJECT_INCREF(thr, set);
 
-			DUK_HOBJECT_E_SET_FLAGS(obj, e_idx, new_flags);
 			goto success_exotics;
 		} else {
 			duk_int_t e_idx;
@@ -4875,13 +5203,12 @@ DUK_INTERNAL duk_ret_t duk_hobject_object_define_property(duk_context *ctx) {
 			}
 
 			/* write to entry part */
-			e_idx = duk__alloc_entry_checked(thr, obj, key);
+			e_idx = duk__alloc_entry_checked(thr, obj, key, new_flags);
 			DUK_ASSERT(e_idx >= 0);
 			tv2 = DUK_HOBJECT_E_GET_VALUE_TVAL_PTR(obj, e_idx);
 			DUK_TVAL_SET_TVAL(tv2, &tv);
 			DUK_TVAL_INCREF(thr, tv2);
 
-			DUK_HOBJECT_E_SET_FLAGS(obj, e_idx, new_flags);
 			goto success_exotics;
 		}
 		DUK_UNREACHABLE();
@@ -5045,6 +5372,7 @@ DUK_INTERNAL duk_ret_t duk_hobject_object_define_property(duk_context *ctx) {
 
 			DUK_ASSERT(!DUK_HOBJECT_E_SLOT_IS_ACCESSOR(obj, curr.e_idx));
 
+			DUK_HOBJECT_UNSHAPE(thr, obj);
 			tv1 = DUK_HOBJECT_E_GET_VALUE_TVAL_PTR(obj, curr.e_idx);
 			DUK_TVAL_SET_TVAL(&tv_tmp, tv1);
 			DUK_TVAL_SET_UNDEFINED_UNUSED(tv1);
@@ -5085,6 +5413,7 @@ DUK_INTERNAL duk_ret_t duk_hobject_object_define_property(duk_context *ctx) {
 
 			DUK_DDD(DUK_DDDPRINT("convert property to data property"));
 
+			DUK_HOBJECT_UNSHAPE(thr, obj);
 			DUK_ASSERT(DUK_HOBJECT_E_SLOT_IS_ACCESSOR(obj, curr.e_idx));
 			tmp = DUK_HOBJECT_E_GET_VALUE_GETTER(obj, curr.e_idx);
 			DUK_UNREF(tmp);
@@ -5213,7 +5542,10 @@ DUK_INTERNAL duk_ret_t duk_hobject_object_define_property(duk_context *ctx) {
 	DUK_ASSERT(curr.e_idx >= 0 && curr.a_idx < 0);
 
 	DUK_DDD(DUK_DDDPRINT("update existing property attributes"));
-	DUK_HOBJECT_E_SET_FLAGS(obj, curr.e_idx, new_flags);
+	if (DUK_HOBJECT_E_GET_FLAGS(obj, curr.e_idx) != new_flags) {
+		DUK_HOBJECT_UNSHAPE(thr, obj);
+		DUK_HOBJECT_E_SET_FLAGS(obj, curr.e_idx, new_flags);
+	}
 
 	if (has_set) {
 		duk_hobject *tmp;
@@ -5329,6 +5661,7 @@ DUK_INTERNAL duk_ret_t duk_hobject_object_define_property(duk_context *ctx) {
 
 			if (pending_write_protect) {
 				DUK_DDD(DUK_DDDPRINT("setting array length non-writable (pending writability update)"));
+				DUK_HOBJECT_UNSHAPE(thr, obj);
 				DUK_HOBJECT_E_SLOT_CLEAR_WRITABLE(obj, curr.e_idx);
 			}
 
@@ -5568,14 +5901,21 @@ DUK_INTERNAL duk_bool_t duk_hobject_object_ownprop_helper(duk_context *ctx, duk_
  *  Freezing is essentially sealing + making plain properties non-writable.
  *
  *  Note: virtual (non-concrete) properties which are non-configurable but
- *  writable would pose some problems, but such properties do not currently
- *  exist (all virtual properties are non-configurable and non-writable).
- *  If they did exist, the non-configurability does NOT prevent them from
- *  becoming non-writable.  However, this change should be recorded somehow
- *  so that it would turn up (e.g. when getting the property descriptor),
- *  requiring some additional flags in the object.
+ *  writable pose some problems, because the non-configurability does NOT
+ *  prevent them from becoming non-writable.  Typed array elements are such
+ *  properties and can't be made non-writable, so freezing a typed array with
+ *  elements is a TypeError like in ES6.  Duktape.Buffer index properties
+ *  are also writable and are left as is.  All other virtual properties are
+ *  non-configurable and non-writable.
  */
 
+/* Typed array view with virtual (writable) element properties. */
+DUK_LOCAL duk_bool_t duk__bufferobject_has_elements(duk_hbufferobject *h_bufobj) {
+	return (duk_bool_t) (h_bufobj->is_typedarray &&
+	                     DUK_HBUFFEROBJECT_VALID_SLICE(h_bufobj) &&
+	                     DUK_HBUFFEROBJECT_GET_ELEM_COUNT(h_bufobj) > 0);
+}
+
 DUK_INTERNAL void duk_hobject_object_seal_freeze_helper(duk_hthread *thr, duk_hobject *obj, duk_bool_t is_freeze) {
 	duk_uint_fast32_t i;
 
@@ -5585,6 +5925,11 @@ DUK_INTERNAL void duk_hobject_object_seal_freeze_helper(duk_hthread *thr, duk_ho
 
 	DUK_ASSERT_VALSTACK_SPACE(thr, DUK__VALSTACK_SPACE);
 
+	if (is_freeze && DUK_HOBJECT_HAS_BUFFEROBJECT(obj) &&
+	    duk__bufferobject_has_elements((duk_hbufferobject *) obj)) {
+		DUK_ERROR(thr, DUK_ERR_TYPE_ERROR, DUK_STR_NOT_CONFIGURABLE);
+	}
+
 	/*
 	 *  Abandon array part because all properties must become non-configurable.
 	 *  Note that this is now done regardless of whether this is always the case
@@ -5594,6 +5939,7 @@ DUK_INTERNAL void duk_hobject_object_seal_freeze_helper(duk_hthread *thr, duk_ho
 
 	duk__abandon_array_checked(thr, obj);
 	DUK_ASSERT(DUK_HOBJECT_GET_ASIZE(obj) == 0);
+	DUK_HOBJECT_ASSERT_NOT_SHAPED(obj);  /* abandon resize also converts to dictionary layout */
 
 	for (i = 0; i < DUK_HOBJECT_GET_ENEXT(obj); i++) {
 		duk_uint8_t *fp;
@@ -5625,9 +5971,10 @@ DUK_INTERNAL void duk_hobject_object_seal_freeze_helper(duk_hthread *thr, duk_ho
  *  Since the algorithms are similar, a helper provides both functions.
  *  Freezing is essentially sealing + making plain properties non-writable.
  *
- *  Note: all virtual (non-concrete) properties are currently non-configurable
- *  and non-writable (and there are no accessor virtual properties), so they don't
- *  need to be considered here now.
+ *  Note: all virtual (non-concrete) properties are non-configurable (and there
+ *  are no accessor virtual properties).  Typed array elements are writable, so
+ *  a typed array with elements is never frozen; other writable virtual
+ *  properties are not considered here now.
  */
 
 DUK_INTERNAL duk_bool_t duk_hobject_object_is_sealed_frozen_helper(duk_hobject *obj, duk_bool_t is_frozen) {
@@ -5642,7 +5989,11 @@ DUK_INTERNAL duk_bool_t duk_hobject_object_is_sealed_frozen_helper(duk_hobject *
 		return 0;
 	}
 
-	/* all virtual properties are non-configurable and non-writable */
+	/* all virtual properties are non-configurable */
+	if (is_frozen && DUK_HOBJECT_HAS_BUFFEROBJECT(obj) &&
+	    duk__bufferobject_has_elements((duk_hbufferobject *) obj)) {
+		return 0;
+	}
 
 	/* entry part must not contain any configurable properties, or
 	 * writable properties (if is_frozen).
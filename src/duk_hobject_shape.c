@@ -0,0 +1,187 @@
+/*
+ *  Object shapes (hidden classes)
+ *
+ *  Shapes form a transition tree rooted at heap->shape_root.  Each shape
+ *  describes the entry part keys and flags of one or more objects; adding
+ *  a new property moves the object to a child shape keyed by the new key
+ *  and flags.  Objects built the same way therefore share their key and
+ *  flag arrays.
+ *
+ *  Shapes are not heap objects and are not visible to mark-and-sweep.
+ *  Their lifecycle is managed with a plain reference count which counts
+ *  the objects using the shape, the shape's direct children, and shapes
+ *  caching it as their enumerator shape.  Key
+ *  references are borrowed: every object using a shape holds a reference
+ *  to each of its own keys, so the keys of a live shape are always
+ *  reachable.
+ */
+
+#include "duk_internal.h"
+
+#if defined(DUK_USE_HOBJECT_SHAPES)
+
+/*
+ *  Lookup or create the shape resulting from appending (key, flags) to
+ *  'shape'.  The result is returned with its reference count increased;
+ *  the caller is responsible for releasing its reference to 'shape'.
+ *  Returns NULL if a new shape would exceed DUK_HSHAPE_MAX_COUNT keys or
+ *  'shape' already has DUK_HSHAPE_MAX_CHILDREN transitions; the caller
+ *  must then convert the object to the dictionary layout.  Throws an
+ *  error if allocation fails.
+ */
+
+DUK_INTERNAL duk_hshape *duk_hshape_get_transition(duk_hthread *thr, duk_hshape *shape, duk_hstring *key, duk_small_uint_t flags) {
+#ifdef DUK_USE_MARK_AND_SWEEP
+	duk_small_uint_t prev_mark_and_sweep_base_flags;
+#endif
+	duk_hshape *res;
+	duk_uint32_t count;
+	duk_size_t alloc_size;
+
+	DUK_ASSERT(thr != NULL);
+	DUK_ASSERT(shape != NULL);
+	DUK_ASSERT(key != NULL);
+	DUK_ASSERT(shape->refcount > 0);
+
+	count = shape->count;
+
+	for (res = shape->child; res != NULL; res = res->next) {
+		DUK_ASSERT(res->parent == shape);
+		DUK_ASSERT(res->count == count + 1);
+		if (res->keys[count] == key && res->flags[count] == (duk_uint8_t) flags) {
+			DUK_DDD(DUK_DDDPRINT("shape transition hit: %p -> %p, key=%!O",
+			                     (void *) shape, (void *) res, (duk_heaphdr *) key));
+
+			/* move to front, so that the common transitions stay cheap */
+			if (res->prev != NULL) {
+				res->prev->next = res->next;
+				if (res->next != NULL) {
+					res->next->prev = res->prev;
+				}
+				res->prev = NULL;
+				res->next = shape->child;
+				shape->child->prev = res;
+				shape->child = res;
+			}
+
+			DUK_HSHAPE_INCREF(res);
+			return res;
+		}
+	}
+
+	if (count >= DUK_HSHAPE_MAX_COUNT || shape->child_count >= DUK_HSHAPE_MAX_CHILDREN) {
+		DUK_DD(DUK_DDPRINT("no room for shape transition: %p, count %ld, child_count %ld",
+		                   (void *) shape, (long) count, (long) shape->child_count));
+		return NULL;
+	}
+
+	/*
+	 *  No existing transition, create a new shape.  Keys and flags are
+	 *  allocated together with the shape.  A GC triggered by the allocation
+	 *  must not run finalizers or compact objects: the caller's object is
+	 *  not yet consistent with the new shape.
+	 */
+
+	alloc_size = sizeof(duk_hshape) + (duk_size_t) (count + 1) * (sizeof(duk_hstring *) + sizeof(duk_uint8_t));
+
+#ifdef DUK_USE_MARK_AND_SWEEP
+	prev_mark_and_sweep_base_flags = thr->heap->mark_and_sweep_base_flags;
+	thr->heap->mark_and_sweep_base_flags |=
+	        DUK_MS_FLAG_NO_FINALIZERS |
+	        DUK_MS_FLAG_NO_OBJECT_COMPACTION;
+#endif
+
+	res = (duk_hshape *) DUK_ALLOC(thr->heap, alloc_size);
+
+#ifdef DUK_USE_MARK_AND_SWEEP
+	thr->heap->mark_and_sweep_base_flags = prev_mark_and_sweep_base_flags;
+#endif
+
+	if (!res) {
+		DUK_ERROR(thr, DUK_ERR_ALLOC_ERROR, DUK_STR_OBJECT_RESIZE_FAILED);
+	}
+
+	res->keys = (duk_hstring **) (void *) (res + 1);
+	res->flags = (duk_uint8_t *) (void *) (res->keys + (count + 1));
+	if (count > 0) {
+		DUK_MEMCPY((void *) res->keys, (void *) shape->keys, sizeof(duk_hstring *) * count);
+		DUK_MEMCPY((void *) res->flags, (void *) shape->flags, sizeof(duk_uint8_t) * count);
+	}
+	res->keys[count] = key;
+	res->flags[count] = (duk_uint8_t) flags;
+	res->count = count + 1;
+	res->refcount = 1;  /* caller's reference */
+	res->child = NULL;
+	res->child_count = 0;
+	res->enum_shape = NULL;
+	res->enum_flags = 0;
+
+	/* link into parent's transition list */
+	res->parent = shape;
+	DUK_HSHAPE_INCREF(shape);
+	res->prev = NULL;
+	res->next = shape->child;
+	if (shape->child) {
+		shape->child->prev = res;
+	}
+	shape->child = res;
+	shape->child_count++;
+
+	DUK_DD(DUK_DDPRINT("created shape %p, parent %p, count %ld, key=%!O",
+	                   (void *) res, (void *) shape, (long) res->count, (duk_heaphdr *) key));
+
+	return res;
+}
+
+/*
+ *  Release a shape reference.  A shape whose reference count drops to zero
+ *  is unlinked and freed, which releases its reference to the parent.  The
+ *  heap root shape is never freed here; the heap holds a reference to it.
+ *  Never throws or causes side effects (may be called during sweep).
+ */
+
+DUK_INTERNAL void duk_hshape_decref(duk_heap *heap, duk_hshape *shape) {
+	duk_hshape *parent;
+
+	DUK_ASSERT(heap != NULL);
+	DUK_ASSERT(shape != NULL);
+
+	for (;;) {
+		DUK_ASSERT(shape->refcount > 0);
+		if (--shape->refcount > 0) {
+			return;
+		}
+
+		/* children hold a reference, so there can be none */
+		DUK_ASSERT(shape->child == NULL);
+		DUK_ASSERT(shape != &heap->shape_root);
+
+		parent = shape->parent;
+		DUK_ASSERT(parent != NULL);
+		if (shape->prev) {
+			shape->prev->next = shape->next;
+		} else {
+			DUK_ASSERT(parent->child == shape);
+			parent->child = shape->next;
+		}
+		if (shape->next) {
+			shape->next->prev = shape->prev;
+		}
+		DUK_ASSERT(parent->child_count > 0);
+		parent->child_count--;
+
+		/* An enumerator shape is never an ancestor of the shape caching
+		 * it, so this recursion cannot free 'parent'.
+		 */
+		if (shape->enum_shape) {
+			duk_hshape_decref(heap, shape->enum_shape);
+		}
+
+		DUK_DDD(DUK_DDDPRINT("free shape %p, count %ld", (void *) shape, (long) shape->count));
+		DUK_FREE(heap, (void *) shape);
+
+		shape = parent;
+	}
+}
+
+#endif  /* DUK_USE_HOBJECT_SHAPES */
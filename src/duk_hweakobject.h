@@ -0,0 +1,68 @@
+/*
+ *  Heap weak object representation.  Used for WeakMap and Duktape.WeakRef.
+ *
+ *  A weak object owns an open addressing hash table of entries keyed by
+ *  object pointer.  Keys are weak: they don't contribute to reference
+ *  counts and are not marked by mark-and-sweep.  WeakMap values are
+ *  ephemerons: they hold a reference count, but mark-and-sweep only marks
+ *  a value once its key has been found reachable some other way.  A WeakRef
+ *  has a single entry whose key is the target and whose value is unused.
+ *
+ *  All weak objects are linked into heap->weak_objects.  When an object
+ *  which has been used as a key (DUK_HOBJECT_FLAG_WEAKKEY) is freed by
+ *  refcounting, its entries are removed from all weak objects; mark-and-sweep
+ *  removes entries of unreachable keys in one pass before sweeping.
+ */
+
+#ifndef DUK_HWEAKOBJECT_H_INCLUDED
+#define DUK_HWEAKOBJECT_H_INCLUDED
+
+/* Table size is zero or a power of two, and live plus deleted entries are
+ * kept at or below 3/4 of the size so that probing always terminates.
+ */
+#define DUK_HWEAKOBJECT_MIN_SIZE               2
+
+/* Deleted entry marker.  The heap structure is never a valid key. */
+#define DUK_HWEAKOBJECT_DELETED_KEY(heap)      ((duk_hobject *) (void *) (heap))
+
+#define DUK_HWEAKOBJECT_ENTRY_IS_USED(heap,e) \
+	((e)->key != NULL && (e)->key != DUK_HWEAKOBJECT_DELETED_KEY((heap)))
+
+struct duk_weakentry {
+	duk_hobject *key;           /* NULL if never used, DUK_HWEAKOBJECT_DELETED_KEY() if deleted */
+	duk_tval value;             /* undefined for WeakRef */
+};
+
+struct duk_hweakobject {
+	/* shared object part */
+	duk_hobject obj;
+
+	/* heap->weak_objects list */
+	duk_hweakobject *next;
+	duk_hweakobject *prev;
+
+	/* Entry table, allocated with DUK_ALLOC(); NULL if size is zero. */
+	duk_weakentry *entries;
+	duk_uint32_t size;
+	duk_uint32_t used;          /* live entries */
+	duk_uint32_t deleted;       /* deleted entries, reclaimed on rehash */
+};
+
+/*
+ *  Prototypes
+ */
+
+#if defined(DUK_USE_WEAK_REFERENCES)
+DUK_INTERNAL_DECL duk_weakentry *duk_hweakobject_find(duk_heap *heap, duk_hweakobject *h, duk_hobject *key);
+DUK_INTERNAL_DECL void duk_hweakobject_put(duk_hthread *thr, duk_hweakobject *h, duk_hobject *key, duk_tval *tv_val);
+DUK_INTERNAL_DECL duk_bool_t duk_hweakobject_remove(duk_hthread *thr, duk_hweakobject *h, duk_hobject *key);
+DUK_INTERNAL_DECL void duk_hweakobject_delete_entry(duk_hthread *thr, duk_hweakobject *h, duk_weakentry *e);
+DUK_INTERNAL_DECL void duk_hweakobject_release_if_empty(duk_heap *heap, duk_hweakobject *h);
+DUK_INTERNAL_DECL void duk_hweakobject_clear(duk_hthread *thr, duk_hweakobject *h);
+#if defined(DUK_USE_REFERENCE_COUNTING)
+DUK_INTERNAL_DECL void duk_hweakobject_key_freed(duk_hthread *thr, duk_hobject *key);
+#endif
+DUK_INTERNAL_DECL void duk_hweakobject_free_inner(duk_heap *heap, duk_hweakobject *h);
+#endif  /* DUK_USE_WEAK_REFERENCES */
+
+#endif  /* DUK_HWEAKOBJECT_H_INCLUDED */
@@ -0,0 +1,293 @@
+/*
+ *  duk_hweakobject entry table helpers.  Used by the WeakMap and WeakRef
+ *  built-ins, refcount finalization, and mark-and-sweep.
+ *
+ *  The table uses linear probing.  Entries are never moved except when the
+ *  whole table is rehashed, so garbage collection can delete entries while
+ *  iterating a table.  Rehashing allocates with DUK_ALLOC() which may run
+ *  a mark-and-sweep and finalizers; the table is kept consistent across the
+ *  allocation and callers re-probe afterwards.
+ */
+
+#include "duk_internal.h"
+
+#if defined(DUK_USE_WEAK_REFERENCES)
+
+/* Small enough that the table byte size can't overflow a 32-bit size_t. */
+#define DUK__WEAK_MAX_SIZE  0x01000000UL
+
+DUK_LOCAL duk_uint32_t duk__weak_hash(duk_hobject *key) {
+	duk_uintptr_t p;
+	duk_uint32_t h;
+
+	/* Pointers have zero low bits and may differ only in the high bits
+	 * on 64-bit platforms, so fold and mix.
+	 */
+	p = (duk_uintptr_t) (void *) key;
+	h = (duk_uint32_t) p ^ (duk_uint32_t) ((p >> 16) >> 16);
+	h ^= h >> 16;
+	h *= 0x85ebca6bUL;
+	h ^= h >> 13;
+	return h;
+}
+
+DUK_INTERNAL duk_weakentry *duk_hweakobject_find(duk_heap *heap, duk_hweakobject *h, duk_hobject *key) {
+	duk_uint32_t mask;
+	duk_uint32_t i;
+	duk_weakentry *e;
+
+	DUK_ASSERT(key != NULL);
+	DUK_ASSERT(key != DUK_HWEAKOBJECT_DELETED_KEY(heap));
+	DUK_UNREF(heap);
+
+	if (h->size == 0) {
+		return NULL;
+	}
+	mask = h->size - 1;
+	i = duk__weak_hash(key) & mask;
+	for (;;) {
+		/* Terminates because the table always has unused slots. */
+		e = h->entries + i;
+		if (e->key == key) {
+			return e;
+		} else if (e->key == NULL) {
+			return NULL;
+		}
+		i = (i + 1) & mask;
+	}
+}
+
+/* Grow or rehash the table so that one more entry fits. */
+DUK_LOCAL void duk__weak_resize(duk_hthread *thr, duk_hweakobject *h) {
+	duk_heap *heap;
+	duk_weakentry *new_entries;
+	duk_weakentry *old_entries;
+	duk_weakentry *e;
+	duk_uint32_t new_size;
+	duk_uint32_t i;
+	duk_uint32_t j;
+	duk_uint32_t mask;
+
+	heap = thr->heap;
+
+	for (;;) {
+		new_size = DUK_HWEAKOBJECT_MIN_SIZE;
+		while ((duk_size_t) new_size < ((duk_size_t) h->used + 1) * 2) {
+			if (new_size >= DUK__WEAK_MAX_SIZE) {
+				DUK_ERROR(thr, DUK_ERR_RANGE_ERROR, DUK_STR_OBJECT_ALLOC_FAILED);
+			}
+			new_size *= 2;
+		}
+
+		new_entries = (duk_weakentry *) DUK_ALLOC(heap, sizeof(duk_weakentry) * (duk_size_t) new_size);
+		if (!new_entries) {
+			DUK_ERROR(thr, DUK_ERR_ALLOC_ERROR, DUK_STR_OBJECT_ALLOC_FAILED);
+		}
+
+		/* Finalizers run by the allocation may have added entries. */
+		if ((duk_size_t) new_size >= ((duk_size_t) h->used + 1) * 2) {
+			break;
+		}
+		DUK_FREE(heap, (void *) new_entries);
+	}
+
+	DUK_DD(DUK_DDPRINT("resize weak object %p: size %ld -> %ld, used %ld, deleted %ld",
+	                   (void *) h, (long) h->size, (long) new_size, (long) h->used, (long) h->deleted));
+
+	for (i = 0; i < new_size; i++) {
+		new_entries[i].key = NULL;
+		DUK_TVAL_SET_UNDEFINED_ACTUAL(&new_entries[i].value);
+	}
+
+	/* No side effects from here on; refcounts move with the values. */
+	mask = new_size - 1;
+	for (i = 0; i < h->size; i++) {
+		e = h->entries + i;
+		if (!DUK_HWEAKOBJECT_ENTRY_IS_USED(heap, e)) {
+			continue;
+		}
+		j = duk__weak_hash(e->key) & mask;
+		while (new_entries[j].key != NULL) {
+			j = (j + 1) & mask;
+		}
+		new_entries[j].key = e->key;
+		DUK_TVAL_SET_TVAL(&new_entries[j].value, &e->value);
+	}
+
+	old_entries = h->entries;
+	h->entries = new_entries;
+	h->size = new_size;
+	h->deleted = 0;
+	DUK_FREE(heap, (void *) old_entries);
+}
+
+/* Set the value for 'key', replacing an existing value.  May have side
+ * effects (allocation, finalizers).  The caller must keep the key and the
+ * value reachable, e.g. on the value stack; 'tv_val' is copied first
+ * because a finalizer may resize the value stack.
+ */
+DUK_INTERNAL void duk_hweakobject_put(duk_hthread *thr, duk_hweakobject *h, duk_hobject *key, duk_tval *tv_val) {
+	duk_heap *heap;
+	duk_weakentry *e;
+	duk_tval tv_new;
+	duk_tval tv_old;
+	duk_uint32_t mask;
+	duk_uint32_t i;
+
+	DUK_ASSERT(thr != NULL);
+	DUK_ASSERT(h != NULL);
+	DUK_ASSERT(key != NULL);
+	DUK_ASSERT(tv_val != NULL);
+
+	heap = thr->heap;
+	DUK_TVAL_SET_TVAL(&tv_new, tv_val);
+
+	for (;;) {
+		e = duk_hweakobject_find(heap, h, key);
+		if (e != NULL) {
+			DUK_TVAL_SET_TVAL(&tv_old, &e->value);
+			DUK_TVAL_SET_TVAL(&e->value, &tv_new);
+			DUK_TVAL_INCREF(thr, &e->value);
+			DUK_TVAL_DECREF(thr, &tv_old);  /* side effects */
+			return;
+		}
+		if (((duk_size_t) h->used + (duk_size_t) h->deleted + 1) * 4 <= (duk_size_t) h->size * 3) {
+			break;
+		}
+		duk__weak_resize(thr, h);
+	}
+
+	/* Key is not present, so the first unused or deleted slot can be
+	 * taken.
+	 */
+	mask = h->size - 1;
+	i = duk__weak_hash(key) & mask;
+	for (;;) {
+		e = h->entries + i;
+		if (e->key == NULL) {
+			break;
+		} else if (e->key == DUK_HWEAKOBJECT_DELETED_KEY(heap)) {
+			DUK_ASSERT(h->deleted > 0);
+			h->deleted--;
+			break;
+		}
+		i = (i + 1) & mask;
+	}
+
+	e->key = key;
+	DUK_TVAL_SET_TVAL(&e->value, &tv_new);
+	DUK_TVAL_INCREF(thr, &e->value);
+	h->used++;
+	DUK_HOBJECT_SET_WEAKKEY(key);
+}
+
+/* Remove an entry without decref'ing the value; the old value is written
+ * to 'tv_out'.
+ */
+DUK_LOCAL void duk__weak_unlink_entry(duk_heap *heap, duk_hweakobject *h, duk_weakentry *e, duk_tval *tv_out) {
+	DUK_ASSERT(DUK_HWEAKOBJECT_ENTRY_IS_USED(heap, e));
+	DUK_ASSERT(h->used > 0);
+
+	DUK_TVAL_SET_TVAL(tv_out, &e->value);
+	e->key = DUK_HWEAKOBJECT_DELETED_KEY(heap);
+	DUK_TVAL_SET_UNDEFINED_ACTUAL(&e->value);
+	h->used--;
+	h->deleted++;
+}
+
+/* Free the entry table once the last entry is gone. */
+DUK_INTERNAL void duk_hweakobject_release_if_empty(duk_heap *heap, duk_hweakobject *h) {
+	if (h->used == 0 && h->entries != NULL) {
+		DUK_FREE(heap, (void *) h->entries);
+		h->entries = NULL;
+		h->size = 0;
+		h->deleted = 0;
+	}
+}
+
+/* Remove 'key'; returns true if it was present.  May have side effects
+ * (finalizers) through the value decref.
+ */
+DUK_INTERNAL duk_bool_t duk_hweakobject_remove(duk_hthread *thr, duk_hweakobject *h, duk_hobject *key) {
+	duk_heap *heap;
+	duk_weakentry *e;
+	duk_tval tv_old;
+
+	heap = thr->heap;
+	e = duk_hweakobject_find(heap, h, key);
+	if (e == NULL) {
+		return 0;
+	}
+	duk__weak_unlink_entry(heap, h, e, &tv_old);
+	duk_hweakobject_release_if_empty(heap, h);
+	DUK_TVAL_DECREF(thr, &tv_old);  /* side effects */
+	return 1;
+}
+
+/* Remove an entry while iterating the table.  The table is not freed even
+ * if it becomes empty.  Only for callers where a decref has no side effects
+ * (refzero processing and mark-and-sweep).
+ */
+DUK_INTERNAL void duk_hweakobject_delete_entry(duk_hthread *thr, duk_hweakobject *h, duk_weakentry *e) {
+	duk_tval tv_old;
+
+	duk__weak_unlink_entry(thr->heap, h, e, &tv_old);
+	DUK_TVAL_DECREF(thr, &tv_old);
+	DUK_UNREF(tv_old);
+}
+
+/* Remove all entries and free the table.  Same decref restrictions as for
+ * duk_hweakobject_delete_entry().
+ */
+DUK_INTERNAL void duk_hweakobject_clear(duk_hthread *thr, duk_hweakobject *h) {
+	duk_heap *heap;
+	duk_uint32_t i;
+
+	heap = thr->heap;
+	for (i = 0; i < h->size; i++) {
+		duk_weakentry *e = h->entries + i;
+		if (DUK_HWEAKOBJECT_ENTRY_IS_USED(heap, e)) {
+			duk_hweakobject_delete_entry(thr, h, e);
+		}
+	}
+	DUK_ASSERT(h->used == 0);
+	duk_hweakobject_release_if_empty(heap, h);
+}
+
+#if defined(DUK_USE_REFERENCE_COUNTING)
+/* Called from refcount finalization of a key which is about to be freed. */
+DUK_INTERNAL void duk_hweakobject_key_freed(duk_hthread *thr, duk_hobject *key) {
+	duk_heap *heap;
+	duk_hweakobject *h;
+	duk_weakentry *e;
+
+	heap = thr->heap;
+	for (h = heap->weak_objects; h != NULL; h = h->next) {
+		/* XXX: every freed key probes every weak object, which is
+		 * slow with a very large number of WeakRefs.
+		 */
+		e = duk_hweakobject_find(heap, h, key);
+		if (e != NULL) {
+			DUK_DDD(DUK_DDDPRINT("key %p freed, remove from weak object %p", (void *) key, (void *) h));
+			duk_hweakobject_delete_entry(thr, h, e);
+			duk_hweakobject_release_if_empty(heap, h);
+		}
+	}
+}
+#endif  /* DUK_USE_REFERENCE_COUNTING */
+
+/* Unlink from the heap list and free the entry table, no decrefs. */
+DUK_INTERNAL void duk_hweakobject_free_inner(duk_heap *heap, duk_hweakobject *h) {
+	if (h->prev != NULL) {
+		h->prev->next = h->next;
+	} else {
+		DUK_ASSERT(heap->weak_objects == h);
+		heap->weak_objects = h->next;
+	}
+	if (h->next != NULL) {
+		h->next->prev = h->prev;
+	}
+	DUK_FREE(heap, (void *) h->entries);
+}
+
+#endif  /* DUK_USE_WEAK_REFERENCES */
@@ -12,7 +12,11 @@
 #define DUK_JMPBUF_H_INCLUDED
 
 struct duk_jmpbuf {
+#if defined(DUK_USE_SIGSETJMP)
+	sigjmp_buf jb;
+#else
 	jmp_buf jb;
+#endif
 };
 
 #endif  /* DUK_JMPBUF_H_INCLUDED */
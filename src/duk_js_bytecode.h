@@ -133,7 +133,7 @@ typedef duk_uint32_t duk_instr_t;
 #define DUK_OP_BREAK                56
 #define DUK_OP_CONTINUE             57
 #define DUK_OP_TRYCATCH             58
-#define DUK_OP_UNUSED59             59
+#define DUK_OP_IFCMP                59
 #define DUK_OP_UNUSED60             60
 #define DUK_OP_UNUSED61             61
 #define DUK_OP_EXTRA                62
@@ -167,6 +167,8 @@ typedef duk_uint32_t duk_instr_t;
 #define DUK_EXTRAOP_UNP             24
 #define DUK_EXTRAOP_INC             25
 #define DUK_EXTRAOP_DEC             26
+#define DUK_EXTRAOP_POSTINC         27
+#define DUK_EXTRAOP_POSTDEC         28
 
 /* DUK_OP_EXTRA for debugging */
 #define DUK_EXTRAOP_DUMPREG         128
@@ -184,6 +186,12 @@ typedef duk_uint32_t duk_instr_t;
 #define DUK_BC_TRYCATCH_FLAG_CATCH_BINDING  (1 << 2)
 #define DUK_BC_TRYCATCH_FLAG_WITH_BINDING   (1 << 3)
 
+/* DUK_OP_IFCMP: comparison opcode relative to DUK_OP_EQ in A bits 0-2,
+ * skip next instruction if comparison result matches the sense flag
+ */
+#define DUK_BC_IFCMP_OP_MASK                0x07
+#define DUK_BC_IFCMP_FLAG_SENSE             (1 << 3)
+
 /* DUK_OP_RETURN flags in A */
 #define DUK_BC_RETURN_FLAG_FAST             (1 << 0)
 #define DUK_BC_RETURN_FLAG_HAVE_RETVAL      (1 << 1)
@@ -716,7 +716,8 @@ duk_hobject *duk__nonbound_func_lookup(duk_context *ctx,
  *    - thr matches heap->curr_thread, and thr is already RUNNING
  *    - thr does not match heap->curr_thread (may be NULL or other),
  *      and thr is INACTIVE (in this case, a setjmp() catchpoint is
- *      always used for thread book-keeping to work properly)
+ *      used for thread book-keeping to work properly, unless an error
+ *      would be fatal anyway)
  *
  *  Like elsewhere, gotos are used to keep indent level minimal and
  *  avoiding a dozen helpers with awkward plumbing.
@@ -784,9 +785,13 @@ duk_int_t duk_handle_call(duk_hthread *thr,
 	idx_args = idx_func + 2;                                   /* idx_args is not necessarily valid if num_stack_args == 0 (idx_args then equals top) */
 
 	/* Need a setjmp() catchpoint if a protected call OR if we need to
-	 * do mandatory cleanup.
+	 * do mandatory cleanup.  Cleanup is only needed when an outer
+	 * catchpoint exists: without one an error is fatal anyway, so e.g.
+	 * an unprotected call made directly from application code doesn't
+	 * pay for a catchpoint.
 	 */
-	need_setjmp = ((call_flags & DUK_CALL_FLAG_PROTECTED) != 0) || (thr->heap->curr_thread != thr);
+	need_setjmp = ((call_flags & DUK_CALL_FLAG_PROTECTED) != 0) ||
+	              (thr->heap->curr_thread != thr && thr->heap->lj.jmpbuf_ptr != NULL);
 
 	DUK_DD(DUK_DDPRINT("duk_handle_call: thr=%p, num_stack_args=%ld, "
 	                   "call_flags=0x%08lx (protected=%ld, ignorerec=%ld, constructor=%ld), need_setjmp=%ld, "
@@ -1513,6 +1518,9 @@ duk_int_t duk_handle_call(duk_hthread *thr,
 
 	thr->heap->call_recursion_depth = entry_call_recursion_depth;
 
+	/* Safe point for batched refzero work, the call is complete. */
+	DUK_HEAP_REFZERO_SAFE_POINT(thr);
+
 	return retval;
 
  thread_state_error:
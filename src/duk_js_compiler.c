@@ -112,7 +112,9 @@ DUK_LOCAL_DECL void duk__insert_jump_entry(duk_compiler_ctx *comp_ctx, duk_int_t
 DUK_LOCAL_DECL void duk__patch_jump(duk_compiler_ctx *comp_ctx, duk_int_t jump_pc, duk_int_t target_pc);
 DUK_LOCAL_DECL void duk__patch_jump_here(duk_compiler_ctx *comp_ctx, duk_int_t jump_pc);
 DUK_LOCAL_DECL void duk__patch_trycatch(duk_compiler_ctx *comp_ctx, duk_int_t trycatch_pc, duk_regconst_t reg_catch, duk_regconst_t const_varname, duk_small_uint_t flags);
+#if 0  /* unused */
 DUK_LOCAL_DECL void duk__emit_if_false_skip(duk_compiler_ctx *comp_ctx, duk_regconst_t regconst);
+#endif
 DUK_LOCAL_DECL void duk__emit_if_true_skip(duk_compiler_ctx *comp_ctx, duk_regconst_t regconst);
 DUK_LOCAL_DECL void duk__emit_invalid(duk_compiler_ctx *comp_ctx);
 
@@ -129,7 +131,9 @@ duk_regconst_t duk__ispec_toregconst_raw(duk_compiler_ctx *comp_ctx,
                                          duk_ispec *x,
                                          duk_reg_t forced_reg,
                                          duk_small_uint_t flags);
+#if 0  /* unused */
 DUK_LOCAL_DECL void duk__ispec_toforcedreg(duk_compiler_ctx *comp_ctx, duk_ispec *x, duk_reg_t forced_reg);
+#endif
 DUK_LOCAL_DECL void duk__ivalue_toplain_raw(duk_compiler_ctx *comp_ctx, duk_ivalue *x, duk_reg_t forced_reg);
 DUK_LOCAL_DECL void duk__ivalue_toplain(duk_compiler_ctx *comp_ctx, duk_ivalue *x);
 DUK_LOCAL_DECL void duk__ivalue_toplain_ignore(duk_compiler_ctx *comp_ctx, duk_ivalue *x);
@@ -144,6 +148,7 @@ DUK_LOCAL_DECL duk_reg_t duk__ivalue_totempreg(duk_compiler_ctx *comp_ctx, duk_i
 #endif
 DUK_LOCAL_DECL void duk__ivalue_toforcedreg(duk_compiler_ctx *comp_ctx, duk_ivalue *x, duk_int_t forced_reg);
 DUK_LOCAL_DECL duk_regconst_t duk__ivalue_toregconst(duk_compiler_ctx *comp_ctx, duk_ivalue *x);
+DUK_LOCAL_DECL void duk__emit_ivalue_if_skip(duk_compiler_ctx *comp_ctx, duk_ivalue *x, duk_small_uint_t sense);
 
 /* identifier handling */
 DUK_LOCAL_DECL duk_reg_t duk__lookup_active_register_binding(duk_compiler_ctx *comp_ctx);
@@ -578,6 +583,9 @@ DUK_LOCAL duk_int_t duk__cleanup_varmap(duk_compiler_ctx *comp_ctx) {
 	h_varmap = duk_get_hobject(ctx, -1);
 	DUK_ASSERT(h_varmap != NULL);
 
+	/* keys are deleted in place below */
+	DUK_HOBJECT_UNSHAPE(thr, h_varmap);
+
 	ret = 0;
 	e_next = DUK_HOBJECT_GET_ENEXT(h_varmap);
 	for (i = 0; i < e_next; i++) {
@@ -1522,9 +1530,11 @@ DUK_LOCAL void duk__patch_trycatch(duk_compiler_ctx *comp_ctx, duk_int_t trycatc
 	instr->ins = DUK_ENC_OP_A_B_C(DUK_OP_TRYCATCH, flags, reg_catch, const_varname);
 }
 
+#if 0  /* unused */
 DUK_LOCAL void duk__emit_if_false_skip(duk_compiler_ctx *comp_ctx, duk_regconst_t regconst) {
 	duk__emit_a_b_c(comp_ctx, DUK_OP_IF, 0 /*false*/, regconst, 0);
 }
+#endif
 
 DUK_LOCAL void duk__emit_if_true_skip(duk_compiler_ctx *comp_ctx, duk_regconst_t regconst) {
 	duk__emit_a_b_c(comp_ctx, DUK_OP_IF, 1 /*true*/, regconst, 0);
@@ -1917,10 +1927,12 @@ duk_regconst_t duk__ispec_toregconst_raw(duk_compiler_ctx *comp_ctx,
 	return 0;
 }
 
+#if 0  /* unused */
 DUK_LOCAL void duk__ispec_toforcedreg(duk_compiler_ctx *comp_ctx, duk_ispec *x, duk_reg_t forced_reg) {
 	DUK_ASSERT(forced_reg >= 0);
 	(void) duk__ispec_toregconst_raw(comp_ctx, x, forced_reg, 0 /*flags*/);
 }
+#endif
 
 /* Coerce an duk_ivalue to a 'plain' value by generating the necessary
  * arithmetic operations, property access, or variable access bytecode.
@@ -2174,6 +2186,30 @@ DUK_LOCAL duk_regconst_t duk__ivalue_toregconst(duk_compiler_ctx *comp_ctx, duk_
 	return duk__ivalue_toregconst_raw(comp_ctx, x, -1, DUK__IVAL_FLAG_ALLOW_CONST /*flags*/);
 }
 
+/* Emit a conditional skip for an expression value: the next instruction
+ * is skipped if ToBoolean() of the value matches 'sense'.  A comparison
+ * ivalue is emitted as a single IFCMP so that the intermediate boolean is
+ * never written into a register.  The ivalue is consumed.
+ */
+DUK_LOCAL void duk__emit_ivalue_if_skip(duk_compiler_ctx *comp_ctx, duk_ivalue *x, duk_small_uint_t sense) {
+	duk_regconst_t arg1;
+	duk_regconst_t arg2;
+
+	if (x->t == DUK_IVAL_ARITH && x->op >= DUK_OP_EQ && x->op <= DUK_OP_LE) {
+		arg1 = duk__ispec_toregconst_raw(comp_ctx, &x->x1, -1, DUK__IVAL_FLAG_ALLOW_CONST | DUK__IVAL_FLAG_REQUIRE_SHORT /*flags*/);
+		arg2 = duk__ispec_toregconst_raw(comp_ctx, &x->x2, -1, DUK__IVAL_FLAG_ALLOW_CONST | DUK__IVAL_FLAG_REQUIRE_SHORT /*flags*/);
+		duk__emit_a_b_c(comp_ctx,
+		                DUK_OP_IFCMP | DUK__EMIT_FLAG_NO_SHUFFLE_A,
+		                (duk_regconst_t) ((x->op - DUK_OP_EQ) | (sense ? DUK_BC_IFCMP_FLAG_SENSE : 0)),
+		                arg1,
+		                arg2);
+		return;
+	}
+
+	arg1 = duk__ivalue_toregconst(comp_ctx, x);
+	duk__emit_a_b_c(comp_ctx, DUK_OP_IF, (duk_regconst_t) (sense ? 1 : 0), arg1, 0);
+}
+
 /* The issues below can be solved with better flags */
 
 /* XXX: many operations actually want toforcedtemp() -- brand new temp? */
@@ -3673,15 +3709,22 @@ DUK_LOCAL void duk__expr_led(duk_compiler_ctx *comp_ctx, duk_ivalue *left, duk_i
 				              rc_varname);
 			}
 		} else if (left->t == DUK_IVAL_PROP) {
+			duk_reg_t reg_base;
+			duk_regconst_t rc_key;
+
 			DUK_DDD(DUK_DDDPRINT("function call with property base"));
 
-			duk__ispec_toforcedreg(comp_ctx, &left->x1, reg_cs + 0);  /* base */
-			duk__ispec_toforcedreg(comp_ctx, &left->x2, reg_cs + 1);  /* key */
+			/* Base and key are used directly when they're already in a
+			 * register or a constant (e.g. 'obj.method(...)' with a register
+			 * bound 'obj'), CSPROP copies them into the call setup registers.
+			 */
+			reg_base = duk__ispec_toregconst_raw(comp_ctx, &left->x1, -1 /*forced_reg*/, 0 /*flags*/);  /* base, don't allow const */
+			rc_key = duk__ispec_toregconst_raw(comp_ctx, &left->x2, -1 /*forced_reg*/, DUK__IVAL_FLAG_ALLOW_CONST /*flags*/);
 			duk__emit_a_b_c(comp_ctx,
 			                DUK_OP_CSPROP,
 			                (duk_regconst_t) (reg_cs + 0),
-			                (duk_regconst_t) (reg_cs + 0),
-			                (duk_regconst_t) (reg_cs + 1));  /* in-place setup */
+			                (duk_regconst_t) reg_base,
+			                rc_key);
 		} else {
 			DUK_DDD(DUK_DDDPRINT("function call with register base"));
 
@@ -4259,18 +4302,31 @@ DUK_LOCAL void duk__expr_led(duk_compiler_ctx *comp_ctx, duk_ivalue *left, duk_i
 
 			duk_dup(ctx, left->x1.valstack_idx);
 			if (duk__lookup_lhs(comp_ctx, &reg_varbind, &rc_varname)) {
-				duk__emit_a_bc(comp_ctx,
-				               DUK_OP_LDREG,
-				               (duk_regconst_t) reg_res,
-				               (duk_regconst_t) reg_varbind);
-				duk__emit_extraop_b_c(comp_ctx,
-				                      DUK_EXTRAOP_TONUM | DUK__EMIT_FLAG_B_IS_TARGET,
-				                      (duk_regconst_t) reg_res,
-				                      (duk_regconst_t) reg_res);
-				duk__emit_extraop_b_c(comp_ctx,
-				                      args_op | DUK__EMIT_FLAG_B_IS_TARGET,
-				                      (duk_regconst_t) reg_varbind,
-				                      (duk_regconst_t) reg_res);
+				if (reg_varbind <= 0xff) {
+					/* Common case, e.g. 'i++' in a loop: a single
+					 * instruction coerces the variable, stores the
+					 * result and updates the variable in place.  The
+					 * variable register must not be shuffled.
+					 */
+					duk__emit_extraop_b_c(comp_ctx,
+					                      (args_op == DUK_EXTRAOP_INC ? DUK_EXTRAOP_POSTINC : DUK_EXTRAOP_POSTDEC) |
+					                      DUK__EMIT_FLAG_B_IS_TARGET,
+					                      (duk_regconst_t) reg_res,
+					                      (duk_regconst_t) reg_varbind);
+				} else {
+					duk__emit_a_bc(comp_ctx,
+					               DUK_OP_LDREG,
+					               (duk_regconst_t) reg_res,
+					               (duk_regconst_t) reg_varbind);
+					duk__emit_extraop_b_c(comp_ctx,
+					                      DUK_EXTRAOP_TONUM | DUK__EMIT_FLAG_B_IS_TARGET,
+					                      (duk_regconst_t) reg_res,
+					                      (duk_regconst_t) reg_res);
+					duk__emit_extraop_b_c(comp_ctx,
+					                      args_op | DUK__EMIT_FLAG_B_IS_TARGET,
+					                      (duk_regconst_t) reg_varbind,
+					                      (duk_regconst_t) reg_res);
+				}
 			} else {
 				duk_reg_t reg_temp = DUK__ALLOCTEMP(comp_ctx);
 				duk__emit_a_bc(comp_ctx,
@@ -4856,7 +4912,6 @@ DUK_LOCAL void duk__parse_for_stmt(duk_compiler_ctx *comp_ctx, duk_ivalue *res,
 	 *  reg_temps + 1: unused
 	 */
 	{
-		duk_regconst_t rc_cond;
 		duk_int_t pc_l1, pc_l2, pc_l3, pc_l4;
 		duk_int_t pc_jumpto_l3, pc_jumpto_l4;
 		duk_bool_t expr_c_empty;
@@ -4876,8 +4931,7 @@ DUK_LOCAL void duk__parse_for_stmt(duk_compiler_ctx *comp_ctx, duk_ivalue *res,
 			pc_jumpto_l3 = duk__emit_jump_empty(comp_ctx);  /* to body */
 			pc_jumpto_l4 = -1;  /* omitted */
 		} else {
-			rc_cond = duk__ivalue_toregconst(comp_ctx, res);
-			duk__emit_if_false_skip(comp_ctx, rc_cond);
+			duk__emit_ivalue_if_skip(comp_ctx, res, 0 /*sense*/);
 			pc_jumpto_l3 = duk__emit_jump_empty(comp_ctx);  /* to body */
 			pc_jumpto_l4 = duk__emit_jump_empty(comp_ctx);  /* to exit */
 		}
@@ -5226,7 +5280,6 @@ DUK_LOCAL void duk__parse_switch_stmt(duk_compiler_ctx *comp_ctx, duk_ivalue *re
 
 DUK_LOCAL void duk__parse_if_stmt(duk_compiler_ctx *comp_ctx, duk_ivalue *res) {
 	duk_reg_t temp_reset;
-	duk_regconst_t rc_cond;
 	duk_int_t pc_jump_false;
 
 	DUK_DDD(DUK_DDDPRINT("begin parsing if statement"));
@@ -5236,8 +5289,8 @@ DUK_LOCAL void duk__parse_if_stmt(duk_compiler_ctx *comp_ctx, duk_ivalue *res) {
 	duk__advance(comp_ctx);  /* eat 'if' */
 	duk__advance_expect(comp_ctx, DUK_TOK_LPAREN);
 
-	rc_cond = duk__exprtop_toregconst(comp_ctx, res, DUK__BP_FOR_EXPR /*rbp_flags*/);
-	duk__emit_if_true_skip(comp_ctx, rc_cond);
+	duk__exprtop(comp_ctx, res, DUK__BP_FOR_EXPR /*rbp_flags*/);
+	duk__emit_ivalue_if_skip(comp_ctx, res, 1 /*sense*/);
 	pc_jump_false = duk__emit_jump_empty(comp_ctx);  /* jump to end or else part */
 	DUK__SETTEMP(comp_ctx, temp_reset);
 
@@ -5272,7 +5325,6 @@ DUK_LOCAL void duk__parse_if_stmt(duk_compiler_ctx *comp_ctx, duk_ivalue *res) {
 }
 
 DUK_LOCAL void duk__parse_do_stmt(duk_compiler_ctx *comp_ctx, duk_ivalue *res, duk_int_t pc_label_site) {
-	duk_regconst_t rc_cond;
 	duk_int_t pc_start;
 
 	DUK_DDD(DUK_DDDPRINT("begin parsing do statement"));
@@ -5286,8 +5338,8 @@ DUK_LOCAL void duk__parse_do_stmt(duk_compiler_ctx *comp_ctx, duk_ivalue *res, d
 	duk__advance_expect(comp_ctx, DUK_TOK_WHILE);
 	duk__advance_expect(comp_ctx, DUK_TOK_LPAREN);
 
-	rc_cond = duk__exprtop_toregconst(comp_ctx, res, DUK__BP_FOR_EXPR /*rbp_flags*/);
-	duk__emit_if_false_skip(comp_ctx, rc_cond);
+	duk__exprtop(comp_ctx, res, DUK__BP_FOR_EXPR /*rbp_flags*/);
+	duk__emit_ivalue_if_skip(comp_ctx, res, 0 /*sense*/);
 	duk__emit_jump(comp_ctx, pc_start);
 	/* no need to reset temps, as we're finished emitting code */
 
@@ -5300,7 +5352,6 @@ DUK_LOCAL void duk__parse_do_stmt(duk_compiler_ctx *comp_ctx, duk_ivalue *res, d
 
 DUK_LOCAL void duk__parse_while_stmt(duk_compiler_ctx *comp_ctx, duk_ivalue *res, duk_int_t pc_label_site) {
 	duk_reg_t temp_reset;
-	duk_regconst_t rc_cond;
 	duk_int_t pc_start;
 	duk_int_t pc_jump_false;
 
@@ -5315,8 +5366,8 @@ DUK_LOCAL void duk__parse_while_stmt(duk_compiler_ctx *comp_ctx, duk_ivalue *res
 	pc_start = duk__get_current_pc(comp_ctx);
 	duk__patch_jump_here(comp_ctx, pc_label_site + 2);  /* continue jump */
 
-	rc_cond = duk__exprtop_toregconst(comp_ctx, res, DUK__BP_FOR_EXPR /*rbp_flags*/);
-	duk__emit_if_true_skip(comp_ctx, rc_cond);
+	duk__exprtop(comp_ctx, res, DUK__BP_FOR_EXPR /*rbp_flags*/);
+	duk__emit_ivalue_if_skip(comp_ctx, res, 1 /*sense*/);
 	pc_jump_false = duk__emit_jump_empty(comp_ctx);
 	DUK__SETTEMP(comp_ctx, temp_reset);
 
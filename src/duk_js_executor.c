@@ -97,9 +97,18 @@ DUK_LOCAL void duk__vm_arith_add(duk_hthread *thr, duk_tval *tv_x, duk_tval *tv_
 	 */
 	if (duk_check_type_mask(ctx, -2, DUK_TYPE_MASK_STRING | DUK_TYPE_MASK_BUFFER) ||
 	    duk_check_type_mask(ctx, -1, DUK_TYPE_MASK_STRING | DUK_TYPE_MASK_BUFFER)) {
-		duk_to_string(ctx, -2);
-		duk_to_string(ctx, -1);
-		duk_concat(ctx, 2);  /* [... s1 s2] -> [... s1+s2] */
+		duk_hstring *h1, *h2;
+
+		h1 = duk_to_hstring(ctx, -2);
+		h2 = duk_to_hstring(ctx, -1);
+		if (DUK_HSTRING_GET_BYTELEN(h2) == 0) {
+			/* Common 'x + ""' idiom, result is the coerced 'x' as is. */
+			duk_pop(ctx);
+		} else if (DUK_HSTRING_GET_BYTELEN(h1) == 0) {
+			duk_remove(ctx, -2);
+		} else {
+			duk_concat(ctx, 2);  /* [... s1 s2] -> [... s1+s2] */
+		}
 		duk_replace(ctx, (duk_idx_t) idx_z);  /* side effects */
 	} else {
 		duk_double_t d1, d2;
@@ -353,6 +362,68 @@ DUK_LOCAL void duk__vm_arith_unary_op(duk_hthread *thr, duk_tval *tv_x, duk_smal
 	DUK_TVAL_DECREF(thr, &tv_tmp);   /* side effects */
 }
 
+DUK_LOCAL void duk__vm_arith_postincdec(duk_hthread *thr, duk_small_uint_fast_t idx_z, duk_small_uint_fast_t idx_x, duk_small_uint_fast_t opcode) {
+	/*
+	 *  Post-increment/decrement of a register bound variable: register
+	 *  'idx_z' gets ToNumber() of the old value and register 'idx_x' is
+	 *  updated in place.  Equivalent to LDREG + TONUM + INC/DEC.
+	 *
+	 *  E5 Sections 11.3.1, 11.3.2.
+	 */
+
+	duk_context *ctx = (duk_context *) thr;
+	duk_tval tv_tmp;
+	duk_tval *tv_x;
+	duk_tval *tv_z;
+	duk_double_t d1;
+	duk_double_union du;
+
+	DUK_ASSERT(thr != NULL);
+	DUK_ASSERT(ctx != NULL);
+	DUK_ASSERT(idx_z != idx_x);
+	DUK_ASSERT((duk_uint_t) idx_z < (duk_uint_t) duk_get_top(ctx));
+	DUK_ASSERT((duk_uint_t) idx_x < (duk_uint_t) duk_get_top(ctx));
+
+	tv_x = thr->valstack_bottom + idx_x;
+	tv_z = thr->valstack_bottom + idx_z;
+
+	if (DUK_TVAL_IS_NUMBER(tv_x)) {
+		/* fast path */
+		d1 = DUK_TVAL_GET_NUMBER(tv_x);
+		du.d = (opcode == DUK_EXTRAOP_POSTINC ? d1 + 1.0 : d1 - 1.0);
+		DUK_DBLUNION_NORMALIZE_NAN_CHECK(&du);
+		DUK_ASSERT(DUK_DBLUNION_IS_NORMALIZED(&du));
+
+		if (DUK_TVAL_IS_NUMBER(tv_z)) {
+			DUK_TVAL_SET_NUMBER(tv_z, d1);
+			DUK_TVAL_SET_NUMBER(tv_x, du.d);
+			return;
+		}
+	} else {
+		duk_push_tval(ctx, tv_x);
+		d1 = duk_to_number(ctx, -1);  /* side effects */
+		DUK_ASSERT(duk_is_number(ctx, -1));
+		DUK_ASSERT_DOUBLE_IS_NORMALIZED(d1);
+		duk_pop(ctx);
+		du.d = (opcode == DUK_EXTRAOP_POSTINC ? d1 + 1.0 : d1 - 1.0);
+		DUK_DBLUNION_NORMALIZE_NAN_CHECK(&du);
+		DUK_ASSERT(DUK_DBLUNION_IS_NORMALIZED(&du));
+	}
+
+	/* Valstack may have been resized by side effects; decrefs have side
+	 * effects too so re-lookup each register before updating it.
+	 */
+	tv_z = thr->valstack_bottom + idx_z;
+	DUK_TVAL_SET_TVAL(&tv_tmp, tv_z);
+	DUK_TVAL_SET_NUMBER(tv_z, d1);
+	DUK_TVAL_DECREF(thr, &tv_tmp);   /* side effects */
+
+	tv_x = thr->valstack_bottom + idx_x;
+	DUK_TVAL_SET_TVAL(&tv_tmp, tv_x);
+	DUK_TVAL_SET_NUMBER(tv_x, du.d);
+	DUK_TVAL_DECREF(thr, &tv_tmp);   /* side effects */
+}
+
 DUK_LOCAL void duk__vm_bitwise_not(duk_hthread *thr, duk_tval *tv_x, duk_small_uint_fast_t idx_z) {
 	/*
 	 *  E5 Section 11.4.8
@@ -413,6 +484,79 @@ DUK_LOCAL void duk__vm_logical_not(duk_hthread *thr, duk_tval *tv_x, duk_tval *t
 	DUK_TVAL_DECREF(thr, &tv_tmp);  /* side effects */
 }
 
+/*
+ *  Typed array element fast paths for GETPROP and PUTPROP.
+ *
+ *  Handle a typed array base with a number key which is a whole number
+ *  inside the current element range; everything else (including non-number
+ *  values for a put, which need a side effecting coercion) is left for the
+ *  generic property code.  Return non-zero if the access was handled.
+ */
+
+DUK_LOCAL duk_uint32_t duk__bufobj_fast_index(duk_tval *tv_obj, duk_tval *tv_key, duk_hbufferobject **out_h) {
+	duk_hobject *h;
+	duk_double_t d;
+	duk_uint32_t idx;
+
+	if (!DUK_TVAL_IS_OBJECT(tv_obj) || !DUK_TVAL_IS_NUMBER(tv_key)) {
+		return 0xffffffffUL;
+	}
+	h = DUK_TVAL_GET_OBJECT(tv_obj);
+	DUK_ASSERT(h != NULL);
+	if (!DUK_HOBJECT_HAS_BUFFEROBJECT(h)) {
+		return 0xffffffffUL;
+	}
+	d = DUK_TVAL_GET_NUMBER(tv_key);
+	if (!(d >= 0.0 && d < 4294967295.0)) {
+		return 0xffffffffUL;
+	}
+	idx = (duk_uint32_t) d;
+	if ((duk_double_t) idx != d) {
+		return 0xffffffffUL;
+	}
+	*out_h = (duk_hbufferobject *) h;
+	return idx;
+}
+
+DUK_LOCAL duk_bool_t duk__vm_getprop_bufobj(duk_hthread *thr, duk_tval *tv_obj, duk_tval *tv_key, duk_small_uint_fast_t idx_z) {
+	duk_hbufferobject *h = NULL;
+	duk_uint32_t idx;
+	duk_tval tv_elem;
+	duk_tval tv_tmp;
+	duk_tval *tv_z;
+
+	idx = duk__bufobj_fast_index(tv_obj, tv_key, &h);
+	if (idx == 0xffffffffUL) {
+		return 0;
+	}
+	DUK_ASSERT(h != NULL);
+	if (!duk_hbufferobject_get_index(h, idx, &tv_elem)) {
+		return 0;
+	}
+
+	tv_z = thr->valstack_bottom + idx_z;
+	DUK_TVAL_SET_TVAL(&tv_tmp, tv_z);
+	DUK_TVAL_SET_TVAL(tv_z, &tv_elem);
+	DUK_ASSERT(!DUK_TVAL_IS_HEAP_ALLOCATED(tv_z));  /* no need to incref */
+	DUK_TVAL_DECREF(thr, &tv_tmp);   /* side effects */
+	return 1;
+}
+
+DUK_LOCAL duk_bool_t duk__vm_putprop_bufobj(duk_hthread *thr, duk_tval *tv_obj, duk_tval *tv_key, duk_tval *tv_val) {
+	duk_hbufferobject *h = NULL;
+	duk_uint32_t idx;
+
+	if (!DUK_TVAL_IS_NUMBER(tv_val)) {
+		return 0;
+	}
+	idx = duk__bufobj_fast_index(tv_obj, tv_key, &h);
+	if (idx == 0xffffffffUL) {
+		return 0;
+	}
+	DUK_ASSERT(h != NULL);
+	return duk_hbufferobject_put_index(thr, h, idx, tv_val);  /* no side effects for a number */
+}
+
 /*
  *  Longjmp handler for the bytecode executor (and a bunch of static
  *  helpers for it).
@@ -1356,6 +1500,18 @@ DUK_LOCAL void duk__executor_interrupt(duk_hthread *thr) {
 
 	ctr = DUK_HEAP_INTCTR_DEFAULT;
 
+#if defined(DUK_USE_REFERENCE_COUNTING)
+	/* Batched refzero work: process one batch and come back sooner if
+	 * there's more, so that a loop making no calls still frees memory.
+	 */
+	if (thr->heap->refzero_list != NULL) {
+		duk_heap_refzero_process_pending(thr, 0);
+		if (thr->heap->refzero_list != NULL) {
+			ctr = DUK_HEAP_INTCTR_REFZERO;
+		}
+	}
+#endif
+
 #if 0
 	/* XXX: cumulative instruction count example */
 	static int step_count = 0;
@@ -1592,6 +1748,12 @@ DUK_INTERNAL void duk_js_execute_bytecode(duk_hthread *entry_thread) {
 	 * though it is not the current thread (any thread will do).
 	 */
 	thr = thr->heap->curr_thread;
+
+	/* Calls and returns are safe points for batched refzero work; may
+	 * have arbitrary side effects through finalizers.
+	 */
+	DUK_HEAP_REFZERO_SAFE_POINT(thr);
+
 #ifdef DUK_USE_INTERRUPT_COUNTER
 	thr->interrupt_counter = thr->heap->interrupt_counter;
 #endif
@@ -2288,6 +2450,9 @@ DUK_INTERNAL void duk_js_execute_bytecode(duk_hthread *entry_thread) {
 
 			tv_obj = DUK__REGCONSTP(b);
 			tv_key = DUK__REGCONSTP(c);
+			if (duk__vm_getprop_bufobj(thr, tv_obj, tv_key, a)) {
+				break;
+			}
 			DUK_DDD(DUK_DDDPRINT("GETPROP: a=%ld obj=%!T, key=%!T",
 			                     (long) a,
 			                     (duk_tval *) DUK__REGCONSTP(b),
@@ -2323,6 +2488,9 @@ DUK_INTERNAL void duk_js_execute_bytecode(duk_hthread *entry_thread) {
 			tv_obj = DUK__REGP(a);
 			tv_key = DUK__REGCONSTP(b);
 			tv_val = DUK__REGCONSTP(c);
+			if (duk__vm_putprop_bufobj(thr, tv_obj, tv_key, tv_val)) {
+				break;
+			}
 			DUK_DDD(DUK_DDDPRINT("PUTPROP: obj=%!T, key=%!T, val=%!T",
 			                     (duk_tval *) DUK__REGP(a),
 			                     (duk_tval *) DUK__REGCONSTP(b),
@@ -2383,9 +2551,15 @@ DUK_INTERNAL void duk_js_execute_bytecode(duk_hthread *entry_thread) {
 			 * more code.
 			 */
 
+			/* The base may be a register bound variable (not a copy) so
+			 * capture the 'this' binding before the lookup: a getter may
+			 * assign to the variable through a closure.
+			 */
+			duk_push_tval(ctx, DUK__REGP(b));  /* [ ... obj ] */
+
 			tv_obj = DUK__REGP(b);
 			tv_key = DUK__REGCONSTP(c);
-			rc = duk_hobject_getprop(thr, tv_obj, tv_key);  /* -> [val] */
+			rc = duk_hobject_getprop(thr, tv_obj, tv_key);  /* -> [ ... obj val ] */
 			DUK_UNREF(rc);  /* unused */
 			tv_obj = NULL;  /* invalidated */
 			tv_key = NULL;  /* invalidated */
@@ -2411,9 +2585,8 @@ DUK_INTERNAL void duk_js_execute_bytecode(duk_hthread *entry_thread) {
 			}
 #endif
 
-			duk_push_tval(ctx, DUK__REGP(b));         /* [ ... val obj ] */
-			duk_replace(ctx, (duk_idx_t) (idx + 1));  /* 'this' binding */
 			duk_replace(ctx, (duk_idx_t) idx);        /* val */
+			duk_replace(ctx, (duk_idx_t) (idx + 1));  /* 'this' binding */
 			break;
 		}
 
@@ -2604,6 +2777,84 @@ DUK_INTERNAL void duk_js_execute_bytecode(duk_hthread *entry_thread) {
 			break;
 		}
 
+		case DUK_OP_IFCMP: {
+			duk_small_uint_fast_t a = DUK_DEC_A(ins);
+			duk_small_uint_fast_t b = DUK_DEC_B(ins);
+			duk_small_uint_fast_t c = DUK_DEC_C(ins);
+			duk_tval *tv_x;
+			duk_tval *tv_y;
+			duk_bool_t tmp;
+
+			/* Fused comparison + IF: same semantics as the EQ...LE
+			 * opcodes above followed by IF, but the boolean result is
+			 * not written to a register.  Plain numbers are compared
+			 * inline; C comparisons give the same results for NaN and
+			 * zeroes as E5 Sections 11.8.5 and 11.9.3.
+			 */
+			tv_x = DUK__REGCONSTP(b);
+			tv_y = DUK__REGCONSTP(c);
+			if (DUK_TVAL_IS_NUMBER(tv_x) && DUK_TVAL_IS_NUMBER(tv_y)) {
+				duk_double_t d1 = DUK_TVAL_GET_NUMBER(tv_x);
+				duk_double_t d2 = DUK_TVAL_GET_NUMBER(tv_y);
+
+				switch (a & DUK_BC_IFCMP_OP_MASK) {
+				case DUK_OP_EQ - DUK_OP_EQ:
+				case DUK_OP_SEQ - DUK_OP_EQ:
+					tmp = (d1 == d2);
+					break;
+				case DUK_OP_NEQ - DUK_OP_EQ:
+				case DUK_OP_SNEQ - DUK_OP_EQ:
+					tmp = (d1 != d2);
+					break;
+				case DUK_OP_GT - DUK_OP_EQ:
+					tmp = (d1 > d2);
+					break;
+				case DUK_OP_GE - DUK_OP_EQ:
+					tmp = (d1 >= d2);
+					break;
+				case DUK_OP_LT - DUK_OP_EQ:
+					tmp = (d1 < d2);
+					break;
+				default:  /* DUK_OP_LE */
+					tmp = (d1 <= d2);
+					break;
+				}
+			} else {
+				switch (a & DUK_BC_IFCMP_OP_MASK) {
+				case DUK_OP_EQ - DUK_OP_EQ:
+					tmp = duk_js_equals(thr, tv_x, tv_y);
+					break;
+				case DUK_OP_NEQ - DUK_OP_EQ:
+					tmp = !duk_js_equals(thr, tv_x, tv_y);
+					break;
+				case DUK_OP_SEQ - DUK_OP_EQ:
+					tmp = duk_js_strict_equals(tv_x, tv_y);
+					break;
+				case DUK_OP_SNEQ - DUK_OP_EQ:
+					tmp = !duk_js_strict_equals(tv_x, tv_y);
+					break;
+				case DUK_OP_GT - DUK_OP_EQ:
+					tmp = duk_js_compare_helper(thr, tv_y, tv_x, 0);
+					break;
+				case DUK_OP_GE - DUK_OP_EQ:
+					tmp = duk_js_compare_helper(thr, tv_x, tv_y, DUK_COMPARE_FLAG_EVAL_LEFT_FIRST | DUK_COMPARE_FLAG_NEGATE);
+					break;
+				case DUK_OP_LT - DUK_OP_EQ:
+					tmp = duk_js_compare_helper(thr, tv_x, tv_y, DUK_COMPARE_FLAG_EVAL_LEFT_FIRST);
+					break;
+				default:  /* DUK_OP_LE */
+					tmp = duk_js_compare_helper(thr, tv_y, tv_x, DUK_COMPARE_FLAG_NEGATE);
+					break;
+				}
+			}
+
+			if (tmp == ((a & DUK_BC_IFCMP_FLAG_SENSE) ? 1 : 0)) {
+				/* if result matches sense flag, skip next inst */
+				act->pc++;
+			}
+			break;
+		}
+
 		case DUK_OP_INSTOF: {
 			duk_context *ctx = (duk_context *) thr;
 			duk_small_uint_fast_t a = DUK_DEC_A(ins);
@@ -3566,6 +3817,15 @@ DUK_INTERNAL void duk_js_execute_bytecode(duk_hthread *entry_thread) {
 				break;
 			}
 
+			case DUK_EXTRAOP_POSTINC:
+			case DUK_EXTRAOP_POSTDEC: {
+				duk_small_uint_fast_t b = DUK_DEC_B(ins);
+				duk_small_uint_fast_t c = DUK_DEC_C(ins);
+
+				duk__vm_arith_postincdec(thr, b, c, extraop);
+				break;
+			}
+
 #ifdef DUK_USE_DEBUG
 			case DUK_EXTRAOP_DUMPREG: {
 				DUK_D(DUK_DPRINT("DUMPREG: %ld -> %!T",
@@ -1663,6 +1663,9 @@ duk_bool_t duk__declvar_helper(duk_hthread *thr,
 			 */
 			DUK_DDD(DUK_DDDPRINT("redefine, offending property in global object itself"));
 
+			/* existing value and attributes are modified in place */
+			DUK_HOBJECT_UNSHAPE(thr, holder);
+
 			if (flags & DUK_PROPDESC_FLAG_ACCESSOR) {
 				duk_hobject *tmp;
 
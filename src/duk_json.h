@@ -26,10 +26,36 @@
 /* How much stack to require on entry to object/array decode */
 #define DUK_JSON_DEC_REQSTACK                 32
 
+/* Cache for recently decoded object keys: 2^DUK_JSON_DEC_KEYCACHE_BITS sets
+ * of two value stack slots each.
+ */
+#define DUK_JSON_DEC_KEYCACHE_BITS            5
+#define DUK_JSON_DEC_KEYCACHE_SIZE            (2 << DUK_JSON_DEC_KEYCACHE_BITS)
+
+/* Object nesting depths for which the decoder remembers the key count of
+ * the previous object, and the max number of properties preallocated based
+ * on it.  The max is kept below DUK_HOBJECT_E_USE_HASH_LIMIT so that a
+ * preallocated object never gets a hash part before it has any properties.
+ */
+#define DUK_JSON_DEC_KEYHINT_DEPTH            8
+#define DUK_JSON_DEC_KEYHINT_MAX              31
+
+/* Max size of output chunks given to the write callback when encoding to
+ * a sink (duk_json_encode_to_sink()).
+ */
+#define DUK_JSON_ENC_SINK_CHUNK               4096
+
+/* Max nesting depth for the JSON.stringify() fast path; deeper values (and
+ * loops) are handled by the slow path.
+ */
+#define DUK_JSON_ENC_LOOPARRAY                64
+
 /* Encoding state.  Heap object references are all borrowed. */
 typedef struct {
 	duk_hthread *thr;
-	duk_hbuffer_dynamic *h_buf;
+	duk_hbuffer_dynamic *h_buf;  /* output buffer; output chunk when writing to a sink */
+	duk_json_write_function write_cb;  /* output sink, NULL if output is accumulated into h_buf */
+	void *write_udata;
 	duk_hobject *h_replacer;     /* replacer function */
 	duk_hstring *h_gap;          /* gap (if empty string, NULL) */
 	duk_hstring *h_indent;       /* current indent (if gap is NULL, this is NULL) */
@@ -52,6 +78,9 @@ typedef struct {
 	duk_small_uint_t stridx_custom_posinf;
 	duk_small_uint_t stridx_custom_function;
 #endif
+#if defined(DUK_USE_JSON_STRINGIFY_FASTPATH)
+	duk_hobject *visiting[DUK_JSON_ENC_LOOPARRAY];  /* fast path loop detection */
+#endif
 } duk_json_enc_ctx;
 
 typedef struct {
@@ -60,6 +89,7 @@ typedef struct {
 	duk_uint8_t *p_start;
 	duk_uint8_t *p_end;
 	duk_idx_t idx_reviver;
+	duk_idx_t idx_keycache;      /* valstack index of first key cache slot */
 	duk_small_uint_t flags;
 #if defined(DUK_USE_JX) || defined(DUK_USE_JC)
 	duk_small_uint_t flag_ext_custom;
@@ -67,6 +97,7 @@ typedef struct {
 #endif
 	duk_int_t recursion_depth;
 	duk_int_t recursion_limit;
+	duk_uint32_t key_count_hint[DUK_JSON_DEC_KEYHINT_DEPTH];  /* key count of previous object at each depth */
 } duk_json_dec_ctx;
 
 #endif  /* DUK_JSON_H_INCLUDED */
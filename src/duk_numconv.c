@@ -149,6 +149,15 @@ DUK_LOCAL void duk__bi_set_small(duk__bigint *x, duk_uint32_t v) {
 	DUK_ASSERT(duk__bi_is_valid(x));
 }
 
+#if defined(DUK_USE_NUMCONV_FAST_PARSE)
+DUK_LOCAL void duk__bi_set_uint64(duk__bigint *x, duk_uint64_t v) {
+	x->n = 2;
+	x->v[0] = (duk_uint32_t) (v & ((duk_uint64_t) 0xffffffffUL));
+	x->v[1] = (duk_uint32_t) (v >> 32);
+	duk__bi_normalize(x);
+}
+#endif
+
 /* Return value: <0  <=>  x < y
  *                0  <=>  x == y
  *               >0  <=>  x > y
@@ -703,6 +712,38 @@ DUK_LOCAL duk_size_t duk__dragon4_format_uint32(duk_uint8_t *buf, duk_uint32_t x
 	return len;
 }
 
+#if defined(DUK_USE_64BIT_OPS)
+DUK_LOCAL duk_size_t duk__dragon4_format_uint64(duk_uint8_t *buf, duk_uint64_t x, duk_small_int_t radix) {
+	duk_uint8_t *p;
+	duk_size_t len;
+	duk_small_int_t dig;
+	duk_uint64_t t;
+
+	DUK_ASSERT(radix >= 2 && radix <= 36);
+
+	/* Same as duk__dragon4_format_uint32() but with at most 64 digits. */
+
+	p = buf + 64;
+	for (;;) {
+		t = x / (duk_uint64_t) radix;
+		dig = (duk_small_int_t) (x - t * (duk_uint64_t) radix);
+		x = t;
+
+		DUK_ASSERT(dig >= 0 && dig < 36);
+		*(--p) = DUK__DIGITCHAR(dig);
+
+		if (x == 0) {
+			break;
+		}
+	}
+	len = (duk_size_t) ((buf + 64) - p);
+
+	DUK_MEMMOVE((void *) buf, (void *) p, (size_t) len);
+
+	return len;
+}
+#endif  /* DUK_USE_64BIT_OPS */
+
 DUK_LOCAL void duk__dragon4_prepare(duk__numconv_stringify_ctx *nc_ctx) {
 	duk_small_int_t lowest_mantissa;
 
@@ -799,7 +840,7 @@ DUK_LOCAL void duk__dragon4_prepare(duk__numconv_stringify_ctx *nc_ctx) {
 		/* When doing string-to-number, lowest_mantissa is always 0 so
 		 * the exponent check, while incorrect, won't matter.
 		 */
-		if (nc_ctx->e > DUK__IEEE_DOUBLE_EXP_MIN /*not minimum exponent*/ &&
+		if (nc_ctx->e > DUK__IEEE_DOUBLE_EXP_MIN - 52 /*not minimum exponent*/ &&
 		    lowest_mantissa /* lowest mantissa for this exponent*/) {
 			/* r <- (* f b 2)                                [if b==2 -> (* f 4)]
 			 * s <- (* (expt b (- 1 e)) 2) == b^(1-e) * 2    [if b==2 -> b^(2-e)]
@@ -847,6 +888,7 @@ DUK_LOCAL void duk__dragon4_prepare(duk__numconv_stringify_ctx *nc_ctx) {
 
 DUK_LOCAL void duk__dragon4_scale(duk__numconv_stringify_ctx *nc_ctx) {
 	duk_small_int_t k = 0;
+	duk_small_int_t high_ok;
 
 	/* This is essentially the 'scale' algorithm, with recursion removed.
 	 * Note that 'k' is either correct immediately, or will move in one
@@ -861,8 +903,15 @@ DUK_LOCAL void duk__dragon4_scale(duk__numconv_stringify_ctx *nc_ctx) {
 	 * The case where m+ == m- (almost always) is optimized for, because
 	 * it reduces the bigint operations considerably and almost always
 	 * applies.  The scale loop only needs to work with m+, so this works.
+	 *
+	 * In fixed format output the digits are those of the value itself,
+	 * so 'k' is found using r alone (as if m+ were zero).  Using r + m+
+	 * would give a leading zero digit for values less than m+ below a
+	 * power of B, e.g. (1e-323).toPrecision(20).
 	 */
 
+	high_ok = (nc_ctx->is_fixed ? 1 : nc_ctx->high_ok);
+
 	/* XXX: this algorithm could be optimized quite a lot by using e.g.
 	 * a logarithm based estimator for 'k' and performing B^n multiplication
 	 * using a lookup table or using some bit-representation based exp
@@ -884,8 +933,12 @@ DUK_LOCAL void duk__dragon4_scale(duk__numconv_stringify_ctx *nc_ctx) {
 		DUK__BI_PRINT("m+", &nc_ctx->mp);
 		DUK__BI_PRINT("m-", &nc_ctx->mm);
 
-		duk__bi_add(&nc_ctx->t1, &nc_ctx->r, &nc_ctx->mp);  /* t1 = (+ r m+) */
-		if (duk__bi_compare(&nc_ctx->t1, &nc_ctx->s) >= (nc_ctx->high_ok ? 0 : 1)) {
+		if (nc_ctx->is_fixed) {
+			duk__bi_copy(&nc_ctx->t1, &nc_ctx->r);  /* t1 = r */
+		} else {
+			duk__bi_add(&nc_ctx->t1, &nc_ctx->r, &nc_ctx->mp);  /* t1 = (+ r m+) */
+		}
+		if (duk__bi_compare(&nc_ctx->t1, &nc_ctx->s) >= (high_ok ? 0 : 1)) {
 			DUK_DDD(DUK_DDDPRINT("k is too low"));
 			/* r <- r
 			 * s <- (* s B)
@@ -913,9 +966,13 @@ DUK_LOCAL void duk__dragon4_scale(duk__numconv_stringify_ctx *nc_ctx) {
 		DUK__BI_PRINT("m+", &nc_ctx->mp);
 		DUK__BI_PRINT("m-", &nc_ctx->mm);
 
-		duk__bi_add(&nc_ctx->t1, &nc_ctx->r, &nc_ctx->mp);  /* t1 = (+ r m+) */
+		if (nc_ctx->is_fixed) {
+			duk__bi_copy(&nc_ctx->t1, &nc_ctx->r);  /* t1 = r */
+		} else {
+			duk__bi_add(&nc_ctx->t1, &nc_ctx->r, &nc_ctx->mp);  /* t1 = (+ r m+) */
+		}
 		duk__bi_mul_small(&nc_ctx->t2, &nc_ctx->t1, nc_ctx->B);   /* t2 = (* (+ r m+) B) */
-		if (duk__bi_compare(&nc_ctx->t2, &nc_ctx->s) <= (nc_ctx->high_ok ? -1 : 0)) {
+		if (duk__bi_compare(&nc_ctx->t2, &nc_ctx->s) <= (high_ok ? -1 : 0)) {
 			DUK_DDD(DUK_DDDPRINT("k is too high"));
 			/* r <- (* r B)
 			 * s <- s
@@ -1013,7 +1070,7 @@ DUK_LOCAL void duk__dragon4_generate(duk__numconv_stringify_ctx *nc_ctx) {
 			tc1 = (duk__bi_compare(&nc_ctx->r, &nc_ctx->mm) <= (nc_ctx->low_ok ? 0 : -1));
 
 			duk__bi_add(&nc_ctx->t1, &nc_ctx->r, &nc_ctx->mp);  /* t1 <- (+ r m+) */
-			tc2 = (duk__bi_compare(&nc_ctx->t1, &nc_ctx->s) >= (&nc_ctx->high_ok ? 0 : 1));
+			tc2 = (duk__bi_compare(&nc_ctx->t1, &nc_ctx->s) >= (nc_ctx->high_ok ? 0 : 1));
 
 			DUK_DDD(DUK_DDDPRINT("tc1=%ld, tc2=%ld", (long) tc1, (long) tc2));
 		} else {
@@ -1030,13 +1087,16 @@ DUK_LOCAL void duk__dragon4_generate(duk__numconv_stringify_ctx *nc_ctx) {
 		if (tc1) {
 			if (tc2) {
 				/* tc1 = true, tc2 = true */
+				duk_small_int_t cmp;
+
 				duk__bi_mul_small(&nc_ctx->t1, &nc_ctx->r, 2);
-				if (duk__bi_compare(&nc_ctx->t1, &nc_ctx->s) < 0) {  /* (< (* r 2) s) */
-					DUK_DDD(DUK_DDDPRINT("tc1=true, tc2=true, 2r > s: output d --> %ld (k=%ld)",
+				cmp = duk__bi_compare(&nc_ctx->t1, &nc_ctx->s);
+				if (cmp < 0 || (cmp == 0 && (d & 1) == 0)) {  /* (< (* r 2) s), ties to even digit (E5 Section 9.8.1) */
+					DUK_DDD(DUK_DDDPRINT("tc1=true, tc2=true, 2r <= s: output d --> %ld (k=%ld)",
 					                     (long) d, (long) nc_ctx->k));
 					DUK__DRAGON4_OUTPUT_PREINC(nc_ctx, count, d);
 				} else {
-					DUK_DDD(DUK_DDDPRINT("tc1=true, tc2=true, 2r <= s: output d+1 --> %ld (k=%ld)",
+					DUK_DDD(DUK_DDDPRINT("tc1=true, tc2=true, 2r >= s: output d+1 --> %ld (k=%ld)",
 					                     (long) (d + 1), (long) nc_ctx->k));
 					DUK__DRAGON4_OUTPUT_PREINC(nc_ctx, count, d + 1);
 				}
@@ -1389,6 +1449,32 @@ DUK_LOCAL void duk__dragon4_double_to_ctx(duk__numconv_stringify_ctx *nc_ctx, du
 	nc_ctx->e = expt;
 }
 
+/* Check whether the binary digits starting from 'round_idx' are an exact
+ * halfway point ('1000...' with a zero remainder) and the last retained
+ * digit is even, i.e. round-half-to-even must not round up.
+ */
+DUK_LOCAL duk_small_int_t duk__dragon4_is_even_tie(duk__numconv_stringify_ctx *nc_ctx, duk_small_int_t round_idx) {
+	duk_small_int_t i;
+
+	DUK_ASSERT(nc_ctx->B == 2);
+
+	if (round_idx < 0 || round_idx >= nc_ctx->count) {
+		return 0;
+	}
+	if (nc_ctx->digits[round_idx] != 1) {
+		return 0;
+	}
+	for (i = round_idx + 1; i < nc_ctx->count; i++) {
+		if (nc_ctx->digits[i] != 0) {
+			return 0;
+		}
+	}
+	if (!duk__bi_is_zero(&nc_ctx->r)) {
+		return 0;
+	}
+	return (round_idx == 0 || nc_ctx->digits[round_idx - 1] == 0);
+}
+
 DUK_LOCAL void duk__dragon4_ctx_to_double(duk__numconv_stringify_ctx *nc_ctx, duk_double_t *x) {
 	duk_double_union u;
 	duk_small_int_t expt;
@@ -1476,7 +1562,12 @@ DUK_LOCAL void duk__dragon4_ctx_to_double(duk__numconv_stringify_ctx *nc_ctx, du
 	                     (long) expt, (long) bitstart, (long) bitround));
 
 	if (!skip_round) {
-		if (duk__dragon4_fixed_format_round(nc_ctx, bitround)) {
+		if (duk__dragon4_is_even_tie(nc_ctx, bitround)) {
+			/* Generated digits are truncated, so an exact tie with an even
+			 * last digit is already correctly rounded.
+			 */
+			DUK_DDD(DUK_DDDPRINT("exact tie, round to even -> no rounding"));
+		} else if (duk__dragon4_fixed_format_round(nc_ctx, bitround)) {
 			/* Corner case: see test-numconv-parse-mant-carry.js.  We could
 			 * just bump the exponent and update bitstart, but it's more robust
 			 * to recompute (but avoid rounding twice).
@@ -1531,6 +1622,608 @@ DUK_LOCAL void duk__dragon4_ctx_to_double(duk__numconv_stringify_ctx *nc_ctx, du
 	*x = DUK_DBLUNION_GET_DOUBLE(&u);
 }
 
+/*
+ *  "Do it yourself" floating point values and cached powers of ten
+ *
+ *  A duk__diyfp is a 64-bit significand with a binary exponent, used by
+ *  the radix 10 fast paths of both conversion directions.
+ */
+
+#if defined(DUK_USE_NUMCONV_GRISU3) || defined(DUK_USE_NUMCONV_FAST_PARSE)
+
+/* Normalized cached powers of ten 10^k, k = -348, -340, ..., 340, rounded
+ * to 64 bits: { significand high, significand low, binary exp, decimal exp }.
+ * Generated with exact rational arithmetic.
+ */
+typedef struct {
+	duk_uint32_t f_hi;
+	duk_uint32_t f_lo;
+	duk_int16_t e;
+	duk_int16_t k;
+} duk__grisu_cached_power;
+
+DUK_LOCAL const duk__grisu_cached_power duk__grisu_cached_powers[] = {
+	{ 0xfa8fd5a0UL, 0x081c0288UL, -1220, -348 },
+	{ 0xbaaee17fUL, 0xa23ebf76UL, -1193, -340 },
+	{ 0x8b16fb20UL, 0x3055ac76UL, -1166, -332 },
+	{ 0xcf42894aUL, 0x5dce35eaUL, -1140, -324 },
+	{ 0x9a6bb0aaUL, 0x55653b2dUL, -1113, -316 },
+	{ 0xe61acf03UL, 0x3d1a45dfUL, -1087, -308 },
+	{ 0xab70fe17UL, 0xc79ac6caUL, -1060, -300 },
+	{ 0xff77b1fcUL, 0xbebcdc4fUL, -1034, -292 },
+	{ 0xbe5691efUL, 0x416bd60cUL, -1007, -284 },
+	{ 0x8dd01fadUL, 0x907ffc3cUL, -980, -276 },
+	{ 0xd3515c28UL, 0x31559a83UL, -954, -268 },
+	{ 0x9d71ac8fUL, 0xada6c9b5UL, -927, -260 },
+	{ 0xea9c2277UL, 0x23ee8bcbUL, -901, -252 },
+	{ 0xaecc4991UL, 0x4078536dUL, -874, -244 },
+	{ 0x823c1279UL, 0x5db6ce57UL, -847, -236 },
+	{ 0xc2109436UL, 0x4dfb5637UL, -821, -228 },
+	{ 0x9096ea6fUL, 0x3848984fUL, -794, -220 },
+	{ 0xd77485cbUL, 0x25823ac7UL, -768, -212 },
+	{ 0xa086cfcdUL, 0x97bf97f4UL, -741, -204 },
+	{ 0xef340a98UL, 0x172aace5UL, -715, -196 },
+	{ 0xb23867fbUL, 0x2a35b28eUL, -688, -188 },
+	{ 0x84c8d4dfUL, 0xd2c63f3bUL, -661, -180 },
+	{ 0xc5dd4427UL, 0x1ad3cdbaUL, -635, -172 },
+	{ 0x936b9fceUL, 0xbb25c996UL, -608, -164 },
+	{ 0xdbac6c24UL, 0x7d62a584UL, -582, -156 },
+	{ 0xa3ab6658UL, 0x0d5fdaf6UL, -555, -148 },
+	{ 0xf3e2f893UL, 0xdec3f126UL, -529, -140 },
+	{ 0xb5b5ada8UL, 0xaaff80b8UL, -502, -132 },
+	{ 0x87625f05UL, 0x6c7c4a8bUL, -475, -124 },
+	{ 0xc9bcff60UL, 0x34c13053UL, -449, -116 },
+	{ 0x964e858cUL, 0x91ba2655UL, -422, -108 },
+	{ 0xdff97724UL, 0x70297ebdUL, -396, -100 },
+	{ 0xa6dfbd9fUL, 0xb8e5b88fUL, -369, -92 },
+	{ 0xf8a95fcfUL, 0x88747d94UL, -343, -84 },
+	{ 0xb9447093UL, 0x8fa89bcfUL, -316, -76 },
+	{ 0x8a08f0f8UL, 0xbf0f156bUL, -289, -68 },
+	{ 0xcdb02555UL, 0x653131b6UL, -263, -60 },
+	{ 0x993fe2c6UL, 0xd07b7facUL, -236, -52 },
+	{ 0xe45c10c4UL, 0x2a2b3b06UL, -210, -44 },
+	{ 0xaa242499UL, 0x697392d3UL, -183, -36 },
+	{ 0xfd87b5f2UL, 0x8300ca0eUL, -157, -28 },
+	{ 0xbce50864UL, 0x92111aebUL, -130, -20 },
+	{ 0x8cbccc09UL, 0x6f5088ccUL, -103, -12 },
+	{ 0xd1b71758UL, 0xe219652cUL, -77, -4 },
+	{ 0x9c400000UL, 0x00000000UL, -50, 4 },
+	{ 0xe8d4a510UL, 0x00000000UL, -24, 12 },
+	{ 0xad78ebc5UL, 0xac620000UL, 3, 20 },
+	{ 0x813f3978UL, 0xf8940984UL, 30, 28 },
+	{ 0xc097ce7bUL, 0xc90715b3UL, 56, 36 },
+	{ 0x8f7e32ceUL, 0x7bea5c70UL, 83, 44 },
+	{ 0xd5d238a4UL, 0xabe98068UL, 109, 52 },
+	{ 0x9f4f2726UL, 0x179a2245UL, 136, 60 },
+	{ 0xed63a231UL, 0xd4c4fb27UL, 162, 68 },
+	{ 0xb0de6538UL, 0x8cc8ada8UL, 189, 76 },
+	{ 0x83c7088eUL, 0x1aab65dbUL, 216, 84 },
+	{ 0xc45d1df9UL, 0x42711d9aUL, 242, 92 },
+	{ 0x924d692cUL, 0xa61be758UL, 269, 100 },
+	{ 0xda01ee64UL, 0x1a708deaUL, 295, 108 },
+	{ 0xa26da399UL, 0x9aef774aUL, 322, 116 },
+	{ 0xf209787bUL, 0xb47d6b85UL, 348, 124 },
+	{ 0xb454e4a1UL, 0x79dd1877UL, 375, 132 },
+	{ 0x865b8692UL, 0x5b9bc5c2UL, 402, 140 },
+	{ 0xc83553c5UL, 0xc8965d3dUL, 428, 148 },
+	{ 0x952ab45cUL, 0xfa97a0b3UL, 455, 156 },
+	{ 0xde469fbdUL, 0x99a05fe3UL, 481, 164 },
+	{ 0xa59bc234UL, 0xdb398c25UL, 508, 172 },
+	{ 0xf6c69a72UL, 0xa3989f5cUL, 534, 180 },
+	{ 0xb7dcbf53UL, 0x54e9beceUL, 561, 188 },
+	{ 0x88fcf317UL, 0xf22241e2UL, 588, 196 },
+	{ 0xcc20ce9bUL, 0xd35c78a5UL, 614, 204 },
+	{ 0x98165af3UL, 0x7b2153dfUL, 641, 212 },
+	{ 0xe2a0b5dcUL, 0x971f303aUL, 667, 220 },
+	{ 0xa8d9d153UL, 0x5ce3b396UL, 694, 228 },
+	{ 0xfb9b7cd9UL, 0xa4a7443cUL, 720, 236 },
+	{ 0xbb764c4cUL, 0xa7a44410UL, 747, 244 },
+	{ 0x8bab8eefUL, 0xb6409c1aUL, 774, 252 },
+	{ 0xd01fef10UL, 0xa657842cUL, 800, 260 },
+	{ 0x9b10a4e5UL, 0xe9913129UL, 827, 268 },
+	{ 0xe7109bfbUL, 0xa19c0c9dUL, 853, 276 },
+	{ 0xac2820d9UL, 0x623bf429UL, 880, 284 },
+	{ 0x80444b5eUL, 0x7aa7cf85UL, 907, 292 },
+	{ 0xbf21e440UL, 0x03acdd2dUL, 933, 300 },
+	{ 0x8e679c2fUL, 0x5e44ff8fUL, 960, 308 },
+	{ 0xd433179dUL, 0x9c8cb841UL, 986, 316 },
+	{ 0x9e19db92UL, 0xb4e31ba9UL, 1013, 324 },
+	{ 0xeb96bf6eUL, 0xbadf77d9UL, 1039, 332 },
+	{ 0xaf87023bUL, 0x9bf0ee6bUL, 1066, 340 },
+};
+
+#define DUK__GRISU_CACHED_POWERS_OFFSET   348   /* -1 * first decimal exponent */
+#define DUK__GRISU_DECIMAL_EXP_DISTANCE   8     /* decimal exponent step in table */
+#define DUK__GRISU_MIN_TARGET_EXP         (-60)
+#define DUK__GRISU_MAX_TARGET_EXP         (-32)
+
+typedef struct {
+	duk_uint64_t f;
+	duk_small_int_t e;
+} duk__diyfp;
+
+/* Rounded upper 64 bits of the 128-bit product. */
+DUK_LOCAL void duk__diyfp_mul(duk__diyfp *x, const duk__diyfp *y) {
+	duk_uint64_t m32 = (duk_uint64_t) 0xffffffffUL;
+	duk_uint64_t a, b, c, d;
+	duk_uint64_t ac, bc, ad, bd;
+	duk_uint64_t tmp;
+
+	a = x->f >> 32;
+	b = x->f & m32;
+	c = y->f >> 32;
+	d = y->f & m32;
+	ac = a * c;
+	bc = b * c;
+	ad = a * d;
+	bd = b * d;
+	tmp = (bd >> 32) + (ad & m32) + (bc & m32);
+	tmp += ((duk_uint64_t) 1) << 31;  /* round */
+	x->f = ac + (ad >> 32) + (bc >> 32) + (tmp >> 32);
+	x->e = x->e + y->e + 64;
+}
+
+DUK_LOCAL void duk__diyfp_normalize(duk__diyfp *x) {
+	DUK_ASSERT(x->f != 0);
+	while ((x->f & (((duk_uint64_t) 0xffc00000UL) << 32)) == 0) {
+		x->f <<= 10;
+		x->e -= 10;
+	}
+	while ((x->f & (((duk_uint64_t) 0x80000000UL) << 32)) == 0) {
+		x->f <<= 1;
+		x->e -= 1;
+	}
+}
+
+#endif  /* DUK_USE_NUMCONV_GRISU3 || DUK_USE_NUMCONV_FAST_PARSE */
+
+/*
+ *  Grisu3 fast path for shortest radix 10 output
+ *
+ *  Grisu3 (Florian Loitsch, "Printing Floating-Point Numbers Quickly and
+ *  Accurately with Integers", PLDI 2010) generates the shortest digit
+ *  sequence using 64-bit integer arithmetic only, and detects the small
+ *  number of cases (around 0.5% of random doubles) where it cannot prove
+ *  the result is the shortest and closest one.  For those cases the caller
+ *  falls back to Dragon4, so output is identical to the Dragon4 output.
+ *
+ *  The digits are written into nc_ctx in the same format Dragon4 uses, so
+ *  that formatting is shared.
+ */
+
+#if defined(DUK_USE_NUMCONV_GRISU3)
+
+/* Grisu "weed" step: try to move the last digit closer to the exact value
+ * and check that the result is guaranteed to be the closest shortest one.
+ */
+DUK_LOCAL duk_bool_t duk__grisu_round_weed(duk__numconv_stringify_ctx *nc_ctx,
+                                           duk_uint64_t distance_too_high_w,
+                                           duk_uint64_t unsafe_interval,
+                                           duk_uint64_t rest,
+                                           duk_uint64_t ten_kappa,
+                                           duk_uint64_t unit) {
+	duk_uint64_t small_distance = distance_too_high_w - unit;
+	duk_uint64_t big_distance = distance_too_high_w + unit;
+
+	while (rest < small_distance &&
+	       unsafe_interval - rest >= ten_kappa &&
+	       (rest + ten_kappa < small_distance ||
+	        small_distance - rest >= rest + ten_kappa - small_distance)) {
+		DUK_ASSERT(nc_ctx->digits[nc_ctx->count - 1] > 0);
+		nc_ctx->digits[nc_ctx->count - 1]--;
+		rest += ten_kappa;
+	}
+
+	if (rest < big_distance &&
+	    unsafe_interval - rest >= ten_kappa &&
+	    (rest + ten_kappa < big_distance ||
+	     big_distance - rest > rest + ten_kappa - big_distance)) {
+		return 0;
+	}
+
+	return (2 * unit <= rest) && (rest <= unsafe_interval - 4 * unit);
+}
+
+/* Generate shortest digits for a finite, positive, non-zero 'x' into
+ * nc_ctx (digits, count, k).  Returns 0 if the result cannot be proven
+ * optimal, in which case nc_ctx contents are garbage.
+ */
+DUK_LOCAL duk_bool_t duk__grisu3_generate(duk__numconv_stringify_ctx *nc_ctx, duk_double_t x) {
+	duk_double_union u;
+	duk__diyfp w, m_plus, m_minus, c_mk;
+	const duk__grisu_cached_power *cp;
+	duk_uint64_t f;
+	duk_uint64_t one_f, one_mask;
+	duk_uint64_t too_low, too_high, unsafe_interval;
+	duk_uint64_t fractionals, rest, unit;
+	duk_uint32_t integrals, divisor;
+	duk_small_int_t e, one_e, kappa, idx, mk;
+	duk_small_int_t count;
+	duk_bool_t ret;
+
+	DUK_ASSERT(x > 0.0);
+
+	/* Decompose, see duk__dragon4_double_to_ctx(). */
+	DUK_DBLUNION_SET_DOUBLE(&u, x);
+	f = (((duk_uint64_t) (DUK_DBLUNION_GET_HIGH32(&u) & 0x000fffffUL)) << 32) |
+	    (duk_uint64_t) DUK_DBLUNION_GET_LOW32(&u);
+	e = (duk_small_int_t) ((DUK_DBLUNION_GET_HIGH32(&u) >> 20) & 0x07ffUL);
+	if (e == 0) {
+		/* denormal */
+		e = DUK__IEEE_DOUBLE_EXP_MIN - 52;
+	} else {
+		f |= ((duk_uint64_t) 0x00100000UL) << 32;
+		e = e - DUK__IEEE_DOUBLE_EXP_BIAS - 52;
+	}
+
+	/* Boundaries m+ and m-: halfway points to the neighbor values.  The
+	 * lower gap is smaller when f is a power of two (except for the
+	 * smallest normal exponent).  Both get the exponent of normalized m+,
+	 * which is also the exponent of normalized w.
+	 */
+	m_plus.f = (f << 1) + 1;
+	m_plus.e = e - 1;
+	duk__diyfp_normalize(&m_plus);
+	if (f == (((duk_uint64_t) 0x00100000UL) << 32) && e != DUK__IEEE_DOUBLE_EXP_MIN - 52) {
+		m_minus.f = (f << 2) - 1;
+		m_minus.e = e - 2;
+	} else {
+		m_minus.f = (f << 1) - 1;
+		m_minus.e = e - 1;
+	}
+	m_minus.f <<= m_minus.e - m_plus.e;
+	m_minus.e = m_plus.e;
+
+	w.f = f;
+	w.e = e;
+	duk__diyfp_normalize(&w);
+	DUK_ASSERT(w.e == m_plus.e);
+
+	/* Pick a cached power c_mk = 10^-mk so that the scaled exponent is in
+	 * [DUK__GRISU_MIN_TARGET_EXP, DUK__GRISU_MAX_TARGET_EXP].
+	 */
+	idx = (duk_small_int_t) DUK_CEIL((double) (DUK__GRISU_MIN_TARGET_EXP - (w.e + 64) + 64 - 1) * 0.30102999566398114);
+	idx = (DUK__GRISU_CACHED_POWERS_OFFSET + idx - 1) / DUK__GRISU_DECIMAL_EXP_DISTANCE + 1;
+	DUK_ASSERT(idx >= 0 && idx < (duk_small_int_t) (sizeof(duk__grisu_cached_powers) / sizeof(duk__grisu_cached_power)));
+	cp = duk__grisu_cached_powers + idx;
+	c_mk.f = (((duk_uint64_t) cp->f_hi) << 32) | (duk_uint64_t) cp->f_lo;
+	c_mk.e = cp->e;
+	mk = -cp->k;
+
+	duk__diyfp_mul(&w, &c_mk);
+	duk__diyfp_mul(&m_plus, &c_mk);
+	duk__diyfp_mul(&m_minus, &c_mk);
+	DUK_ASSERT(w.e >= DUK__GRISU_MIN_TARGET_EXP && w.e <= DUK__GRISU_MAX_TARGET_EXP);
+
+	/* Digit generation.  The scaled boundaries are imprecise by up to one
+	 * unit, so digits are generated for the "unsafe" (widened) interval
+	 * and checked by the weeding step.
+	 */
+	unit = 1;
+	too_low = m_minus.f - unit;
+	too_high = m_plus.f + unit;
+	unsafe_interval = too_high - too_low;
+	one_e = -w.e;  /* 32...60 */
+	one_f = ((duk_uint64_t) 1) << one_e;
+	one_mask = one_f - 1;
+	integrals = (duk_uint32_t) (too_high >> one_e);
+	fractionals = too_high & one_mask;
+
+	divisor = 1;
+	kappa = 0;
+	if (integrals > 0) {
+		kappa = 1;
+		while (integrals / divisor >= 10) {
+			divisor *= 10;
+			kappa++;
+		}
+	}
+
+	count = 0;
+	while (kappa > 0) {
+		nc_ctx->digits[count++] = (duk_uint8_t) (integrals / divisor);
+		integrals %= divisor;
+		kappa--;
+		rest = (((duk_uint64_t) integrals) << one_e) + fractionals;
+		if (rest < unsafe_interval) {
+			nc_ctx->count = count;
+			ret = duk__grisu_round_weed(nc_ctx, too_high - w.f, unsafe_interval, rest,
+			                            ((duk_uint64_t) divisor) << one_e, unit);
+			goto done;
+		}
+		divisor /= 10;
+	}
+
+	for (;;) {
+		DUK_ASSERT(count < 20);  /* at most 17 significant digits + slack */
+		fractionals *= 10;
+		unit *= 10;
+		unsafe_interval *= 10;
+		nc_ctx->digits[count++] = (duk_uint8_t) (fractionals >> one_e);
+		fractionals &= one_mask;
+		kappa--;
+		if (fractionals < unsafe_interval) {
+			nc_ctx->count = count;
+			ret = duk__grisu_round_weed(nc_ctx, (too_high - w.f) * unit, unsafe_interval, fractionals,
+			                            one_f, unit);
+			goto done;
+		}
+	}
+
+ done:
+	if (!ret) {
+		return 0;
+	}
+
+	/* Value is digits * 10^(mk + kappa); Dragon4 'k' is the position of
+	 * the leading digit.  Trailing zeroes are not part of the shortest
+	 * form and don't affect 'k'.
+	 */
+	count = nc_ctx->count;
+	nc_ctx->k = mk + kappa + count;
+	while (count > 1 && nc_ctx->digits[count - 1] == 0) {
+		count--;
+	}
+	nc_ctx->count = count;
+	DUK_ASSERT(nc_ctx->digits[0] != 0);
+	return 1;
+}
+
+#endif  /* DUK_USE_NUMCONV_GRISU3 */
+
+/*
+ *  Fast path for radix 10 string-to-number conversion
+ *
+ *  The significand is scanned into a 64-bit integer 'f' (at most 19 digits)
+ *  and f * 10^expt is computed as a duk__diyfp using the cached powers of
+ *  ten, tracking an upper bound for the accumulated error (in units of 1/8
+ *  of the lowest significand bit).  If the value rounded to double precision
+ *  is unambiguous despite the error, the result is correctly rounded;
+ *  otherwise the caller falls back to Dragon4.  This is the DiyFp step of
+ *  the double-conversion library's strtod(); in practice it fails for a
+ *  tiny fraction of inputs close to a rounding boundary.
+ */
+
+#if defined(DUK_USE_NUMCONV_FAST_PARSE)
+
+#define DUK__S2N_FAST_F_LIMIT        (((duk_uint64_t) 1) << 58)  /* f * 36 + 35 fits into 64 bits */
+#define DUK__S2N_ERR_DENOM_LOG       3
+#define DUK__S2N_ERR_DENOM           (1 << DUK__S2N_ERR_DENOM_LOG)
+#define DUK__S2N_MAX_UINT64_DIGITS   19
+#define DUK__IEEE_DOUBLE_DENORM_EXP  (-1074)  /* binary exponent of smallest denormal, integer significand */
+#define DUK__IEEE_DOUBLE_MAX_EXP     972      /* 2047 - 1075 */
+
+/* Normalized 10^1 ... 10^7: { significand high 32 bits, binary exp }. */
+DUK_LOCAL const duk_int16_t duk__s2n_adjust_powers_e[7] = {
+	-60, -57, -54, -50, -47, -44, -40
+};
+DUK_LOCAL const duk_uint32_t duk__s2n_adjust_powers_f[7] = {
+	0xa0000000UL, 0xc8000000UL, 0xfa000000UL, 0x9c400000UL,
+	0xc3500000UL, 0xf4240000UL, 0x98968000UL
+};
+
+/* Convert a duk__diyfp whose significand fits into 53 bits (after the
+ * rounding done by the caller) into a double.
+ */
+DUK_LOCAL duk_double_t duk__diyfp_to_double(duk__diyfp *x) {
+	duk_double_union u;
+	duk_uint64_t f;
+	duk_small_int_t e;
+	duk_uint32_t biased_e;
+
+	f = x->f;
+	e = x->e;
+	while (f > ((((duk_uint64_t) 1) << 53) - 1)) {
+		/* rounding may carry into bit 53 */
+		f >>= 1;
+		e++;
+	}
+	if (e >= DUK__IEEE_DOUBLE_MAX_EXP) {
+		return (duk_double_t) DUK_DOUBLE_INFINITY;
+	}
+	if (e < DUK__IEEE_DOUBLE_DENORM_EXP) {
+		return 0.0;
+	}
+	while (e > DUK__IEEE_DOUBLE_DENORM_EXP && (f & (((duk_uint64_t) 1) << 52)) == 0) {
+		f <<= 1;
+		e--;
+	}
+	if (e == DUK__IEEE_DOUBLE_DENORM_EXP && (f & (((duk_uint64_t) 1) << 52)) == 0) {
+		biased_e = 0;  /* denormal */
+	} else {
+		biased_e = (duk_uint32_t) (e + DUK__IEEE_DOUBLE_EXP_BIAS + 52);
+	}
+
+	DUK_DBLUNION_SET_HIGH32(&u, (((duk_uint32_t) (f >> 32)) & 0x000fffffUL) | (biased_e << 20));
+	DUK_DBLUNION_SET_LOW32(&u, (duk_uint32_t) (f & ((duk_uint64_t) 0xffffffffUL)));
+	return DUK_DBLUNION_GET_DOUBLE(&u);
+}
+
+/* Compute f * 10^expt, where 'f' is exact, non-zero and has 'digits'
+ * decimal digits.  Returns zero if the result cannot be determined reliably.
+ */
+DUK_LOCAL duk_bool_t duk__s2n_fast_radix10(duk_uint64_t f, duk_small_int_t digits, duk_small_int_t expt, duk_double_t *res) {
+	const duk__grisu_cached_power *cp;
+	duk__diyfp x;
+	duk__diyfp p;
+	duk_uint64_t error;
+	duk_uint64_t prec_bits;
+	duk_uint64_t half_way;
+	duk_small_int_t idx;
+	duk_small_int_t adj;
+	duk_small_int_t old_e;
+	duk_small_int_t order;
+	duk_small_int_t sig_size;
+	duk_small_int_t prec_count;
+	duk_small_int_t shift;
+
+	DUK_ASSERT(f != 0);
+	DUK_ASSERT(digits >= 1 && digits <= DUK__S2N_MAX_UINT64_DIGITS);
+
+	/* 10^(expt + digits - 1) <= value < 10^(expt + digits); the largest
+	 * double is ~1.8e308 and values below 2.4e-324 round to zero.
+	 */
+	if (expt + digits > 309) {
+		*res = (duk_double_t) DUK_DOUBLE_INFINITY;
+		return 1;
+	}
+	if (expt + digits <= -324) {
+		*res = 0.0;
+		return 1;
+	}
+	DUK_ASSERT(expt >= -DUK__GRISU_CACHED_POWERS_OFFSET && expt <= 340);
+
+	x.f = f;
+	x.e = 0;
+	duk__diyfp_normalize(&x);
+	error = 0;
+
+	idx = (expt + DUK__GRISU_CACHED_POWERS_OFFSET) / DUK__GRISU_DECIMAL_EXP_DISTANCE;
+	DUK_ASSERT(idx >= 0 && idx < (duk_small_int_t) (sizeof(duk__grisu_cached_powers) / sizeof(duk__grisu_cached_power)));
+	cp = duk__grisu_cached_powers + idx;
+	adj = expt - cp->k;
+	DUK_ASSERT(adj >= 0 && adj < DUK__GRISU_DECIMAL_EXP_DISTANCE);
+
+	if (adj > 0) {
+		p.f = ((duk_uint64_t) duk__s2n_adjust_powers_f[adj - 1]) << 32;
+		p.e = duk__s2n_adjust_powers_e[adj - 1];
+		duk__diyfp_mul(&x, &p);
+		if (digits + adj > DUK__S2N_MAX_UINT64_DIGITS) {
+			/* product doesn't fit into 64 bits, rounded */
+			error += DUK__S2N_ERR_DENOM / 2;
+		}
+	}
+
+	p.f = (((duk_uint64_t) cp->f_hi) << 32) | (duk_uint64_t) cp->f_lo;
+	p.e = cp->e;
+	duk__diyfp_mul(&x, &p);
+	/* cached power error, product rounding, and the error of 'x' scaled
+	 * by the cached power (rounded up to one unit)
+	 */
+	error += DUK__S2N_ERR_DENOM / 2 + DUK__S2N_ERR_DENOM / 2 + (error != 0 ? 1 : 0);
+
+	old_e = x.e;
+	duk__diyfp_normalize(&x);
+	error <<= (old_e - x.e);
+
+	/* Number of significand bits available at this magnitude: 53 for
+	 * normals, less for denormals.
+	 */
+	order = 64 + x.e;
+	if (order >= DUK__IEEE_DOUBLE_DENORM_EXP + 53) {
+		sig_size = 53;
+	} else if (order <= DUK__IEEE_DOUBLE_DENORM_EXP) {
+		sig_size = 0;
+	} else {
+		sig_size = order - DUK__IEEE_DOUBLE_DENORM_EXP;
+	}
+	prec_count = 64 - sig_size;
+	if (prec_count + DUK__S2N_ERR_DENOM_LOG >= 64) {
+		/* Very small denormals: make room for the error denominator. */
+		shift = prec_count + DUK__S2N_ERR_DENOM_LOG - 64 + 1;
+		x.f >>= shift;
+		x.e += shift;
+		error = (error >> shift) + 1 + DUK__S2N_ERR_DENOM;
+		prec_count -= shift;
+	}
+	DUK_ASSERT(prec_count >= 11 && prec_count < 64 - DUK__S2N_ERR_DENOM_LOG);
+
+	prec_bits = (x.f & ((((duk_uint64_t) 1) << prec_count) - 1)) * DUK__S2N_ERR_DENOM;
+	half_way = (((duk_uint64_t) 1) << (prec_count - 1)) * DUK__S2N_ERR_DENOM;
+	if (half_way - error < prec_bits && prec_bits < half_way + error) {
+		DUK_DDD(DUK_DDDPRINT("radix 10 fast path too close to rounding boundary"));
+		return 0;
+	}
+
+	x.f >>= prec_count;
+	x.e += prec_count;
+	if (prec_bits >= half_way + error) {
+		x.f++;
+	}
+	*res = duk__diyfp_to_double(&x);
+	return 1;
+}
+
+#endif  /* DUK_USE_NUMCONV_FAST_PARSE */
+
+/*
+ *  Exact rounding for long decimal inputs
+ *
+ *  Dragon4 parsing only looks at the first 20 significant digits.  When
+ *  non-zero digits are dropped, the input is strictly above the truncated
+ *  value 'x' (already rounded to a double) and below the truncated value
+ *  incremented at its 20th digit.  The correctly rounded result is then
+ *  either 'x' or the next larger double, depending on which side of the
+ *  halfway point between the two the input lies.  The halfway point is an
+ *  exact binary fraction, so its decimal digits can be generated and
+ *  compared against all input digits.
+ */
+
+/* Compare the decimal digits at 'p' against the halfway point between 'x'
+ * and the next larger double.  The first significant input digit has the
+ * weight 10^q.  Returns < 0, 0, > 0 if the input is below, at, or above the
+ * halfway point.  On return nc_ctx->f contains the significand of 'x'.
+ */
+DUK_LOCAL duk_small_int_t duk__s2n_compare_halfway(duk__numconv_stringify_ctx *nc_ctx, const duk_uint8_t *p, duk_small_int_t q, duk_double_t x) {
+	duk_small_int_t ch;
+	duk_small_int_t dig;
+	duk_small_int_t seen_period = 0;
+	duk_small_int_t seen_nonzero = 0;
+
+	/* halfway = (2 * f + 1) * 2^(e - 1) = r / s * 10^q */
+	duk__dragon4_double_to_ctx(nc_ctx, x);
+	duk__bi_mul_small(&nc_ctx->t1, &nc_ctx->f, 2);
+	duk__bi_add_small(&nc_ctx->r, &nc_ctx->t1, 1);
+	if (nc_ctx->e >= 1) {
+		duk__bi_twoexp(&nc_ctx->mp, nc_ctx->e - 1);
+		duk__bi_mul_copy(&nc_ctx->r, &nc_ctx->mp, &nc_ctx->t1);
+		duk__bi_set_small(&nc_ctx->s, 1);
+	} else {
+		duk__bi_twoexp(&nc_ctx->s, 1 - nc_ctx->e);
+	}
+	if (q >= 0) {
+		duk__bi_exp_small(&nc_ctx->mp, 10, q, &nc_ctx->t1, &nc_ctx->t2);
+		duk__bi_mul_copy(&nc_ctx->s, &nc_ctx->mp, &nc_ctx->t1);
+	} else {
+		duk__bi_exp_small(&nc_ctx->mp, 10, -q, &nc_ctx->t1, &nc_ctx->t2);
+		duk__bi_mul_copy(&nc_ctx->r, &nc_ctx->mp, &nc_ctx->t1);
+	}
+
+	/* The input has already been validated, so it's enough to skip a
+	 * single period and leading zeroes, and stop at anything else.
+	 */
+	for (;;) {
+		ch = *p++;
+		if (ch == (duk_small_int_t) '.' && !seen_period) {
+			seen_period = 1;
+			continue;
+		}
+		if (ch < (duk_small_int_t) '0' || ch > (duk_small_int_t) '9') {
+			break;
+		}
+		if (ch == (duk_small_int_t) '0' && !seen_nonzero) {
+			continue;
+		}
+		seen_nonzero = 1;
+
+		/* Next halfway point digit; may be 10 for the first digit. */
+		dig = 0;
+		while (duk__bi_compare(&nc_ctx->r, &nc_ctx->s) >= 0) {
+			duk__bi_sub_copy(&nc_ctx->r, &nc_ctx->s, &nc_ctx->t1);
+			dig++;
+		}
+		if (dig != ch - (duk_small_int_t) '0') {
+			return (duk_small_int_t) (ch - (duk_small_int_t) '0' - dig);
+		}
+		duk__bi_mul_small_copy(&nc_ctx->r, 10, &nc_ctx->t1);
+	}
+
+	/* Input digits exhausted: at the halfway point only if it has no
+	 * further non-zero digits.
+	 */
+	return (duk__bi_is_zero(&nc_ctx->r) ? 0 : -1);
+}
+
 /*
  *  Exposed number-to-string API
  *
@@ -1590,26 +2283,74 @@ DUK_INTERNAL void duk_numconv_stringify(duk_context *ctx, duk_small_int_t radix,
 	 *  the fast path when special formatting (e.g. forced exponential)
 	 *  is in force.
 	 *
+	 *  With 64-bit arithmetic, integers up to 2**53 are handled too:
+	 *  all such integers are exactly representable, so the shortest
+	 *  round-tripping form is the exact integer in any radix.
+	 *
 	 *  XXX: could save space by supporting radix 10 only and using
 	 *  sprintf "%lu" for the fast path and for exponent formatting.
 	 */
 
-	uval = (unsigned int) x;
-	if (((double) uval) == x &&  /* integer number in range */
-	    flags == 0) {            /* no special formatting */
+	if (flags == 0 && x < 9007199254740992.0) {  /* no special formatting, below 2**53 */
 		/* use bigint area as a temp */
 		duk_uint8_t *buf = (duk_uint8_t *) (&nc_ctx->f);
 		duk_uint8_t *p = buf;
 
-		DUK_ASSERT(DUK__NUMCONV_CTX_BIGINTS_SIZE >= 32 + 1);  /* max size: radix=2 + sign */
-		if (neg && uval != 0) {
-			/* no negative sign for zero */
-			*p++ = (duk_uint8_t) '-';
+		DUK_ASSERT(DUK__NUMCONV_CTX_BIGINTS_SIZE >= 64 + 1);  /* max size: radix=2 + sign */
+		if (x <= 4294967295.0) {
+			uval = (duk_uint32_t) x;
+			if (((double) uval) == x) {  /* integer number in range */
+#if defined(DUK_USE_INTSTR_CACHE)
+				if (radix == 10 && uval < DUK_USE_INTSTR_CACHE_SIZE && (!neg || uval == 0)) {
+					duk_push_hstring(ctx, duk_heap_string_intern_u32_checked((duk_hthread *) ctx, uval));
+					return;
+				}
+#endif
+				if (neg && uval != 0) {
+					/* no negative sign for zero */
+					*p++ = (duk_uint8_t) '-';
+				}
+				p += duk__dragon4_format_uint32(p, uval, radix);
+				duk_push_lstring(ctx, (const char *) buf, (duk_size_t) (p - buf));
+				return;
+			}
 		}
-		p += duk__dragon4_format_uint32(p, uval, radix);
-		duk_push_lstring(ctx, (const char *) buf, (duk_size_t) (p - buf));
-		return;
+#if defined(DUK_USE_64BIT_OPS)
+		else {
+			duk_uint64_t uval64 = (duk_uint64_t) x;
+			if (((double) uval64) == x) {  /* integer number in range */
+				if (neg) {
+					*p++ = (duk_uint8_t) '-';
+				}
+				p += duk__dragon4_format_uint64(p, uval64, radix);
+				duk_push_lstring(ctx, (const char *) buf, (duk_size_t) (p - buf));
+				return;
+			}
+		}
+#endif
+	}
+
+#if defined(DUK_USE_NUMCONV_GRISU3)
+	/*
+	 *  Shortest radix 10 output without bigints when possible.  Zero
+	 *  goes through the Dragon4 setup below (it may need special
+	 *  formatting), and fixed format output is always Dragon4.
+	 */
+
+	if (radix == 10 && c != DUK_FP_ZERO && !(flags & DUK_N2S_FLAG_FIXED_FORMAT)) {
+		if (duk__grisu3_generate(nc_ctx, x)) {
+			nc_ctx->is_s2n = 0;
+			nc_ctx->is_fixed = 0;
+			nc_ctx->abs_pos = 0;
+			nc_ctx->req_digits = 0;
+			nc_ctx->b = 2;
+			nc_ctx->B = 10;
+			duk__dragon4_convert_and_push(nc_ctx, ctx, radix, digits, flags, neg);
+			return;
+		}
+		DUK_DDD(DUK_DDDPRINT("grisu3 failed, fall back to dragon4: %lf", (double) x));
 	}
+#endif
 
 	/*
 	 *  Dragon4 setup.
@@ -1757,9 +2498,15 @@ DUK_INTERNAL void duk_numconv_parse(duk_context *ctx, duk_small_int_t radix, duk
 	duk_small_int_t dig_frac;
 	duk_small_int_t dig_expt;
 	duk_small_int_t dig_prec;
+	duk_small_int_t dig_dropped;
 	const duk__exp_limits *explim;
 	const duk_uint8_t *p;
+	const duk_uint8_t *p_digits;
 	duk_small_int_t ch;
+#if defined(DUK_USE_NUMCONV_FAST_PARSE)
+	duk_uint64_t f64;
+	duk_small_int_t f64_active;
+#endif
 
 	/* This seems to waste a lot of stack frame entries, but good compilers
 	 * will compute these as needed below.  Some of these initial flags are
@@ -1887,15 +2634,21 @@ DUK_INTERNAL void duk_numconv_parse(duk_context *ctx, duk_small_int_t radix, duk
 	 *  be worth it: the multiplications for building 'f' are not
 	 *  expensive when 'f' is small.
 	 *
+	 *  With DUK_USE_NUMCONV_FAST_PARSE the significand is accumulated into
+	 *  a 64-bit integer ('f64') while it fits, and only moved into the
+	 *  bigint 'f' when it grows too large or the fast paths fail.
+	 *
 	 *  The significand ('f') must contain enough bits of (apparent)
 	 *  accuracy, so that Dragon4 will generate enough binary output digits.
 	 *  For decimal numbers, this means generating a 20-digit significand,
 	 *  which should yield enough practical accuracy to parse IEEE doubles.
 	 *  In fact, the Ecmascript specification explicitly allows an
 	 *  implementation to treat digits beyond 20 as zeroes (and even
-	 *  to round the 20th digit upwards).  For non-decimal numbers, the
-	 *  appropriate number of digits has been precomputed for comparable
-	 *  accuracy.
+	 *  to round the 20th digit upwards).  Duktape still rounds decimal
+	 *  inputs correctly: if non-zero digits were ignored, the Dragon4
+	 *  result is checked against all input digits afterwards.  For
+	 *  non-decimal numbers, the appropriate number of digits has been
+	 *  precomputed for comparable accuracy.
 	 *
 	 *  Digit counts:
 	 *
@@ -1925,7 +2678,12 @@ DUK_INTERNAL void duk_numconv_parse(duk_context *ctx, duk_small_int_t radix, duk
 	 */
 
 	duk__bi_set_small(&nc_ctx->f, 0);
+#if defined(DUK_USE_NUMCONV_FAST_PARSE)
+	f64 = 0;
+	f64_active = 1;
+#endif
 	dig_prec = 0;
+	dig_dropped = 0;
 	dig_lzero = 0;
 	dig_whole = 0;
 	dig_frac = -1;
@@ -1933,6 +2691,7 @@ DUK_INTERNAL void duk_numconv_parse(duk_context *ctx, duk_small_int_t radix, duk
 	expt = 0;
 	expt_adj = 0;  /* essentially tracks digit position of lowest 'f' digit */
 	expt_neg = 0;
+	p_digits = p;
 	for (;;) {
 		ch = *p++;
 
@@ -2029,7 +2788,15 @@ DUK_INTERNAL void duk_numconv_parse(duk_context *ctx, duk_small_int_t radix, duk
 			if (dig_prec < duk__str2num_digits_for_radix[radix - 2]) {
 				/* significant from precision perspective */
 
-				duk_small_int_t f_zero = duk__bi_is_zero(&nc_ctx->f);
+				duk_small_int_t f_zero;
+#if defined(DUK_USE_NUMCONV_FAST_PARSE)
+				if (f64_active) {
+					f_zero = (f64 == 0);
+				} else
+#endif
+				{
+					f_zero = duk__bi_is_zero(&nc_ctx->f);
+				}
 				if (f_zero && dig == 0) {
 					/* Leading zero is not counted towards precision digits; not
 					 * in the integer part, nor in the fraction part.
@@ -2038,18 +2805,33 @@ DUK_INTERNAL void duk_numconv_parse(duk_context *ctx, duk_small_int_t radix, duk
 						dig_lzero++;
 					}
 				} else {
-					/* XXX: join these ops (multiply-accumulate), but only if
-					 * code footprint decreases.
-					 */
-					duk__bi_mul_small(&nc_ctx->t1, &nc_ctx->f, radix);
-					duk__bi_add_small(&nc_ctx->f, &nc_ctx->t1, dig);
+#if defined(DUK_USE_NUMCONV_FAST_PARSE)
+					if (f64_active && f64 >= DUK__S2N_FAST_F_LIMIT) {
+						duk__bi_set_uint64(&nc_ctx->f, f64);
+						f64_active = 0;
+					}
+					if (f64_active) {
+						f64 = f64 * (duk_uint64_t) radix + (duk_uint64_t) dig;
+					} else
+#endif
+					{
+						/* XXX: join these ops (multiply-accumulate), but only if
+						 * code footprint decreases.
+						 */
+						duk__bi_mul_small(&nc_ctx->t1, &nc_ctx->f, radix);
+						duk__bi_add_small(&nc_ctx->f, &nc_ctx->t1, dig);
+					}
 					dig_prec++;
 				}
 			} else {
 				/* Ignore digits beyond a radix-specific limit, but note them
-				 * in expt_adj.
+				 * in expt_adj.  For radix 10, non-zero ignored digits are
+				 * taken into account when rounding the Dragon4 result.
 				 */
 				expt_adj++;
+				if (dig != 0 && radix == 10) {
+					dig_dropped = 1;
+				}
 			}
 
 			if (dig_frac >= 0) {
@@ -2138,6 +2920,33 @@ DUK_INTERNAL void duk_numconv_parse(duk_context *ctx, duk_small_int_t radix, duk
 	                     (long) expt, (long) expt_adj, (long) (expt + expt_adj)));
 	expt += expt_adj;
 
+#if defined(DUK_USE_NUMCONV_FAST_PARSE)
+	/* 'f64' never holds more than 19 digits, so inputs with ignored
+	 * digits always take the Dragon4 path.
+	 */
+	DUK_ASSERT(!(f64_active && dig_dropped));
+	if (f64_active) {
+		if (f64 == 0) {
+			/* Also covers e.g. "0e1000".  Remember to respect zero sign. */
+			res = 0.0;
+			goto negcheck_and_ret;
+		}
+		if (expt == 0) {
+			/* Integer conversion rounds to nearest, ties to even, so this
+			 * is exact up to 53 bits and correctly rounded above that.
+			 */
+			DUK_DDD(DUK_DDDPRINT("fast path number parse, 64-bit integer"));
+			res = (duk_double_t) f64;
+			goto negcheck_and_ret;
+		}
+		if (radix == 10 && duk__s2n_fast_radix10(f64, dig_prec, expt, &res)) {
+			DUK_DDD(DUK_DDDPRINT("fast path number parse, radix 10"));
+			goto negcheck_and_ret;
+		}
+		duk__bi_set_uint64(&nc_ctx->f, f64);
+	}
+#endif
+
 	/* Fast path check. */
 
 	if (nc_ctx->f.n <= 1 &&   /* 32-bit value */
@@ -2242,6 +3051,28 @@ DUK_INTERNAL void duk_numconv_parse(duk_context *ctx, duk_small_int_t radix, duk
 	 */
 
 	duk__dragon4_ctx_to_double(nc_ctx, &res);
+
+	/*
+	 *  Round correctly when non-zero digits were ignored.
+	 */
+
+	if (dig_dropped && !DUK_ISINF(res)) {
+		duk_small_int_t c;
+		duk_double_union u;
+		duk_uint32_t lo;
+
+		DUK_ASSERT(dig_prec == duk__str2num_digits_for_radix[radix - 2]);
+		c = duk__s2n_compare_halfway(nc_ctx, p_digits, expt + dig_prec - 1, res);
+		DUK_DDD(DUK_DDDPRINT("ignored digits, compare to halfway point -> %ld", (long) c));
+		if (c > 0 || (c == 0 && !duk__bi_is_even(&nc_ctx->f))) {
+			/* Next larger double; may become Infinity. */
+			DUK_DBLUNION_SET_DOUBLE(&u, res);
+			lo = DUK_DBLUNION_GET_LOW32(&u) + 1U;
+			DUK_DBLUNION_SET_HIGH32(&u, DUK_DBLUNION_GET_HIGH32(&u) + (lo == 0U ? 1U : 0U));
+			DUK_DBLUNION_SET_LOW32(&u, lo);
+			res = DUK_DBLUNION_GET_DOUBLE(&u);
+		}
+	}
 	goto negcheck_and_ret;
 
  negcheck_and_ret:
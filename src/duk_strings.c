@@ -44,6 +44,7 @@ DUK_INTERNAL const char *duk_str_object_alloc_failed = "object alloc failed";
 DUK_INTERNAL const char *duk_str_thread_alloc_failed = "thread alloc failed";
 DUK_INTERNAL const char *duk_str_func_alloc_failed = "func alloc failed";
 DUK_INTERNAL const char *duk_str_buffer_alloc_failed = "buffer alloc failed";
+DUK_INTERNAL const char *duk_str_memory_limit_exceeded = "memory limit exceeded";
 DUK_INTERNAL const char *duk_str_pop_too_many = "attempt to pop too many entries";
 DUK_INTERNAL const char *duk_str_buffer_not_dynamic = "buffer is not dynamic";
 DUK_INTERNAL const char *duk_str_failed_to_extend_valstack = "failed to extend valstack";
@@ -68,6 +68,7 @@ DUK_INTERNAL_DECL const char *duk_str_not_configurable;
 #define DUK_STR_THREAD_ALLOC_FAILED duk_str_thread_alloc_failed
 #define DUK_STR_FUNC_ALLOC_FAILED duk_str_func_alloc_failed
 #define DUK_STR_BUFFER_ALLOC_FAILED duk_str_buffer_alloc_failed
+#define DUK_STR_MEMORY_LIMIT_EXCEEDED duk_str_memory_limit_exceeded
 #define DUK_STR_POP_TOO_MANY duk_str_pop_too_many
 #define DUK_STR_BUFFER_NOT_DYNAMIC duk_str_buffer_not_dynamic
 #define DUK_STR_FAILED_TO_EXTEND_VALSTACK duk_str_failed_to_extend_valstack
@@ -107,6 +108,7 @@ DUK_INTERNAL_DECL const char *duk_str_object_alloc_failed;
 DUK_INTERNAL_DECL const char *duk_str_thread_alloc_failed;
 DUK_INTERNAL_DECL const char *duk_str_func_alloc_failed;
 DUK_INTERNAL_DECL const char *duk_str_buffer_alloc_failed;
+DUK_INTERNAL_DECL const char *duk_str_memory_limit_exceeded;
 DUK_INTERNAL_DECL const char *duk_str_pop_too_many;
 DUK_INTERNAL_DECL const char *duk_str_buffer_not_dynamic;
 DUK_INTERNAL_DECL const char *duk_str_failed_to_extend_valstack;
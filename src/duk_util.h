@@ -42,6 +42,9 @@ struct duk_bitencoder_ctx {
 DUK_INTERNAL_DECL duk_uint8_t duk_lc_digits[36];
 DUK_INTERNAL_DECL duk_uint8_t duk_uc_nybbles[16];
 DUK_INTERNAL_DECL duk_int8_t duk_hex_dectab[256];
+#if defined(DUK_USE_HEX_FASTPATH)
+DUK_INTERNAL_DECL duk_uint16_t duk_hex_enctab[256];
+#endif
 #endif  /* !DUK_SINGLE_FILE */
 
 /* Note: assumes that duk_util_probe_steps size is 32 */
@@ -22,6 +22,57 @@ DUK_INTERNAL duk_uint8_t duk_uc_nybbles[16] = {
 	'8', '9', 'A', 'B', 'C', 'D', 'E', 'F'
 };
 
+#if defined(DUK_USE_HEX_FASTPATH)
+/*
+ *  Table for encoding a byte as two lowercase ASCII hex digits.  Each entry
+ *  has the digit bytes in memory order so that it can be written with a
+ *  single two-byte copy.
+ */
+
+#if defined(DUK_USE_INTEGER_BE)
+#define DUK__MKHEX(hi,lo)  ((duk_uint16_t) ((((duk_uint16_t) (hi)) << 8) | ((duk_uint16_t) (lo))))
+#else
+#define DUK__MKHEX(hi,lo)  ((duk_uint16_t) ((((duk_uint16_t) (lo)) << 8) | ((duk_uint16_t) (hi))))
+#endif
+
+DUK_INTERNAL duk_uint16_t duk_hex_enctab[256] = {
+	DUK__MKHEX('0', '0'), DUK__MKHEX('0', '1'), DUK__MKHEX('0', '2'), DUK__MKHEX('0', '3'), DUK__MKHEX('0', '4'), DUK__MKHEX('0', '5'), DUK__MKHEX('0', '6'), DUK__MKHEX('0', '7'),
+	DUK__MKHEX('0', '8'), DUK__MKHEX('0', '9'), DUK__MKHEX('0', 'a'), DUK__MKHEX('0', 'b'), DUK__MKHEX('0', 'c'), DUK__MKHEX('0', 'd'), DUK__MKHEX('0', 'e'), DUK__MKHEX('0', 'f'),
+	DUK__MKHEX('1', '0'), DUK__MKHEX('1', '1'), DUK__MKHEX('1', '2'), DUK__MKHEX('1', '3'), DUK__MKHEX('1', '4'), DUK__MKHEX('1', '5'), DUK__MKHEX('1', '6'), DUK__MKHEX('1', '7'),
+	DUK__MKHEX('1', '8'), DUK__MKHEX('1', '9'), DUK__MKHEX('1', 'a'), DUK__MKHEX('1', 'b'), DUK__MKHEX('1', 'c'), DUK__MKHEX('1', 'd'), DUK__MKHEX('1', 'e'), DUK__MKHEX('1', 'f'),
+	DUK__MKHEX('2', '0'), DUK__MKHEX('2', '1'), DUK__MKHEX('2', '2'), DUK__MKHEX('2', '3'), DUK__MKHEX('2', '4'), DUK__MKHEX('2', '5'), DUK__MKHEX('2', '6'), DUK__MKHEX('2', '7'),
+	DUK__MKHEX('2', '8'), DUK__MKHEX('2', '9'), DUK__MKHEX('2', 'a'), DUK__MKHEX('2', 'b'), DUK__MKHEX('2', 'c'), DUK__MKHEX('2', 'd'), DUK__MKHEX('2', 'e'), DUK__MKHEX('2', 'f'),
+	DUK__MKHEX('3', '0'), DUK__MKHEX('3', '1'), DUK__MKHEX('3', '2'), DUK__MKHEX('3', '3'), DUK__MKHEX('3', '4'), DUK__MKHEX('3', '5'), DUK__MKHEX('3', '6'), DUK__MKHEX('3', '7'),
+	DUK__MKHEX('3', '8'), DUK__MKHEX('3', '9'), DUK__MKHEX('3', 'a'), DUK__MKHEX('3', 'b'), DUK__MKHEX('3', 'c'), DUK__MKHEX('3', 'd'), DUK__MKHEX('3', 'e'), DUK__MKHEX('3', 'f'),
+	DUK__MKHEX('4', '0'), DUK__MKHEX('4', '1'), DUK__MKHEX('4', '2'), DUK__MKHEX('4', '3'), DUK__MKHEX('4', '4'), DUK__MKHEX('4', '5'), DUK__MKHEX('4', '6'), DUK__MKHEX('4', '7'),
+	DUK__MKHEX('4', '8'), DUK__MKHEX('4', '9'), DUK__MKHEX('4', 'a'), DUK__MKHEX('4', 'b'), DUK__MKHEX('4', 'c'), DUK__MKHEX('4', 'd'), DUK__MKHEX('4', 'e'), DUK__MKHEX('4', 'f'),
+	DUK__MKHEX('5', '0'), DUK__MKHEX('5', '1'), DUK__MKHEX('5', '2'), DUK__MKHEX('5', '3'), DUK__MKHEX('5', '4'), DUK__MKHEX('5', '5'), DUK__MKHEX('5', '6'), DUK__MKHEX('5', '7'),
+	DUK__MKHEX('5', '8'), DUK__MKHEX('5', '9'), DUK__MKHEX('5', 'a'), DUK__MKHEX('5', 'b'), DUK__MKHEX('5', 'c'), DUK__MKHEX('5', 'd'), DUK__MKHEX('5', 'e'), DUK__MKHEX('5', 'f'),
+	DUK__MKHEX('6', '0'), DUK__MKHEX('6', '1'), DUK__MKHEX('6', '2'), DUK__MKHEX('6', '3'), DUK__MKHEX('6', '4'), DUK__MKHEX('6', '5'), DUK__MKHEX('6', '6'), DUK__MKHEX('6', '7'),
+	DUK__MKHEX('6', '8'), DUK__MKHEX('6', '9'), DUK__MKHEX('6', 'a'), DUK__MKHEX('6', 'b'), DUK__MKHEX('6', 'c'), DUK__MKHEX('6', 'd'), DUK__MKHEX('6', 'e'), DUK__MKHEX('6', 'f'),
+	DUK__MKHEX('7', '0'), DUK__MKHEX('7', '1'), DUK__MKHEX('7', '2'), DUK__MKHEX('7', '3'), DUK__MKHEX('7', '4'), DUK__MKHEX('7', '5'), DUK__MKHEX('7', '6'), DUK__MKHEX('7', '7'),
+	DUK__MKHEX('7', '8'), DUK__MKHEX('7', '9'), DUK__MKHEX('7', 'a'), DUK__MKHEX('7', 'b'), DUK__MKHEX('7', 'c'), DUK__MKHEX('7', 'd'), DUK__MKHEX('7', 'e'), DUK__MKHEX('7', 'f'),
+	DUK__MKHEX('8', '0'), DUK__MKHEX('8', '1'), DUK__MKHEX('8', '2'), DUK__MKHEX('8', '3'), DUK__MKHEX('8', '4'), DUK__MKHEX('8', '5'), DUK__MKHEX('8', '6'), DUK__MKHEX('8', '7'),
+	DUK__MKHEX('8', '8'), DUK__MKHEX('8', '9'), DUK__MKHEX('8', 'a'), DUK__MKHEX('8', 'b'), DUK__MKHEX('8', 'c'), DUK__MKHEX('8', 'd'), DUK__MKHEX('8', 'e'), DUK__MKHEX('8', 'f'),
+	DUK__MKHEX('9', '0'), DUK__MKHEX('9', '1'), DUK__MKHEX('9', '2'), DUK__MKHEX('9', '3'), DUK__MKHEX('9', '4'), DUK__MKHEX('9', '5'), DUK__MKHEX('9', '6'), DUK__MKHEX('9', '7'),
+	DUK__MKHEX('9', '8'), DUK__MKHEX('9', '9'), DUK__MKHEX('9', 'a'), DUK__MKHEX('9', 'b'), DUK__MKHEX('9', 'c'), DUK__MKHEX('9', 'd'), DUK__MKHEX('9', 'e'), DUK__MKHEX('9', 'f'),
+	DUK__MKHEX('a', '0'), DUK__MKHEX('a', '1'), DUK__MKHEX('a', '2'), DUK__MKHEX('a', '3'), DUK__MKHEX('a', '4'), DUK__MKHEX('a', '5'), DUK__MKHEX('a', '6'), DUK__MKHEX('a', '7'),
+	DUK__MKHEX('a', '8'), DUK__MKHEX('a', '9'), DUK__MKHEX('a', 'a'), DUK__MKHEX('a', 'b'), DUK__MKHEX('a', 'c'), DUK__MKHEX('a', 'd'), DUK__MKHEX('a', 'e'), DUK__MKHEX('a', 'f'),
+	DUK__MKHEX('b', '0'), DUK__MKHEX('b', '1'), DUK__MKHEX('b', '2'), DUK__MKHEX('b', '3'), DUK__MKHEX('b', '4'), DUK__MKHEX('b', '5'), DUK__MKHEX('b', '6'), DUK__MKHEX('b', '7'),
+	DUK__MKHEX('b', '8'), DUK__MKHEX('b', '9'), DUK__MKHEX('b', 'a'), DUK__MKHEX('b', 'b'), DUK__MKHEX('b', 'c'), DUK__MKHEX('b', 'd'), DUK__MKHEX('b', 'e'), DUK__MKHEX('b', 'f'),
+	DUK__MKHEX('c', '0'), DUK__MKHEX('c', '1'), DUK__MKHEX('c', '2'), DUK__MKHEX('c', '3'), DUK__MKHEX('c', '4'), DUK__MKHEX('c', '5'), DUK__MKHEX('c', '6'), DUK__MKHEX('c', '7'),
+	DUK__MKHEX('c', '8'), DUK__MKHEX('c', '9'), DUK__MKHEX('c', 'a'), DUK__MKHEX('c', 'b'), DUK__MKHEX('c', 'c'), DUK__MKHEX('c', 'd'), DUK__MKHEX('c', 'e'), DUK__MKHEX('c', 'f'),
+	DUK__MKHEX('d', '0'), DUK__MKHEX('d', '1'), DUK__MKHEX('d', '2'), DUK__MKHEX('d', '3'), DUK__MKHEX('d', '4'), DUK__MKHEX('d', '5'), DUK__MKHEX('d', '6'), DUK__MKHEX('d', '7'),
+	DUK__MKHEX('d', '8'), DUK__MKHEX('d', '9'), DUK__MKHEX('d', 'a'), DUK__MKHEX('d', 'b'), DUK__MKHEX('d', 'c'), DUK__MKHEX('d', 'd'), DUK__MKHEX('d', 'e'), DUK__MKHEX('d', 'f'),
+	DUK__MKHEX('e', '0'), DUK__MKHEX('e', '1'), DUK__MKHEX('e', '2'), DUK__MKHEX('e', '3'), DUK__MKHEX('e', '4'), DUK__MKHEX('e', '5'), DUK__MKHEX('e', '6'), DUK__MKHEX('e', '7'),
+	DUK__MKHEX('e', '8'), DUK__MKHEX('e', '9'), DUK__MKHEX('e', 'a'), DUK__MKHEX('e', 'b'), DUK__MKHEX('e', 'c'), DUK__MKHEX('e', 'd'), DUK__MKHEX('e', 'e'), DUK__MKHEX('e', 'f'),
+	DUK__MKHEX('f', '0'), DUK__MKHEX('f', '1'), DUK__MKHEX('f', '2'), DUK__MKHEX('f', '3'), DUK__MKHEX('f', '4'), DUK__MKHEX('f', '5'), DUK__MKHEX('f', '6'), DUK__MKHEX('f', '7'),
+	DUK__MKHEX('f', '8'), DUK__MKHEX('f', '9'), DUK__MKHEX('f', 'a'), DUK__MKHEX('f', 'b'), DUK__MKHEX('f', 'c'), DUK__MKHEX('f', 'd'), DUK__MKHEX('f', 'e'), DUK__MKHEX('f', 'f')
+};
+
+#undef DUK__MKHEX
+#endif  /* DUK_USE_HEX_FASTPATH */
+
 /*
  *  Table for decoding ASCII hex digits, -1 if invalid.
  */
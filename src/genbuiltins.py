@@ -97,7 +97,7 @@ DEFAULT_PROPERTY_ATTRIBUTES = "wc"
 
 # encoding constants (must match duk_hthread_builtins.c)
 CLASS_BITS = 5
-BIDX_BITS = 6
+BIDX_BITS = 7
 STRIDX_BITS = 9   # would be nice to optimize to 8
 NATIDX_BITS = 8
 NUM_NORMAL_PROPS_BITS = 6
@@ -112,7 +112,7 @@ MAGIC_BITS = 16
 
 NARGS_VARARGS_MARKER = 0x07
 NO_CLASS_MARKER = 0x00   # 0 = DUK_HOBJECT_CLASS_UNUSED 
-NO_BIDX_MARKER = 0x3f
+NO_BIDX_MARKER = 0x7f
 NO_STRIDX_MARKER = 0xff
 
 PROP_TYPE_DOUBLE = 0
@@ -155,6 +155,18 @@ BI_MATH_TAN_IDX =    12
 BI_MATH_ATAN2_IDX =  0
 BI_MATH_POW_IDX =    1
 
+# magic values for typed arrays and DataView, element types must match
+# duk_hbufferobject.h
+BI_ELEM_UINT8 =         0
+BI_ELEM_UINT8CLAMPED =  1
+BI_ELEM_INT8 =          2
+BI_ELEM_UINT16 =        3
+BI_ELEM_INT16 =         4
+BI_ELEM_UINT32 =        5
+BI_ELEM_INT32 =         6
+BI_ELEM_FLOAT32 =       7
+BI_ELEM_FLOAT64 =       8
+
 # numeric indices must match duk_hobject.h class numbers
 _classnames = [
 	'Unused',
@@ -176,6 +188,19 @@ _classnames = [
 	'Buffer',
 	'Pointer',
 	'Thread',
+	'ArrayBuffer',
+	'DataView',
+	'Int8Array',
+	'Uint8Array',
+	'Uint8ClampedArray',
+	'Int16Array',
+	'Uint16Array',
+	'Int32Array',
+	'Uint32Array',
+	'Float32Array',
+	'Float64Array',
+	'WeakMap',
+	'WeakRef',
 ]
 _class2num = {}
 for i,v in enumerate(_classnames):
@@ -236,6 +261,18 @@ bi_global = {
 
 		# ES6 (draft)
 		{ 'name': 'Proxy',			'value': { 'type': 'builtin', 'id': 'bi_proxy_constructor' } },
+		{ 'name': 'ArrayBuffer',		'value': { 'type': 'builtin', 'id': 'bi_arraybuffer_constructor' } },
+		{ 'name': 'DataView',			'value': { 'type': 'builtin', 'id': 'bi_dataview_constructor' } },
+		{ 'name': 'Int8Array',			'value': { 'type': 'builtin', 'id': 'bi_int8array_constructor' } },
+		{ 'name': 'Uint8Array',			'value': { 'type': 'builtin', 'id': 'bi_uint8array_constructor' } },
+		{ 'name': 'Uint8ClampedArray',		'value': { 'type': 'builtin', 'id': 'bi_uint8clampedarray_constructor' } },
+		{ 'name': 'Int16Array',			'value': { 'type': 'builtin', 'id': 'bi_int16array_constructor' } },
+		{ 'name': 'Uint16Array',		'value': { 'type': 'builtin', 'id': 'bi_uint16array_constructor' } },
+		{ 'name': 'Int32Array',			'value': { 'type': 'builtin', 'id': 'bi_int32array_constructor' } },
+		{ 'name': 'Uint32Array',		'value': { 'type': 'builtin', 'id': 'bi_uint32array_constructor' } },
+		{ 'name': 'Float32Array',		'value': { 'type': 'builtin', 'id': 'bi_float32array_constructor' } },
+		{ 'name': 'Float64Array',		'value': { 'type': 'builtin', 'id': 'bi_float64array_constructor' } },
+		{ 'name': 'WeakMap',			'value': { 'type': 'builtin', 'id': 'bi_weakmap_constructor' } },
 
 		# Duktape specific
 		{ 'name': 'Duktape',			'value': { 'type': 'builtin', 'id': 'bi_duktape' } },
@@ -1120,6 +1157,7 @@ bi_duktape = {
 		{ 'name': 'Pointer',			'value': { 'type': 'builtin', 'id': 'bi_pointer_constructor' } },
 		{ 'name': 'Thread',			'value': { 'type': 'builtin', 'id': 'bi_thread_constructor' } },
 		{ 'name': 'Logger',			'value': { 'type': 'builtin', 'id': 'bi_logger_constructor' } },
+		{ 'name': 'WeakRef',			'value': { 'type': 'builtin', 'id': 'bi_weakref_constructor' } },
 	],
 	'functions': [
 		{ 'name': 'info',			'native': 'duk_bi_duktape_object_info',		'length': 1 },
@@ -1129,6 +1167,7 @@ bi_duktape = {
 		{ 'name': 'enc',			'native': 'duk_bi_duktape_object_enc',		'length': 0,	'varargs': True },
 		{ 'name': 'dec',			'native': 'duk_bi_duktape_object_dec',		'length': 0,	'varargs': True },
 		{ 'name': 'compact',			'native': 'duk_bi_duktape_object_compact',	'length': 1 },
+		{ 'name': 'heapStats',			'native': 'duk_bi_duktape_object_heap_stats',	'length': 0 },
 	],
 }
 
@@ -1202,6 +1241,414 @@ bi_buffer_prototype = {
 	],
 }
 
+bi_arraybuffer_constructor = {
+	'internal_prototype': 'bi_function_prototype',
+	'external_prototype': 'bi_arraybuffer_prototype',
+	'class': 'Function',
+	'name': 'ArrayBuffer',
+
+	'length': 1,
+	'native': 'duk_bi_arraybuffer_constructor',
+	'callable': True,
+	'constructable': True,
+
+	'values': [],
+	'functions': [
+		{ 'name': 'isView',			'native': 'duk_bi_arraybuffer_isview',			'length': 1 },
+	]
+}
+
+bi_arraybuffer_prototype = {
+	'internal_prototype': 'bi_object_prototype',
+	'external_constructor': 'bi_arraybuffer_constructor',
+	'class': 'Object',
+
+	# 'byteLength' is a virtual own property of ArrayBuffer instances.
+
+	'values': [
+	],
+	'functions': [
+		{ 'name': 'slice',			'native': 'duk_bi_arraybuffer_prototype_slice',		'length': 2 },
+	],
+}
+
+bi_dataview_constructor = {
+	'internal_prototype': 'bi_function_prototype',
+	'external_prototype': 'bi_dataview_prototype',
+	'class': 'Function',
+	'name': 'DataView',
+
+	'length': 3,
+	'native': 'duk_bi_dataview_constructor',
+	'callable': True,
+	'constructable': True,
+
+	'values': [],
+	'functions': [
+	]
+}
+
+bi_dataview_prototype = {
+	'internal_prototype': 'bi_object_prototype',
+	'external_constructor': 'bi_dataview_constructor',
+	'class': 'Object',
+
+	# 'buffer', 'byteLength', and 'byteOffset' are virtual own properties
+	# of DataView instances.
+
+	'values': [
+	],
+	'functions': [
+		{ 'name': 'getInt8',			'native': 'duk_bi_dataview_prototype_getter',	'length': 1,	'nargs': 2,	'magic': { 'type': 'plain', 'value': BI_ELEM_INT8 } },
+		{ 'name': 'getUint8',			'native': 'duk_bi_dataview_prototype_getter',	'length': 1,	'nargs': 2,	'magic': { 'type': 'plain', 'value': BI_ELEM_UINT8 } },
+		{ 'name': 'getInt16',			'native': 'duk_bi_dataview_prototype_getter',	'length': 1,	'nargs': 2,	'magic': { 'type': 'plain', 'value': BI_ELEM_INT16 } },
+		{ 'name': 'getUint16',			'native': 'duk_bi_dataview_prototype_getter',	'length': 1,	'nargs': 2,	'magic': { 'type': 'plain', 'value': BI_ELEM_UINT16 } },
+		{ 'name': 'getInt32',			'native': 'duk_bi_dataview_prototype_getter',	'length': 1,	'nargs': 2,	'magic': { 'type': 'plain', 'value': BI_ELEM_INT32 } },
+		{ 'name': 'getUint32',			'native': 'duk_bi_dataview_prototype_getter',	'length': 1,	'nargs': 2,	'magic': { 'type': 'plain', 'value': BI_ELEM_UINT32 } },
+		{ 'name': 'getFloat32',			'native': 'duk_bi_dataview_prototype_getter',	'length': 1,	'nargs': 2,	'magic': { 'type': 'plain', 'value': BI_ELEM_FLOAT32 } },
+		{ 'name': 'getFloat64',			'native': 'duk_bi_dataview_prototype_getter',	'length': 1,	'nargs': 2,	'magic': { 'type': 'plain', 'value': BI_ELEM_FLOAT64 } },
+		{ 'name': 'setInt8',			'native': 'duk_bi_dataview_prototype_setter',	'length': 2,	'nargs': 3,	'magic': { 'type': 'plain', 'value': BI_ELEM_INT8 } },
+		{ 'name': 'setUint8',			'native': 'duk_bi_dataview_prototype_setter',	'length': 2,	'nargs': 3,	'magic': { 'type': 'plain', 'value': BI_ELEM_UINT8 } },
+		{ 'name': 'setInt16',			'native': 'duk_bi_dataview_prototype_setter',	'length': 2,	'nargs': 3,	'magic': { 'type': 'plain', 'value': BI_ELEM_INT16 } },
+		{ 'name': 'setUint16',			'native': 'duk_bi_dataview_prototype_setter',	'length': 2,	'nargs': 3,	'magic': { 'type': 'plain', 'value': BI_ELEM_UINT16 } },
+		{ 'name': 'setInt32',			'native': 'duk_bi_dataview_prototype_setter',	'length': 2,	'nargs': 3,	'magic': { 'type': 'plain', 'value': BI_ELEM_INT32 } },
+		{ 'name': 'setUint32',			'native': 'duk_bi_dataview_prototype_setter',	'length': 2,	'nargs': 3,	'magic': { 'type': 'plain', 'value': BI_ELEM_UINT32 } },
+		{ 'name': 'setFloat32',			'native': 'duk_bi_dataview_prototype_setter',	'length': 2,	'nargs': 3,	'magic': { 'type': 'plain', 'value': BI_ELEM_FLOAT32 } },
+		{ 'name': 'setFloat64',			'native': 'duk_bi_dataview_prototype_setter',	'length': 2,	'nargs': 3,	'magic': { 'type': 'plain', 'value': BI_ELEM_FLOAT64 } },
+	],
+}
+
+# Shared prototype of the typed array prototypes (%TypedArray%.prototype in
+# ES6).  There's no shared %TypedArray% constructor now.
+
+bi_typedarray_prototype = {
+	'internal_prototype': 'bi_object_prototype',
+	'class': 'Object',
+
+	# 'buffer', 'byteLength', 'byteOffset', and 'length' are virtual own
+	# properties of typed array instances.
+
+	'values': [
+	],
+	'functions': [
+		{ 'name': 'set',			'native': 'duk_bi_typedarray_set',			'length': 1,	'nargs': 2 },
+		{ 'name': 'subarray',			'native': 'duk_bi_typedarray_subarray',			'length': 2 },
+	],
+}
+
+bi_int8array_constructor = {
+	'internal_prototype': 'bi_function_prototype',
+	'external_prototype': 'bi_int8array_prototype',
+	'class': 'Function',
+	'name': 'Int8Array',
+
+	'length': 3,
+	'native': 'duk_bi_typedarray_constructor',
+	'callable': True,
+	'constructable': True,
+	'magic': { 'type': 'plain', 'value': BI_ELEM_INT8 },
+
+	'values': [
+		{ 'name': 'BYTES_PER_ELEMENT',		'value': 1,	'attributes': '' },
+	],
+	'functions': [
+	]
+}
+
+bi_int8array_prototype = {
+	'internal_prototype': 'bi_typedarray_prototype',
+	'external_constructor': 'bi_int8array_constructor',
+	'class': 'Object',
+
+	'values': [
+		{ 'name': 'BYTES_PER_ELEMENT',		'value': 1,	'attributes': '' },
+	],
+	'functions': [
+	],
+}
+
+bi_uint8array_constructor = {
+	'internal_prototype': 'bi_function_prototype',
+	'external_prototype': 'bi_uint8array_prototype',
+	'class': 'Function',
+	'name': 'Uint8Array',
+
+	'length': 3,
+	'native': 'duk_bi_typedarray_constructor',
+	'callable': True,
+	'constructable': True,
+	'magic': { 'type': 'plain', 'value': BI_ELEM_UINT8 },
+
+	'values': [
+		{ 'name': 'BYTES_PER_ELEMENT',		'value': 1,	'attributes': '' },
+	],
+	'functions': [
+	]
+}
+
+bi_uint8array_prototype = {
+	'internal_prototype': 'bi_typedarray_prototype',
+	'external_constructor': 'bi_uint8array_constructor',
+	'class': 'Object',
+
+	'values': [
+		{ 'name': 'BYTES_PER_ELEMENT',		'value': 1,	'attributes': '' },
+	],
+	'functions': [
+	],
+}
+
+bi_uint8clampedarray_constructor = {
+	'internal_prototype': 'bi_function_prototype',
+	'external_prototype': 'bi_uint8clampedarray_prototype',
+	'class': 'Function',
+	'name': 'Uint8ClampedArray',
+
+	'length': 3,
+	'native': 'duk_bi_typedarray_constructor',
+	'callable': True,
+	'constructable': True,
+	'magic': { 'type': 'plain', 'value': BI_ELEM_UINT8CLAMPED },
+
+	'values': [
+		{ 'name': 'BYTES_PER_ELEMENT',		'value': 1,	'attributes': '' },
+	],
+	'functions': [
+	]
+}
+
+bi_uint8clampedarray_prototype = {
+	'internal_prototype': 'bi_typedarray_prototype',
+	'external_constructor': 'bi_uint8clampedarray_constructor',
+	'class': 'Object',
+
+	'values': [
+		{ 'name': 'BYTES_PER_ELEMENT',		'value': 1,	'attributes': '' },
+	],
+	'functions': [
+	],
+}
+
+bi_int16array_constructor = {
+	'internal_prototype': 'bi_function_prototype',
+	'external_prototype': 'bi_int16array_prototype',
+	'class': 'Function',
+	'name': 'Int16Array',
+
+	'length': 3,
+	'native': 'duk_bi_typedarray_constructor',
+	'callable': True,
+	'constructable': True,
+	'magic': { 'type': 'plain', 'value': BI_ELEM_INT16 },
+
+	'values': [
+		{ 'name': 'BYTES_PER_ELEMENT',		'value': 2,	'attributes': '' },
+	],
+	'functions': [
+	]
+}
+
+bi_int16array_prototype = {
+	'internal_prototype': 'bi_typedarray_prototype',
+	'external_constructor': 'bi_int16array_constructor',
+	'class': 'Object',
+
+	'values': [
+		{ 'name': 'BYTES_PER_ELEMENT',		'value': 2,	'attributes': '' },
+	],
+	'functions': [
+	],
+}
+
+bi_uint16array_constructor = {
+	'internal_prototype': 'bi_function_prototype',
+	'external_prototype': 'bi_uint16array_prototype',
+	'class': 'Function',
+	'name': 'Uint16Array',
+
+	'length': 3,
+	'native': 'duk_bi_typedarray_constructor',
+	'callable': True,
+	'constructable': True,
+	'magic': { 'type': 'plain', 'value': BI_ELEM_UINT16 },
+
+	'values': [
+		{ 'name': 'BYTES_PER_ELEMENT',		'value': 2,	'attributes': '' },
+	],
+	'functions': [
+	]
+}
+
+bi_uint16array_prototype = {
+	'internal_prototype': 'bi_typedarray_prototype',
+	'external_constructor': 'bi_uint16array_constructor',
+	'class': 'Object',
+
+	'values': [
+		{ 'name': 'BYTES_PER_ELEMENT',		'value': 2,	'attributes': '' },
+	],
+	'functions': [
+	],
+}
+
+bi_int32array_constructor = {
+	'internal_prototype': 'bi_function_prototype',
+	'external_prototype': 'bi_int32array_prototype',
+	'class': 'Function',
+	'name': 'Int32Array',
+
+	'length': 3,
+	'native': 'duk_bi_typedarray_constructor',
+	'callable': True,
+	'constructable': True,
+	'magic': { 'type': 'plain', 'value': BI_ELEM_INT32 },
+
+	'values': [
+		{ 'name': 'BYTES_PER_ELEMENT',		'value': 4,	'attributes': '' },
+	],
+	'functions': [
+	]
+}
+
+bi_int32array_prototype = {
+	'internal_prototype': 'bi_typedarray_prototype',
+	'external_constructor': 'bi_int32array_constructor',
+	'class': 'Object',
+
+	'values': [
+		{ 'name': 'BYTES_PER_ELEMENT',		'value': 4,	'attributes': '' },
+	],
+	'functions': [
+	],
+}
+
+bi_uint32array_constructor = {
+	'internal_prototype': 'bi_function_prototype',
+	'external_prototype': 'bi_uint32array_prototype',
+	'class': 'Function',
+	'name': 'Uint32Array',
+
+	'length': 3,
+	'native': 'duk_bi_typedarray_constructor',
+	'callable': True,
+	'constructable': True,
+	'magic': { 'type': 'plain', 'value': BI_ELEM_UINT32 },
+
+	'values': [
+		{ 'name': 'BYTES_PER_ELEMENT',		'value': 4,	'attributes': '' },
+	],
+	'functions': [
+	]
+}
+
+bi_uint32array_prototype = {
+	'internal_prototype': 'bi_typedarray_prototype',
+	'external_constructor': 'bi_uint32array_constructor',
+	'class': 'Object',
+
+	'values': [
+		{ 'name': 'BYTES_PER_ELEMENT',		'value': 4,	'attributes': '' },
+	],
+	'functions': [
+	],
+}
+
+bi_float32array_constructor = {
+	'internal_prototype': 'bi_function_prototype',
+	'external_prototype': 'bi_float32array_prototype',
+	'class': 'Function',
+	'name': 'Float32Array',
+
+	'length': 3,
+	'native': 'duk_bi_typedarray_constructor',
+	'callable': True,
+	'constructable': True,
+	'magic': { 'type': 'plain', 'value': BI_ELEM_FLOAT32 },
+
+	'values': [
+		{ 'name': 'BYTES_PER_ELEMENT',		'value': 4,	'attributes': '' },
+	],
+	'functions': [
+	]
+}
+
+bi_float32array_prototype = {
+	'internal_prototype': 'bi_typedarray_prototype',
+	'external_constructor': 'bi_float32array_constructor',
+	'class': 'Object',
+
+	'values': [
+		{ 'name': 'BYTES_PER_ELEMENT',		'value': 4,	'attributes': '' },
+	],
+	'functions': [
+	],
+}
+
+bi_float64array_constructor = {
+	'internal_prototype': 'bi_function_prototype',
+	'external_prototype': 'bi_float64array_prototype',
+	'class': 'Function',
+	'name': 'Float64Array',
+
+	'length': 3,
+	'native': 'duk_bi_typedarray_constructor',
+	'callable': True,
+	'constructable': True,
+	'magic': { 'type': 'plain', 'value': BI_ELEM_FLOAT64 },
+
+	'values': [
+		{ 'name': 'BYTES_PER_ELEMENT',		'value': 8,	'attributes': '' },
+	],
+	'functions': [
+	]
+}
+
+bi_float64array_prototype = {
+	'internal_prototype': 'bi_typedarray_prototype',
+	'external_constructor': 'bi_float64array_constructor',
+	'class': 'Object',
+
+	'values': [
+		{ 'name': 'BYTES_PER_ELEMENT',		'value': 8,	'attributes': '' },
+	],
+	'functions': [
+	],
+}
+
+bi_weakmap_constructor = {
+	'internal_prototype': 'bi_function_prototype',
+	'external_prototype': 'bi_weakmap_prototype',
+	'class': 'Function',
+	'name': 'WeakMap',
+
+	'length': 0,
+	'varargs': True,
+	'native': 'duk_bi_weakmap_constructor',
+	'callable': True,
+	'constructable': True,
+
+	'values': [],
+	'functions': [
+	]
+}
+
+bi_weakmap_prototype = {
+	'internal_prototype': 'bi_object_prototype',
+	'external_constructor': 'bi_weakmap_constructor',
+	'class': 'Object',
+
+	# Like ES6, WeakMap.prototype is not a WeakMap instance.
+
+	'values': [
+	],
+	'functions': [
+		{ 'name': 'delete',			'native': 'duk_bi_weakmap_prototype_delete',	'length': 1 },
+		{ 'name': 'get',			'native': 'duk_bi_weakmap_prototype_get',	'length': 1 },
+		{ 'name': 'has',			'native': 'duk_bi_weakmap_prototype_has',	'length': 1 },
+		{ 'name': 'set',			'native': 'duk_bi_weakmap_prototype_set',	'length': 2 },
+	],
+}
+
 bi_pointer_constructor = {
 	'internal_prototype': 'bi_function_prototype',
 	'external_prototype': 'bi_pointer_prototype',
@@ -1273,6 +1720,33 @@ bi_logger_prototype = {
 	],
 }
 
+bi_weakref_constructor = {
+	'internal_prototype': 'bi_function_prototype',
+	'external_prototype': 'bi_weakref_prototype',
+	'class': 'Function',
+	'name': 'WeakRef',
+
+	'length': 1,
+	'native': 'duk_bi_weakref_constructor',
+	'callable': True,
+	'constructable': True,
+
+	'values': [],
+	'functions': [
+	]
+}
+
+bi_weakref_prototype = {
+	'internal_prototype': 'bi_object_prototype',
+	'external_constructor': 'bi_weakref_constructor',
+	'class': 'Object',
+
+	'values': [
+	],
+	'functions': [
+		{ 'name': 'deref',			'native': 'duk_bi_weakref_prototype_deref',	'length': 0 },
+	],
+}
 
 # This is an Error *instance* used to avoid allocation when a "double error" occurs.
 # The object is "frozen and sealed" to avoid code accidentally modifying the instance.
@@ -1337,6 +1811,31 @@ builtins_orig = [
 
 	# es6
 	{ 'id': 'bi_proxy_constructor',			'info': bi_proxy_constructor },
+	{ 'id': 'bi_arraybuffer_constructor',		'info': bi_arraybuffer_constructor },
+	{ 'id': 'bi_arraybuffer_prototype',		'info': bi_arraybuffer_prototype },
+	{ 'id': 'bi_dataview_constructor',		'info': bi_dataview_constructor },
+	{ 'id': 'bi_dataview_prototype',		'info': bi_dataview_prototype },
+	{ 'id': 'bi_typedarray_prototype',		'info': bi_typedarray_prototype },
+	{ 'id': 'bi_int8array_constructor',		'info': bi_int8array_constructor },
+	{ 'id': 'bi_int8array_prototype',		'info': bi_int8array_prototype },
+	{ 'id': 'bi_uint8array_constructor',		'info': bi_uint8array_constructor },
+	{ 'id': 'bi_uint8array_prototype',		'info': bi_uint8array_prototype },
+	{ 'id': 'bi_uint8clampedarray_constructor',	'info': bi_uint8clampedarray_constructor },
+	{ 'id': 'bi_uint8clampedarray_prototype',	'info': bi_uint8clampedarray_prototype },
+	{ 'id': 'bi_int16array_constructor',		'info': bi_int16array_constructor },
+	{ 'id': 'bi_int16array_prototype',		'info': bi_int16array_prototype },
+	{ 'id': 'bi_uint16array_constructor',		'info': bi_uint16array_constructor },
+	{ 'id': 'bi_uint16array_prototype',		'info': bi_uint16array_prototype },
+	{ 'id': 'bi_int32array_constructor',		'info': bi_int32array_constructor },
+	{ 'id': 'bi_int32array_prototype',		'info': bi_int32array_prototype },
+	{ 'id': 'bi_uint32array_constructor',		'info': bi_uint32array_constructor },
+	{ 'id': 'bi_uint32array_prototype',		'info': bi_uint32array_prototype },
+	{ 'id': 'bi_float32array_constructor',		'info': bi_float32array_constructor },
+	{ 'id': 'bi_float32array_prototype',		'info': bi_float32array_prototype },
+	{ 'id': 'bi_float64array_constructor',		'info': bi_float64array_constructor },
+	{ 'id': 'bi_float64array_prototype',		'info': bi_float64array_prototype },
+	{ 'id': 'bi_weakmap_constructor',		'info': bi_weakmap_constructor },
+	{ 'id': 'bi_weakmap_prototype',			'info': bi_weakmap_prototype },
 
 	# custom
 	{ 'id': 'bi_duktape',				'info': bi_duktape },
@@ -1348,6 +1847,8 @@ builtins_orig = [
 	{ 'id': 'bi_pointer_prototype',			'info': bi_pointer_prototype },
 	{ 'id': 'bi_logger_constructor',		'info': bi_logger_constructor },
 	{ 'id': 'bi_logger_prototype',			'info': bi_logger_prototype },
+	{ 'id': 'bi_weakref_constructor',		'info': bi_weakref_constructor },
+	{ 'id': 'bi_weakref_prototype',			'info': bi_weakref_prototype },
 	{ 'id': 'bi_double_error',                      'info': bi_double_error },
 ]
 
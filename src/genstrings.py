@@ -498,6 +498,42 @@ es6_string_list = [
 
 	mkstr("setPrototypeOf", es6=True),
 	mkstr("__proto__", es6=True),
+
+	# TypedArray and related
+	mkstr("ArrayBuffer", es6=True, class_name=True),
+	mkstr("DataView", es6=True, class_name=True),
+	mkstr("Int8Array", es6=True, class_name=True),
+	mkstr("Uint8Array", es6=True, class_name=True),
+	mkstr("Uint8ClampedArray", es6=True, class_name=True),
+	mkstr("Int16Array", es6=True, class_name=True),
+	mkstr("Uint16Array", es6=True, class_name=True),
+	mkstr("Int32Array", es6=True, class_name=True),
+	mkstr("Uint32Array", es6=True, class_name=True),
+	mkstr("Float32Array", es6=True, class_name=True),
+	mkstr("Float64Array", es6=True, class_name=True),
+	mkstr("WeakMap", es6=True, class_name=True),
+	mkstr("isView", es6=True),
+	mkstr("buffer", es6=True),
+	mkstr("byteLength", es6=True),
+	mkstr("byteOffset", es6=True),
+	mkstr("BYTES_PER_ELEMENT", es6=True),
+	mkstr("subarray", es6=True),
+	mkstr("getInt8", es6=True),
+	mkstr("getUint8", es6=True),
+	mkstr("getInt16", es6=True),
+	mkstr("getUint16", es6=True),
+	mkstr("getInt32", es6=True),
+	mkstr("getUint32", es6=True),
+	mkstr("getFloat32", es6=True),
+	mkstr("getFloat64", es6=True),
+	mkstr("setInt8", es6=True),
+	mkstr("setUint8", es6=True),
+	mkstr("setInt16", es6=True),
+	mkstr("setUint16", es6=True),
+	mkstr("setInt32", es6=True),
+	mkstr("setUint32", es6=True),
+	mkstr("setFloat32", es6=True),
+	mkstr("setFloat64", es6=True),
 ]
 
 # CommonJS related strings
@@ -519,6 +555,7 @@ duk_string_list = [
 	mkstr("Pointer", custom=True, class_name=True),
 	mkstr("Thread", custom=True, class_name=True),
 	mkstr("Logger", custom=True, class_name=True),
+	mkstr("WeakRef", custom=True, class_name=True),
 
 	# non-standard built-in object names
 	mkstr("ThrowTypeError", custom=True),  # implementation specific, matches V8
@@ -545,6 +582,7 @@ duk_string_list = [
 	# internal properties for enumerator objects
 	mkstr("Target", internal=True, custom=True),
 	mkstr("Next", internal=True, custom=True),
+	mkstr("Limit", internal=True, custom=True),
 
 	# internal properties for RegExp instances
 	mkstr("Bytecode", internal=True, custom=True),
@@ -607,6 +645,7 @@ duk_string_list = [
 	mkstr("jx", custom=True),       # enc/dec alg
 	mkstr("jc", custom=True),       # enc/dec alg
 	mkstr("compact", custom=True),
+	mkstr("heapStats", custom=True),
 
 	# Buffer constructor
 
@@ -623,6 +662,9 @@ duk_string_list = [
 
 	# Thread prototype
 
+	# WeakRef prototype
+	mkstr("deref", custom=True),
+
 	# Logger constructor
 
 	# Logger prototype and logger instances
@@ -790,6 +832,7 @@ special_define_names = {
 	'MAX_VALUE': 'MAX_VALUE',
 	'NEGATIVE_INFINITY': 'NEGATIVE_INFINITY',
 	'POSITIVE_INFINITY': 'POSITIVE_INFINITY',
+	'BYTES_PER_ELEMENT': 'BYTES_PER_ELEMENT',
 	'(?:)': 'ESCAPED_EMPTY_REGEXP',
 	'Invalid Date': 'INVALID_DATE',
 
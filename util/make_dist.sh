@@ -108,8 +108,10 @@ for i in \
 	duk_bi_regexp.c		\
 	duk_bi_string.c		\
 	duk_bi_proxy.c		\
+	duk_bi_weakmap.c	\
 	duk_bi_thread.c		\
 	duk_bi_thrower.c	\
+	duk_bi_typedarray.c	\
 	duk_debug_fixedbuffer.c	\
 	duk_debug.h		\
 	duk_debug_heap.c	\
@@ -126,6 +128,10 @@ for i in \
 	duk_hbuffer_alloc.c	\
 	duk_hbuffer.h		\
 	duk_hbuffer_ops.c	\
+	duk_hbufferobject.h	\
+	duk_hbufferobject_misc.c \
+	duk_hweakobject.h	\
+	duk_hweakobject_misc.c	\
 	duk_hcompiledfunction.h	\
 	duk_heap_alloc.c	\
 	duk_heap.h		\
@@ -135,6 +141,8 @@ for i in \
 	duk_heap_memory.c	\
 	duk_heap_misc.c		\
 	duk_heap_refcount.c	\
+	duk_heap_slab.c		\
+	duk_heap_arena.c		\
 	duk_heap_stringcache.c	\
 	duk_heap_stringtable.c	\
 	duk_hnativefunction.h	\
@@ -146,6 +154,7 @@ for i in \
 	duk_hobject_misc.c	\
 	duk_hobject_pc2line.c	\
 	duk_hobject_props.c	\
+	duk_hobject_shape.c	\
 	duk_hstring.h		\
 	duk_hstring_misc.c	\
 	duk_hthread_alloc.c	\